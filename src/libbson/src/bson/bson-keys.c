@@ -17,11 +17,7 @@
 
 #include <bson/bson-keys.h>
 
-#include <common-string-private.h>
-
-#include <mlib/cmp.h>
-
-#include <stdio.h>
+#include <string.h>
 
 
 static const char *gUint32Strs[] = {
@@ -89,6 +85,23 @@ static const char *gUint32Strs[] = {
    "976", "977", "978", "979", "980", "981", "982", "983", "984", "985", "986", "987", "988", "989", "990", "991",
    "992", "993", "994", "995", "996", "997", "998", "999"};
 
+// Two-digit decimal representations of 0 to 99, used to format two digits at a time.
+static const char gDigitPairs[] = "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+                                  "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+
+// Returns the number of decimal digits in @value.
+static BSON_INLINE size_t
+_bson_uint32_num_digits(uint32_t value)
+{
+   if (value < 100000u) {
+      return value < 100u ? (value < 10u ? 1u : 2u) : (value < 1000u ? 3u : (value < 10000u ? 4u : 5u));
+   }
+
+   return value < 10000000u ? (value < 1000000u ? 6u : 7u)
+                            : (value < 100000000u ? 8u : (value < 1000000000u ? 9u : 10u));
+}
+
 
 /*
  *--------------------------------------------------------------------------
@@ -100,8 +113,7 @@ static const char *gUint32Strs[] = {
  *       If @value is from 0 to 1000, it will use a constant string in the
  *       data section of the library.
  *
- *       If not, a string will be formatted using @str and snprintf(). This
- *       is much slower, of course and therefore we try to optimize it out.
+ *       If not, the decimal digits are written to @str, two at a time.
  *
  *       @strptr will always be set. It will either point to @str or a
  *       constant string. You will want to use this as your key.
@@ -109,7 +121,7 @@ static const char *gUint32Strs[] = {
  * Parameters:
  *       @value: A #uint32_t to convert to string.
  *       @strptr: (out): A pointer to the resulting string.
- *       @str: (out): Storage for a string made with snprintf.
+ *       @str: (out): Storage for the formatted string.
  *       @size: Size of @str.
  *
  * Returns:
@@ -144,9 +156,30 @@ bson_uint32_to_string(uint32_t value,      /* IN */
 
    *strptr = str;
 
-   int ret = bson_snprintf(str, size, "%u", value);
+   // Format from the last digit, two digits at a time. UINT32_MAX is 10 digits.
+   char digits[10];
+   const size_t len = _bson_uint32_num_digits(value);
+   char *p = digits + len;
+
+   while (value >= 100u) {
+      p -= 2;
+      memcpy(p, gDigitPairs + (value % 100u) * 2u, 2u);
+      value /= 100u;
+   }
+
+   if (value >= 10u) {
+      p -= 2;
+      memcpy(p, gDigitPairs + value * 2u, 2u);
+   } else {
+      *--p = (char)('0' + value);
+   }
+
    // Truncation is OK.
-   BSON_ASSERT(ret > 0);
-   BSON_ASSERT(mlib_in_range(size_t, ret));
-   return (size_t)ret;
+   if (size > 0u) {
+      const size_t n = BSON_MIN(len, size - 1u);
+      memcpy(str, digits, n);
+      str[n] = '\0';
+   }
+
+   return len;
 }
@@ -353,6 +353,50 @@ BSON_STATIC_ASSERT2(max_alloc_grow_fits_min_sizet, (uint64_t)BSON_MAX_SIZE * 2u
    ((void)0)
 
 
+// Fast path for elements whose value size is known up front, in place of an argument list: checks the key, grows
+// `bson` once, and writes the type, key and trailing NULL byte of the document. The caller stores `value_size` bytes at
+// the returned address. Returns NULL, leaving `bson` unchanged, on an embedded NULL in the key or BSON max size overflow.
+static BSON_INLINE uint8_t *
+_bson_append_element_begin(bson_t *bson, bson_type_t type, const char *key, int key_length, uint32_t value_size)
+{
+   size_t key_zulen;
+
+   if (key_length < 0) {
+      key_zulen = strlen(key);
+   } else {
+      key_zulen = (size_t)key_length;
+
+      // Necessary to validate embedded NULL is not present in key.
+      if (memchr(key, '\0', key_zulen) != NULL) {
+         return NULL;
+      }
+   }
+
+   if (BSON_UNLIKELY(key_zulen > BSON_MAX_SIZE || value_size > BSON_MAX_SIZE)) {
+      return NULL;
+   }
+
+   // The type, the key and its NULL terminator, and the value.
+   const uint64_t n_bytes = 2u + (uint64_t)key_zulen + (uint64_t)value_size;
+
+   if (BSON_UNLIKELY(n_bytes > BSON_MAX_SIZE - bson->len) || BSON_UNLIKELY(!_bson_grow(bson, (uint32_t)n_bytes))) {
+      return NULL;
+   }
+
+   uint8_t *const data = _bson_data(bson) + (bson->len - 1u);
+
+   data[0] = (uint8_t)type;
+   memcpy(data + 1u, key, key_zulen);
+   data[1u + key_zulen] = '\0';
+   data[n_bytes] = '\0';
+
+   bson->len += (uint32_t)n_bytes;
+   _bson_encode_length(bson);
+
+   return data + 2u + key_zulen;
+}
+
+
 /*
  *--------------------------------------------------------------------------
  *
@@ -894,27 +938,17 @@ bson_append_bool(bson_t *bson,    /* IN */
                  int key_length,  /* IN */
                  bool value)      /* IN */
 {
-   static const uint8_t type = BSON_TYPE_BOOL;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-
-   const uint8_t byte_arg = value ? 1u : 0u;
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &byte_arg, sizeof(byte_arg));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_BOOL, key, key_length, 1u);
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   data[0] = value ? 1u : 0u;
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
@@ -1159,107 +1193,68 @@ append_failure:
 bool
 bson_append_double(bson_t *bson, const char *key, int key_length, double value)
 {
-   static const uint8_t type = BSON_TYPE_DOUBLE;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   const double value_arg = BSON_DOUBLE_TO_LE(value);
-
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &value_arg, sizeof(value_arg));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_DOUBLE, key, key_length, sizeof(double));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   mlib_write_f64le(data, value);
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
 bool
 bson_append_int32(bson_t *bson, const char *key, int key_length, int32_t value)
 {
-   static const uint8_t type = BSON_TYPE_INT32;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   const uint32_t value_arg = BSON_UINT32_TO_LE(value);
-
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &value_arg, sizeof(value_arg));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_INT32, key, key_length, sizeof(int32_t));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   mlib_write_i32le(data, value);
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
 bool
 bson_append_int64(bson_t *bson, const char *key, int key_length, int64_t value)
 {
-   static const uint8_t type = BSON_TYPE_INT64;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   const uint64_t value_arg = BSON_UINT64_TO_LE(value);
-
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &value_arg, sizeof(value_arg));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_INT64, key, key_length, sizeof(int64_t));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   mlib_write_i64le(data, value);
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
 bool
 bson_append_decimal128(bson_t *bson, const char *key, int key_length, const bson_decimal128_t *value)
 {
-   static const uint8_t type = BSON_TYPE_DECIMAL128;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   const uint64_t value_arg[] = {
-      BSON_UINT64_TO_LE(value->low),
-      BSON_UINT64_TO_LE(value->high),
-   };
-
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &value_arg, sizeof(value_arg));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_DECIMAL128, key, key_length, 2u * sizeof(uint64_t));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   mlib_write_u64le(mlib_write_u64le(data, value->low), value->high);
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
@@ -1418,94 +1413,48 @@ bson_append_iter(bson_t *bson, const char *key, int key_length, const bson_iter_
 bool
 bson_append_maxkey(bson_t *bson, const char *key, int key_length)
 {
-   static const uint8_t type = BSON_TYPE_MAXKEY;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
-
-   return true;
-
-append_failure:
-   return false;
+   return _bson_append_element_begin(bson, BSON_TYPE_MAXKEY, key, key_length, 0u) != NULL;
 }
 
 
 bool
 bson_append_minkey(bson_t *bson, const char *key, int key_length)
 {
-   static const uint8_t type = BSON_TYPE_MINKEY;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
-
-   return true;
-
-append_failure:
-   return false;
+   return _bson_append_element_begin(bson, BSON_TYPE_MINKEY, key, key_length, 0u) != NULL;
 }
 
 
 bool
 bson_append_null(bson_t *bson, const char *key, int key_length)
 {
-   static const uint8_t type = BSON_TYPE_NULL;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
-
-   return true;
-
-append_failure:
-   return false;
+   return _bson_append_element_begin(bson, BSON_TYPE_NULL, key, key_length, 0u) != NULL;
 }
 
 
 bool
 bson_append_oid(bson_t *bson, const char *key, int key_length, const bson_oid_t *value)
 {
-   static const uint8_t type = BSON_TYPE_OID;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
    BSON_ASSERT_PARAM(value);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, value->bytes, sizeof(value->bytes));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_OID, key, key_length, sizeof(value->bytes));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   memcpy(data, value->bytes, sizeof(value->bytes));
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
@@ -1566,8 +1515,6 @@ append_failure:
 bool
 bson_append_utf8(bson_t *bson, const char *key, int key_length, const char *value, int length)
 {
-   static const uint8_t type = BSON_TYPE_UTF8;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
@@ -1582,28 +1529,23 @@ bson_append_utf8(bson_t *bson, const char *key, int key_length, const char *valu
       zulength = (size_t)length;
    }
 
-   if (zulength > UINT32_MAX - 1u) {
+   // The length prefix, the string, and its NULL terminator.
+   if (zulength > BSON_MAX_SIZE - 5u) {
       return false;
    }
 
    const uint32_t ulength = (uint32_t)zulength;
-   const uint32_t ulength_arg = BSON_UINT32_TO_LE(ulength + 1u);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &ulength_arg, sizeof(ulength_arg));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, value, ulength);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_UTF8, key, key_length, 4u + ulength + 1u);
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   uint8_t *const str = mlib_write_u32le(data, ulength + 1u);
+   memcpy(str, value, ulength);
+   str[ulength] = '\0';
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
@@ -1670,26 +1612,17 @@ bson_append_time_t(bson_t *bson, const char *key, int key_length, time_t value)
 bool
 bson_append_timestamp(bson_t *bson, const char *key, int key_length, uint32_t timestamp, uint32_t increment)
 {
-   static const uint8_t type = BSON_TYPE_TIMESTAMP;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   const uint64_t value = BSON_UINT64_TO_LE(((((uint64_t)timestamp) << 32) | ((uint64_t)increment)));
-
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &value, sizeof(value));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_TIMESTAMP, key, key_length, sizeof(uint64_t));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   mlib_write_u64le(data, (((uint64_t)timestamp) << 32) | ((uint64_t)increment));
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
@@ -1707,26 +1640,17 @@ bson_append_now_utc(bson_t *bson, const char *key, int key_length)
 bool
 bson_append_date_time(bson_t *bson, const char *key, int key_length, int64_t value)
 {
-   static const uint8_t type = BSON_TYPE_DATE_TIME;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   const uint64_t value_arg = BSON_UINT64_TO_LE(value);
-
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &value_arg, sizeof(value_arg));
+   uint8_t *const data = _bson_append_element_begin(bson, BSON_TYPE_DATE_TIME, key, key_length, sizeof(int64_t));
+   if (BSON_UNLIKELY(!data)) {
+      return false;
+   }
 
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
+   mlib_write_i64le(data, value);
 
    return true;
-
-append_failure:
-   return false;
 }
 
 
@@ -1747,23 +1671,10 @@ bson_append_timeval(bson_t *bson, const char *key, int key_length, struct timeva
 bool
 bson_append_undefined(bson_t *bson, const char *key, int key_length)
 {
-   static const uint8_t type = BSON_TYPE_UNDEFINED;
-
    BSON_ASSERT_PARAM(bson);
    BSON_ASSERT_PARAM(key);
 
-   BSON_APPEND_BYTES_LIST_DECLARE(args);
-
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &type, sizeof(type));
-   BSON_APPEND_BYTES_ADD_CHECKED_STRING(args, key, key_length);
-   BSON_APPEND_BYTES_ADD_ARGUMENT(args, &gZero, sizeof(gZero));
-
-   BSON_APPEND_BYTES_APPLY_ARGUMENTS(bson, args);
-
-   return true;
-
-append_failure:
-   return false;
+   return _bson_append_element_begin(bson, BSON_TYPE_UNDEFINED, key, key_length, 0u) != NULL;
 }
 
 
@@ -2235,6 +2146,24 @@ bson_reserve_buffer(bson_t *bson, uint32_t total_size)
 }
 
 
+bool
+bson_reserve_capacity(bson_t *bson, uint32_t size)
+{
+   BSON_ASSERT_PARAM(bson);
+
+   if (bson->flags & (BSON_FLAG_IN_CHILD | BSON_FLAG_RDONLY)) {
+      return false;
+   }
+
+   if ((size_t)size > BSON_MAX_SIZE - bson->len) {
+      return false;
+   }
+
+   // Children grow their parent's buffer, including the parent's trailing bytes, as appending to them would.
+   return _bson_grow(bson, size);
+}
+
+
 bool
 bson_steal(bson_t *dst, bson_t *src)
 {
@@ -2699,6 +2628,120 @@ bson_array_builder_append_int64(bson_array_builder_t *bab, int64_t value)
 }
 
 
+static void
+_bson_encode_int32_value(uint8_t *out, const void *values, size_t i)
+{
+   mlib_write_i32le(out, ((const int32_t *)values)[i]);
+}
+
+
+static void
+_bson_encode_int64_value(uint8_t *out, const void *values, size_t i)
+{
+   mlib_write_i64le(out, ((const int64_t *)values)[i]);
+}
+
+
+static void
+_bson_encode_double_value(uint8_t *out, const void *values, size_t i)
+{
+   mlib_write_f64le(out, ((const double *)values)[i]);
+}
+
+
+// `_bson_array_builder_append_values` appends `n_values` elements of a fixed-size `type`. Space for all elements is
+// reserved with one grow, and `encode_fn` writes each value in place after its key. Nothing is appended on failure.
+static bool
+_bson_array_builder_append_values(bson_array_builder_t *bab,
+                                  bson_type_t type,
+                                  uint32_t value_size,
+                                  const void *values,
+                                  size_t n_values,
+                                  void (*encode_fn)(uint8_t *out, const void *values, size_t i))
+{
+   BSON_ASSERT_PARAM(bab);
+
+   if (n_values == 0u) {
+      return true;
+   }
+
+   BSON_ASSERT_PARAM(values);
+
+   bson_t *const bson = &bab->bson;
+
+   if (n_values > BSON_MAX_SIZE) {
+      return false;
+   }
+
+   // Each element is the type, the key, a NULL terminator, and the value. Add the key lengths by number of digits.
+   uint64_t n_bytes = (uint64_t)n_values * (2u + value_size);
+   {
+      uint64_t index = bab->index;
+      const uint64_t end = index + n_values;
+      uint64_t bound = 10u;
+
+      for (uint64_t digits = 1u; index < end; digits++, bound *= 10u) {
+         const uint64_t range_end = BSON_MIN(end, bound);
+
+         if (index < range_end) {
+            n_bytes += (range_end - index) * digits;
+            index = range_end;
+         }
+      }
+   }
+
+   if (n_bytes > BSON_MAX_SIZE - bson->len || !_bson_grow(bson, (uint32_t)n_bytes)) {
+      return false;
+   }
+
+   uint8_t *data = _bson_data(bson) + (bson->len - 1u);
+
+   for (size_t i = 0u; i < n_values; i++) {
+      const char *key;
+      char buf[16];
+      const size_t key_length = bson_uint32_to_string(bab->index, &key, buf, sizeof buf);
+
+      *data++ = (uint8_t)type;
+      // Copy the key with its NULL terminator.
+      memcpy(data, key, key_length + 1u);
+      data += key_length + 1u;
+      encode_fn(data, values, i);
+      data += value_size;
+      bab->index += 1;
+   }
+
+   bson->len += (uint32_t)n_bytes;
+   _bson_encode_length(bson);
+   data[0] = '\0';
+
+   return true;
+}
+
+
+bool
+bson_array_builder_append_int32_values(bson_array_builder_t *bab, const int32_t *values, size_t n_values)
+{
+   return _bson_array_builder_append_values(
+      bab, BSON_TYPE_INT32, sizeof(int32_t), values, n_values, _bson_encode_int32_value);
+}
+
+
+bool
+bson_array_builder_append_int64_values(bson_array_builder_t *bab, const int64_t *values, size_t n_values)
+{
+   return _bson_array_builder_append_values(
+      bab, BSON_TYPE_INT64, sizeof(int64_t), values, n_values, _bson_encode_int64_value);
+}
+
+
+bool
+bson_array_builder_append_double_values(bson_array_builder_t *bab, const double *values, size_t n_values)
+{
+   return _bson_array_builder_append_values(
+      bab, BSON_TYPE_DOUBLE, sizeof(double), values, n_values, _bson_encode_double_value);
+}
+
+
 bool
 bson_array_builder_append_decimal128(bson_array_builder_t *bab, const bson_decimal128_t *value)
 {
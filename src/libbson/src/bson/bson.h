@@ -314,6 +314,20 @@ bson_destroy(bson_t *bson);
 BSON_EXPORT(uint8_t *)
 bson_reserve_buffer(bson_t *bson, uint32_t total_size);
 
+/**
+ * bson_reserve_capacity:
+ * @bson: A bson_t.
+ * @size: The number of bytes to make room for.
+ *
+ * Grows the buffer of @bson so that @size more bytes of elements can be
+ * appended without reallocating. The contents of @bson are unchanged.
+ *
+ * Returns: true if successful; false if @bson is read-only, has a child in
+ *   progress, or cannot grow by @size bytes.
+ */
+BSON_EXPORT(bool)
+bson_reserve_capacity(bson_t *bson, uint32_t size);
+
 BSON_EXPORT(bool)
 bson_steal(bson_t *dst, bson_t *src);
 
@@ -895,6 +909,18 @@ bson_append_int64(bson_t *bson, const char *key, int key_length, int64_t value);
 BSON_EXPORT(bool)
 bson_array_builder_append_int64(bson_array_builder_t *bab, int64_t value);
 
+// bson_array_builder_append_int32_values, bson_array_builder_append_int64_values, and
+// bson_array_builder_append_double_values append `n_values` elements from `values` in one call. Returns false and
+// appends nothing if the array would overflow max size.
+BSON_EXPORT(bool)
+bson_array_builder_append_int32_values(bson_array_builder_t *bab, const int32_t *values, size_t n_values);
+
+BSON_EXPORT(bool)
+bson_array_builder_append_int64_values(bson_array_builder_t *bab, const int64_t *values, size_t n_values);
+
+BSON_EXPORT(bool)
+bson_array_builder_append_double_values(bson_array_builder_t *bab, const double *values, size_t n_values);
+
 /**
  * bson_append_decimal128:
  * @bson: A bson_t.
@@ -510,3 +510,34 @@ bson_mem_restore_vtable(void)
 
    bson_mem_set_vtable(&vtable);
 }
+
+
+/*
+ *--------------------------------------------------------------------------
+ *
+ * bson_mem_get_vtable --
+ *
+ *       Copies the installed allocation vtable into @vtable, so that a
+ *       wrapping allocator can forward to it. @vtable->aligned_alloc is
+ *       NULL if the installed vtable was set without one.
+ *
+ * Returns:
+ *       None.
+ *
+ * Side effects:
+ *       None.
+ *
+ *--------------------------------------------------------------------------
+ */
+
+void
+bson_mem_get_vtable(bson_mem_vtable_t *vtable)
+{
+   BSON_ASSERT(vtable);
+
+   *vtable = gMemVtable;
+
+   if (vtable->aligned_alloc == _aligned_alloc_as_malloc) {
+      vtable->aligned_alloc = NULL;
+   }
+}
@@ -39,6 +39,8 @@ BSON_EXPORT(void)
 bson_mem_set_vtable(const bson_mem_vtable_t *vtable);
 BSON_EXPORT(void)
 bson_mem_restore_vtable(void);
+BSON_EXPORT(void)
+bson_mem_get_vtable(bson_mem_vtable_t *vtable);
 BSON_EXPORT(void *)
 bson_malloc(size_t num_bytes);
 BSON_EXPORT(void *)
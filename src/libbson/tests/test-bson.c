@@ -1684,6 +1684,91 @@ test_bson_reserve_buffer_errors(void)
 }
 
 
+static void
+test_bson_reserve_capacity(void)
+{
+   bson_t bson = BSON_INITIALIZER;
+   bson_t expected = BSON_INITIALIZER;
+   bson_t child;
+   uint8_t data[5] = {0};
+
+   /* appends within the reserved space don't move the buffer */
+   ASSERT(bson_reserve_capacity(&bson, 1000u));
+   ASSERT_CMPUINT32(bson.len, ==, 5u);
+   const uint8_t *const buf = bson_get_data(&bson);
+
+   for (int i = 0; i < 20; i++) {
+      ASSERT(BSON_APPEND_INT64(&bson, "key", i));
+      ASSERT(BSON_APPEND_UTF8(&bson, "str", "value"));
+      ASSERT(BSON_APPEND_INT64(&expected, "key", i));
+      ASSERT(BSON_APPEND_UTF8(&expected, "str", "value"));
+   }
+
+   ASSERT(bson_get_data(&bson) == buf);
+   ASSERT(bson_equal(&bson, &expected));
+   bson_reinit(&expected);
+
+   /* too big */
+   ASSERT(!bson_reserve_capacity(&bson, (uint32_t)BSON_MAX_SIZE));
+   bson_destroy(&bson);
+
+   /* read-only */
+   mlib_write_u32le(data, 5);
+   ASSERT(bson_init_static(&bson, data, sizeof data));
+   ASSERT(!bson_reserve_capacity(&bson, 10u));
+
+   /* the child grows, the parent is locked until the child ends */
+   bson_init(&bson);
+   BSON_APPEND_DOCUMENT_BEGIN(&bson, "child", &child);
+   ASSERT(!bson_reserve_capacity(&bson, 10u));
+   ASSERT(bson_reserve_capacity(&child, 1000u));
+   ASSERT(BSON_APPEND_INT32(&child, "x", 1));
+   bson_append_document_end(&bson, &child);
+   ASSERT(bson_reserve_capacity(&bson, 10u));
+   BSON_APPEND_DOCUMENT_BEGIN(&expected, "child", &child);
+   BSON_APPEND_INT32(&child, "x", 1);
+   bson_append_document_end(&expected, &child);
+   ASSERT(bson_equal(&bson, &expected));
+   bson_destroy(&expected);
+
+   bson_destroy(&bson);
+}
+
+
+static void
+test_bson_append_fixed_size_key_errors(void)
+{
+   bson_t bson = BSON_INITIALIZER;
+   const bson_oid_t oid = {{0}};
+   const bson_decimal128_t dec = {0};
+
+   /* keys with an embedded NULL are rejected, leaving the document unchanged */
+   ASSERT(!bson_append_bool(&bson, "a\0b", 3, true));
+   ASSERT(!bson_append_double(&bson, "a\0b", 3, 1.0));
+   ASSERT(!bson_append_int32(&bson, "a\0b", 3, 1));
+   ASSERT(!bson_append_int64(&bson, "a\0b", 3, 1));
+   ASSERT(!bson_append_decimal128(&bson, "a\0b", 3, &dec));
+   ASSERT(!bson_append_maxkey(&bson, "a\0b", 3));
+   ASSERT(!bson_append_minkey(&bson, "a\0b", 3));
+   ASSERT(!bson_append_null(&bson, "a\0b", 3));
+   ASSERT(!bson_append_oid(&bson, "a\0b", 3, &oid));
+   ASSERT(!bson_append_timestamp(&bson, "a\0b", 3, 1u, 2u));
+   ASSERT(!bson_append_date_time(&bson, "a\0b", 3, 1));
+   ASSERT(!bson_append_undefined(&bson, "a\0b", 3));
+   ASSERT(!bson_append_utf8(&bson, "a\0b", 3, "x", 1));
+   ASSERT(bson_empty(&bson));
+
+   /* an explicit key length takes a prefix of the key */
+   ASSERT(bson_append_int32(&bson, "abc", 1, 1));
+   ASSERT(bson_append_utf8(&bson, "", 0, "x", -1));
+   ASSERT_CMPUINT32(bson_count_keys(&bson), ==, 2u);
+   ASSERT(bson_has_field(&bson, "a"));
+   ASSERT(bson_has_field(&bson, ""));
+
+   bson_destroy(&bson);
+}
+
+
 static void
 test_bson_destroy_with_steal(void)
 {
@@ -2570,6 +2655,85 @@ test_bson_uint32_to_string(void)
       // Expect the input buffer is used.
       ASSERT_CMPSTR(buf, "100");
    }
+
+   // Test values at each number of digits match snprintf.
+   {
+      const uint32_t values[] = {1000u, 9999u, 10000u, 99999u, 100000u, 1234567u, 10000000u, 987654321u, 1000000000u,
+                                 UINT32_MAX};
+      for (size_t i = 0; i < sizeof values / sizeof values[0]; i++) {
+         char buf[16] = {0};
+         char expect[16];
+         const char *strptr;
+         size_t got = bson_uint32_to_string(values[i], &strptr, buf, sizeof buf);
+         bson_snprintf(expect, sizeof expect, "%" PRIu32, values[i]);
+         ASSERT_CMPSIZE_T(got, ==, strlen(expect));
+         ASSERT_CMPSTR(strptr, expect);
+      }
+   }
+}
+
+static void
+test_bson_array_builder_append_values(void)
+{
+   // Appending values in bulk produces the same bytes as appending one at a time. Cross the boundaries of key lengths.
+   {
+      enum { n = 1200 };
+      int32_t *i32 = bson_malloc(n * sizeof(int32_t));
+      int64_t *i64 = bson_malloc(n * sizeof(int64_t));
+      double *dbl = bson_malloc(n * sizeof(double));
+      for (size_t i = 0; i < n; i++) {
+         i32[i] = (int32_t)i - 600;
+         i64[i] = (int64_t)i * INT64_C(1000000007);
+         dbl[i] = (double)i / 3.0;
+      }
+
+      bson_array_builder_t *expect_bab = bson_array_builder_new();
+      ASSERT(bson_array_builder_append_utf8(expect_bab, "first", -1));
+      for (size_t i = 0; i < n; i++) {
+         ASSERT(bson_array_builder_append_int32(expect_bab, i32[i]));
+      }
+      for (size_t i = 0; i < n; i++) {
+         ASSERT(bson_array_builder_append_int64(expect_bab, i64[i]));
+      }
+      for (size_t i = 0; i < n; i++) {
+         ASSERT(bson_array_builder_append_double(expect_bab, dbl[i]));
+      }
+      bson_t expect;
+      ASSERT(bson_array_builder_build(expect_bab, &expect));
+
+      bson_array_builder_t *bab = bson_array_builder_new();
+      ASSERT(bson_array_builder_append_utf8(bab, "first", -1));
+      ASSERT(bson_array_builder_append_int32_values(bab, i32, n));
+      ASSERT(bson_array_builder_append_int64_values(bab, i64, n));
+      ASSERT(bson_array_builder_append_double_values(bab, dbl, 0)); // No-op.
+      ASSERT(bson_array_builder_append_double_values(bab, dbl, n));
+      bson_t got;
+      ASSERT(bson_array_builder_build(bab, &got));
+
+      ASSERT_CMPUINT32(got.len, ==, expect.len);
+      ASSERT_MEMCMP(bson_get_data(&got), bson_get_data(&expect), (int)expect.len);
+
+      bson_destroy(&got);
+      bson_destroy(&expect);
+      bson_array_builder_destroy(bab);
+      bson_array_builder_destroy(expect_bab);
+      bson_free(dbl);
+      bson_free(i64);
+      bson_free(i32);
+   }
+
+   // Append values to an array nested in a document.
+   {
+      const int32_t values[] = {1, 2, 3};
+      bson_t b = BSON_INITIALIZER;
+      bson_array_builder_t *child;
+      ASSERT(BSON_APPEND_ARRAY_BUILDER_BEGIN(&b, "array", &child));
+      ASSERT(bson_array_builder_append_int32_values(child, values, 3));
+      ASSERT(bson_append_array_builder_end(&b, child));
+      ASSERT(BSON_APPEND_INT32(&b, "after", 4));
+      ASSERT_BSON_EQUAL(b, {"array" : [ 1, 2, 3 ], "after" : 4});
+      bson_destroy(&b);
+   }
 }
 
 static void
@@ -3061,6 +3225,8 @@ test_bson_install(TestSuite *suite)
    TestSuite_Add(suite, "/bson/steal", test_bson_steal);
    TestSuite_Add(suite, "/bson/reserve_buffer", test_bson_reserve_buffer);
    TestSuite_Add(suite, "/bson/reserve_buffer/errors", test_bson_reserve_buffer_errors);
+   TestSuite_Add(suite, "/bson/reserve_capacity", test_bson_reserve_capacity);
+   TestSuite_Add(suite, "/bson/append_fixed_size/key_errors", test_bson_append_fixed_size_key_errors);
    TestSuite_Add(suite, "/bson/destroy_with_steal", test_bson_destroy_with_steal);
    TestSuite_Add(suite, "/bson/has_field", test_bson_has_field);
    TestSuite_Add(suite, "/bson/visit_invalid_field", test_bson_visit_invalid_field);
@@ -3084,4 +3250,5 @@ test_bson_install(TestSuite *suite)
    TestSuite_Add(suite, "/bson/with_duplicate_keys", test_bson_with_duplicate_keys);
    TestSuite_Add(suite, "/bson/uint32_to_string", test_bson_uint32_to_string);
    TestSuite_Add(suite, "/bson/array_builder", test_bson_array_builder);
+   TestSuite_Add(suite, "/bson/array_builder/append_values", test_bson_array_builder_append_values);
 }
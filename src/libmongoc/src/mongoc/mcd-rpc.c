@@ -1540,6 +1540,65 @@ fail:
    return ret;
 }
 
+void *
+mcd_rpc_message_to_compact_iovecs(mcd_rpc_message *rpc, size_t *count)
+{
+   BSON_ASSERT_PARAM(count);
+
+   size_t num_iovecs = 0u;
+   mongoc_iovec_t *const iovecs = mcd_rpc_message_to_iovecs(rpc, &num_iovecs);
+
+   if (!iovecs) {
+      return NULL;
+   }
+
+   size_t copied_len = 0u;
+   for (size_t i = 0u; i < num_iovecs; ++i) {
+      if (iovecs[i].iov_len < MCD_RPC_COMPACT_IOVEC_THRESHOLD) {
+         copied_len += iovecs[i].iov_len;
+      }
+   }
+
+   // The copied bytes follow the (possibly oversized) iovec array.
+   mongoc_iovec_t *const ret = bson_malloc(num_iovecs * sizeof(mongoc_iovec_t) + copied_len);
+   uint8_t *buffer = (uint8_t *)(ret + num_iovecs);
+   bool last_is_copied = false;
+   size_t ret_count = 0u;
+
+   for (size_t i = 0u; i < num_iovecs; ++i) {
+      const mongoc_iovec_t iovec = iovecs[i];
+
+      if (iovec.iov_len >= MCD_RPC_COMPACT_IOVEC_THRESHOLD) {
+         ret[ret_count++] = iovec;
+         last_is_copied = false;
+         continue;
+      }
+
+      if (iovec.iov_len == 0u) {
+         continue;
+      }
+
+      memcpy(buffer, iovec.iov_base, iovec.iov_len);
+
+      if (last_is_copied) {
+         ret[ret_count - 1u].iov_len += iovec.iov_len;
+      } else {
+         ret[ret_count].iov_base = (void *)buffer;
+         ret[ret_count].iov_len = iovec.iov_len;
+         ret_count++;
+         last_is_copied = true;
+      }
+
+      buffer += iovec.iov_len;
+   }
+
+   bson_free(iovecs);
+
+   *count = ret_count;
+
+   return ret;
+}
+
 mcd_rpc_message *
 mcd_rpc_message_new(void)
 {
@@ -123,6 +123,20 @@ mcd_rpc_message_from_data_in_place(mcd_rpc_message *rpc, const void *data, size_
 void *
 mcd_rpc_message_to_iovecs(mcd_rpc_message *rpc, size_t *count);
 
+// Segments shorter than this are copied into a contiguous buffer by
+// `mcd_rpc_message_to_compact_iovecs`.
+#define MCD_RPC_COMPACT_IOVEC_THRESHOLD 512u
+
+// Equivalent to `mcd_rpc_message_to_iovecs`, except adjacent segments shorter
+// than `MCD_RPC_COMPACT_IOVEC_THRESHOLD` bytes (header fields, section kinds,
+// identifiers, small command documents) are copied into a single segment.
+// Larger segments continue to reference the RPC message data without copying.
+//
+// The copied bytes are stored in the same allocation as the iovec array, so
+// the return value is freed with `bson_free` as usual.
+void *
+mcd_rpc_message_to_compact_iovecs(mcd_rpc_message *rpc, size_t *count);
+
 // Return an RPC message object in an initialized state whose fields will be set
 // manually. The return value must be freed by `mcd_rpc_message_destroy`.
 mcd_rpc_message *
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_ALLOC_STATS_PRIVATE_H
+#define MONGOC_ALLOC_STATS_PRIVATE_H
+
+#include <mongoc/mongoc-alloc-stats.h> // IWYU pragma: export
+
+//
+
+#include <bson/bson.h>
+
+BSON_BEGIN_DECLS
+
+/* Attributes the calling thread's allocations to @tag until the matching
+ * _mongoc_alloc_tag_pop. Nested subsystems push their own tag, so the
+ * innermost one wins. Returns the tag to pass to _mongoc_alloc_tag_pop. */
+mongoc_alloc_tag_t
+_mongoc_alloc_tag_push(mongoc_alloc_tag_t tag);
+
+void
+_mongoc_alloc_tag_pop(mongoc_alloc_tag_t prev);
+
+/* Called by mongoc_init and mongoc_cleanup: allocations are only added to the
+ * shared memory counters while they exist. */
+void
+_mongoc_alloc_stats_export_counters(bool enabled);
+
+/* Reinstalls the allocator that mongoc_alloc_stats_enable wrapped. For tests,
+ * which must not leave the wrapper installed for the tests after them. */
+void
+_mongoc_alloc_stats_disable(void);
+
+BSON_END_DECLS
+
+#endif /* MONGOC_ALLOC_STATS_PRIVATE_H */
@@ -0,0 +1,292 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common-atomic-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
+#include <mongoc/mongoc-counters-private.h>
+#include <mongoc/mongoc-thread-private.h>
+
+#include <bson/bson.h>
+
+#include <mlib/config.h>
+
+
+#define MONGOC_ALLOC_TAG_COUNT (MONGOC_ALLOC_TAG_TOPOLOGY + 1)
+
+/* Each tag's totals get their own cache line, since every allocation in the
+ * process updates one of them. */
+typedef struct {
+   int64_t count;
+   int64_t bytes;
+   int64_t reallocs;
+   int64_t padding[5];
+} mongoc_alloc_stats_slot_t;
+
+static mlib_thread_local mongoc_alloc_tag_t gAllocTag = MONGOC_ALLOC_TAG_BSON;
+
+static mongoc_alloc_stats_slot_t gAllocStats[MONGOC_ALLOC_TAG_COUNT];
+
+/* The allocator that was installed before mongoc_alloc_stats_enable. */
+static bson_mem_vtable_t gForwardVtable;
+
+/* Whether our wrapper is installed. INSTALLING while one thread swaps the
+ * vtables; the others wait for it. */
+enum {
+   MONGOC_ALLOC_STATS_OFF,
+   MONGOC_ALLOC_STATS_INSTALLING,
+   MONGOC_ALLOC_STATS_ON,
+};
+
+static int gState = MONGOC_ALLOC_STATS_OFF;
+
+static int gExportCounters;
+
+
+mongoc_alloc_tag_t
+_mongoc_alloc_tag_push(mongoc_alloc_tag_t tag)
+{
+   const mongoc_alloc_tag_t prev = gAllocTag;
+
+   gAllocTag = tag;
+
+   return prev;
+}
+
+
+void
+_mongoc_alloc_tag_pop(mongoc_alloc_tag_t prev)
+{
+   gAllocTag = prev;
+}
+
+
+void
+_mongoc_alloc_stats_export_counters(bool enabled)
+{
+   mcommon_atomic_int_exchange(&gExportCounters, enabled ? 1 : 0, mcommon_memory_order_release);
+}
+
+
+static void
+_mongoc_alloc_stats_record(size_t num_bytes)
+{
+   const mongoc_alloc_tag_t tag = gAllocTag;
+   const int64_t bytes = (int64_t)num_bytes;
+
+   mcommon_atomic_int64_fetch_add(&gAllocStats[tag].count, 1, mcommon_memory_order_relaxed);
+   mcommon_atomic_int64_fetch_add(&gAllocStats[tag].bytes, bytes, mcommon_memory_order_relaxed);
+
+   if (!mcommon_atomic_int_fetch(&gExportCounters, mcommon_memory_order_acquire)) {
+      return;
+   }
+
+   switch (tag) {
+   case MONGOC_ALLOC_TAG_BSON:
+      mongoc_counter_allocs_bson_inc();
+      mongoc_counter_alloc_bytes_bson_add(bytes);
+      break;
+   case MONGOC_ALLOC_TAG_CLUSTER:
+      mongoc_counter_allocs_cluster_inc();
+      mongoc_counter_alloc_bytes_cluster_add(bytes);
+      break;
+   case MONGOC_ALLOC_TAG_CURSOR:
+      mongoc_counter_allocs_cursor_inc();
+      mongoc_counter_alloc_bytes_cursor_add(bytes);
+      break;
+   case MONGOC_ALLOC_TAG_BULK:
+      mongoc_counter_allocs_bulk_inc();
+      mongoc_counter_alloc_bytes_bulk_add(bytes);
+      break;
+   case MONGOC_ALLOC_TAG_APM:
+      mongoc_counter_allocs_apm_inc();
+      mongoc_counter_alloc_bytes_apm_add(bytes);
+      break;
+   case MONGOC_ALLOC_TAG_TOPOLOGY:
+      mongoc_counter_allocs_topology_inc();
+      mongoc_counter_alloc_bytes_topology_add(bytes);
+      break;
+   default:
+      break;
+   }
+}
+
+
+static void *BSON_CALL
+_mongoc_alloc_stats_malloc(size_t num_bytes)
+{
+   _mongoc_alloc_stats_record(num_bytes);
+   return gForwardVtable.malloc(num_bytes);
+}
+
+
+static void *BSON_CALL
+_mongoc_alloc_stats_calloc(size_t n_members, size_t num_bytes)
+{
+   _mongoc_alloc_stats_record(n_members * num_bytes);
+   return gForwardVtable.calloc(n_members, num_bytes);
+}
+
+
+/* The size of @mem is unknown, so resizing it is counted on its own instead
+ * of as an allocation of @num_bytes. */
+static void
+_mongoc_alloc_stats_record_realloc(void)
+{
+   const mongoc_alloc_tag_t tag = gAllocTag;
+
+   mcommon_atomic_int64_fetch_add(&gAllocStats[tag].reallocs, 1, mcommon_memory_order_relaxed);
+
+   if (!mcommon_atomic_int_fetch(&gExportCounters, mcommon_memory_order_acquire)) {
+      return;
+   }
+
+   switch (tag) {
+   case MONGOC_ALLOC_TAG_BSON:
+      mongoc_counter_reallocs_bson_inc();
+      break;
+   case MONGOC_ALLOC_TAG_CLUSTER:
+      mongoc_counter_reallocs_cluster_inc();
+      break;
+   case MONGOC_ALLOC_TAG_CURSOR:
+      mongoc_counter_reallocs_cursor_inc();
+      break;
+   case MONGOC_ALLOC_TAG_BULK:
+      mongoc_counter_reallocs_bulk_inc();
+      break;
+   case MONGOC_ALLOC_TAG_APM:
+      mongoc_counter_reallocs_apm_inc();
+      break;
+   case MONGOC_ALLOC_TAG_TOPOLOGY:
+      mongoc_counter_reallocs_topology_inc();
+      break;
+   default:
+      break;
+   }
+}
+
+
+static void *BSON_CALL
+_mongoc_alloc_stats_realloc(void *mem, size_t num_bytes)
+{
+   if (mem) {
+      _mongoc_alloc_stats_record_realloc();
+   } else {
+      _mongoc_alloc_stats_record(num_bytes);
+   }
+
+   return gForwardVtable.realloc(mem, num_bytes);
+}
+
+
+static void BSON_CALL
+_mongoc_alloc_stats_free(void *mem)
+{
+   gForwardVtable.free(mem);
+}
+
+
+static void *BSON_CALL
+_mongoc_alloc_stats_aligned_alloc(size_t alignment, size_t num_bytes)
+{
+   _mongoc_alloc_stats_record(num_bytes);
+   return gForwardVtable.aligned_alloc(alignment, num_bytes);
+}
+
+
+void
+mongoc_alloc_stats_enable(void)
+{
+   int state = mcommon_atomic_int_compare_exchange_strong(
+      &gState, MONGOC_ALLOC_STATS_OFF, MONGOC_ALLOC_STATS_INSTALLING, mcommon_memory_order_acquire);
+
+   if (state != MONGOC_ALLOC_STATS_OFF) {
+      /* Another call installed the wrapper, or is installing it. */
+      while (state == MONGOC_ALLOC_STATS_INSTALLING) {
+         mcommon_thrd_yield();
+         state = mcommon_atomic_int_fetch(&gState, mcommon_memory_order_acquire);
+      }
+      return;
+   }
+
+   bson_mem_get_vtable(&gForwardVtable);
+
+   /* Without an aligned_alloc to forward to, libbson calls our malloc
+    * instead, which records the allocation once. */
+   const bson_mem_vtable_t vtable = {
+      .malloc = _mongoc_alloc_stats_malloc,
+      .calloc = _mongoc_alloc_stats_calloc,
+      .realloc = _mongoc_alloc_stats_realloc,
+      .free = _mongoc_alloc_stats_free,
+      .aligned_alloc = gForwardVtable.aligned_alloc ? _mongoc_alloc_stats_aligned_alloc : NULL,
+   };
+
+   bson_mem_set_vtable(&vtable);
+
+   mcommon_atomic_int_exchange(&gState, MONGOC_ALLOC_STATS_ON, mcommon_memory_order_release);
+}
+
+
+void
+_mongoc_alloc_stats_disable(void)
+{
+   if (mcommon_atomic_int_compare_exchange_strong(
+          &gState, MONGOC_ALLOC_STATS_ON, MONGOC_ALLOC_STATS_INSTALLING, mcommon_memory_order_acquire) !=
+       MONGOC_ALLOC_STATS_ON) {
+      return;
+   }
+
+   bson_mem_set_vtable(&gForwardVtable);
+
+   mcommon_atomic_int_exchange(&gState, MONGOC_ALLOC_STATS_OFF, mcommon_memory_order_release);
+}
+
+
+int64_t
+mongoc_alloc_stats_get_count(mongoc_alloc_tag_t tag)
+{
+   BSON_ASSERT((int)tag >= 0 && (int)tag < MONGOC_ALLOC_TAG_COUNT);
+
+   return mcommon_atomic_int64_fetch(&gAllocStats[tag].count, mcommon_memory_order_relaxed);
+}
+
+
+int64_t
+mongoc_alloc_stats_get_bytes(mongoc_alloc_tag_t tag)
+{
+   BSON_ASSERT((int)tag >= 0 && (int)tag < MONGOC_ALLOC_TAG_COUNT);
+
+   return mcommon_atomic_int64_fetch(&gAllocStats[tag].bytes, mcommon_memory_order_relaxed);
+}
+
+
+int64_t
+mongoc_alloc_stats_get_realloc_count(mongoc_alloc_tag_t tag)
+{
+   BSON_ASSERT((int)tag >= 0 && (int)tag < MONGOC_ALLOC_TAG_COUNT);
+
+   return mcommon_atomic_int64_fetch(&gAllocStats[tag].reallocs, mcommon_memory_order_relaxed);
+}
+
+
+void
+mongoc_alloc_stats_reset(void)
+{
+   for (int i = 0; i < MONGOC_ALLOC_TAG_COUNT; i++) {
+      mcommon_atomic_int64_exchange(&gAllocStats[i].count, 0, mcommon_memory_order_relaxed);
+      mcommon_atomic_int64_exchange(&gAllocStats[i].bytes, 0, mcommon_memory_order_relaxed);
+      mcommon_atomic_int64_exchange(&gAllocStats[i].reallocs, 0, mcommon_memory_order_relaxed);
+   }
+}
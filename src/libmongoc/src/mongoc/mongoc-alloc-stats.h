@@ -0,0 +1,55 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_ALLOC_STATS_H
+#define MONGOC_ALLOC_STATS_H
+
+#include <mongoc/mongoc-macros.h>
+
+#include <bson/bson.h>
+
+
+BSON_BEGIN_DECLS
+
+
+typedef enum {
+   MONGOC_ALLOC_TAG_BSON,
+   MONGOC_ALLOC_TAG_CLUSTER,
+   MONGOC_ALLOC_TAG_CURSOR,
+   MONGOC_ALLOC_TAG_BULK,
+   MONGOC_ALLOC_TAG_APM,
+   MONGOC_ALLOC_TAG_TOPOLOGY,
+} mongoc_alloc_tag_t;
+
+
+MONGOC_EXPORT(void)
+mongoc_alloc_stats_enable(void);
+MONGOC_EXPORT(int64_t)
+mongoc_alloc_stats_get_count(mongoc_alloc_tag_t tag);
+MONGOC_EXPORT(int64_t)
+mongoc_alloc_stats_get_bytes(mongoc_alloc_tag_t tag);
+MONGOC_EXPORT(int64_t)
+mongoc_alloc_stats_get_realloc_count(mongoc_alloc_tag_t tag);
+MONGOC_EXPORT(void)
+mongoc_alloc_stats_reset(void);
+
+
+BSON_END_DECLS
+
+
+#endif /* MONGOC_ALLOC_STATS_H */
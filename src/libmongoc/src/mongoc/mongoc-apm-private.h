@@ -52,6 +52,10 @@ struct _mongoc_apm_callbacks_t {
 struct _mongoc_apm_command_started_t {
    bson_t *command;
    bool command_owned;
+   /* If set, the OP_MSG document sequences of this command have not been
+    * appended to "command" yet. They are copied on the first call to
+    * mongoc_apm_command_started_get_command. */
+   const struct _mongoc_cmd_t *pending_payloads;
    const char *database_name;
    const char *command_name;
    int64_t request_id;
@@ -63,6 +67,14 @@ struct _mongoc_apm_command_started_t {
    void *context;
 };
 
+#define MONGOC_APM_COMMAND_PHASE_COUNT ((int)MONGOC_APM_COMMAND_PHASE_PARSE_REPLY + 1)
+
+/* Per-phase durations of one command in microseconds, -1 for phases that did
+ * not run or were not measured. */
+typedef struct {
+   int64_t usec[MONGOC_APM_COMMAND_PHASE_COUNT];
+} mongoc_apm_command_phases_t;
+
 struct _mongoc_apm_command_succeeded_t {
    int64_t duration;
    bson_t *reply;
@@ -76,6 +88,7 @@ struct _mongoc_apm_command_succeeded_t {
    bson_oid_t service_id;
    int64_t server_connection_id;
    void *context;
+   mongoc_apm_command_phases_t phases;
 };
 
 struct _mongoc_apm_command_failed_t {
@@ -92,6 +105,7 @@ struct _mongoc_apm_command_failed_t {
    bson_oid_t service_id;
    int64_t server_connection_id;
    void *context;
+   mongoc_apm_command_phases_t phases;
 };
 
 /*
@@ -218,6 +232,9 @@ mongoc_apm_command_failed_init(mongoc_apm_command_failed_t *event,
 void
 mongoc_apm_command_failed_cleanup(mongoc_apm_command_failed_t *event);
 
+void
+_mongoc_apm_command_phases_init(mongoc_apm_command_phases_t *phases);
+
 /**
  * @brief Determine whether the given command-related message is a "sensitive
  * command."
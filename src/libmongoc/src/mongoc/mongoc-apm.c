@@ -15,6 +15,7 @@
  */
 
 #include <common-oid-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-apm-private.h>
 #include <mongoc/mongoc-cmd-private.h>
 #include <mongoc/mongoc-handshake-private.h>
@@ -35,12 +36,16 @@ append_documents_from_cmd(const mongoc_cmd_t *cmd, mongoc_apm_command_started_t
       return;
    }
 
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_APM);
+
    if (!event->command_owned) {
       event->command = bson_copy(event->command);
       event->command_owned = true;
    }
 
    _mongoc_cmd_append_payload_as_array(cmd, event->command);
+
+   _mongoc_alloc_tag_pop(alloc_tag);
 }
 
 
@@ -83,6 +88,7 @@ mongoc_apm_command_started_init(mongoc_apm_command_started_t *event,
    bson_iter_t iter;
    uint32_t len;
    const uint8_t *data;
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_APM);
 
    /* Command Monitoring Spec:
     *
@@ -124,6 +130,7 @@ mongoc_apm_command_started_init(mongoc_apm_command_started_t *event,
       *is_redacted = false;
    }
 
+   event->pending_payloads = NULL;
    event->database_name = database_name;
    event->command_name = command_name;
    event->request_id = request_id;
@@ -134,6 +141,8 @@ mongoc_apm_command_started_init(mongoc_apm_command_started_t *event,
    event->server_connection_id = server_connection_id;
 
    bson_oid_copy_unsafe(service_id, &event->service_id);
+
+   _mongoc_alloc_tag_pop(alloc_tag);
 }
 
 
@@ -169,8 +178,12 @@ mongoc_apm_command_started_init_with_cmd(mongoc_apm_command_started_t *event,
                                    is_redacted,
                                    context);
 
-   /* OP_MSG document sequence for insert, update, or delete? */
-   append_documents_from_cmd(cmd, event);
+   /* OP_MSG document sequence for insert, update, or delete? Copying the
+    * documents may be expensive, so only do it if the callback asks for the
+    * command. */
+   if (cmd->payloads_count > 0) {
+      event->pending_payloads = cmd;
+   }
 }
 
 
@@ -213,10 +226,14 @@ mongoc_apm_command_succeeded_init(mongoc_apm_command_succeeded_t *event,
    BSON_ASSERT(reply);
 
    if (force_redaction || mongoc_apm_is_sensitive_command_message(command_name, reply)) {
+      const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_APM);
+
       event->reply = bson_copy(reply);
       event->reply_owned = true;
 
       mongoc_apm_redact_reply(event->reply);
+
+      _mongoc_alloc_tag_pop(alloc_tag);
    } else {
       /* discard "const", we promise not to modify "reply" */
       event->reply = (bson_t *)reply;
@@ -232,6 +249,7 @@ mongoc_apm_command_succeeded_init(mongoc_apm_command_succeeded_t *event,
    event->server_id = server_id;
    event->server_connection_id = server_connection_id;
    event->context = context;
+   _mongoc_apm_command_phases_init(&event->phases);
 
    bson_oid_copy_unsafe(service_id, &event->service_id);
 }
@@ -277,10 +295,14 @@ mongoc_apm_command_failed_init(mongoc_apm_command_failed_t *event,
    BSON_ASSERT(reply);
 
    if (force_redaction || mongoc_apm_is_sensitive_command_message(command_name, reply)) {
+      const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_APM);
+
       event->reply = bson_copy(reply);
       event->reply_owned = true;
 
       mongoc_apm_redact_reply(event->reply);
+
+      _mongoc_alloc_tag_pop(alloc_tag);
    } else {
       /* discard "const", we promise not to modify "reply" */
       event->reply = (bson_t *)reply;
@@ -297,6 +319,7 @@ mongoc_apm_command_failed_init(mongoc_apm_command_failed_t *event,
    event->server_id = server_id;
    event->server_connection_id = server_connection_id;
    event->context = context;
+   _mongoc_apm_command_phases_init(&event->phases);
 
    bson_oid_copy_unsafe(service_id, &event->service_id);
 }
@@ -311,6 +334,17 @@ mongoc_apm_command_failed_cleanup(mongoc_apm_command_failed_t *event)
 }
 
 
+void
+_mongoc_apm_command_phases_init(mongoc_apm_command_phases_t *phases)
+{
+   BSON_ASSERT_PARAM(phases);
+
+   for (int i = 0; i < MONGOC_APM_COMMAND_PHASE_COUNT; i++) {
+      phases->usec[i] = -1;
+   }
+}
+
+
 /*
  * event field accessors
  */
@@ -320,6 +354,15 @@ mongoc_apm_command_failed_cleanup(mongoc_apm_command_failed_t *event)
 const bson_t *
 mongoc_apm_command_started_get_command(const mongoc_apm_command_started_t *event)
 {
+   if (event->pending_payloads) {
+      /* Events are only valid during the callback, which the driver invokes
+       * with an event it owns, so it is safe to complete it in place. */
+      mongoc_apm_command_started_t *const mutable_event = (mongoc_apm_command_started_t *)event;
+
+      append_documents_from_cmd(event->pending_payloads, mutable_event);
+      mutable_event->pending_payloads = NULL;
+   }
+
    return event->command;
 }
 
@@ -401,6 +444,25 @@ mongoc_apm_command_succeeded_get_duration(const mongoc_apm_command_succeeded_t *
 }
 
 
+static int64_t
+_mongoc_apm_command_phase_duration(const mongoc_apm_command_phases_t *phases, mongoc_apm_command_phase_t phase)
+{
+   if ((int)phase < 0 || (int)phase >= MONGOC_APM_COMMAND_PHASE_COUNT) {
+      return -1;
+   }
+
+   return phases->usec[phase];
+}
+
+
+int64_t
+mongoc_apm_command_succeeded_get_phase_duration(const mongoc_apm_command_succeeded_t *event,
+                                                mongoc_apm_command_phase_t phase)
+{
+   return _mongoc_apm_command_phase_duration(&event->phases, phase);
+}
+
+
 const bson_t *
 mongoc_apm_command_succeeded_get_reply(const mongoc_apm_command_succeeded_t *event)
 {
@@ -483,6 +545,13 @@ mongoc_apm_command_failed_get_duration(const mongoc_apm_command_failed_t *event)
 }
 
 
+int64_t
+mongoc_apm_command_failed_get_phase_duration(const mongoc_apm_command_failed_t *event, mongoc_apm_command_phase_t phase)
+{
+   return _mongoc_apm_command_phase_duration(&event->phases, phase);
+}
+
+
 const char *
 mongoc_apm_command_failed_get_command_name(const mongoc_apm_command_failed_t *event)
 {
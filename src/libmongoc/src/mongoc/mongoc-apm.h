@@ -55,6 +55,19 @@ typedef struct _mongoc_apm_command_started_t mongoc_apm_command_started_t;
 typedef struct _mongoc_apm_command_succeeded_t mongoc_apm_command_succeeded_t;
 typedef struct _mongoc_apm_command_failed_t mongoc_apm_command_failed_t;
 
+/* phases of a command whose duration is reported on succeeded/failed events */
+typedef enum {
+   MONGOC_APM_COMMAND_PHASE_SERVER_SELECTION,
+   MONGOC_APM_COMMAND_PHASE_STREAM_CHECKOUT,
+   MONGOC_APM_COMMAND_PHASE_ASSEMBLE,
+   MONGOC_APM_COMMAND_PHASE_COMPRESS,
+   MONGOC_APM_COMMAND_PHASE_WRITE,
+   MONGOC_APM_COMMAND_PHASE_WAIT_FIRST_BYTE,
+   MONGOC_APM_COMMAND_PHASE_READ_BODY,
+   MONGOC_APM_COMMAND_PHASE_DECOMPRESS,
+   MONGOC_APM_COMMAND_PHASE_PARSE_REPLY,
+} mongoc_apm_command_phase_t;
+
 
 /*
  * SDAM monitoring events
@@ -113,6 +126,10 @@ mongoc_apm_command_started_get_context(const mongoc_apm_command_started_t *event
 MONGOC_EXPORT(int64_t)
 mongoc_apm_command_succeeded_get_duration(const mongoc_apm_command_succeeded_t *event);
 
+MONGOC_EXPORT(int64_t)
+mongoc_apm_command_succeeded_get_phase_duration(const mongoc_apm_command_succeeded_t *event,
+                                                mongoc_apm_command_phase_t phase);
+
 MONGOC_EXPORT(const bson_t *)
 mongoc_apm_command_succeeded_get_reply(const mongoc_apm_command_succeeded_t *event);
 
@@ -149,6 +166,10 @@ mongoc_apm_command_succeeded_get_context(const mongoc_apm_command_succeeded_t *e
 MONGOC_EXPORT(int64_t)
 mongoc_apm_command_failed_get_duration(const mongoc_apm_command_failed_t *event);
 
+MONGOC_EXPORT(int64_t)
+mongoc_apm_command_failed_get_phase_duration(const mongoc_apm_command_failed_t *event,
+                                             mongoc_apm_command_phase_t phase);
+
 MONGOC_EXPORT(const char *)
 mongoc_apm_command_failed_get_command_name(const mongoc_apm_command_failed_t *event);
 
@@ -17,6 +17,7 @@
 
 #include <mongoc/mongoc-bulk-operation.h>
 
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-bulk-operation-private.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-error-private.h>
@@ -691,10 +692,8 @@ mongoc_bulk_operation_replace_one(mongoc_bulk_operation_t *bulk,
    EXIT;
 }
 
-uint32_t
-mongoc_bulk_operation_execute(mongoc_bulk_operation_t *bulk, /* IN */
-                              bson_t *reply,                 /* OUT */
-                              bson_error_t *error)           /* OUT */
+static uint32_t
+_mongoc_bulk_operation_execute(mongoc_bulk_operation_t *bulk, bson_t *reply, bson_error_t *error)
 {
    mongoc_cluster_t *cluster;
    mongoc_write_command_t *command;
@@ -814,6 +813,18 @@ err:
    RETURN(false);
 }
 
+uint32_t
+mongoc_bulk_operation_execute(mongoc_bulk_operation_t *bulk, /* IN */
+                              bson_t *reply,                 /* OUT */
+                              bson_error_t *error)           /* OUT */
+{
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_BULK);
+   const uint32_t ret = _mongoc_bulk_operation_execute(bulk, reply, error);
+   _mongoc_alloc_tag_pop(alloc_tag);
+
+   return ret;
+}
+
 void
 mongoc_bulk_operation_set_write_concern(mongoc_bulk_operation_t *bulk, const mongoc_write_concern_t *write_concern)
 {
@@ -17,12 +17,15 @@
 #include <mongoc/mongoc-bulkwrite.h>
 
 #include <common-macros-private.h> // MC_ENABLE_CONVERSION_WARNING_BEGIN
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-array-private.h>
 #include <mongoc/mongoc-buffer-private.h>
+#include <mongoc/mongoc-client-pool.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-client-side-encryption-private.h>
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-server-stream-private.h>
+#include <mongoc/mongoc-thread-private.h>
 #include <mongoc/mongoc-util-private.h> // _mongoc_iter_document_as_bson
 
 #include <mongoc/mcd-nsinfo.h>
@@ -44,6 +47,7 @@ struct _mongoc_bulkwriteopts_t {
    bson_value_t comment;
    bson_t *extra;
    uint32_t serverid;
+   uint32_t maxparallelbatches;
 };
 
 // `set_bson_opt` sets `*dst` by copying `src`. If `src` is NULL, `dst` is cleared.
@@ -128,6 +132,12 @@ mongoc_bulkwriteopts_set_serverid(mongoc_bulkwriteopts_t *self, uint32_t serveri
    self->serverid = serverid;
 }
 void
+mongoc_bulkwriteopts_set_maxparallelbatches(mongoc_bulkwriteopts_t *self, uint32_t maxparallelbatches)
+{
+   BSON_ASSERT_PARAM(self);
+   self->maxparallelbatches = maxparallelbatches;
+}
+void
 mongoc_bulkwriteopts_destroy(mongoc_bulkwriteopts_t *self)
 {
    if (!self) {
@@ -1527,8 +1537,533 @@ mongoc_bulkwrite_set_session(mongoc_bulkwrite_t *self, mongoc_client_session_t *
    self->session = session;
 }
 
-mongoc_bulkwritereturn_t
-mongoc_bulkwrite_execute(mongoc_bulkwrite_t *self, const mongoc_bulkwriteopts_t *opts)
+// `bulkwrite_limits_t` holds the server limits used to split the `ops` document sequence into batches.
+typedef struct {
+   int32_t maxWriteBatchSize;
+   int32_t maxMessageSizeBytes;
+   // `opmsg_overhead` is the size reserved for OP_MSG and the `bulkWrite` command. See bulk write specification.
+   size_t opmsg_overhead;
+} bulkwrite_limits_t;
+
+// `bulkwrite_batch_t` is a contiguous range of the `ops` document sequence sent in one `bulkWrite` command.
+typedef struct {
+   // `ops_doc_offset` is the index of the first model in the batch.
+   size_t ops_doc_offset;
+   // `ops_doc_len` is the number of documents from `ops` to send in this batch.
+   size_t ops_doc_len;
+   // `ops_byte_offset` is the offset into `ops` of the first document in the batch.
+   size_t ops_byte_offset;
+   // `ops_byte_len` is the number of bytes from `ops` to send in this batch.
+   size_t ops_byte_len;
+   // `nsinfo` tracks the nsInfo entries to include in this batch.
+   mcd_nsinfo_t *nsinfo;
+} bulkwrite_batch_t;
+
+// `_bulkwrite_next_batch` reads as many documents from `ops` as fit in one `bulkWrite` command, starting at the given
+// offsets. On success, `batch->nsinfo` must be freed with `mcd_nsinfo_destroy`.
+static bool
+_bulkwrite_next_batch(mongoc_bulkwrite_t *self,
+                      const bulkwrite_limits_t *limits,
+                      size_t ops_doc_offset,
+                      size_t ops_byte_offset,
+                      bulkwrite_batch_t *batch,
+                      bson_error_t *error)
+{
+   BSON_ASSERT_PARAM(self);
+   BSON_ASSERT_PARAM(limits);
+   BSON_ASSERT_PARAM(batch);
+
+   *batch = (bulkwrite_batch_t){
+      .ops_doc_offset = ops_doc_offset, .ops_byte_offset = ops_byte_offset, .nsinfo = mcd_nsinfo_new()};
+
+   while (true) {
+      if (ops_byte_offset + batch->ops_byte_len >= self->ops.len) {
+         // All remaining ops are readied.
+         break;
+      }
+
+      if (mlib_cmp(batch->ops_doc_len, >=, limits->maxWriteBatchSize)) {
+         // Maximum number of operations are readied.
+         break;
+      }
+
+      // Read length of next document.
+      const uint32_t doc_len = mlib_read_u32le(self->ops.data + ops_byte_offset + batch->ops_byte_len);
+
+      // Check if adding this operation requires adding an `nsInfo` entry.
+      // `models_idx` is the index of the model that produced this result.
+      size_t models_idx = batch->ops_doc_len + ops_doc_offset;
+      modeldata_t *md = &_mongoc_array_index(&self->arrayof_modeldata, modeldata_t, models_idx);
+      uint32_t nsinfo_bson_size = 0;
+      int32_t ns_index = mcd_nsinfo_find(batch->nsinfo, md->ns);
+      if (ns_index == -1) {
+         // Need to append `nsInfo` entry. Append after checking that both the document and the `nsInfo` entry fit.
+         nsinfo_bson_size = mcd_nsinfo_get_bson_size(md->ns);
+      }
+
+      if (mlib_cmp(limits->opmsg_overhead + batch->ops_byte_len + doc_len + nsinfo_bson_size,
+                   >,
+                   limits->maxMessageSizeBytes)) {
+         if (batch->ops_byte_len == 0) {
+            // Could not even fit one document within an OP_MSG.
+            _mongoc_set_error(error,
+                              MONGOC_ERROR_COMMAND,
+                              MONGOC_ERROR_COMMAND_INVALID_ARG,
+                              "unable to send document at index %zu. Sending "
+                              "would exceed maxMessageSizeBytes=%" PRId32,
+                              batch->ops_doc_len,
+                              limits->maxMessageSizeBytes);
+            goto fail;
+         }
+         break;
+      }
+
+      // Check if a new `nsInfo` entry is needed.
+      if (ns_index == -1) {
+         ns_index = mcd_nsinfo_append(batch->nsinfo, md->ns, error);
+         if (ns_index == -1) {
+            goto fail;
+         }
+      }
+
+      // Overwrite the placeholder to the index of the `nsInfo` entry.
+      {
+         bson_iter_t nsinfo_iter;
+         bson_t doc;
+         BSON_ASSERT(bson_init_static(&doc, self->ops.data + ops_byte_offset + batch->ops_byte_len, doc_len));
+         // Find the index.
+         BSON_ASSERT(bson_iter_init(&nsinfo_iter, &doc));
+         BSON_ASSERT(bson_iter_next(&nsinfo_iter));
+         bson_iter_overwrite_int32(&nsinfo_iter, ns_index);
+      }
+
+      // Include document.
+      {
+         batch->ops_byte_len += doc_len;
+         batch->ops_doc_len += 1;
+      }
+   }
+
+   return true;
+
+fail:
+   mcd_nsinfo_destroy(batch->nsinfo);
+   batch->nsinfo = NULL;
+   return false;
+}
+
+// `_bulkwrite_run_batch` sends one batch with `client` and applies the reply to `ret`. `*ss` is replaced if a new
+// stream is selected. Returns false if a top-level error is set on `ret->exc`.
+static bool
+_bulkwrite_run_batch(mongoc_bulkwrite_t *self,
+                     mongoc_client_t *client,
+                     mongoc_cmd_parts_t *parts,
+                     mongoc_server_stream_t **ss,
+                     const mongoc_ss_log_context_t *ss_log_context,
+                     const bulkwrite_batch_t *batch,
+                     mongoc_bulkwritereturn_t *ret)
+{
+   BSON_ASSERT_PARAM(self);
+   BSON_ASSERT_PARAM(client);
+   BSON_ASSERT_PARAM(parts);
+   BSON_ASSERT_PARAM(ss);
+   BSON_ASSERT_PARAM(ss_log_context);
+   BSON_ASSERT_PARAM(batch);
+   BSON_ASSERT_PARAM(ret);
+
+   bool ok = false;
+   bson_error_t error = {0};
+   bson_t cmd_reply = BSON_INITIALIZER;
+   mongoc_cursor_t *reply_cursor = NULL;
+
+   parts->assembled.payloads_count = 2;
+
+   // Create the `nsInfo` payload.
+   {
+      mongoc_cmd_payload_t *payload = &parts->assembled.payloads[0];
+      const mongoc_buffer_t *nsinfo_docseq = mcd_nsinfo_as_document_sequence(batch->nsinfo);
+      payload->documents = nsinfo_docseq->data;
+      BSON_ASSERT(mlib_in_range(int32_t, nsinfo_docseq->len));
+      payload->size = (int32_t)nsinfo_docseq->len;
+      payload->identifier = "nsInfo";
+   }
+
+   // Create the `ops` payload.
+   {
+      mongoc_cmd_payload_t *payload = &parts->assembled.payloads[1];
+      payload->identifier = "ops";
+      payload->documents = self->ops.data + batch->ops_byte_offset;
+      BSON_ASSERT(mlib_in_range(int32_t, batch->ops_byte_len));
+      payload->size = (int32_t)batch->ops_byte_len;
+   }
+
+   // Check if stream is valid. A previous call to `mongoc_cluster_run_retryable_write` may have invalidated
+   // stream (e.g. due to processing an error). If invalid, select a new stream before processing more batches.
+   if (!mongoc_cluster_stream_valid(&client->cluster, parts->assembled.server_stream)) {
+      bson_t reply;
+      // Select a server and create a stream again.
+      mongoc_server_stream_cleanup(*ss);
+      *ss = mongoc_cluster_stream_for_writes(&client->cluster,
+                                             ss_log_context,
+                                             NULL /* session */,
+                                             NULL /* deprioritized servers */,
+                                             &reply,
+                                             &error);
+
+      if (*ss) {
+         parts->assembled.server_stream = *ss;
+      } else {
+         _bulkwriteexception_set_error(ret->exc, &error);
+         _bulkwriteexception_set_error_reply(ret->exc, &reply);
+         bson_destroy(&reply);
+         goto fail;
+      }
+   }
+
+   // Send command.
+   {
+      mongoc_server_stream_t *new_ss = NULL;
+      bool cmd_ok = mongoc_cluster_run_retryable_write(
+         &client->cluster, &parts->assembled, parts->is_retryable_write, &new_ss, &cmd_reply, &error);
+      if (new_ss) {
+         // A retry occurred. Save the newly created stream to use for subsequent commands.
+         mongoc_server_stream_cleanup(*ss);
+         *ss = new_ss;
+         parts->assembled.server_stream = *ss;
+      }
+
+      // Check for a command ('ok': 0) error.
+      if (!cmd_ok) {
+         if (error.code != 0) {
+            // The original error was a command ('ok': 0) error.
+            _bulkwriteexception_set_error(ret->exc, &error);
+         }
+         _bulkwriteexception_set_error_reply(ret->exc, &cmd_reply);
+         goto fail;
+      }
+   }
+
+   // Add to result and/or exception.
+   if (mongoc_optional_value(&self->is_acknowledged)) {
+      // Parse top-level fields.
+      if (!_bulkwritereturn_apply_reply(ret, &cmd_reply)) {
+         goto fail;
+      }
+
+      // Construct reply cursor and read individual results.
+      {
+         bson_t cursor_opts = BSON_INITIALIZER;
+         {
+            uint32_t serverid = parts->assembled.server_stream->sd->id;
+            BSON_ASSERT(mlib_in_range(int32_t, serverid));
+            int32_t serverid_i32 = (int32_t)serverid;
+            BSON_ASSERT(BSON_APPEND_INT32(&cursor_opts, "serverId", serverid_i32));
+            // Use same session if one was applied.
+            if (parts->assembled.session &&
+                !mongoc_client_session_append(parts->assembled.session, &cursor_opts, &error)) {
+               _bulkwriteexception_set_error(ret->exc, &error);
+               _bulkwriteexception_set_error_reply(ret->exc, &cmd_reply);
+               bson_destroy(&cursor_opts);
+               goto fail;
+            }
+         }
+
+         // Construct the reply cursor.
+         reply_cursor = mongoc_cursor_new_from_command_reply_with_opts(client, &cmd_reply, &cursor_opts);
+         bson_destroy(&cursor_opts);
+         // `cmd_reply` is stolen. Clear it.
+         bson_init(&cmd_reply);
+
+         // Ensure constructing cursor did not error.
+         {
+            const bson_t *error_document;
+            if (mongoc_cursor_error_document(reply_cursor, &error, &error_document)) {
+               _bulkwriteexception_set_error(ret->exc, &error);
+               if (error_document) {
+                  _bulkwriteexception_set_error_reply(ret->exc, error_document);
+               }
+               goto fail;
+            }
+         }
+
+         // Iterate over cursor results.
+         const bson_t *result;
+         while (mongoc_cursor_next(reply_cursor, &result)) {
+            if (!_bulkwritereturn_apply_result(
+                   ret, result, batch->ops_doc_offset, &self->arrayof_modeldata, &self->ops)) {
+               goto fail;
+            }
+         }
+         // Ensure iterating cursor did not error.
+         {
+            const bson_t *error_document;
+            if (mongoc_cursor_error_document(reply_cursor, &error, &error_document)) {
+               _bulkwriteexception_set_error(ret->exc, &error);
+               if (error_document) {
+                  _bulkwriteexception_set_error_reply(ret->exc, error_document);
+               }
+               goto fail;
+            }
+         }
+      }
+   }
+
+   ok = true;
+fail:
+   mongoc_cursor_destroy(reply_cursor);
+   bson_destroy(&cmd_reply);
+   return ok;
+}
+
+// `_bulkwritereturn_merge` appends the results and errors of a later batch in `src` to `dst`.
+static void
+_bulkwritereturn_merge(mongoc_bulkwritereturn_t *dst, const mongoc_bulkwritereturn_t *src)
+{
+   BSON_ASSERT_PARAM(dst);
+   BSON_ASSERT_PARAM(src);
+
+   mongoc_bulkwriteresult_t *const dres = dst->res;
+   const mongoc_bulkwriteresult_t *const sres = src->res;
+
+   dres->insertedcount += sres->insertedcount;
+   dres->upsertedcount += sres->upsertedcount;
+   dres->matchedcount += sres->matchedcount;
+   dres->modifiedcount += sres->modifiedcount;
+   dres->deletedcount += sres->deletedcount;
+   dres->errorscount += sres->errorscount;
+   if (!dres->first_error_index.isset && sres->first_error_index.isset) {
+      dres->first_error_index = sres->first_error_index;
+   }
+   dres->parsed_some_results = dres->parsed_some_results || sres->parsed_some_results;
+   // Batches are merged in order, so verbose results remain sorted by model index.
+   BSON_ASSERT(bson_concat(&dres->insertresults, &sres->insertresults));
+   BSON_ASSERT(bson_concat(&dres->updateresults, &sres->updateresults));
+   BSON_ASSERT(bson_concat(&dres->deleteresults, &sres->deleteresults));
+
+   mongoc_bulkwriteexception_t *const dexc = dst->exc;
+   const mongoc_bulkwriteexception_t *const sexc = src->exc;
+
+   if (!sexc->has_any_error) {
+      return;
+   }
+
+   // Report the top-level error of the first failed batch.
+   const bool dst_has_toplevel_error = dexc->error.code != 0 || !bson_empty(&dexc->error_reply);
+   if (!dst_has_toplevel_error) {
+      if (sexc->error.code != 0) {
+         memcpy(&dexc->error, &sexc->error, sizeof(dexc->error));
+      }
+      if (!bson_empty(&sexc->error_reply)) {
+         bson_destroy(&dexc->error_reply);
+         bson_copy_to(&sexc->error_reply, &dexc->error_reply);
+      }
+   }
+
+   BSON_ASSERT(bson_concat(&dexc->write_errors, &sexc->write_errors));
+
+   // Renumber write concern errors to keep `write_concern_errors` a BSON array.
+   bson_iter_t wce_iter;
+   BSON_ASSERT(bson_iter_init(&wce_iter, &sexc->write_concern_errors));
+   while (bson_iter_next(&wce_iter)) {
+      char *key = bson_strdup_printf("%zu", dexc->write_concern_errors_len);
+      dexc->write_concern_errors_len++;
+      BSON_ASSERT(BSON_APPEND_ITER(&dexc->write_concern_errors, key, &wce_iter));
+      bson_free(key);
+   }
+
+   dexc->has_any_error = true;
+}
+
+// `bulkwrite_parallel_t` is shared by the threads executing an unordered bulk write with multiple pooled clients.
+typedef struct {
+   mongoc_bulkwrite_t *bw;
+   // `cmd` is the unassembled `bulkWrite` command. Each client assembles it with its own implicit session.
+   const bson_t *cmd;
+   const mongoc_write_concern_t *wc;
+   const mongoc_ss_log_context_t *ss_log_context;
+   bulkwrite_limits_t limits;
+   bool verboseresults;
+   uint32_t serverid;
+
+   bson_mutex_t mutex;
+   // `ops_doc_offset` and `ops_byte_offset` locate the next batch to claim. Guarded by `mutex`.
+   size_t ops_doc_offset;
+   size_t ops_byte_offset;
+   // `batch_returns` is an array of `mongoc_bulkwritereturn_t` in batch order. Guarded by `mutex`.
+   mongoc_array_t batch_returns;
+   // `stopped` is set after a top-level error to stop sending more batches. Guarded by `mutex`.
+   bool stopped;
+} bulkwrite_parallel_t;
+
+typedef struct {
+   bulkwrite_parallel_t *shared;
+   mongoc_client_t *client;
+   bson_thread_t thread;
+} bulkwrite_worker_t;
+
+// `_bulkwrite_parallel_run` claims and sends batches until all models are sent or a top-level error occurs.
+static void
+_bulkwrite_parallel_run(bulkwrite_parallel_t *shared,
+                        mongoc_client_t *client,
+                        mongoc_cmd_parts_t *parts,
+                        mongoc_server_stream_t **ss)
+{
+   BSON_ASSERT_PARAM(shared);
+   BSON_ASSERT_PARAM(client);
+   BSON_ASSERT_PARAM(parts);
+   BSON_ASSERT_PARAM(ss);
+
+   mongoc_bulkwrite_t *const bw = shared->bw;
+
+   while (true) {
+      bulkwrite_batch_t batch;
+      bson_error_t error;
+      bool claimed;
+      mongoc_bulkwritereturn_t batch_ret;
+
+      bson_mutex_lock(&shared->mutex);
+      if (shared->stopped || shared->ops_byte_offset == bw->ops.len) {
+         bson_mutex_unlock(&shared->mutex);
+         break;
+      }
+      batch_ret.res = _bulkwriteresult_new();
+      batch_ret.res->verboseresults = shared->verboseresults;
+      batch_ret.exc = _bulkwriteexception_new();
+      // Reading the batch overwrites `nsInfo` indexes within the claimed range of `ops`. Hold the lock.
+      claimed =
+         _bulkwrite_next_batch(bw, &shared->limits, shared->ops_doc_offset, shared->ops_byte_offset, &batch, &error);
+      if (claimed) {
+         shared->ops_doc_offset += batch.ops_doc_len;
+         shared->ops_byte_offset += batch.ops_byte_len;
+      } else {
+         _bulkwriteexception_set_error(batch_ret.exc, &error);
+         shared->stopped = true;
+      }
+      _mongoc_array_append_val(&shared->batch_returns, batch_ret);
+      bson_mutex_unlock(&shared->mutex);
+
+      if (!claimed) {
+         break;
+      }
+
+      const bool batch_ok = _bulkwrite_run_batch(bw, client, parts, ss, shared->ss_log_context, &batch, &batch_ret);
+      mcd_nsinfo_destroy(batch.nsinfo);
+
+      if (!batch_ok) {
+         bson_mutex_lock(&shared->mutex);
+         shared->stopped = true;
+         bson_mutex_unlock(&shared->mutex);
+         break;
+      }
+   }
+}
+
+static BSON_THREAD_FUN(_bulkwrite_worker_thread, worker_void)
+{
+   bulkwrite_worker_t *const worker = worker_void;
+   bulkwrite_parallel_t *const shared = worker->shared;
+   mongoc_bulkwrite_t *const bw = shared->bw;
+   mongoc_client_t *const client = worker->client;
+   mongoc_server_stream_t *ss = NULL;
+   mongoc_cmd_parts_t parts;
+   bson_error_t error;
+
+   // Workers only run bulk writes, so attribute everything they allocate to them.
+   _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_BULK);
+
+   if (shared->serverid) {
+      ss = mongoc_cluster_stream_for_server(
+         &client->cluster, shared->serverid, true /* reconnect_ok */, NULL /* session */, NULL /* reply */, &error);
+   } else {
+      ss = mongoc_cluster_stream_for_writes(
+         &client->cluster, shared->ss_log_context, NULL /* session */, NULL /* deprioritized servers */, NULL, &error);
+   }
+
+   if (!ss) {
+      // Leave the remaining batches to the other clients.
+      BSON_THREAD_RETURN;
+   }
+
+   mongoc_cmd_parts_init(&parts, client, "admin", MONGOC_QUERY_NONE, shared->cmd);
+   parts.assembled.operation_id = bw->operation_id;
+   parts.allow_txn_number =
+      bw->has_multi_write ? MONGOC_CMD_PARTS_ALLOW_TXN_NUMBER_NO : MONGOC_CMD_PARTS_ALLOW_TXN_NUMBER_YES;
+   parts.is_write_command = true;
+
+   if (mongoc_cmd_parts_set_write_concern(&parts, shared->wc, &error) &&
+       mongoc_cmd_parts_assemble(&parts, ss, &error)) {
+      _bulkwrite_parallel_run(shared, client, &parts, &ss);
+   }
+
+   mongoc_cmd_parts_cleanup(&parts);
+   mongoc_server_stream_cleanup(ss);
+   BSON_THREAD_RETURN;
+}
+
+// `_bulkwrite_execute_parallel` sends batches concurrently with `client` and additional clients taken from the pool
+// `client` was popped from. Results of each batch are merged into `ret` in batch order.
+static void
+_bulkwrite_execute_parallel(bulkwrite_parallel_t *shared,
+                            uint32_t maxparallelbatches,
+                            mongoc_client_t *client,
+                            mongoc_cmd_parts_t *parts,
+                            mongoc_server_stream_t **ss,
+                            mongoc_bulkwritereturn_t *ret)
+{
+   BSON_ASSERT_PARAM(shared);
+   BSON_ASSERT_PARAM(client);
+   BSON_ASSERT_PARAM(client->pool);
+   BSON_ASSERT_PARAM(parts);
+   BSON_ASSERT_PARAM(ss);
+   BSON_ASSERT_PARAM(ret);
+
+   mongoc_array_t workers;
+   _mongoc_array_init(&workers, sizeof(bulkwrite_worker_t *));
+
+   bson_mutex_init(&shared->mutex);
+   _mongoc_array_init(&shared->batch_returns, sizeof(mongoc_bulkwritereturn_t));
+
+   // Start one thread per additional client. Do not block waiting for a client: use as many as are available.
+   for (uint32_t i = 1; i < maxparallelbatches; i++) {
+      mongoc_client_t *worker_client = mongoc_client_pool_try_pop(client->pool);
+      if (!worker_client) {
+         break;
+      }
+
+      bulkwrite_worker_t *worker = bson_malloc0(sizeof(*worker));
+      worker->shared = shared;
+      worker->client = worker_client;
+      if (0 != mcommon_thread_create(&worker->thread, _bulkwrite_worker_thread, worker)) {
+         mongoc_client_pool_push(client->pool, worker_client);
+         bson_free(worker);
+         break;
+      }
+      _mongoc_array_append_val(&workers, worker);
+   }
+
+   // The calling thread sends batches too.
+   _bulkwrite_parallel_run(shared, client, parts, ss);
+
+   for (size_t i = 0; i < workers.len; i++) {
+      bulkwrite_worker_t *worker = _mongoc_array_index(&workers, bulkwrite_worker_t *, i);
+      mcommon_thread_join(worker->thread);
+      mongoc_client_pool_push(client->pool, worker->client);
+      bson_free(worker);
+   }
+   _mongoc_array_destroy(&workers);
+
+   for (size_t i = 0; i < shared->batch_returns.len; i++) {
+      mongoc_bulkwritereturn_t batch_ret = _mongoc_array_index(&shared->batch_returns, mongoc_bulkwritereturn_t, i);
+      _bulkwritereturn_merge(ret, &batch_ret);
+      mongoc_bulkwriteresult_destroy(batch_ret.res);
+      mongoc_bulkwriteexception_destroy(batch_ret.exc);
+   }
+   _mongoc_array_destroy(&shared->batch_returns);
+   bson_mutex_destroy(&shared->mutex);
+}
+
+static mongoc_bulkwritereturn_t
+_mongoc_bulkwrite_execute(mongoc_bulkwrite_t *self, const mongoc_bulkwriteopts_t *opts)
 {
    BSON_ASSERT_PARAM(self);
    BSON_OPTIONAL_PARAM(opts);
@@ -1541,6 +2076,7 @@ mongoc_bulkwrite_execute(mongoc_bulkwrite_t *self, const mongoc_bulkwriteopts_t
    bson_t cmd = BSON_INITIALIZER;
    mongoc_cmd_parts_t parts = {{0}};
    mongoc_bulkwriteopts_t defaults = {{0}};
+   const mongoc_write_concern_t *wc = NULL;
 
    if (!opts) {
       opts = &defaults;
@@ -1644,7 +2180,7 @@ mongoc_bulkwrite_execute(mongoc_bulkwrite_t *self, const mongoc_bulkwriteopts_t
 
       // Apply write concern:
       {
-         const mongoc_write_concern_t *wc = self->client->write_concern; // Default to client.
+         wc = self->client->write_concern; // Default to client.
          if (opts->writeconcern) {
             if (_mongoc_client_session_in_txn(self->session)) {
                _mongoc_set_error(&error,
@@ -1698,258 +2234,58 @@ mongoc_bulkwrite_execute(mongoc_bulkwrite_t *self, const mongoc_bulkwriteopts_t
       }
    }
 
-   const int32_t maxWriteBatchSize = mongoc_server_stream_max_write_batch_size(ss);
-   int32_t maxMessageSizeBytes = mongoc_server_stream_max_msg_size(ss);
+   bulkwrite_limits_t limits = {.maxWriteBatchSize = mongoc_server_stream_max_write_batch_size(ss),
+                                .maxMessageSizeBytes = mongoc_server_stream_max_msg_size(ss)};
    if (_mongoc_cse_is_enabled(self->client)) {
-      maxMessageSizeBytes = MONGOC_REDUCED_MAX_MSG_SIZE_FOR_FLE;
+      limits.maxMessageSizeBytes = MONGOC_REDUCED_MAX_MSG_SIZE_FOR_FLE;
    }
-   // `ops_doc_offset` is an offset into the `ops` document sequence. Counts the number of documents sent.
-   size_t ops_doc_offset = 0;
-   // `ops_byte_offset` is an offset into the `ops` document sequence. Counts the number of bytes sent.
-   size_t ops_byte_offset = 0;
    // Calculate overhead of OP_MSG and the `bulkWrite` command. See bulk write specification for explanation.
-   size_t opmsg_overhead = 0;
    {
-      opmsg_overhead += 1000;
+      limits.opmsg_overhead += 1000;
       // Add size of `bulkWrite` command. Exclude command-agnostic fields added in `mongoc_cmd_parts_assemble` (e.g.
       // `txnNumber` and `lsid`).
-      opmsg_overhead += cmd.len;
+      limits.opmsg_overhead += cmd.len;
+   }
+
+   // Batches of an unordered bulk write are independent. If requested, send them concurrently with other clients from
+   // the pool. Each client uses its own implicit session, so this is not done with an explicit session.
+   if (opts->maxparallelbatches > 1 && !is_ordered && mongoc_optional_value(&self->is_acknowledged) &&
+       self->client->pool && !self->session && !_mongoc_cse_is_enabled(self->client)) {
+      bulkwrite_parallel_t shared = {.bw = self,
+                                     .cmd = &cmd,
+                                     .wc = wc,
+                                     .ss_log_context = &ss_log_context,
+                                     .limits = limits,
+                                     .verboseresults = verboseresults,
+                                     .serverid = opts->serverid};
+      _bulkwrite_execute_parallel(&shared, opts->maxparallelbatches, self->client, &parts, &ss, &ret);
+      goto fail;
    }
 
-   // Send one or more `bulkWrite` commands. Split input payload if necessary to satisfy server size limits.
-   while (true) {
-      bool has_write_errors = false;
-      bool batch_ok = false;
-      bson_t cmd_reply = BSON_INITIALIZER;
-      mongoc_cursor_t *reply_cursor = NULL;
-      // `ops_byte_len` is the number of bytes from `ops` to send in this batch.
-      size_t ops_byte_len = 0;
-      // `ops_doc_len` is the number of documents from `ops` to send in this batch.
-      size_t ops_doc_len = 0;
-
-      if (ops_byte_offset == self->ops.len) {
-         // All write models were sent.
-         break;
-      }
-
-      // Track the nsInfo entries to include in this batch.
-      mcd_nsinfo_t *nsinfo = mcd_nsinfo_new();
-
-      // Read as many documents from payload as possible.
-      while (true) {
-         if (ops_byte_offset + ops_byte_len >= self->ops.len) {
-            // All remaining ops are readied.
-            break;
-         }
-
-         if (mlib_cmp(ops_doc_len, >=, maxWriteBatchSize)) {
-            // Maximum number of operations are readied.
-            break;
-         }
-
-         // Read length of next document.
-         const uint32_t doc_len = mlib_read_u32le(self->ops.data + ops_byte_offset + ops_byte_len);
-
-         // Check if adding this operation requires adding an `nsInfo` entry.
-         // `models_idx` is the index of the model that produced this result.
-         size_t models_idx = ops_doc_len + ops_doc_offset;
-         modeldata_t *md = &_mongoc_array_index(&self->arrayof_modeldata, modeldata_t, models_idx);
-         uint32_t nsinfo_bson_size = 0;
-         int32_t ns_index = mcd_nsinfo_find(nsinfo, md->ns);
-         if (ns_index == -1) {
-            // Need to append `nsInfo` entry. Append after checking that both the document and the `nsInfo` entry fit.
-            nsinfo_bson_size = mcd_nsinfo_get_bson_size(md->ns);
-         }
-
-         if (mlib_cmp(opmsg_overhead + ops_byte_len + doc_len + nsinfo_bson_size, >, maxMessageSizeBytes)) {
-            if (ops_byte_len == 0) {
-               // Could not even fit one document within an OP_MSG.
-               _mongoc_set_error(&error,
-                                 MONGOC_ERROR_COMMAND,
-                                 MONGOC_ERROR_COMMAND_INVALID_ARG,
-                                 "unable to send document at index %zu. Sending "
-                                 "would exceed maxMessageSizeBytes=%" PRId32,
-                                 ops_doc_len,
-                                 maxMessageSizeBytes);
-               _bulkwriteexception_set_error(ret.exc, &error);
-               goto batch_fail;
-            }
-            break;
-         }
-
-         // Check if a new `nsInfo` entry is needed.
-         if (ns_index == -1) {
-            ns_index = mcd_nsinfo_append(nsinfo, md->ns, &error);
-            if (ns_index == -1) {
-               _bulkwriteexception_set_error(ret.exc, &error);
-               goto batch_fail;
-            }
-         }
-
-         // Overwrite the placeholder to the index of the `nsInfo` entry.
-         {
-            bson_iter_t nsinfo_iter;
-            bson_t doc;
-            BSON_ASSERT(bson_init_static(&doc, self->ops.data + ops_byte_offset + ops_byte_len, doc_len));
-            // Find the index.
-            BSON_ASSERT(bson_iter_init(&nsinfo_iter, &doc));
-            BSON_ASSERT(bson_iter_next(&nsinfo_iter));
-            bson_iter_overwrite_int32(&nsinfo_iter, ns_index);
-         }
-
-         // Include document.
-         {
-            ops_byte_len += doc_len;
-            ops_doc_len += 1;
-         }
-      }
-
-      // Send batch.
-      {
-         parts.assembled.payloads_count = 2;
-
-         // Create the `nsInfo` payload.
-         {
-            mongoc_cmd_payload_t *payload = &parts.assembled.payloads[0];
-            const mongoc_buffer_t *nsinfo_docseq = mcd_nsinfo_as_document_sequence(nsinfo);
-            payload->documents = nsinfo_docseq->data;
-            BSON_ASSERT(mlib_in_range(int32_t, nsinfo_docseq->len));
-            payload->size = (int32_t)nsinfo_docseq->len;
-            payload->identifier = "nsInfo";
-         }
-
-         // Create the `ops` payload.
-         {
-            mongoc_cmd_payload_t *payload = &parts.assembled.payloads[1];
-            payload->identifier = "ops";
-            payload->documents = self->ops.data + ops_byte_offset;
-            BSON_ASSERT(mlib_in_range(int32_t, ops_byte_len));
-            payload->size = (int32_t)ops_byte_len;
-         }
-
-         // Check if stream is valid. A previous call to `mongoc_cluster_run_retryable_write` may have invalidated
-         // stream (e.g. due to processing an error). If invalid, select a new stream before processing more batches.
-         if (!mongoc_cluster_stream_valid(&self->client->cluster, parts.assembled.server_stream)) {
-            bson_t reply;
-            // Select a server and create a stream again.
-            mongoc_server_stream_cleanup(ss);
-            ss = mongoc_cluster_stream_for_writes(&self->client->cluster,
-                                                  &ss_log_context,
-                                                  NULL /* session */,
-                                                  NULL /* deprioritized servers */,
-                                                  &reply,
-                                                  &error);
-
-            if (ss) {
-               parts.assembled.server_stream = ss;
-            } else {
-               _bulkwriteexception_set_error(ret.exc, &error);
-               _bulkwriteexception_set_error_reply(ret.exc, &reply);
-               bson_destroy(&reply);
-               goto batch_fail;
-            }
-         }
-
-         // Send command.
-         {
-            mongoc_server_stream_t *new_ss = NULL;
-            bool ok = mongoc_cluster_run_retryable_write(
-               &self->client->cluster, &parts.assembled, parts.is_retryable_write, &new_ss, &cmd_reply, &error);
-            if (new_ss) {
-               // A retry occurred. Save the newly created stream to use for subsequent commands.
-               mongoc_server_stream_cleanup(ss);
-               ss = new_ss;
-               parts.assembled.server_stream = ss;
-            }
-
-            // Check for a command ('ok': 0) error.
-            if (!ok) {
-               if (error.code != 0) {
-                  // The original error was a command ('ok': 0) error.
-                  _bulkwriteexception_set_error(ret.exc, &error);
-               }
-               _bulkwriteexception_set_error_reply(ret.exc, &cmd_reply);
-               goto batch_fail;
-            }
-         }
-
-         // Add to result and/or exception.
-         if (mongoc_optional_value(&self->is_acknowledged)) {
-            // Parse top-level fields.
-            if (!_bulkwritereturn_apply_reply(&ret, &cmd_reply)) {
-               goto batch_fail;
-            }
-
-            // Construct reply cursor and read individual results.
-            {
-               bson_t cursor_opts = BSON_INITIALIZER;
-               {
-                  uint32_t serverid = parts.assembled.server_stream->sd->id;
-                  BSON_ASSERT(mlib_in_range(int32_t, serverid));
-                  int32_t serverid_i32 = (int32_t)serverid;
-                  BSON_ASSERT(BSON_APPEND_INT32(&cursor_opts, "serverId", serverid_i32));
-                  // Use same session if one was applied.
-                  if (parts.assembled.session &&
-                      !mongoc_client_session_append(parts.assembled.session, &cursor_opts, &error)) {
-                     _bulkwriteexception_set_error(ret.exc, &error);
-                     _bulkwriteexception_set_error_reply(ret.exc, &cmd_reply);
-                     goto batch_fail;
-                  }
-               }
+   // `ops_doc_offset` is an offset into the `ops` document sequence. Counts the number of documents sent.
+   size_t ops_doc_offset = 0;
+   // `ops_byte_offset` is an offset into the `ops` document sequence. Counts the number of bytes sent.
+   size_t ops_byte_offset = 0;
 
-               // Construct the reply cursor.
-               reply_cursor = mongoc_cursor_new_from_command_reply_with_opts(self->client, &cmd_reply, &cursor_opts);
-               bson_destroy(&cursor_opts);
-               // `cmd_reply` is stolen. Clear it.
-               bson_init(&cmd_reply);
-
-               // Ensure constructing cursor did not error.
-               {
-                  const bson_t *error_document;
-                  if (mongoc_cursor_error_document(reply_cursor, &error, &error_document)) {
-                     _bulkwriteexception_set_error(ret.exc, &error);
-                     if (error_document) {
-                        _bulkwriteexception_set_error_reply(ret.exc, error_document);
-                     }
-                     goto batch_fail;
-                  }
-               }
+   // Send one or more `bulkWrite` commands. Split input payload if necessary to satisfy server size limits.
+   while (ops_byte_offset < self->ops.len) {
+      bulkwrite_batch_t batch;
 
-               // Iterate over cursor results.
-               const bson_t *result;
-               while (mongoc_cursor_next(reply_cursor, &result)) {
-                  if (!_bulkwritereturn_apply_result(
-                         &ret, result, ops_doc_offset, &self->arrayof_modeldata, &self->ops)) {
-                     goto batch_fail;
-                  }
-               }
-               has_write_errors = !bson_empty(&ret.exc->write_errors);
-               // Ensure iterating cursor did not error.
-               {
-                  const bson_t *error_document;
-                  if (mongoc_cursor_error_document(reply_cursor, &error, &error_document)) {
-                     _bulkwriteexception_set_error(ret.exc, &error);
-                     if (error_document) {
-                        _bulkwriteexception_set_error_reply(ret.exc, error_document);
-                     }
-                     goto batch_fail;
-                  }
-               }
-            }
-         }
+      if (!_bulkwrite_next_batch(self, &limits, ops_doc_offset, ops_byte_offset, &batch, &error)) {
+         _bulkwriteexception_set_error(ret.exc, &error);
+         goto fail;
       }
 
-      ops_doc_offset += ops_doc_len;
-      ops_byte_offset += ops_byte_len;
-      batch_ok = true;
-   batch_fail:
-      mcd_nsinfo_destroy(nsinfo);
-      mongoc_cursor_destroy(reply_cursor);
-      bson_destroy(&cmd_reply);
+      const bool batch_ok = _bulkwrite_run_batch(self, self->client, &parts, &ss, &ss_log_context, &batch, &ret);
+      mcd_nsinfo_destroy(batch.nsinfo);
       if (!batch_ok) {
          goto fail;
       }
-      if (has_write_errors && is_ordered) {
+
+      ops_doc_offset += batch.ops_doc_len;
+      ops_byte_offset += batch.ops_byte_len;
+
+      if (!bson_empty(&ret.exc->write_errors) && is_ordered) {
          // Ordered writes must not continue to send batches once an error is
          // occurred. An individual write error is not a top-level error.
          break;
@@ -1997,6 +2333,16 @@ fail:
    return ret;
 }
 
+mongoc_bulkwritereturn_t
+mongoc_bulkwrite_execute(mongoc_bulkwrite_t *self, const mongoc_bulkwriteopts_t *opts)
+{
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_BULK);
+   const mongoc_bulkwritereturn_t ret = _mongoc_bulkwrite_execute(self, opts);
+   _mongoc_alloc_tag_pop(alloc_tag);
+
+   return ret;
+}
+
 MONGOC_EXPORT(mongoc_bulkwrite_check_acknowledged_t)
 mongoc_bulkwrite_check_acknowledged(mongoc_bulkwrite_t const *self, bson_error_t *error)
 {
@@ -47,6 +47,10 @@ mongoc_bulkwriteopts_set_extra(mongoc_bulkwriteopts_t *self, const bson_t *extra
 // wrapping drivers that select a server before running the operation.
 MONGOC_EXPORT(void)
 mongoc_bulkwriteopts_set_serverid(mongoc_bulkwriteopts_t *self, uint32_t serverid);
+// `mongoc_bulkwriteopts_set_maxparallelbatches` permits an unordered bulk write executed with a pooled client to send
+// up to `maxparallelbatches` batches concurrently using other clients from the same pool.
+MONGOC_EXPORT(void)
+mongoc_bulkwriteopts_set_maxparallelbatches(mongoc_bulkwriteopts_t *self, uint32_t maxparallelbatches);
 MONGOC_EXPORT(void)
 mongoc_bulkwriteopts_destroy(mongoc_bulkwriteopts_t *self);
 
@@ -27,6 +27,7 @@
 #include <mongoc/mongoc-log-and-monitor-private.h>
 #include <mongoc/mongoc-oidc-callback-private.h>
 #include <mongoc/mongoc-queue-private.h>
+#include <mongoc/mongoc-structured-log-private.h>
 #include <mongoc/mongoc-thread-private.h>
 #include <mongoc/mongoc-topology-background-monitoring-private.h>
 #include <mongoc/mongoc-topology-private.h>
@@ -44,6 +45,7 @@
 
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
 #include <mongoc/mongoc-openssl-private.h>
+#include <mongoc/mongoc-openssl-session-cache-private.h>
 #endif
 
 #if defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
@@ -57,7 +59,16 @@ struct _mongoc_client_pool_t {
    mongoc_topology_t *topology;
    mongoc_uri_t *uri;
    uint32_t max_pool_size;
+   uint32_t min_pool_size;
    uint32_t size;
+   /* threads blocked in mongoc_client_pool_pop */
+   int32_t waiters;
+   /* the warm-up worker keeps min_pool_size clients connected, see
+    * _mongoc_client_pool_warm_run */
+   bson_thread_t warm_thread;
+   mongoc_cond_t warm_cond;
+   bool warm_thread_started;
+   bool warm_thread_shutdown;
 #ifdef MONGOC_ENABLE_SSL
    mongoc_ssl_opt_t ssl_opts;
    bool ssl_opts_set;
@@ -94,6 +105,7 @@ mongoc_client_pool_set_ssl_opts(mongoc_client_pool_t *pool, const mongoc_ssl_opt
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
       SSL_CTX_free(pool->topology->scanner->openssl_ctx);
       pool->topology->scanner->openssl_ctx = _mongoc_openssl_ctx_new(&pool->ssl_opts);
+      _mongoc_openssl_session_cache_install(pool->topology->scanner->openssl_ctx);
 #elif defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
       // Access to secure_channel_cred_ptr does not need the thread-safe `mongoc_atomic_*` functions.
       // secure_channel_cred_ptr is not expected to be modified by multiple threads.
@@ -194,9 +206,11 @@ mongoc_client_pool_new_with_error(const mongoc_uri_t *uri, bson_error_t *error)
    _mongoc_array_init(&pool->last_known_serverids, sizeof(uint32_t));
    bson_mutex_init(&pool->mutex);
    mongoc_cond_init(&pool->cond);
+   mongoc_cond_init(&pool->warm_cond);
    _mongoc_queue_init(&pool->queue);
    pool->uri = mongoc_uri_copy(uri);
    pool->max_pool_size = 100;
+   pool->min_pool_size = 0;
    pool->size = 0;
    pool->topology = topology;
    pool->error_api_version = MONGOC_ERROR_API_VERSION_LEGACY;
@@ -209,6 +223,12 @@ mongoc_client_pool_new_with_error(const mongoc_uri_t *uri, bson_error_t *error)
       }
    }
 
+   if (bson_iter_init_find_case(&iter, b, MONGOC_URI_MINPOOLSIZE)) {
+      if (BSON_ITER_HOLDS_INT32(&iter)) {
+         pool->min_pool_size = (uint32_t)BSON_MAX(0, bson_iter_int32(&iter));
+      }
+   }
+
    appname = mongoc_uri_get_option_as_utf8(pool->uri, MONGOC_URI_APPNAME, NULL);
    if (appname) {
       /* the appname should have already been validated */
@@ -232,6 +252,9 @@ mongoc_client_pool_new_with_error(const mongoc_uri_t *uri, bson_error_t *error)
 }
 
 
+static void
+_mongoc_client_pool_warm_stop(mongoc_client_pool_t *pool);
+
 void
 mongoc_client_pool_destroy(mongoc_client_pool_t *pool)
 {
@@ -243,6 +266,8 @@ mongoc_client_pool_destroy(mongoc_client_pool_t *pool)
       EXIT;
    }
 
+   _mongoc_client_pool_warm_stop(pool);
+
    if (!mongoc_server_session_pool_is_empty(pool->topology->session_pool)) {
       client = mongoc_client_pool_pop(pool);
       _mongoc_client_end_sessions(client);
@@ -258,6 +283,7 @@ mongoc_client_pool_destroy(mongoc_client_pool_t *pool)
    mongoc_uri_destroy(pool->uri);
    bson_mutex_destroy(&pool->mutex);
    mongoc_cond_destroy(&pool->cond);
+   mongoc_cond_destroy(&pool->warm_cond);
 
    mongoc_server_api_destroy(pool->api);
 
@@ -276,6 +302,227 @@ mongoc_client_pool_destroy(mongoc_client_pool_t *pool)
 }
 
 
+static void
+_initialize_new_client(mongoc_client_pool_t *pool, mongoc_client_t *client);
+
+static bool
+_server_is_data_bearing(const mongoc_server_description_t *sd)
+{
+   switch (sd->type) {
+   case MONGOC_SERVER_STANDALONE:
+   case MONGOC_SERVER_MONGOS:
+   case MONGOC_SERVER_RS_PRIMARY:
+   case MONGOC_SERVER_RS_SECONDARY:
+   case MONGOC_SERVER_LOAD_BALANCER:
+      return true;
+   case MONGOC_SERVER_UNKNOWN:
+   case MONGOC_SERVER_POSSIBLE_PRIMARY:
+   case MONGOC_SERVER_RS_ARBITER:
+   case MONGOC_SERVER_RS_OTHER:
+   case MONGOC_SERVER_RS_GHOST:
+   case MONGOC_SERVER_DESCRIPTION_TYPES:
+   default:
+      return false;
+   }
+}
+
+/* Returns true if @client has no connection, or only a stale one, to a
+ * data-bearing server in @td. */
+static bool
+_client_is_cold(mongoc_client_t *client, const mongoc_topology_description_t *td)
+{
+   const mongoc_set_t *servers = mc_tpld_servers_const(td);
+
+   for (size_t i = 0u; i < servers->items_len; i++) {
+      const mongoc_server_description_t *sd = mongoc_set_get_item_const(servers, i);
+      const mongoc_cluster_node_t *node;
+
+      if (!_server_is_data_bearing(sd)) {
+         continue;
+      }
+
+      node = (const mongoc_cluster_node_t *)mongoc_set_get(client->cluster.nodes, sd->id);
+      if (!node || node->handshake_sd->generation <
+                      _mongoc_topology_get_connection_pool_generation(td, sd->id, &node->handshake_sd->service_id)) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/* Connect and authenticate @client to every data-bearing server. Returns false
+ * if any connection failed. */
+static bool
+_client_warm(mongoc_client_t *client)
+{
+   mongoc_array_t server_ids;
+   bool ret = true;
+
+   _mongoc_array_init(&server_ids, sizeof(uint32_t));
+
+   {
+      mc_shared_tpld td = mc_tpld_take_ref(client->topology);
+      const mongoc_set_t *servers = mc_tpld_servers_const(td.ptr);
+
+      for (size_t i = 0u; i < servers->items_len; i++) {
+         const mongoc_server_description_t *sd = mongoc_set_get_item_const(servers, i);
+
+         if (_server_is_data_bearing(sd)) {
+            _mongoc_array_append_val(&server_ids, sd->id);
+         }
+      }
+      mc_tpld_drop_ref(&td);
+   }
+
+   for (size_t i = 0u; i < server_ids.len; i++) {
+      const uint32_t server_id = _mongoc_array_index(&server_ids, uint32_t, i);
+      mongoc_server_stream_t *server_stream;
+      bson_error_t error;
+
+      server_stream = mongoc_cluster_stream_for_server(&client->cluster, server_id, true, NULL, NULL, &error);
+      if (!server_stream) {
+         TRACE("warm-up connection to server %" PRIu32 " failed: %s", server_id, error.message);
+         ret = false;
+         continue;
+      }
+
+      mongoc_server_stream_cleanup(server_stream);
+   }
+
+   _mongoc_array_destroy(&server_ids);
+
+   return ret;
+}
+
+/* Returns a client that needs warming, removed from the pool, or NULL. Only
+ * the first min_pool_size idle clients are considered: the queue is LIFO, so
+ * these are the ones mongoc_client_pool_pop hands out next.
+ *
+ * This function assumes the pool's mutex is locked. */
+static mongoc_client_t *
+_take_cold_client(mongoc_client_pool_t *pool)
+{
+   mongoc_client_t *client = NULL;
+   const uint32_t min_pool_size = BSON_MIN(pool->min_pool_size, pool->max_pool_size);
+   uint32_t n = 0u;
+
+   {
+      mc_shared_tpld td = mc_tpld_take_ref(pool->topology);
+
+      for (mongoc_queue_item_t *ptr = pool->queue.head; ptr && n < min_pool_size; ptr = ptr->next, n++) {
+         if (_client_is_cold((mongoc_client_t *)ptr->data, td.ptr)) {
+            client = (mongoc_client_t *)ptr->data;
+            break;
+         }
+      }
+      mc_tpld_drop_ref(&td);
+   }
+
+   if (client) {
+      BSON_ASSERT(_mongoc_queue_remove(&pool->queue, client));
+   } else if (pool->size < min_pool_size) {
+      client = _mongoc_client_new_from_topology(pool->topology);
+      BSON_ASSERT(client);
+      _initialize_new_client(pool, client);
+      pool->size++;
+   }
+
+   return client;
+}
+
+/* The warm-up worker rechecks the pool on the topology's heartbeatFrequencyMS schedule. */
+static int64_t
+_warm_interval_msec(mongoc_client_pool_t *pool)
+{
+   mc_shared_tpld td = mc_tpld_take_ref(pool->topology);
+   const int64_t heartbeat_msec = td.ptr->heartbeat_msec;
+
+   mc_tpld_drop_ref(&td);
+
+   return heartbeat_msec;
+}
+
+/*
+ * Background worker for the "minPoolSize" URI option. It creates clients until
+ * the pool holds min_pool_size of them, and connects and authenticates each to
+ * every data-bearing server, so the first operations after startup or after a
+ * connection pool is cleared do not pay for TCP, TLS, hello, and auth inline.
+ */
+static BSON_THREAD_FUN(_mongoc_client_pool_warm_run, pool_void)
+{
+   mongoc_client_pool_t *pool = (mongoc_client_pool_t *)pool_void;
+   const int64_t interval_msec = _warm_interval_msec(pool);
+
+   bson_mutex_lock(&pool->mutex);
+   while (!pool->warm_thread_shutdown) {
+      mongoc_client_t *client = _take_cold_client(pool);
+      bool warmed;
+
+      if (!client) {
+         mongoc_cond_timedwait(&pool->warm_cond, &pool->mutex, interval_msec);
+         continue;
+      }
+
+      bson_mutex_unlock(&pool->mutex);
+      warmed = _client_warm(client);
+      mongoc_client_pool_push(pool, client);
+      bson_mutex_lock(&pool->mutex);
+
+      if (!warmed && !pool->warm_thread_shutdown) {
+         /* Let the monitors mark the server unknown before retrying. */
+         mongoc_cond_timedwait(&pool->warm_cond, &pool->mutex, interval_msec);
+      }
+   }
+   bson_mutex_unlock(&pool->mutex);
+
+   BSON_THREAD_RETURN;
+}
+
+/*
+ * Start the warm-up worker if "minPoolSize" is set.
+ *
+ * This function assumes the pool's mutex is locked
+ */
+static void
+_mongoc_client_pool_warm_start(mongoc_client_pool_t *pool)
+{
+   int ret;
+
+   if (pool->min_pool_size == 0 || pool->warm_thread_started || pool->warm_thread_shutdown) {
+      return;
+   }
+
+   ret = mcommon_thread_create(&pool->warm_thread, _mongoc_client_pool_warm_run, pool);
+   if (ret != 0) {
+      char errmsg_buf[BSON_ERROR_BUFFER_SIZE];
+      char *errmsg = bson_strerror_r(ret, errmsg_buf, sizeof errmsg_buf);
+      MONGOC_ERROR("Failed to start connection pool warm-up thread. Connections will be created on demand. Error: %s",
+                   errmsg);
+      /* do not try again */
+      pool->warm_thread_shutdown = true;
+      return;
+   }
+
+   pool->warm_thread_started = true;
+}
+
+static void
+_mongoc_client_pool_warm_stop(mongoc_client_pool_t *pool)
+{
+   bool started;
+
+   bson_mutex_lock(&pool->mutex);
+   pool->warm_thread_shutdown = true;
+   started = pool->warm_thread_started;
+   mongoc_cond_signal(&pool->warm_cond);
+   bson_mutex_unlock(&pool->mutex);
+
+   if (started) {
+      mcommon_thread_join(pool->warm_thread);
+   }
+}
+
 /*
  * Start the background topology scanner.
  *
@@ -288,6 +535,7 @@ _start_scanner_if_needed(mongoc_client_pool_t *pool)
 
    if (!pool->topology->single_threaded) {
       _mongoc_topology_background_monitoring_start(pool->topology);
+      _mongoc_client_pool_warm_start(pool);
    }
 }
 
@@ -302,6 +550,7 @@ _initialize_new_client(mongoc_client_pool_t *pool, mongoc_client_t *client)
       client, pool->topology->scanner->initiator, pool->topology->scanner->initiator_context);
 
    pool->client_initialized = true;
+   client->pool = pool;
    client->error_api_version = pool->error_api_version;
 
    client->api = mongoc_server_api_copy(pool->api);
@@ -313,16 +562,60 @@ _initialize_new_client(mongoc_client_pool_t *pool, mongoc_client_t *client)
 #endif
 }
 
+/* The waits of one mongoc_client_pool_pop, for counters and the "Client pool
+ * checkout wait ended" log message. */
+typedef struct {
+   int64_t started;
+   int64_t total_usec;
+   int32_t wakeups;
+   /* Threads waiting when the last wait ended, including this one. */
+   int32_t waiting;
+   const char *woken_by;
+} _mongoc_client_pool_waits_t;
+
+
+static void
+_mongoc_client_pool_wait_begin(mongoc_client_pool_t *pool, _mongoc_client_pool_waits_t *waits)
+{
+   pool->waiters++;
+   mongoc_counter_client_pools_waiting_inc();
+   waits->started = bson_get_monotonic_time();
+}
+
+
+static void
+_mongoc_client_pool_wait_end(mongoc_client_pool_t *pool, _mongoc_client_pool_waits_t *waits, int r)
+{
+   const int64_t waited = bson_get_monotonic_time() - waits->started;
+
+   waits->waiting = pool->waiters--;
+   waits->total_usec += waited;
+   waits->wakeups++;
+   mongoc_counter_client_pools_waiting_dec();
+   mongoc_counter_client_pools_wait_usec_add(waited);
+
+   if (mongo_cond_ret_is_timedout(r)) {
+      waits->woken_by = "timeout";
+      mongoc_counter_client_pools_timeouts_inc();
+   } else {
+      waits->woken_by = "clientReturned";
+      mongoc_counter_client_pools_woken_inc();
+   }
+}
+
+
 mongoc_client_t *
 mongoc_client_pool_pop(mongoc_client_pool_t *pool)
 {
    mongoc_client_t *client;
+   _mongoc_client_pool_waits_t waits = {0};
    int r;
 
    ENTRY;
 
    BSON_ASSERT_PARAM(pool);
 
+   const int64_t checkout_started = bson_get_monotonic_time();
    mlib_timer expires_at = mlib_expires_never();
 
    const int32_t wait_queue_timeout_ms = mongoc_uri_get_option_as_int32(pool->uri, MONGOC_URI_WAITQUEUETIMEOUTMS, -1);
@@ -342,7 +635,9 @@ again:
          if (wait_queue_timeout_ms > 0) {
             if (!mlib_timer_is_expired(expires_at)) {
                const mlib_duration remain = mlib_timer_remaining(expires_at);
+               _mongoc_client_pool_wait_begin(pool, &waits);
                r = mongoc_cond_timedwait(&pool->cond, &pool->mutex, mlib_milliseconds_count(remain));
+               _mongoc_client_pool_wait_end(pool, &waits, r);
                if (mongo_cond_ret_is_timedout(r)) {
                   GOTO(done);
                }
@@ -350,7 +645,9 @@ again:
                GOTO(done);
             }
          } else {
+            _mongoc_client_pool_wait_begin(pool, &waits);
             mongoc_cond_wait(&pool->cond, &pool->mutex);
+            _mongoc_client_pool_wait_end(pool, &waits, 0);
          }
          GOTO(again);
       }
@@ -360,6 +657,21 @@ again:
 done:
    bson_mutex_unlock(&pool->mutex);
 
+   mongoc_histogram_client_pools_checkout_record(bson_get_monotonic_time() - checkout_started);
+
+   /* Logged after unlocking, so the handler may use the pool. */
+   if (waits.wakeups > 0) {
+      mongoc_structured_log(pool->topology->log_and_monitor.structured_log,
+                            MONGOC_STRUCTURED_LOG_LEVEL_TRACE,
+                            MONGOC_STRUCTURED_LOG_COMPONENT_CONNECTION,
+                            "Client pool checkout wait ended",
+                            monotonic_time_duration(waits.total_usec),
+                            int32("wakeups", waits.wakeups),
+                            int32("waitingThreads", waits.waiting),
+                            utf8("wokenBy", waits.woken_by),
+                            boolean("succeeded", client != NULL));
+   }
+
    RETURN(client);
 }
 
@@ -710,3 +1022,16 @@ mongoc_client_pool_set_oidc_callback(mongoc_client_pool_t *pool, const mongoc_oi
    mongoc_oidc_cache_set_user_callback(pool->topology->oidc_cache, callback);
    return true;
 }
+
+mongoc_server_wire_stats_t **
+mongoc_client_pool_get_server_wire_stats(mongoc_client_pool_t *pool, size_t *n /* OUT */)
+{
+   BSON_ASSERT_PARAM(pool);
+   BSON_ASSERT_PARAM(n);
+
+   mc_shared_tpld td = mc_tpld_take_ref(pool->topology);
+   mongoc_server_wire_stats_t **const ret = _mongoc_wire_stats_snapshot(pool->topology->wire_stats, td.ptr, n);
+   mc_tpld_drop_ref(&td);
+
+   return ret;
+}
@@ -87,6 +87,9 @@ mongoc_client_pool_set_structured_log_opts(mongoc_client_pool_t *pool, const mon
 MONGOC_EXPORT(bool)
 mongoc_client_pool_set_oidc_callback(mongoc_client_pool_t *pool, const mongoc_oidc_callback_t *callback);
 
+MONGOC_EXPORT(mongoc_server_wire_stats_t **)
+mongoc_client_pool_get_server_wire_stats(mongoc_client_pool_t *pool, size_t *n) BSON_GNUC_WARN_UNUSED_RESULT;
+
 BSON_END_DECLS
 
 
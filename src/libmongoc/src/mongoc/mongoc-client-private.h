@@ -107,6 +107,9 @@ struct _mongoc_client_t {
 
    mongoc_topology_t *topology;
 
+   /* the pool this client was popped from, or NULL for a single-threaded client */
+   struct _mongoc_client_pool_t *pool;
+
    mongoc_read_prefs_t *read_prefs;
    mongoc_read_concern_t *read_concern;
    mongoc_write_concern_t *write_concern;
@@ -204,6 +207,13 @@ _mongoc_client_end_sessions(mongoc_client_t *client);
 mongoc_stream_t *
 mongoc_client_connect_tcp(int32_t connecttimeoutms, const mongoc_host_list_t *host, bson_error_t *error);
 
+mongoc_stream_t *
+_mongoc_client_connect_tcp_with_dns_cache(int32_t connecttimeoutms,
+                                          const mongoc_host_list_t *host,
+                                          mongoc_dns_cache_t *dns_cache,
+                                          bool use_io_uring,
+                                          bson_error_t *error);
+
 mongoc_stream_t *
 mongoc_client_connect(bool use_ssl,
                       void *ssl_opts_void,
@@ -211,6 +221,7 @@ mongoc_client_connect(bool use_ssl,
                       const mongoc_host_list_t *host,
                       void *openssl_ctx_void,
                       mongoc_shared_ptr secure_channel_cred_ptr,
+                      mongoc_dns_cache_t *dns_cache,
                       bson_error_t *error);
 
 
@@ -45,10 +45,13 @@
 #include <mongoc/mongoc-gridfs-private.h>
 #include <mongoc/mongoc-host-list-private.h>
 #include <mongoc/mongoc-oidc-callback-private.h>
+#include <mongoc/mongoc-probes-private.h>
 #include <mongoc/mongoc-queue-private.h>
 #include <mongoc/mongoc-read-concern-private.h>
 #include <mongoc/mongoc-read-prefs-private.h>
 #include <mongoc/mongoc-set-private.h>
+#include <mongoc/mongoc-socket-private.h>
+#include <mongoc/mongoc-stream-private.h>
 #include <mongoc/mongoc-structured-log-private.h>
 #include <mongoc/mongoc-thread-private.h>
 #include <mongoc/mongoc-trace-private.h>
@@ -60,6 +63,7 @@
 #include <mongoc/mongoc-socket.h>
 #include <mongoc/mongoc-stream-buffered.h>
 #include <mongoc/mongoc-stream-socket.h>
+#include <mongoc/mongoc-stream-uring.h>
 
 #include <mlib/str.h>
 
@@ -73,6 +77,7 @@
 
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
 #include <mongoc/mongoc-openssl-private.h>
+#include <mongoc/mongoc-openssl-session-cache-private.h>
 #include <mongoc/mongoc-stream-tls-private.h>
 #endif
 
@@ -600,6 +605,22 @@ _mongoc_client_get_rr(const char *hostname,
 
 #undef DNS_ERROR
 
+/* Wrap a connected socket in an io_uring stream if requested and available,
+ * otherwise in a poll-based socket stream. */
+static mongoc_stream_t *
+_mongoc_client_new_socket_stream(mongoc_socket_t *sock, bool use_io_uring)
+{
+   if (use_io_uring) {
+      mongoc_stream_t *const stream = mongoc_stream_uring_new(sock);
+      if (stream) {
+         return stream;
+      }
+      TRACE("%s", "io_uring is unavailable, falling back to a socket stream");
+   }
+
+   return mongoc_stream_socket_new(sock);
+}
+
 /*
  *--------------------------------------------------------------------------
  *
@@ -622,43 +643,48 @@ _mongoc_client_get_rr(const char *hostname,
 
 mongoc_stream_t *
 mongoc_client_connect_tcp(int32_t connecttimeoutms, const mongoc_host_list_t *host, bson_error_t *error)
+{
+   return _mongoc_client_connect_tcp_with_dns_cache(connecttimeoutms, host, NULL, false, error);
+}
+
+
+/*
+ *--------------------------------------------------------------------------
+ *
+ * _mongoc_client_connect_tcp_with_dns_cache --
+ *
+ *       Same as mongoc_client_connect_tcp, but resolves @host through
+ *       @dns_cache, which may be NULL. If no address of a cached result
+ *       can be connected, the result is invalidated.
+ *
+ *       If @use_io_uring is true, the connected socket is wrapped in an
+ *       io_uring stream when the kernel supports it.
+ *
+ *--------------------------------------------------------------------------
+ */
+
+mongoc_stream_t *
+_mongoc_client_connect_tcp_with_dns_cache(int32_t connecttimeoutms,
+                                          const mongoc_host_list_t *host,
+                                          mongoc_dns_cache_t *dns_cache,
+                                          bool use_io_uring,
+                                          bson_error_t *error)
 {
    mongoc_socket_t *sock = NULL;
-   struct addrinfo hints;
-   struct addrinfo *result, *rp;
+   mongoc_dns_result_t *result;
+   struct addrinfo *rp;
    int64_t expire_at;
-   char portstr[8];
-   int s;
 
    ENTRY;
 
    BSON_ASSERT(connecttimeoutms);
    BSON_ASSERT(host);
 
-   // Expect no truncation.
-   int req = bson_snprintf(portstr, sizeof portstr, "%hu", host->port);
-   BSON_ASSERT(mlib_cmp(req, <, sizeof portstr));
-
-   memset(&hints, 0, sizeof hints);
-   hints.ai_family = host->family;
-   hints.ai_socktype = SOCK_STREAM;
-   hints.ai_flags = 0;
-   hints.ai_protocol = 0;
-
-   TRACE("DNS lookup for %s", host->host);
-   s = getaddrinfo(host->host, portstr, &hints, &result);
-
-   if (s != 0) {
-      mongoc_counter_dns_failure_inc();
-      TRACE("Failed to resolve %s", host->host);
-      _mongoc_set_error(
-         error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_NAME_RESOLUTION, "Failed to resolve %s", host->host);
+   if (!(result = _mongoc_dns_cache_lookup(dns_cache, host, error))) {
       RETURN(NULL);
    }
 
-   mongoc_counter_dns_success_inc();
-
-   for (rp = result; rp; rp = rp->ai_next) {
+   for (rp = _mongoc_dns_result_addrinfo(result); rp; rp = rp->ai_next) {
       /*
        * Create a new non-blocking socket.
        */
@@ -685,13 +711,15 @@ mongoc_client_connect_tcp(int32_t connecttimeoutms, const mongoc_host_list_t *ho
                         MONGOC_ERROR_STREAM_CONNECT,
                         "Failed to connect to target host: %s",
                         host->host_and_port);
-      freeaddrinfo(result);
+      /* the addresses may be stale */
+      _mongoc_dns_cache_invalidate(dns_cache, host);
+      _mongoc_dns_result_release(result);
       RETURN(NULL);
    }
 
-   freeaddrinfo(result);
+   _mongoc_dns_result_release(result);
 
-   return mongoc_stream_socket_new(sock);
+   return _mongoc_client_new_socket_stream(sock, use_io_uring);
 }
 
 
@@ -713,11 +741,12 @@ mongoc_client_connect_tcp(int32_t connecttimeoutms, const mongoc_host_list_t *ho
  */
 
 static mongoc_stream_t *
-mongoc_client_connect_unix(const mongoc_host_list_t *host, bson_error_t *error)
+mongoc_client_connect_unix(const mongoc_host_list_t *host, bool use_io_uring, bson_error_t *error)
 {
 #ifdef _WIN32
    ENTRY;
    BSON_UNUSED(host);
+   BSON_UNUSED(use_io_uring);
    _mongoc_set_error(
       error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_CONNECT, "UNIX domain sockets not supported on win32.");
    RETURN(NULL);
@@ -755,23 +784,25 @@ mongoc_client_connect_unix(const mongoc_host_list_t *host, bson_error_t *error)
       RETURN(NULL);
    }
 
-   ret = mongoc_stream_socket_new(sock);
+   ret = _mongoc_client_new_socket_stream(sock, use_io_uring);
 
    RETURN(ret);
 #endif
 }
 
-mongoc_stream_t *
-mongoc_client_connect(bool use_ssl,
-                      void *ssl_opts_void,
-                      const mongoc_uri_t *uri,
-                      const mongoc_host_list_t *host,
-                      void *openssl_ctx_void,
-                      mongoc_shared_ptr secure_channel_cred_ptr,
-                      bson_error_t *error)
+static mongoc_stream_t *
+_mongoc_client_connect(bool use_ssl,
+                       void *ssl_opts_void,
+                       const mongoc_uri_t *uri,
+                       const mongoc_host_list_t *host,
+                       void *openssl_ctx_void,
+                       mongoc_shared_ptr secure_channel_cred_ptr,
+                       mongoc_dns_cache_t *dns_cache,
+                       bson_error_t *error)
 {
    mongoc_stream_t *base_stream = NULL;
    int32_t connecttimeoutms;
+   bool is_tcp = false;
 
    BSON_ASSERT(uri);
    BSON_ASSERT(host);
@@ -790,6 +821,7 @@ mongoc_client_connect(bool use_ssl,
 #endif
 
    connecttimeoutms = mongoc_uri_get_option_as_int32(uri, MONGOC_URI_CONNECTTIMEOUTMS, MONGOC_DEFAULT_CONNECTTIMEOUTMS);
+   const bool use_io_uring = mongoc_uri_get_option_as_bool(uri, MONGOC_URI_USEIOURING, false);
 
    switch (host->family) {
    case AF_UNSPEC:
@@ -797,10 +829,11 @@ mongoc_client_connect(bool use_ssl,
    case AF_INET6:
 #endif
    case AF_INET:
-      base_stream = mongoc_client_connect_tcp(connecttimeoutms, host, error);
+      base_stream = _mongoc_client_connect_tcp_with_dns_cache(connecttimeoutms, host, dns_cache, use_io_uring, error);
+      is_tcp = true;
       break;
    case AF_UNIX:
-      base_stream = mongoc_client_connect_unix(host, error);
+      base_stream = mongoc_client_connect_unix(host, use_io_uring, error);
       break;
    default:
       _mongoc_set_error(error,
@@ -826,6 +859,9 @@ mongoc_client_connect(bool use_ssl,
          // Use shared OpenSSL context.
          base_stream = mongoc_stream_tls_new_with_hostname_and_openssl_context(
             base_stream, host->host, ssl_opts, true, (SSL_CTX *)openssl_ctx_void);
+         if (base_stream) {
+            _mongoc_stream_tls_openssl_set_session_cache_key(base_stream, host->host_and_port);
+         }
 #elif defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
          // Use shared Secure Channel credentials.
          base_stream =
@@ -851,9 +887,43 @@ mongoc_client_connect(bool use_ssl,
    if (!base_stream) {
       return NULL;
    }
+
+   /* A TLS stream sends its own encrypted copy of the data, so zero-copy only
+    * applies when nothing is layered on top of the socket. */
+   if (is_tcp && base_stream->type == MONGOC_STREAM_SOCKET) {
+      const int32_t zerocopy_threshold = mongoc_uri_get_option_as_int32(uri, MONGOC_URI_ZEROCOPYTHRESHOLDBYTES, 0);
+      if (zerocopy_threshold > 0) {
+         /* Best effort: unsupported kernels keep sending by copying. */
+         (void)_mongoc_socket_enable_zerocopy(mongoc_stream_socket_get_socket((mongoc_stream_socket_t *)base_stream),
+                                              (size_t)zerocopy_threshold);
+      }
+   }
+
    return base_stream;
 }
 
+mongoc_stream_t *
+mongoc_client_connect(bool use_ssl,
+                      void *ssl_opts_void,
+                      const mongoc_uri_t *uri,
+                      const mongoc_host_list_t *host,
+                      void *openssl_ctx_void,
+                      mongoc_shared_ptr secure_channel_cred_ptr,
+                      mongoc_dns_cache_t *dns_cache,
+                      bson_error_t *error)
+{
+   mongoc_stream_t *stream;
+
+   BSON_ASSERT(host);
+
+   MONGOC_PROBE1(connect_start, host->host_and_port);
+   stream = _mongoc_client_connect(
+      use_ssl, ssl_opts_void, uri, host, openssl_ctx_void, secure_channel_cred_ptr, dns_cache, error);
+   MONGOC_PROBE2(connect_done, host->host_and_port, stream != NULL);
+
+   return stream;
+}
+
 /*
  *--------------------------------------------------------------------------
  *
@@ -894,12 +964,20 @@ mongoc_client_default_stream_initiator(const mongoc_uri_t *uri,
 
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
    SSL_CTX *ssl_ctx = client->topology->scanner->openssl_ctx;
-   return mongoc_client_connect(use_ssl, ssl_opts_void, uri, host, (void *)ssl_ctx, MONGOC_SHARED_PTR_NULL, error);
-#elif defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
    return mongoc_client_connect(
-      use_ssl, ssl_opts_void, uri, host, NULL, client->topology->scanner->secure_channel_cred_ptr, error);
+      use_ssl, ssl_opts_void, uri, host, (void *)ssl_ctx, MONGOC_SHARED_PTR_NULL, client->topology->dns_cache, error);
+#elif defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
+   return mongoc_client_connect(use_ssl,
+                                ssl_opts_void,
+                                uri,
+                                host,
+                                NULL,
+                                client->topology->scanner->secure_channel_cred_ptr,
+                                client->topology->dns_cache,
+                                error);
 #else
-   return mongoc_client_connect(use_ssl, ssl_opts_void, uri, host, NULL, MONGOC_SHARED_PTR_NULL, error);
+   return mongoc_client_connect(
+      use_ssl, ssl_opts_void, uri, host, NULL, MONGOC_SHARED_PTR_NULL, client->topology->dns_cache, error);
 #endif
 }
 
@@ -1026,6 +1104,7 @@ _mongoc_client_set_ssl_opts_for_single_or_pooled(mongoc_client_t *client, const
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
       SSL_CTX_free(client->topology->scanner->openssl_ctx);
       client->topology->scanner->openssl_ctx = _mongoc_openssl_ctx_new(&client->ssl_opts);
+      _mongoc_openssl_session_cache_install(client->topology->scanner->openssl_ctx);
 #endif
 
 #if defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
@@ -2375,6 +2454,20 @@ mongoc_server_descriptions_destroy_all(mongoc_server_description_t **sds, size_t
 }
 
 
+mongoc_server_wire_stats_t **
+mongoc_client_get_server_wire_stats(mongoc_client_t *client, size_t *n /* OUT */)
+{
+   BSON_ASSERT_PARAM(client);
+   BSON_ASSERT_PARAM(n);
+
+   mc_shared_tpld td = mc_tpld_take_ref(client->topology);
+   mongoc_server_wire_stats_t **const ret = _mongoc_wire_stats_snapshot(client->topology->wire_stats, td.ptr, n);
+   mc_tpld_drop_ref(&td);
+
+   return ret;
+}
+
+
 mongoc_server_description_t *
 mongoc_client_select_server(mongoc_client_t *client,
                             bool for_writes,
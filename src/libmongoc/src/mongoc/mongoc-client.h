@@ -37,6 +37,7 @@
 #include <mongoc/mongoc-oidc-callback.h>
 #include <mongoc/mongoc-read-concern.h>
 #include <mongoc/mongoc-server-description.h>
+#include <mongoc/mongoc-server-wire-stats.h>
 #include <mongoc/mongoc-stream.h>
 #include <mongoc/mongoc-structured-log.h>
 #include <mongoc/mongoc-uri.h>
@@ -246,6 +247,9 @@ mongoc_client_get_server_descriptions(const mongoc_client_t *client, size_t *n)
 MONGOC_EXPORT(void)
 mongoc_server_descriptions_destroy_all(mongoc_server_description_t **sds, size_t n);
 
+MONGOC_EXPORT(mongoc_server_wire_stats_t **)
+mongoc_client_get_server_wire_stats(mongoc_client_t *client, size_t *n) BSON_GNUC_WARN_UNUSED_RESULT;
+
 MONGOC_EXPORT(mongoc_server_description_t *)
 mongoc_client_select_server(mongoc_client_t *client,
                             bool for_writes,
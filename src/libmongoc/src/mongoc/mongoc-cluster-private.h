@@ -51,6 +51,8 @@ typedef struct _mongoc_cluster_node_t {
     * stream. */
    mongoc_server_description_t *handshake_sd;
    mongoc_oidc_connection_cache_t *oidc_connection_cache;
+   /* The statistics of the messages exchanged on stream. */
+   mongoc_wire_stats_server_t *wire_stats;
 } mongoc_cluster_node_t;
 
 typedef struct _mongoc_cluster_t {
@@ -39,14 +39,18 @@
 #include <common-b64-private.h>
 #include <common-bson-dsl-private.h>
 #include <common-oid-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
+#include <mongoc/mongoc-apm-private.h>
 #include <mongoc/mongoc-cluster-aws-private.h>
 #include <mongoc/mongoc-cluster-oidc-private.h>
 #include <mongoc/mongoc-cmd-private.h>
 #include <mongoc/mongoc-compression-private.h>
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-handshake-private.h>
+#include <mongoc/mongoc-probes-private.h>
 #include <mongoc/mongoc-rpc-private.h>
 #include <mongoc/mongoc-scram-private.h>
+#include <mongoc/mongoc-server-wire-stats-private.h>
 #include <mongoc/mongoc-set-private.h>
 #include <mongoc/mongoc-stream-private.h>
 #include <mongoc/mongoc-structured-log-private.h>
@@ -91,7 +95,11 @@ _cluster_fetch_stream_pooled(mongoc_cluster_t *cluster,
                              bson_error_t *error);
 
 static bool
-mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, bson_t *reply, bson_error_t *error);
+mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster,
+                         const mongoc_cmd_t *cmd,
+                         bson_t *reply,
+                         bson_error_t *error,
+                         mongoc_apm_command_phases_t *phases);
 
 static void
 _bson_error_message_printf(bson_error_t *error, const char *format, ...) BSON_GNUC_PRINTF(2, 3);
@@ -323,13 +331,15 @@ _mongoc_cluster_run_command_opquery_send(mongoc_cluster_t *cluster,
                                          int32_t compressor_id,
                                          mcd_rpc_message *rpc,
                                          bson_t *reply,
-                                         bson_error_t *error)
+                                         bson_error_t *error,
+                                         mongoc_wire_stats_values_t *wire)
 {
    BSON_ASSERT_PARAM(cluster);
    BSON_ASSERT_PARAM(cmd);
    BSON_ASSERT_PARAM(rpc);
    BSON_ASSERT_PARAM(reply);
    BSON_ASSERT_PARAM(error);
+   BSON_ASSERT_PARAM(wire);
 
    bool ret = false;
 
@@ -345,9 +355,9 @@ _mongoc_cluster_run_command_opquery_send(mongoc_cluster_t *cluster,
    // already.
    const int32_t flags = (int32_t)cmd->query_flags & MONGOC_OP_QUERY_FLAG_SECONDARY_OK;
 
-   {
-      int32_t message_length = 0;
+   int32_t message_length = 0;
 
+   {
       message_length += mcd_rpc_header_set_message_length(rpc, 0);
       message_length += mcd_rpc_header_set_request_id(rpc, request_id);
       message_length += mcd_rpc_header_set_response_to(rpc, 0);
@@ -393,9 +403,13 @@ _mongoc_cluster_run_command_opquery_send(mongoc_cluster_t *cluster,
    if (!_mongoc_stream_writev_full(stream, iovecs, num_iovecs, cluster->sockettimeoutms, error)) {
       RUN_CMD_ERR_DECORATE;
       _handle_network_error(cluster, cmd, reply, error);
+      wire->errors = 1;
       goto done;
    }
 
+   wire->messages_out = 1;
+   wire->bytes_out = message_length;
+
    ret = true;
 
 done:
@@ -411,14 +425,19 @@ done:
  * unmodified.
  */
 static bool
-_mongoc_cluster_run_command_opquery_recv(
-   mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, mcd_rpc_message *rpc, bson_t *reply, bson_error_t *error)
+_mongoc_cluster_run_command_opquery_recv(mongoc_cluster_t *cluster,
+                                         const mongoc_cmd_t *cmd,
+                                         mcd_rpc_message *rpc,
+                                         bson_t *reply,
+                                         bson_error_t *error,
+                                         mongoc_wire_stats_values_t *wire)
 {
    BSON_ASSERT_PARAM(cluster);
    BSON_ASSERT_PARAM(cmd);
    BSON_ASSERT_PARAM(rpc);
    BSON_ASSERT_PARAM(reply);
    BSON_ASSERT_PARAM(error);
+   BSON_ASSERT_PARAM(wire);
 
    bool ret = false;
 
@@ -433,6 +452,7 @@ _mongoc_cluster_run_command_opquery_recv(
    if (!_mongoc_buffer_append_from_stream(&buffer, stream, sizeof(int32_t), cluster->sockettimeoutms, error)) {
       RUN_CMD_ERR(MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_SOCKET, "socket error or timeout");
       _handle_network_error(cluster, cmd, reply, error);
+      wire->errors = 1;
       goto done;
    }
 
@@ -441,6 +461,7 @@ _mongoc_cluster_run_command_opquery_recv(
    if (message_length < message_header_length || message_length > MONGOC_DEFAULT_MAX_MSG_SIZE) {
       RUN_CMD_ERR(MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_SOCKET, "invalid message length");
       _handle_network_error(cluster, cmd, reply, error);
+      wire->errors = 1;
       goto done;
    }
 
@@ -449,6 +470,7 @@ _mongoc_cluster_run_command_opquery_recv(
    if (!_mongoc_buffer_append_from_stream(&buffer, stream, remaining_bytes, cluster->sockettimeoutms, error)) {
       RUN_CMD_ERR(MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_SOCKET, "socket error or timeout");
       _handle_network_error(cluster, cmd, reply, error);
+      wire->errors = 1;
       goto done;
    }
 
@@ -464,6 +486,14 @@ _mongoc_cluster_run_command_opquery_recv(
       goto done;
    }
 
+   wire->messages_in = 1;
+   wire->bytes_in = message_length;
+
+   if (decompressed_data) {
+      wire->compressed_bytes_in = message_length;
+      wire->uncompressed_bytes_in = (int64_t)decompressed_data_len;
+   }
+
    {
       bson_t body;
 
@@ -489,6 +519,38 @@ done:
    return ret;
 }
 
+/* Add the messages exchanged for @cmd, sent at @sent_at, to the totals of its server. */
+static void
+_mongoc_cluster_record_wire_stats(mongoc_cluster_t *cluster,
+                                  const mongoc_cmd_t *cmd,
+                                  mongoc_wire_stats_values_t *wire,
+                                  int64_t sent_at)
+{
+   mongoc_server_stream_t *const server_stream = cmd->server_stream;
+   mongoc_wire_stats_server_t *server;
+
+   if (wire->messages_in) {
+      wire->in_flight_usec = bson_get_monotonic_time() - sent_at;
+   }
+
+   if (server_stream->wire_stats) {
+      _mongoc_wire_stats_server_record(server_stream->wire_stats, wire);
+      return;
+   }
+
+   /* The handshake and authentication run before the connection's node holds
+    * the statistics, so look them up. */
+   mc_shared_tpld td = mc_tpld_take_ref(cluster->client->topology);
+   server = _mongoc_wire_stats_get_server(
+      cluster->client->topology->wire_stats, td.ptr, server_stream->sd->id, server_stream->sd->host.host_and_port);
+   mc_tpld_drop_ref(&td);
+
+   if (server) {
+      _mongoc_wire_stats_server_record(server, wire);
+      _mongoc_wire_stats_server_release(server);
+   }
+}
+
 /**
  * @param reply is a required out-param. `*reply` is always initialized upon return.
  */
@@ -505,19 +567,21 @@ mongoc_cluster_run_command_opquery(
    ENTRY;
 
    bool ret = false;
+   mongoc_wire_stats_values_t wire = {0};
+   const int64_t sent_at = bson_get_monotonic_time();
 
    bson_init(reply);
    error->code = 0;
 
    mcd_rpc_message *const rpc = mcd_rpc_message_new();
 
-   if (!_mongoc_cluster_run_command_opquery_send(cluster, cmd, compressor_id, rpc, reply, error)) {
+   if (!_mongoc_cluster_run_command_opquery_send(cluster, cmd, compressor_id, rpc, reply, error, &wire)) {
       GOTO(done);
    }
 
    mcd_rpc_message_reset(rpc);
 
-   if (!_mongoc_cluster_run_command_opquery_recv(cluster, cmd, rpc, reply, error)) {
+   if (!_mongoc_cluster_run_command_opquery_recv(cluster, cmd, rpc, reply, error, &wire)) {
       GOTO(done);
    }
 
@@ -531,6 +595,8 @@ done:
 
    mcd_rpc_message_destroy(rpc);
 
+   _mongoc_cluster_record_wire_stats(cluster, cmd, &wire, sent_at);
+
    RETURN(ret);
 }
 
@@ -572,6 +638,30 @@ _handle_txn_error_labels(bool cmd_ret, const bson_error_t *cmd_err, const mongoc
    _mongoc_write_error_handle_labels(cmd_ret, cmd_err, reply, cmd->server_stream->sd);
 }
 
+/* Adds the durations of a command's phases to the "Command Phases" counters. */
+static void
+_record_command_phases(const mongoc_apm_command_phases_t *phases)
+{
+#define RECORD_PHASE(phase, ident)                          \
+   do {                                                     \
+      if (phases->usec[phase] > 0) {                        \
+         mongoc_counter_##ident##_add(phases->usec[phase]); \
+      }                                                     \
+   } while (0)
+
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_SERVER_SELECTION, cmd_phase_selection_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_STREAM_CHECKOUT, cmd_phase_checkout_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_ASSEMBLE, cmd_phase_assemble_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_COMPRESS, cmd_phase_compress_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_WRITE, cmd_phase_write_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_WAIT_FIRST_BYTE, cmd_phase_first_byte_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_READ_BODY, cmd_phase_read_body_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_DECOMPRESS, cmd_phase_decompress_usec);
+   RECORD_PHASE(MONGOC_APM_COMMAND_PHASE_PARSE_REPLY, cmd_phase_parse_usec);
+
+#undef RECORD_PHASE
+}
+
 /**
  * @brief An internal helper to run a command with APM monitoring.
  * @param reply is an optional out-param. If non-NULL, `*reply` is always initialized upon return.
@@ -588,6 +678,7 @@ run_command_monitored(mongoc_cluster_t *cluster, mongoc_cmd_t *cmd, bson_t *repl
    mongoc_apm_command_succeeded_t succeeded_event;
    mongoc_apm_command_failed_t failed_event;
    int64_t started = bson_get_monotonic_time();
+   int64_t rtt_started;
    const mongoc_server_stream_t *server_stream;
    bson_t reply_local;
    bson_iter_t iter;
@@ -595,12 +686,18 @@ run_command_monitored(mongoc_cluster_t *cluster, mongoc_cmd_t *cmd, bson_t *repl
    bson_t decrypted = BSON_INITIALIZER;
    mongoc_cmd_t encrypted_cmd;
    bool is_redacted_by_apm = false;
+   mongoc_apm_command_phases_t phases;
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CLUSTER);
 
    server_stream = cmd->server_stream;
    server_id = server_stream->sd->id;
 
    const mongoc_log_and_monitor_instance_t *log_and_monitor = &cluster->client->topology->log_and_monitor;
 
+   const bool collect_phases = mongoc_log_and_monitor_instance_collects_command_phases(log_and_monitor);
+
+   _mongoc_apm_command_phases_init(&phases);
+
    if (!reply) {
       reply = &reply_local;
    }
@@ -634,7 +731,28 @@ run_command_monitored(mongoc_cluster_t *cluster, mongoc_cmd_t *cmd, bson_t *repl
       mongoc_apm_command_started_cleanup(&started_event);
    }
 
-   retval = mongoc_cluster_run_opmsg(cluster, cmd, reply, error);
+   MONGOC_PROBE4(command_start, request_id, cmd->command_name, server_id, cmd->operation_id);
+   rtt_started = bson_get_monotonic_time();
+   retval = mongoc_cluster_run_opmsg(cluster, cmd, reply, error, collect_phases ? &phases : NULL);
+   const int64_t rtt_usec = bson_get_monotonic_time() - rtt_started;
+   _mongoc_histogram_record_command_rtt(cmd->command_name, rtt_usec);
+   MONGOC_PROBE4(command_done, request_id, cmd->command_name, rtt_usec, retval);
+
+   if (collect_phases) {
+      /* Selection and checkout happened once for the server stream; report them with its first command only. */
+      phases.usec[MONGOC_APM_COMMAND_PHASE_SERVER_SELECTION] = cmd->server_stream->selection_usec;
+      phases.usec[MONGOC_APM_COMMAND_PHASE_STREAM_CHECKOUT] = cmd->server_stream->checkout_usec;
+      cmd->server_stream->selection_usec = -1;
+      cmd->server_stream->checkout_usec = -1;
+
+      /* The ASSEMBLE phase measured so far is only the OP_MSG framing. */
+      if (cmd->assemble_usec >= 0) {
+         phases.usec[MONGOC_APM_COMMAND_PHASE_ASSEMBLE] =
+            cmd->assemble_usec + BSON_MAX(phases.usec[MONGOC_APM_COMMAND_PHASE_ASSEMBLE], 0);
+      }
+
+      _record_command_phases(&phases);
+   }
 
    if (retval) {
       bson_t fake_reply = BSON_INITIALIZER;
@@ -674,6 +792,7 @@ run_command_monitored(mongoc_cluster_t *cluster, mongoc_cmd_t *cmd, bson_t *repl
                                            server_stream->sd->server_connection_id,
                                            is_redacted_by_apm,
                                            log_and_monitor->apm_context);
+         succeeded_event.phases = phases;
 
          log_and_monitor->apm_callbacks.succeeded(&succeeded_event);
          mongoc_apm_command_succeeded_cleanup(&succeeded_event);
@@ -709,6 +828,7 @@ run_command_monitored(mongoc_cluster_t *cluster, mongoc_cmd_t *cmd, bson_t *repl
                                         server_stream->sd->server_connection_id,
                                         is_redacted_by_apm,
                                         log_and_monitor->apm_context);
+         failed_event.phases = phases;
 
          log_and_monitor->apm_callbacks.failed(&failed_event);
          mongoc_apm_command_failed_cleanup(&failed_event);
@@ -751,6 +871,8 @@ fail_no_events:
 
    _mongoc_topology_update_last_used(cluster->client->topology, server_id);
 
+   _mongoc_alloc_tag_pop(alloc_tag);
+
    return retval;
 }
 
@@ -896,8 +1018,10 @@ mongoc_cluster_run_command_private(mongoc_cluster_t *cluster,
 
    server_stream = cmd->server_stream;
 
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CLUSTER);
+
    if (_should_use_op_msg(cluster) || server_stream->sd->max_wire_version >= WIRE_VERSION_MIN) {
-      retval = mongoc_cluster_run_opmsg(cluster, cmd, reply, error);
+      retval = mongoc_cluster_run_opmsg(cluster, cmd, reply, error, NULL);
    } else {
       retval = mongoc_cluster_run_command_opquery(cluster, cmd, -1, reply, error);
    }
@@ -910,6 +1034,8 @@ mongoc_cluster_run_command_private(mongoc_cluster_t *cluster,
 
    _mongoc_topology_update_last_used(cluster->client->topology, server_stream->sd->id);
 
+   _mongoc_alloc_tag_pop(alloc_tag);
+
    return retval;
 }
 
@@ -1049,6 +1175,7 @@ _stream_run_hello(mongoc_cluster_t *cluster,
       .server_stream = server_stream,
       .is_acknowledged = true,
       .query_flags = query_flags,
+      .assemble_usec = -1,
    };
 
    bson_t hello_reply;
@@ -1151,6 +1278,8 @@ _cluster_run_hello(mongoc_cluster_t *cluster,
    BSON_ASSERT(node);
    BSON_ASSERT(node->stream);
 
+   MONGOC_PROBE2(handshake_start, node->connection_address, server_id);
+
    sd = _stream_run_hello(cluster,
                           node->stream,
                           node->oidc_connection_cache,
@@ -1162,16 +1291,14 @@ _cluster_run_hello(mongoc_cluster_t *cluster,
                           reply,
                           error);
 
-   if (!sd) {
-      return NULL;
-   }
-
-   if (sd->type == MONGOC_SERVER_UNKNOWN) {
+   if (sd && sd->type == MONGOC_SERVER_UNKNOWN) {
       memcpy(error, &sd->error, sizeof(bson_error_t));
       mongoc_server_description_destroy(sd);
-      return NULL;
+      sd = NULL;
    }
 
+   MONGOC_PROBE3(handshake_done, node->connection_address, server_id, sd != NULL);
+
    return sd;
 }
 
@@ -1919,6 +2046,7 @@ _mongoc_cluster_node_destroy(mongoc_cluster_node_t *node)
    bson_free(node->connection_address);
    mongoc_server_description_destroy(node->handshake_sd);
    mongoc_oidc_connection_cache_destroy(node->oidc_connection_cache);
+   _mongoc_wire_stats_server_release(node->wire_stats);
 
    bson_free(node);
 }
@@ -2064,6 +2192,8 @@ _cluster_add_node(mongoc_cluster_t *cluster,
    mongoc_scram_t scram = {0};
    bson_t speculative_auth_response = BSON_INITIALIZER;
    bool reply_initialized = false;
+   bool connecting = false;
+   int64_t connect_started;
 
    ENTRY;
 
@@ -2075,6 +2205,16 @@ _cluster_add_node(mongoc_cluster_t *cluster,
       GOTO(error);
    }
 
+   /* Limit concurrent connection establishment to this server across all
+    * clients of the pool, so a failover does not trigger a handshake storm. */
+   if (!_mongoc_topology_connecting_begin(cluster->client->topology, server_id, error)) {
+      GOTO(error);
+   }
+   connecting = true;
+
+   /* Measured after the maxConnecting wait, which is not part of the connection's own latency. */
+   connect_started = bson_get_monotonic_time();
+
    TRACE("Adding new server to cluster: %s", host->host_and_port);
 
    stream = _mongoc_client_create_stream(cluster->client, host, error);
@@ -2092,6 +2232,8 @@ _cluster_add_node(mongoc_cluster_t *cluster,
    /* take critical fields from a fresh hello */
    cluster_node = _mongoc_cluster_node_new(stream, host->host_and_port);
    cluster_node->oidc_connection_cache = mongoc_oidc_connection_cache_new();
+   cluster_node->wire_stats =
+      _mongoc_wire_stats_get_server(cluster->client->topology->wire_stats, td, server_id, host->host_and_port);
 
    handshake_sd =
       _cluster_run_hello(cluster, cluster_node, server_id, &scram, &speculative_auth_response, reply, error);
@@ -2129,6 +2271,8 @@ _cluster_add_node(mongoc_cluster_t *cluster,
    bson_destroy(&speculative_auth_response);
    mongoc_set_add(cluster->nodes, server_id, cluster_node);
    _mongoc_host_list_destroy_all(host);
+   _mongoc_topology_connecting_end(cluster->client->topology, server_id);
+   mongoc_histogram_connect_handshake_record(bson_get_monotonic_time() - connect_started);
 
 #ifdef MONGOC_ENABLE_CRYPTO
    _mongoc_scram_destroy(&scram);
@@ -2148,6 +2292,12 @@ error:
       _mongoc_cluster_node_destroy(cluster_node); /* also destroys stream */
    }
 
+   if (connecting) {
+      /* after the error handling above, so waiters see the server marked
+       * unknown */
+      _mongoc_topology_connecting_end(cluster->client->topology, server_id);
+   }
+
    if (!reply_initialized && reply) {
       bson_init(reply);
    }
@@ -2225,9 +2375,13 @@ _mongoc_cluster_stream_for_server(mongoc_cluster_t *cluster,
     * them to mongoc_topology_description_invalidate_server. */
    bson_error_t *err_ptr = error ? error : &err_local;
    mc_shared_tpld td;
+   const bool collect_phases = mongoc_log_and_monitor_instance_collects_command_phases(&topology->log_and_monitor);
+   const int64_t started = collect_phases ? bson_get_monotonic_time() : 0;
 
    ENTRY;
 
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CLUSTER);
+
    td = mc_tpld_take_ref(topology);
 
    if (cluster->client->topology->single_threaded) {
@@ -2262,8 +2416,13 @@ _mongoc_cluster_stream_for_server(mongoc_cluster_t *cluster,
       }
    }
 
+   if (collect_phases) {
+      ret_server_stream->checkout_usec = bson_get_monotonic_time() - started;
+   }
+
 done:
    mc_tpld_drop_ref(&td);
+   _mongoc_alloc_tag_pop(alloc_tag);
    RETURN(ret_server_stream);
 }
 
@@ -2325,6 +2484,7 @@ _cluster_fetch_stream_single(mongoc_cluster_t *cluster,
 {
    mongoc_server_description_t *handshake_sd;
    mongoc_topology_scanner_node_t *scanner_node;
+   mongoc_server_stream_t *server_stream;
    char *address;
 
    scanner_node = mongoc_topology_scanner_get_node(cluster->client->topology->scanner, server_id);
@@ -2421,7 +2581,15 @@ _cluster_fetch_stream_single(mongoc_cluster_t *cluster,
     * TODO (CDRIVER-4078) do not store the generation counter on the server
     * description */
    handshake_sd->generation = _mongoc_topology_get_connection_pool_generation(td, server_id, &handshake_sd->service_id);
-   return mongoc_server_stream_new(td, handshake_sd, scanner_node->stream);
+
+   if (!scanner_node->wire_stats) {
+      scanner_node->wire_stats = _mongoc_wire_stats_get_server(
+         cluster->client->topology->wire_stats, td, server_id, scanner_node->host.host_and_port);
+   }
+
+   server_stream = mongoc_server_stream_new(td, handshake_sd, scanner_node->stream);
+   server_stream->wire_stats = scanner_node->wire_stats;
+   return server_stream;
 }
 
 
@@ -2500,6 +2668,7 @@ _cluster_fetch_stream_pooled(mongoc_cluster_t *cluster,
 {
    mongoc_cluster_node_t *cluster_node;
    mongoc_server_description_t const *sd;
+   mongoc_server_stream_t *server_stream;
    bool has_server_description = false;
 
    cluster_node = (mongoc_cluster_node_t *)mongoc_set_get(cluster->nodes, server_id);
@@ -2527,7 +2696,9 @@ _cluster_fetch_stream_pooled(mongoc_cluster_t *cluster,
           */
          mongoc_cluster_disconnect_node(cluster, server_id);
       } else {
-         return _mongoc_cluster_create_server_stream(td, cluster_node->handshake_sd, cluster_node->stream);
+         server_stream = _mongoc_cluster_create_server_stream(td, cluster_node->handshake_sd, cluster_node->stream);
+         server_stream->wire_stats = cluster_node->wire_stats;
+         return server_stream;
       }
    }
 
@@ -2540,7 +2711,9 @@ _cluster_fetch_stream_pooled(mongoc_cluster_t *cluster,
 
    cluster_node = _cluster_add_node(cluster, td, server_id, reply, error);
    if (cluster_node) {
-      return _mongoc_cluster_create_server_stream(td, cluster_node->handshake_sd, cluster_node->stream);
+      server_stream = _mongoc_cluster_create_server_stream(td, cluster_node->handshake_sd, cluster_node->stream);
+      server_stream->wire_stats = cluster_node->wire_stats;
+      return server_stream;
    } else {
       return NULL;
    }
@@ -2726,6 +2899,9 @@ _mongoc_cluster_stream_for_optype(mongoc_cluster_t *cluster,
    uint32_t server_id;
    mongoc_topology_t *topology = cluster->client->topology;
    bool must_use_primary = false;
+   const bool collect_phases = mongoc_log_and_monitor_instance_collects_command_phases(&topology->log_and_monitor);
+   const int64_t selection_started = collect_phases ? bson_get_monotonic_time() : 0;
+   int64_t selection_usec = -1;
 
    ENTRY;
 
@@ -2756,6 +2932,10 @@ _mongoc_cluster_stream_for_optype(mongoc_cluster_t *cluster,
       }
    }
 
+   if (collect_phases) {
+      selection_usec = bson_get_monotonic_time() - selection_started;
+   }
+
    bson_t first_reply;
    bson_error_t first_error = {0};
 
@@ -2764,6 +2944,7 @@ _mongoc_cluster_stream_for_optype(mongoc_cluster_t *cluster,
 
    if (server_stream) {
       server_stream->must_use_primary = must_use_primary;
+      server_stream->selection_usec = selection_usec;
       RETURN(server_stream);
    }
 
@@ -2781,6 +2962,7 @@ _mongoc_cluster_stream_for_optype(mongoc_cluster_t *cluster,
       if (server_stream) {
          server_stream->must_use_primary = must_use_primary;
          server_stream->retry_attempted = true;
+         server_stream->selection_usec = selection_usec;
          bson_destroy(&first_reply);
          RETURN(server_stream);
       }
@@ -3103,26 +3285,52 @@ mongoc_cluster_check_interval(mongoc_cluster_t *cluster, uint32_t server_id)
    return r;
 }
 
+/* Returns the current time, or 0 without reading the clock if @phases are not being collected. */
+static int64_t
+_phases_now(const mongoc_apm_command_phases_t *phases)
+{
+   return phases ? bson_get_monotonic_time() : 0;
+}
+
+static void
+_phases_set(mongoc_apm_command_phases_t *phases, mongoc_apm_command_phase_t phase, int64_t usec)
+{
+   if (phases) {
+      phases->usec[phase] = usec;
+   }
+}
+
 /**
  * @param reply is a required out-param. `*reply` is only initialized on error.
+ * @param phases is an optional out-param for the durations of the framing, compression and write phases.
+ * @param wire is a required out-param for the size of the message, set if it was written.
  */
 static bool
-_mongoc_cluster_run_opmsg_send(
-   mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, mcd_rpc_message *rpc, bson_t *reply, bson_error_t *error)
+_mongoc_cluster_run_opmsg_send(mongoc_cluster_t *cluster,
+                               const mongoc_cmd_t *cmd,
+                               mcd_rpc_message *rpc,
+                               bson_t *reply,
+                               bson_error_t *error,
+                               mongoc_apm_command_phases_t *phases,
+                               mongoc_wire_stats_values_t *wire)
 {
    BSON_ASSERT_PARAM(cluster);
    BSON_ASSERT_PARAM(cmd);
    BSON_ASSERT_PARAM(rpc);
    BSON_ASSERT_PARAM(reply);
    BSON_ASSERT_PARAM(error);
+   BSON_OPTIONAL_PARAM(phases);
+   BSON_ASSERT_PARAM(wire);
 
    mongoc_server_stream_t *const server_stream = cmd->server_stream;
+   int64_t phase_started = _phases_now(phases);
 
    const uint32_t flags = (cmd->is_acknowledged ? MONGOC_OP_MSG_FLAG_NONE : MONGOC_OP_MSG_FLAG_MORE_TO_COME) |
                           (cmd->op_msg_is_exhaust ? MONGOC_OP_MSG_FLAG_EXHAUST_ALLOWED : MONGOC_OP_MSG_FLAG_NONE);
 
+   int32_t message_length = 0;
+
    {
-      int32_t message_length = 0;
 
       message_length += mcd_rpc_header_set_message_length(rpc, 0);
       message_length += mcd_rpc_header_set_request_id(rpc, ++cluster->request_id);
@@ -3156,6 +3364,12 @@ _mongoc_cluster_run_opmsg_send(
       mcd_rpc_message_set_length(rpc, message_length);
    }
 
+   {
+      const int64_t now = _phases_now(phases);
+      _phases_set(phases, MONGOC_APM_COMMAND_PHASE_ASSEMBLE, now - phase_started);
+      phase_started = now;
+   }
+
    void *compressed_data = NULL;
    size_t compressed_data_len = 0u;
 
@@ -3175,17 +3389,35 @@ _mongoc_cluster_run_opmsg_send(
          server_stream->stream = NULL;
          return false;
       }
+
+      if (compressor_id != -1) {
+         const int64_t now = _phases_now(phases);
+         _phases_set(phases, MONGOC_APM_COMMAND_PHASE_COMPRESS, now - phase_started);
+         phase_started = now;
+      }
    }
 
+   // Read before the header is converted to little endian for the wire.
+   const int32_t wire_length = mcd_rpc_header_get_message_length(rpc);
+
    size_t num_iovecs = 0u;
-   mongoc_iovec_t *const iovecs = mcd_rpc_message_to_iovecs(rpc, &num_iovecs);
+   mongoc_iovec_t *const iovecs = mcd_rpc_message_to_compact_iovecs(rpc, &num_iovecs);
    BSON_ASSERT(iovecs);
 
    mcd_rpc_message_egress(rpc);
    const bool res =
       _mongoc_stream_writev_full(server_stream->stream, iovecs, num_iovecs, cluster->sockettimeoutms, error);
+   _phases_set(phases, MONGOC_APM_COMMAND_PHASE_WRITE, _phases_now(phases) - phase_started);
+
+   if (res) {
+      wire->messages_out = 1;
+      wire->bytes_out = wire_length;
 
-   if (!res) {
+      if (compressed_data) {
+         wire->compressed_bytes_out = wire_length;
+         wire->uncompressed_bytes_out = message_length;
+      }
+   } else {
       RUN_CMD_ERR_DECORATE;
       _handle_network_error(cluster, cmd, reply, error);
       server_stream->stream = NULL;
@@ -3199,18 +3431,29 @@ _mongoc_cluster_run_opmsg_send(
 
 /**
  * @param reply is a required out-param. `*reply` is always initialized upon return.
+ * @param phases is an optional out-param for the durations of the read, decompression and parsing phases.
+ * @param wire is a required out-param for the size of the reply, set if it was read and decompressed.
  */
 static bool
-_mongoc_cluster_run_opmsg_recv(
-   mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, mcd_rpc_message *rpc, bson_t *reply, bson_error_t *error)
+_mongoc_cluster_run_opmsg_recv(mongoc_cluster_t *cluster,
+                               const mongoc_cmd_t *cmd,
+                               mcd_rpc_message *rpc,
+                               bson_t *reply,
+                               bson_error_t *error,
+                               mongoc_apm_command_phases_t *phases,
+                               mongoc_wire_stats_values_t *wire)
 {
    BSON_ASSERT_PARAM(cluster);
    BSON_ASSERT_PARAM(cmd);
    BSON_ASSERT_PARAM(rpc);
    BSON_ASSERT_PARAM(reply);
    BSON_ASSERT_PARAM(error);
+   BSON_OPTIONAL_PARAM(phases);
+   BSON_ASSERT_PARAM(wire);
 
    bool ret = false;
+   int64_t phase_started = _phases_now(phases);
+   int64_t parse_usec = 0;
 
    mongoc_server_stream_t *const server_stream = cmd->server_stream;
 
@@ -3226,6 +3469,12 @@ _mongoc_cluster_run_opmsg_recv(
       goto done;
    }
 
+   {
+      const int64_t now = _phases_now(phases);
+      _phases_set(phases, MONGOC_APM_COMMAND_PHASE_WAIT_FIRST_BYTE, now - phase_started);
+      phase_started = now;
+   }
+
    const int32_t message_length = mlib_read_i32le(buffer.data);
 
    if (message_length < message_header_length || message_length > server_stream->sd->max_msg_size) {
@@ -3250,6 +3499,12 @@ _mongoc_cluster_run_opmsg_recv(
       goto done;
    }
 
+   {
+      const int64_t now = _phases_now(phases);
+      _phases_set(phases, MONGOC_APM_COMMAND_PHASE_READ_BODY, now - phase_started);
+      phase_started = now;
+   }
+
    if (!mcd_rpc_message_from_data_in_place(rpc, buffer.data, buffer.len, NULL)) {
       RUN_CMD_ERR(MONGOC_ERROR_PROTOCOL, MONGOC_ERROR_PROTOCOL_INVALID_REPLY, "malformed server message");
       _handle_network_error(cluster, cmd, reply, error);
@@ -3258,6 +3513,12 @@ _mongoc_cluster_run_opmsg_recv(
    }
    mcd_rpc_message_ingress(rpc);
 
+   {
+      const int64_t now = _phases_now(phases);
+      parse_usec += now - phase_started;
+      phase_started = now;
+   }
+
    void *decompressed_data = NULL;
    size_t decompressed_data_len = 0u;
 
@@ -3269,7 +3530,17 @@ _mongoc_cluster_run_opmsg_recv(
       GOTO(done);
    }
 
+   wire->messages_in = 1;
+   wire->bytes_in = message_length;
+
    if (decompressed_data) {
+      const int64_t now = _phases_now(phases);
+      _phases_set(phases, MONGOC_APM_COMMAND_PHASE_DECOMPRESS, now - phase_started);
+      phase_started = now;
+
+      wire->compressed_bytes_in = message_length;
+      wire->uncompressed_bytes_in = (int64_t)decompressed_data_len;
+
       _mongoc_buffer_destroy(&buffer);
       _mongoc_buffer_init(&buffer, decompressed_data, decompressed_data_len, NULL, NULL);
    }
@@ -3311,6 +3582,8 @@ _mongoc_cluster_run_opmsg_recv(
    bson_copy_to(&body, reply);
    bson_destroy(&body);
 
+   _phases_set(phases, MONGOC_APM_COMMAND_PHASE_PARSE_REPLY, parse_usec + _phases_now(phases) - phase_started);
+
 done:
    _mongoc_buffer_destroy(&buffer);
 
@@ -3321,7 +3594,11 @@ done:
  * @param reply is a required out-param. `*reply` is always initialized upon return.
  */
 static bool
-mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, bson_t *reply, bson_error_t *error)
+mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster,
+                         const mongoc_cmd_t *cmd,
+                         bson_t *reply,
+                         bson_error_t *error,
+                         mongoc_apm_command_phases_t *phases)
 {
    BSON_ASSERT_PARAM(cluster);
    BSON_ASSERT_PARAM(cmd);
@@ -3344,10 +3621,13 @@ mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, bso
    }
 
    bool ret = false;
+   mongoc_wire_stats_values_t wire = {0};
+   const int64_t sent_at = bson_get_monotonic_time();
 
    mcd_rpc_message *const rpc = mcd_rpc_message_new();
 
-   if (!cluster->client->in_exhaust && !_mongoc_cluster_run_opmsg_send(cluster, cmd, rpc, reply, error)) {
+   if (!cluster->client->in_exhaust &&
+       !_mongoc_cluster_run_opmsg_send(cluster, cmd, rpc, reply, error, phases, &wire)) {
       goto done;
    }
 
@@ -3360,7 +3640,7 @@ mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, bso
 
    mcd_rpc_message_reset(rpc);
 
-   if (!_mongoc_cluster_run_opmsg_recv(cluster, cmd, rpc, reply, error)) {
+   if (!_mongoc_cluster_run_opmsg_recv(cluster, cmd, rpc, reply, error, phases, &wire)) {
       goto done;
    }
 
@@ -3369,6 +3649,13 @@ mongoc_cluster_run_opmsg(mongoc_cluster_t *cluster, const mongoc_cmd_t *cmd, bso
 done:
    mcd_rpc_message_destroy(rpc);
 
+   // Network and protocol errors invalidate the stream; errors reported by the server do not.
+   if (!cmd->server_stream->stream) {
+      wire.errors = 1;
+   }
+
+   _mongoc_cluster_record_wire_stats(cluster, cmd, &wire, sent_at);
+
    return ret;
 }
 
@@ -77,6 +77,7 @@ typedef struct _mongoc_cmd_t {
    bool is_acknowledged;
    bool is_txn_finish;
    bool op_msg_is_exhaust;
+   int64_t assemble_usec; // Time spent in mongoc_cmd_parts_assemble, or -1 if not measured.
 } mongoc_cmd_t;
 
 
@@ -63,6 +63,7 @@ mongoc_cmd_parts_init(mongoc_cmd_parts_t *parts,
    parts->assembled.session = NULL;
    parts->assembled.is_acknowledged = true;
    parts->assembled.is_txn_finish = false;
+   parts->assembled.assemble_usec = -1;
 }
 
 
@@ -716,6 +717,10 @@ mongoc_cmd_parts_assemble(mongoc_cmd_parts_t *parts, mongoc_server_stream_t *ser
    BSON_ASSERT(parts);
    BSON_ASSERT(server_stream);
 
+   const bool collect_phases =
+      mongoc_log_and_monitor_instance_collects_command_phases(&parts->client->topology->log_and_monitor);
+   const int64_t started = collect_phases ? bson_get_monotonic_time() : 0;
+
    server_type = server_stream->sd->type;
 
    cs = parts->prohibit_lsid ? NULL : parts->assembled.session;
@@ -908,6 +913,7 @@ mongoc_cmd_parts_assemble(mongoc_cmd_parts_t *parts, mongoc_server_stream_t *ser
 
 done:
    mongoc_read_prefs_destroy(prefs);
+   parts->assembled.assemble_usec = collect_phases ? bson_get_monotonic_time() - started : -1;
    RETURN(ret);
 }
 
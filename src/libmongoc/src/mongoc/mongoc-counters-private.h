@@ -213,6 +213,195 @@ enum {
 #undef COUNTER
 #endif
 
+
+/*
+ * Latency histograms.
+ *
+ * Values are recorded in microseconds into log-linear buckets: values below
+ * 2^MONGOC_HISTOGRAM_SUB_BUCKET_BITS get a bucket each, and every following
+ * power of two is split into 2^MONGOC_HISTOGRAM_SUB_BUCKET_BITS buckets, which
+ * bounds the relative error of a bucket to 12.5%. The last bucket also holds
+ * every value of 2^32 microseconds (~71 minutes) or more.
+ *
+ * Like counters, each CPU has its own set of buckets so recording is a single
+ * uncontended atomic add. Readers sum the buckets across CPUs.
+ */
+#define MONGOC_HISTOGRAM_SUB_BUCKET_BITS 3
+#define MONGOC_HISTOGRAM_SUB_BUCKETS (1 << MONGOC_HISTOGRAM_SUB_BUCKET_BITS)
+#define MONGOC_HISTOGRAM_N_BUCKETS ((32 - MONGOC_HISTOGRAM_SUB_BUCKET_BITS + 1) * MONGOC_HISTOGRAM_SUB_BUCKETS)
+
+
+typedef struct {
+   int64_t buckets[MONGOC_HISTOGRAM_N_BUCKETS];
+   int64_t sum;
+   int64_t padding[15];
+} mongoc_histogram_slots_t;
+
+
+typedef struct {
+   mongoc_histogram_slots_t *cpus;
+} mongoc_histogram_t;
+
+
+#define HISTOGRAM(ident, Category, Name, Description) extern mongoc_histogram_t __mongoc_histogram_##ident;
+#include <mongoc/mongoc-histograms.defs>
+#undef HISTOGRAM
+
+
+enum {
+#define HISTOGRAM(ident, Category, Name, Description) HISTOGRAM_##ident,
+#include <mongoc/mongoc-histograms.defs>
+#undef HISTOGRAM
+   LAST_HISTOGRAM
+};
+
+
+/* Returns the bucket index for @usec. Negative values go to the first bucket. */
+static BSON_INLINE uint32_t
+_mongoc_histogram_bucket(int64_t usec)
+{
+   uint64_t v;
+   uint32_t exp;
+   uint32_t idx;
+
+   if (usec < MONGOC_HISTOGRAM_SUB_BUCKETS) {
+      return usec < 0 ? 0u : (uint32_t)usec;
+   }
+
+   v = (uint64_t)usec;
+#if defined(__GNUC__) || defined(__clang__)
+   exp = 63u - (uint32_t)__builtin_clzll(v);
+#else
+   exp = 0;
+   while (v >> (exp + 1)) {
+      exp++;
+   }
+#endif
+
+   idx = (exp - MONGOC_HISTOGRAM_SUB_BUCKET_BITS + 1) * MONGOC_HISTOGRAM_SUB_BUCKETS +
+         (uint32_t)(v >> (exp - MONGOC_HISTOGRAM_SUB_BUCKET_BITS)) - MONGOC_HISTOGRAM_SUB_BUCKETS;
+
+   return idx < MONGOC_HISTOGRAM_N_BUCKETS ? idx : MONGOC_HISTOGRAM_N_BUCKETS - 1;
+}
+
+
+/* Returns the smallest value recorded into bucket @idx. */
+static BSON_INLINE int64_t
+_mongoc_histogram_bucket_lower(uint32_t idx)
+{
+   if (idx < MONGOC_HISTOGRAM_SUB_BUCKETS) {
+      return (int64_t)idx;
+   }
+
+   return (int64_t)(MONGOC_HISTOGRAM_SUB_BUCKETS + idx % MONGOC_HISTOGRAM_SUB_BUCKETS)
+          << (idx / MONGOC_HISTOGRAM_SUB_BUCKETS - 1);
+}
+
+
+void
+_mongoc_histogram_record_command_rtt(const char *command_name, int64_t usec);
+
+
+/*
+ * Per-server wire statistics.
+ *
+ * The segment ends with MONGOC_COUNTERS_N_SERVERS server names, each claimed
+ * by a host and port the first time the process connects to that server,
+ * followed by the values of each server, one slot per CPU. A server's slots
+ * add up the traffic of every client and client pool in the process. Once all
+ * names are claimed, further servers are not exported.
+ */
+#define MONGOC_COUNTERS_N_SERVERS 64
+
+
+typedef struct {
+   int64_t messages_out;
+   int64_t messages_in;
+   int64_t bytes_out;
+   int64_t bytes_in;
+   /* Wire size of compressed messages, and their size before compression. */
+   int64_t compressed_bytes_out;
+   int64_t uncompressed_bytes_out;
+   int64_t compressed_bytes_in;
+   int64_t uncompressed_bytes_in;
+   /* Time from sending a command until its reply was read. */
+   int64_t in_flight_usec;
+   /* Network and protocol errors, which close the connection. */
+   int64_t errors;
+} mongoc_wire_stats_values_t;
+
+
+/* One CPU's share of a server's wire statistics. Padded to two cache lines, so
+ * threads on different CPUs do not contend for them. */
+typedef struct {
+   mongoc_wire_stats_values_t values;
+   int64_t padding[6];
+} mongoc_wire_stats_slot_t;
+
+
+typedef struct {
+   char host_and_port[64];
+} mongoc_counters_server_t;
+
+
+/* Returns the _mongoc_get_cpu_count() slots of @host_and_port, claiming a free
+ * name on first use, or NULL if all names are taken or counters are disabled.
+ * Hosts longer than the name are truncated. */
+mongoc_wire_stats_slot_t *
+_mongoc_counters_server(const char *host_and_port);
+
+
+#ifdef MONGOC_ENABLE_SHM_COUNTERS
+#define HISTOGRAM(ident, Category, Name, Description)                                                          \
+   static BSON_INLINE void mongoc_histogram_##ident##_record(int64_t usec)                                     \
+   {                                                                                                           \
+      mongoc_histogram_slots_t *slots = &BSON_CONCAT(__mongoc_histogram_, ident).cpus[_mongoc_sched_getcpu()]; \
+      mcommon_atomic_int64_fetch_add(                                                                          \
+         &slots->buckets[_mongoc_histogram_bucket(usec)], 1, mcommon_memory_order_relaxed);                    \
+      mcommon_atomic_int64_fetch_add(&slots->sum, usec, mcommon_memory_order_relaxed);                         \
+   }                                                                                                           \
+   static BSON_INLINE int64_t mongoc_histogram_##ident##_bucket_count(uint32_t idx)                            \
+   {                                                                                                           \
+      int64_t _sum = 0;                                                                                        \
+      uint32_t _i;                                                                                             \
+      for (_i = 0; _i < _mongoc_get_cpu_count(); _i++) {                                                       \
+         _sum += mcommon_atomic_int64_fetch(&BSON_CONCAT(__mongoc_histogram_, ident).cpus[_i].buckets[idx],    \
+                                            mcommon_memory_order_relaxed);                                     \
+      }                                                                                                        \
+      return _sum;                                                                                             \
+   }                                                                                                           \
+   static BSON_INLINE int64_t mongoc_histogram_##ident##_count(void)                                           \
+   {                                                                                                           \
+      int64_t _sum = 0;                                                                                        \
+      uint32_t _i;                                                                                             \
+      for (_i = 0; _i < MONGOC_HISTOGRAM_N_BUCKETS; _i++) {                                                    \
+         _sum += mongoc_histogram_##ident##_bucket_count(_i);                                                  \
+      }                                                                                                        \
+      return _sum;                                                                                             \
+   }
+#include <mongoc/mongoc-histograms.defs>
+#undef HISTOGRAM
+
+#else
+/* when counters are disabled, these functions are no-ops */
+#define HISTOGRAM(ident, Category, Name, Description)                               \
+   static BSON_INLINE void mongoc_histogram_##ident##_record(int64_t usec)          \
+   {                                                                                \
+      (void)usec;                                                                   \
+   }                                                                                \
+   static BSON_INLINE int64_t mongoc_histogram_##ident##_bucket_count(uint32_t idx) \
+   {                                                                                \
+      (void)idx;                                                                    \
+      return 0;                                                                     \
+   }                                                                                \
+   static BSON_INLINE int64_t mongoc_histogram_##ident##_count(void)                \
+   {                                                                                \
+      return 0;                                                                     \
+   }
+#include <mongoc/mongoc-histograms.defs>
+#undef HISTOGRAM
+#endif
+
 BSON_END_DECLS
 
 
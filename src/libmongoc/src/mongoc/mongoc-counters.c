@@ -35,6 +35,7 @@
 #endif
 
 #include <common-atomic-private.h>
+#include <common-thread-private.h>
 #include <mongoc/mongoc-counters-private.h>
 
 #include <mongoc/mongoc-log.h>
@@ -54,6 +55,22 @@ typedef struct {
 BSON_STATIC_ASSERT2(counter_info_t, sizeof(mongoc_counter_info_t) == 128);
 
 
+#pragma pack(1)
+typedef struct {
+   uint32_t offset;
+   uint16_t n_buckets;
+   uint16_t sub_bucket_bits;
+   char category[24];
+   char name[32];
+   char description[64];
+} mongoc_histogram_info_t;
+#pragma pack()
+
+
+BSON_STATIC_ASSERT2(histogram_info_t, sizeof(mongoc_histogram_info_t) == 128);
+BSON_STATIC_ASSERT2(histogram_slots_t, sizeof(mongoc_histogram_slots_t) % 64 == 0);
+
+
 #pragma pack(1)
 typedef struct {
    uint32_t size;
@@ -61,12 +78,24 @@ typedef struct {
    uint32_t n_counters;
    uint32_t infos_offset;
    uint32_t values_offset;
-   uint8_t padding[44];
+   /* Histograms were added after counters. Readers that predate them only
+    * look at the fields above, so they must stay where they are. */
+   uint32_t n_histograms;
+   uint32_t histogram_infos_offset;
+   uint32_t histogram_values_offset;
+   /* Per-server slots were added after histograms. n_servers is the number of
+    * claimed names. */
+   uint32_t n_servers;
+   uint32_t servers_offset;
+   uint32_t server_values_offset;
+   uint8_t padding[20];
 } mongoc_counters_t;
 #pragma pack()
 
 
 BSON_STATIC_ASSERT2(counters_t, sizeof(mongoc_counters_t) == 64);
+BSON_STATIC_ASSERT2(counters_server_t, sizeof(mongoc_counters_server_t) == 64);
+BSON_STATIC_ASSERT2(wire_stats_slot_t, sizeof(mongoc_wire_stats_slot_t) == 128);
 
 #ifdef MONGOC_ENABLE_SHM_COUNTERS
 /* When counters are enabled at compile time but fail to initiate a shared
@@ -76,10 +105,19 @@ BSON_STATIC_ASSERT2(counters_t, sizeof(mongoc_counters_t) == 64);
  * for whether or not initiating the shared memory segment succeeded. */
 static void *gCounterFallback = NULL;
 
+static mongoc_counters_t *gCounters = NULL;
+
+/* Serializes claiming per-server slots. */
+static bson_mutex_t gServersMutex;
+
 #define COUNTER(ident, Category, Name, Description) mongoc_counter_t __mongoc_counter_##ident;
 #include <mongoc/mongoc-counters.defs>
 #undef COUNTER
 
+#define HISTOGRAM(ident, Category, Name, Description) mongoc_histogram_t __mongoc_histogram_##ident;
+#include <mongoc/mongoc-histograms.defs>
+#undef HISTOGRAM
+
 /**
  * mongoc_counters_use_shm:
  *
@@ -113,6 +151,9 @@ mongoc_counters_calc_size(void)
    n_groups = (LAST_COUNTER / SLOTS_PER_CACHELINE) + 1;
    size = (sizeof(mongoc_counters_t) + (LAST_COUNTER * sizeof(mongoc_counter_info_t)) +
            (n_cpu * n_groups * sizeof(mongoc_counter_slots_t)));
+   size += (LAST_HISTOGRAM * sizeof(mongoc_histogram_info_t)) +
+           (LAST_HISTOGRAM * n_cpu * sizeof(mongoc_histogram_slots_t));
+   size += MONGOC_COUNTERS_N_SERVERS * (sizeof(mongoc_counters_server_t) + n_cpu * sizeof(mongoc_wire_stats_slot_t));
 
 #ifdef BSON_OS_UNIX
    const long pg_sz = sysconf(_SC_PAGESIZE);
@@ -138,6 +179,9 @@ void
 _mongoc_counters_cleanup(void)
 {
 #ifdef MONGOC_ENABLE_SHM_COUNTERS
+   gCounters = NULL;
+   bson_mutex_destroy(&gServersMutex);
+
    if (gCounterFallback) {
       bson_free(gCounterFallback);
       gCounterFallback = NULL;
@@ -283,8 +327,86 @@ mongoc_counters_register(
 
    return infos->offset;
 }
+
+
+/**
+ * mongoc_counters_register_histogram:
+ * @counters: A mongoc_counter_t.
+ * @num: The histogram number.
+ * @category: The histogram category.
+ * @name: The histogram name.
+ * @description The histogram description.
+ *
+ * Registers a new histogram in the memory segment for counters. Each
+ * histogram is followed by one mongoc_histogram_slots_t per CPU.
+ *
+ * Returns: The offset to the data for the histogram buckets.
+ */
+static size_t
+mongoc_counters_register_histogram(
+   mongoc_counters_t *counters, uint32_t num, const char *category, const char *name, const char *description)
+{
+   mongoc_histogram_info_t *infos;
+   char *segment;
+   size_t n_cpu;
+
+   BSON_ASSERT(counters);
+   BSON_ASSERT(category);
+   BSON_ASSERT(name);
+   BSON_ASSERT(description);
+
+   n_cpu = _mongoc_get_cpu_count();
+   segment = (char *)counters;
+
+   infos = (mongoc_histogram_info_t *)(segment + counters->histogram_infos_offset);
+   infos = &infos[counters->n_histograms];
+   infos->offset = (uint32_t)(counters->histogram_values_offset + (num * n_cpu * sizeof(mongoc_histogram_slots_t)));
+   infos->n_buckets = MONGOC_HISTOGRAM_N_BUCKETS;
+   infos->sub_bucket_bits = MONGOC_HISTOGRAM_SUB_BUCKET_BITS;
+
+   bson_strncpy(infos->category, category, sizeof infos->category);
+   bson_strncpy(infos->name, name, sizeof infos->name);
+   bson_strncpy(infos->description, description, sizeof infos->description);
+
+   /* As with counters, publish the histogram only once it is initialized. */
+   mcommon_atomic_thread_fence();
+
+   counters->n_histograms++;
+
+   return infos->offset;
+}
 #endif
 
+
+void
+_mongoc_histogram_record_command_rtt(const char *command_name, int64_t usec)
+{
+#ifdef MONGOC_ENABLE_SHM_COUNTERS
+   BSON_ASSERT_PARAM(command_name);
+
+   if (!strcmp(command_name, "find")) {
+      mongoc_histogram_cmd_rtt_find_record(usec);
+   } else if (!strcmp(command_name, "getMore")) {
+      mongoc_histogram_cmd_rtt_getmore_record(usec);
+   } else if (!strcmp(command_name, "aggregate")) {
+      mongoc_histogram_cmd_rtt_aggregate_record(usec);
+   } else if (!strcmp(command_name, "insert")) {
+      mongoc_histogram_cmd_rtt_insert_record(usec);
+   } else if (!strcmp(command_name, "update")) {
+      mongoc_histogram_cmd_rtt_update_record(usec);
+   } else if (!strcmp(command_name, "delete")) {
+      mongoc_histogram_cmd_rtt_delete_record(usec);
+   } else if (!strcmp(command_name, "findAndModify")) {
+      mongoc_histogram_cmd_rtt_find_and_modify_record(usec);
+   } else {
+      mongoc_histogram_cmd_rtt_other_record(usec);
+   }
+#else
+   BSON_UNUSED(command_name);
+   BSON_UNUSED(usec);
+#endif
+}
+
 /**
  * mongoc_counters_init:
  *
@@ -314,12 +436,36 @@ _mongoc_counters_init(void)
 
    BSON_ASSERT((counters->values_offset % 64) == 0);
 
+   counters->n_histograms = 0;
+   counters->histogram_infos_offset =
+      (uint32_t)(counters->values_offset +
+                 (counters->n_cpu * ((LAST_COUNTER / SLOTS_PER_CACHELINE) + 1) * sizeof(mongoc_counter_slots_t)));
+   counters->histogram_values_offset =
+      (uint32_t)(counters->histogram_infos_offset + (LAST_HISTOGRAM * sizeof(mongoc_histogram_info_t)));
+
+   BSON_ASSERT((counters->histogram_values_offset % 64) == 0);
+
+   counters->n_servers = 0;
+   counters->servers_offset =
+      (uint32_t)(counters->histogram_values_offset + (LAST_HISTOGRAM * counters->n_cpu * sizeof(mongoc_histogram_slots_t)));
+   counters->server_values_offset =
+      (uint32_t)(counters->servers_offset + (MONGOC_COUNTERS_N_SERVERS * sizeof(mongoc_counters_server_t)));
+
+   BSON_ASSERT((counters->servers_offset % 64) == 0);
+   BSON_ASSERT((counters->server_values_offset % 64) == 0);
+
 #define COUNTER(ident, Category, Name, Desc)                                        \
    off = mongoc_counters_register(counters, COUNTER_##ident, Category, Name, Desc); \
    __mongoc_counter_##ident.cpus = (mongoc_counter_slots_t *)(segment + off);
 #include <mongoc/mongoc-counters.defs>
 #undef COUNTER
 
+#define HISTOGRAM(ident, Category, Name, Desc)                                                \
+   off = mongoc_counters_register_histogram(counters, HISTOGRAM_##ident, Category, Name, Desc); \
+   __mongoc_histogram_##ident.cpus = (mongoc_histogram_slots_t *)(segment + off);
+#include <mongoc/mongoc-histograms.defs>
+#undef HISTOGRAM
+
    /*
     * NOTE:
     *
@@ -329,5 +475,59 @@ _mongoc_counters_init(void)
     */
    mcommon_atomic_thread_fence();
    counters->size = (uint32_t)size;
+
+   bson_mutex_init(&gServersMutex);
+   gCounters = counters;
+#endif
+}
+
+
+mongoc_wire_stats_slot_t *
+_mongoc_counters_server(const char *host_and_port)
+{
+#ifdef MONGOC_ENABLE_SHM_COUNTERS
+   mongoc_counters_server_t *servers;
+   mongoc_wire_stats_slot_t *values;
+   mongoc_wire_stats_slot_t *ret = NULL;
+   char key[sizeof servers->host_and_port];
+
+   BSON_ASSERT_PARAM(host_and_port);
+
+   if (!gCounters) {
+      return NULL;
+   }
+
+   bson_strncpy(key, host_and_port, sizeof key);
+
+   bson_mutex_lock(&gServersMutex);
+
+   servers = (mongoc_counters_server_t *)((char *)gCounters + gCounters->servers_offset);
+   values = (mongoc_wire_stats_slot_t *)((char *)gCounters + gCounters->server_values_offset);
+
+   for (uint32_t i = 0; i < gCounters->n_servers; i++) {
+      if (0 == strcmp(servers[i].host_and_port, key)) {
+         ret = &values[i * gCounters->n_cpu];
+         goto done;
+      }
+   }
+
+   if (gCounters->n_servers < MONGOC_COUNTERS_N_SERVERS) {
+      ret = &values[gCounters->n_servers * gCounters->n_cpu];
+      bson_strncpy(servers[gCounters->n_servers].host_and_port, key, sizeof servers->host_and_port);
+
+      /* As with counters, publish the slot only once it is initialized. */
+      mcommon_atomic_thread_fence();
+
+      gCounters->n_servers++;
+   }
+
+done:
+   bson_mutex_unlock(&gServersMutex);
+
+   return ret;
+#else
+   BSON_UNUSED(host_and_port);
+
+   return NULL;
 #endif
 }
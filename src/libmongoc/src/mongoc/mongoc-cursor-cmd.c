@@ -73,6 +73,14 @@ _get_next_batch(mongoc_cursor_t *cursor)
 }
 
 
+static mongoc_cursor_response_t *
+_get_response(mongoc_cursor_t *cursor)
+{
+   data_cmd_t *data = (data_cmd_t *)cursor->impl.data;
+   return &data->response;
+}
+
+
 static void
 _destroy(mongoc_cursor_impl_t *impl)
 {
@@ -114,6 +122,7 @@ _mongoc_cursor_cmd_new(mongoc_client_t *client,
    cursor->impl.prime = _prime;
    cursor->impl.pop_from_batch = _pop_from_batch;
    cursor->impl.get_next_batch = _get_next_batch;
+   cursor->impl.get_response = _get_response;
    cursor->impl.destroy = _destroy;
    cursor->impl.clone = _clone;
    cursor->impl.data = (void *)data;
@@ -0,0 +1,404 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-array-private.h>
+#include <mongoc/mongoc-cursor-private.h>
+#include <mongoc/mongoc-trace-private.h>
+
+#include <mongoc/mongoc.h>
+
+#include <string.h>
+
+#define NO_COLUMN SIZE_MAX
+
+typedef enum {
+   COLUMN_INT64,
+   COLUMN_DOUBLE,
+   COLUMN_DATE_TIME,
+   COLUMN_TIMESTAMP,
+   COLUMN_UTF8,
+} column_type_t;
+
+typedef struct {
+   column_type_t type;
+   void *values;
+   void *aux; /* lengths of UTF-8 values, or increments of timestamps */
+   uint8_t *nulls;
+} column_t;
+
+/* one segment of a dotted path. documents are matched against the tree of
+ * segments, so each element of a document is visited at most once no matter
+ * how many columns are requested. */
+typedef struct {
+   char *key;
+   size_t key_len;
+   size_t column;           /* index into columns, or NO_COLUMN */
+   uint64_t seen;           /* serial of the last document this matched in */
+   mongoc_array_t children; /* of size_t indexes into nodes */
+} path_node_t;
+
+struct _mongoc_cursor_columns_t {
+   size_t max_rows;
+   uint64_t serial;
+   mongoc_array_t columns; /* of column_t */
+   mongoc_array_t nodes;   /* of path_node_t, nodes[0] is the root */
+};
+
+
+static size_t
+_add_node(mongoc_cursor_columns_t *columns, const char *key, size_t key_len)
+{
+   path_node_t node = {0};
+
+   node.key = bson_strndup(key, key_len);
+   node.key_len = key_len;
+   node.column = NO_COLUMN;
+   _mongoc_array_init(&node.children, sizeof(size_t));
+   _mongoc_array_append_val(&columns->nodes, node);
+
+   return columns->nodes.len - 1u;
+}
+
+
+static size_t
+_find_or_add_child(mongoc_cursor_columns_t *columns, size_t parent, const char *key, size_t key_len)
+{
+   path_node_t *node = &_mongoc_array_index(&columns->nodes, path_node_t, parent);
+   size_t child;
+
+   for (size_t i = 0; i < node->children.len; i++) {
+      child = _mongoc_array_index(&node->children, size_t, i);
+      const path_node_t *candidate = &_mongoc_array_index(&columns->nodes, path_node_t, child);
+      if (candidate->key_len == key_len && 0 == memcmp(candidate->key, key, key_len)) {
+         return child;
+      }
+   }
+
+   child = _add_node(columns, key, key_len);
+   /* adding a node may have moved the array. */
+   node = &_mongoc_array_index(&columns->nodes, path_node_t, parent);
+   _mongoc_array_append_val(&node->children, child);
+
+   return child;
+}
+
+
+static void
+_add_column(
+   mongoc_cursor_columns_t *columns, const char *path, column_type_t type, void *values, void *aux, uint8_t *nulls)
+{
+   size_t node_idx = 0;
+   const char *segment = path;
+   const char *dot;
+   path_node_t *node;
+   column_t column;
+
+   while ((dot = strchr(segment, '.'))) {
+      node_idx = _find_or_add_child(columns, node_idx, segment, (size_t)(dot - segment));
+      segment = dot + 1;
+   }
+
+   node_idx = _find_or_add_child(columns, node_idx, segment, strlen(segment));
+   node = &_mongoc_array_index(&columns->nodes, path_node_t, node_idx);
+   /* each path may only be added once. */
+   BSON_ASSERT(node->column == NO_COLUMN);
+   node->column = columns->columns.len;
+
+   column.type = type;
+   column.values = values;
+   column.aux = aux;
+   column.nulls = nulls;
+   _mongoc_array_append_val(&columns->columns, column);
+}
+
+
+mongoc_cursor_columns_t *
+mongoc_cursor_columns_new(size_t max_rows)
+{
+   mongoc_cursor_columns_t *columns;
+
+   BSON_ASSERT(max_rows > 0);
+
+   columns = BSON_ALIGNED_ALLOC0(mongoc_cursor_columns_t);
+   columns->max_rows = max_rows;
+   _mongoc_array_init(&columns->columns, sizeof(column_t));
+   _mongoc_array_init(&columns->nodes, sizeof(path_node_t));
+   _add_node(columns, "", 0);
+
+   return columns;
+}
+
+
+void
+mongoc_cursor_columns_destroy(mongoc_cursor_columns_t *columns)
+{
+   if (!columns) {
+      return;
+   }
+
+   for (size_t i = 0; i < columns->nodes.len; i++) {
+      path_node_t *node = &_mongoc_array_index(&columns->nodes, path_node_t, i);
+      bson_free(node->key);
+      _mongoc_array_destroy(&node->children);
+   }
+
+   _mongoc_array_destroy(&columns->nodes);
+   _mongoc_array_destroy(&columns->columns);
+   bson_free(columns);
+}
+
+
+void
+mongoc_cursor_columns_add_int64(mongoc_cursor_columns_t *columns, const char *path, int64_t *values, uint8_t *nulls)
+{
+   BSON_ASSERT_PARAM(columns);
+   BSON_ASSERT_PARAM(path);
+   BSON_ASSERT_PARAM(values);
+   BSON_OPTIONAL_PARAM(nulls);
+
+   _add_column(columns, path, COLUMN_INT64, values, NULL, nulls);
+}
+
+
+void
+mongoc_cursor_columns_add_double(mongoc_cursor_columns_t *columns, const char *path, double *values, uint8_t *nulls)
+{
+   BSON_ASSERT_PARAM(columns);
+   BSON_ASSERT_PARAM(path);
+   BSON_ASSERT_PARAM(values);
+   BSON_OPTIONAL_PARAM(nulls);
+
+   _add_column(columns, path, COLUMN_DOUBLE, values, NULL, nulls);
+}
+
+
+void
+mongoc_cursor_columns_add_date_time(mongoc_cursor_columns_t *columns,
+                                    const char *path,
+                                    int64_t *values,
+                                    uint8_t *nulls)
+{
+   BSON_ASSERT_PARAM(columns);
+   BSON_ASSERT_PARAM(path);
+   BSON_ASSERT_PARAM(values);
+   BSON_OPTIONAL_PARAM(nulls);
+
+   _add_column(columns, path, COLUMN_DATE_TIME, values, NULL, nulls);
+}
+
+
+void
+mongoc_cursor_columns_add_timestamp(mongoc_cursor_columns_t *columns,
+                                    const char *path,
+                                    uint32_t *timestamps,
+                                    uint32_t *increments,
+                                    uint8_t *nulls)
+{
+   BSON_ASSERT_PARAM(columns);
+   BSON_ASSERT_PARAM(path);
+   BSON_ASSERT_PARAM(timestamps);
+   BSON_ASSERT_PARAM(increments);
+   BSON_OPTIONAL_PARAM(nulls);
+
+   _add_column(columns, path, COLUMN_TIMESTAMP, timestamps, increments, nulls);
+}
+
+
+void
+mongoc_cursor_columns_add_utf8(
+   mongoc_cursor_columns_t *columns, const char *path, const char **values, uint32_t *lengths, uint8_t *nulls)
+{
+   BSON_ASSERT_PARAM(columns);
+   BSON_ASSERT_PARAM(path);
+   BSON_ASSERT_PARAM(values);
+   BSON_ASSERT_PARAM(lengths);
+   BSON_OPTIONAL_PARAM(nulls);
+
+   _add_column(columns, path, COLUMN_UTF8, (void *)values, lengths, nulls);
+}
+
+
+static void
+_clear_row(const mongoc_cursor_columns_t *columns, size_t row)
+{
+   for (size_t i = 0; i < columns->columns.len; i++) {
+      const column_t *column = &_mongoc_array_index(&columns->columns, column_t, i);
+
+      switch (column->type) {
+      case COLUMN_INT64:
+      case COLUMN_DATE_TIME:
+         ((int64_t *)column->values)[row] = 0;
+         break;
+      case COLUMN_DOUBLE:
+         ((double *)column->values)[row] = 0.0;
+         break;
+      case COLUMN_TIMESTAMP:
+         ((uint32_t *)column->values)[row] = 0;
+         ((uint32_t *)column->aux)[row] = 0;
+         break;
+      case COLUMN_UTF8:
+         ((const char **)column->values)[row] = NULL;
+         ((uint32_t *)column->aux)[row] = 0;
+         break;
+      default:
+         BSON_UNREACHABLE("invalid column type");
+      }
+
+      if (column->nulls) {
+         column->nulls[row] = 1;
+      }
+   }
+}
+
+
+static void
+_store_value(const column_t *column, const bson_iter_t *iter, size_t row)
+{
+   switch (column->type) {
+   case COLUMN_INT64:
+      if (BSON_ITER_HOLDS_INT64(iter)) {
+         ((int64_t *)column->values)[row] = bson_iter_int64(iter);
+      } else if (BSON_ITER_HOLDS_INT32(iter)) {
+         ((int64_t *)column->values)[row] = bson_iter_int32(iter);
+      } else {
+         return;
+      }
+      break;
+   case COLUMN_DOUBLE:
+      if (BSON_ITER_HOLDS_DOUBLE(iter)) {
+         ((double *)column->values)[row] = bson_iter_double(iter);
+      } else if (BSON_ITER_HOLDS_INT32(iter)) {
+         ((double *)column->values)[row] = (double)bson_iter_int32(iter);
+      } else if (BSON_ITER_HOLDS_INT64(iter)) {
+         ((double *)column->values)[row] = (double)bson_iter_int64(iter);
+      } else {
+         return;
+      }
+      break;
+   case COLUMN_DATE_TIME:
+      if (!BSON_ITER_HOLDS_DATE_TIME(iter)) {
+         return;
+      }
+      ((int64_t *)column->values)[row] = bson_iter_date_time(iter);
+      break;
+   case COLUMN_TIMESTAMP:
+      if (!BSON_ITER_HOLDS_TIMESTAMP(iter)) {
+         return;
+      }
+      bson_iter_timestamp(iter, &((uint32_t *)column->values)[row], &((uint32_t *)column->aux)[row]);
+      break;
+   case COLUMN_UTF8:
+      if (!BSON_ITER_HOLDS_UTF8(iter)) {
+         return;
+      }
+      ((const char **)column->values)[row] = bson_iter_utf8(iter, &((uint32_t *)column->aux)[row]);
+      break;
+   default:
+      BSON_UNREACHABLE("invalid column type");
+   }
+
+   if (column->nulls) {
+      column->nulls[row] = 0;
+   }
+}
+
+
+static void
+_decode_level(mongoc_cursor_columns_t *columns, size_t node_idx, bson_iter_t *iter, size_t row)
+{
+   const path_node_t *node = &_mongoc_array_index(&columns->nodes, path_node_t, node_idx);
+   bson_iter_t child_iter;
+
+   while (bson_iter_next(iter)) {
+      const char *key = bson_iter_key(iter);
+      const size_t key_len = bson_iter_key_len(iter);
+
+      for (size_t i = 0; i < node->children.len; i++) {
+         const size_t child_idx = _mongoc_array_index(&node->children, size_t, i);
+         path_node_t *child = &_mongoc_array_index(&columns->nodes, path_node_t, child_idx);
+
+         if (child->key_len != key_len || 0 != memcmp(child->key, key, key_len)) {
+            continue;
+         }
+
+         /* like bson_iter_find, the first of duplicate keys wins. */
+         if (child->seen == columns->serial) {
+            break;
+         }
+         child->seen = columns->serial;
+
+         if (child->column != NO_COLUMN) {
+            _store_value(&_mongoc_array_index(&columns->columns, column_t, child->column), iter, row);
+         }
+
+         if (child->children.len > 0 && (BSON_ITER_HOLDS_DOCUMENT(iter) || BSON_ITER_HOLDS_ARRAY(iter)) &&
+             bson_iter_recurse(iter, &child_iter)) {
+            _decode_level(columns, child_idx, &child_iter, row);
+         }
+
+         break;
+      }
+   }
+}
+
+
+bool
+mongoc_cursor_next_columns(mongoc_cursor_t *cursor, mongoc_cursor_columns_t *columns, size_t *n_rows)
+{
+   mongoc_cursor_response_t *response;
+   bson_iter_t peek;
+   bson_iter_t iter;
+   const uint8_t *data;
+   uint32_t data_len;
+   size_t row = 0;
+
+   ENTRY;
+
+   BSON_ASSERT_PARAM(cursor);
+   BSON_ASSERT_PARAM(columns);
+   BSON_ASSERT_PARAM(n_rows);
+
+   *n_rows = 0;
+
+   response = _mongoc_cursor_next_response(cursor);
+   if (!response) {
+      RETURN(false);
+   }
+
+   while (row < columns->max_rows) {
+      peek = response->batch_iter;
+      if (!bson_iter_next(&peek) || !BSON_ITER_HOLDS_DOCUMENT(&peek)) {
+         break;
+      }
+
+      response->batch_iter = peek;
+      bson_iter_document(&peek, &data_len, &data);
+
+      _clear_row(columns, row);
+      columns->serial++;
+
+      if (bson_iter_init_from_data(&iter, data, data_len)) {
+         _decode_level(columns, 0, &iter, row);
+      }
+
+      row++;
+   }
+
+   cursor->count += (uint32_t)row;
+   *n_rows = row;
+
+   RETURN(true);
+}
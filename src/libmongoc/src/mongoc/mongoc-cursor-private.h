@@ -97,21 +97,26 @@ BSON_BEGIN_DECLS
 typedef struct _mongoc_cursor_impl_t mongoc_cursor_impl_t;
 typedef enum { UNPRIMED, IN_BATCH, END_OF_BATCH, DONE } mongoc_cursor_state_t;
 typedef mongoc_cursor_state_t (*_mongoc_cursor_impl_transition_t)(mongoc_cursor_t *cursor);
+typedef struct _mongoc_cursor_response_t mongoc_cursor_response_t;
 struct _mongoc_cursor_impl_t {
    void (*clone)(mongoc_cursor_impl_t *dst, const mongoc_cursor_impl_t *src);
    void (*destroy)(mongoc_cursor_impl_t *ctx);
    _mongoc_cursor_impl_transition_t prime;
    _mongoc_cursor_impl_transition_t pop_from_batch;
    _mongoc_cursor_impl_transition_t get_next_batch;
+   /* optional. returns the response the cursor reads its batch from, if any. */
+   mongoc_cursor_response_t *(*get_response)(mongoc_cursor_t *cursor);
    void *data;
 };
 
 /* 3.2+ responses -- read batch docs like {cursor:{id: 123, firstBatch: []}} */
-typedef struct _mongoc_cursor_response_t {
+struct _mongoc_cursor_response_t {
    bson_t reply;           /* the entire command reply */
    bson_iter_t batch_iter; /* iterates over the batch array */
+   const uint8_t *batch;   /* the batch array */
+   uint32_t batch_len;
    bson_t current_doc;     /* the current doc inside the batch array */
-} mongoc_cursor_response_t;
+};
 
 struct _mongoc_cursor_t {
    mongoc_client_t *client;
@@ -153,6 +158,7 @@ struct _mongoc_cursor_t {
    bool had_stream_timeout; // True if previous command run resulted in a timeout on the mongoc_stream_t.
 
    const bson_t *current;
+   bson_t batch_copy; // Always initialized. Set by mongoc_cursor_next_batch if the batch was partially read.
 
    mongoc_cursor_impl_t impl;
 
@@ -200,6 +206,8 @@ bool
 _mongoc_cursor_start_reading_response(mongoc_cursor_t *cursor, mongoc_cursor_response_t *response);
 void
 _mongoc_cursor_response_read(mongoc_cursor_t *cursor, mongoc_cursor_response_t *response, const bson_t **bson);
+mongoc_cursor_response_t *
+_mongoc_cursor_next_response(mongoc_cursor_t *cursor);
 void
 _mongoc_cursor_prepare_getmore_command(mongoc_cursor_t *cursor, bson_t *command);
 void
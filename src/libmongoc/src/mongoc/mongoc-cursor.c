@@ -19,11 +19,13 @@
 
 #include <common-bson-dsl-private.h>
 #include <mongoc/mongoc-aggregate-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-client-session-private.h>
 #include <mongoc/mongoc-counters-private.h>
 #include <mongoc/mongoc-cursor-private.h>
 #include <mongoc/mongoc-error-private.h>
+#include <mongoc/mongoc-probes-private.h>
 #include <mongoc/mongoc-read-concern-private.h>
 #include <mongoc/mongoc-read-prefs-private.h>
 #include <mongoc/mongoc-structured-log-private.h>
@@ -274,6 +276,8 @@ _mongoc_cursor_new_with_opts(mongoc_client_t *client,
 
    BSON_ASSERT_PARAM(client);
 
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CURSOR);
+
    cursor = BSON_ALIGNED_ALLOC0(mongoc_cursor_t);
    cursor->client = client;
    cursor->state = UNPRIMED;
@@ -282,6 +286,7 @@ _mongoc_cursor_new_with_opts(mongoc_client_t *client,
 
    bson_init(&cursor->opts);
    bson_init(&cursor->error_doc);
+   bson_init(&cursor->batch_copy);
 
    if (opts) {
       if (!bson_validate_with_error(opts, BSON_VALIDATE_EMPTY_KEYS, &validate_err)) {
@@ -386,6 +391,7 @@ _mongoc_cursor_new_with_opts(mongoc_client_t *client,
 finish:
    mongoc_read_concern_destroy(read_concern_local);
    mongoc_counter_cursors_active_inc();
+   _mongoc_alloc_tag_pop(alloc_tag);
 
    RETURN(cursor);
 }
@@ -608,6 +614,7 @@ mongoc_cursor_destroy(mongoc_cursor_t *cursor)
 
    bson_destroy(&cursor->opts);
    bson_destroy(&cursor->error_doc);
+   bson_destroy(&cursor->batch_copy);
    bson_free(cursor->ns);
    bson_free(cursor);
 
@@ -986,7 +993,9 @@ _call_transition(mongoc_cursor_t *cursor)
    if (!fn) {
       return DONE;
    }
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CURSOR);
    state = fn(cursor);
+   _mongoc_alloc_tag_pop(alloc_tag);
    if (cursor->error.domain) {
       state = DONE;
    }
@@ -994,33 +1003,20 @@ _call_transition(mongoc_cursor_t *cursor)
 }
 
 
-bool
-mongoc_cursor_next(mongoc_cursor_t *cursor, const bson_t **bson)
+/* returns false and sets the cursor error if the cursor may not advance. */
+static bool
+_mongoc_cursor_can_advance(mongoc_cursor_t *cursor)
 {
-   bool ret = false;
-   bool attempted_refresh = false;
-
-   ENTRY;
-
-   BSON_ASSERT(cursor);
-   BSON_ASSERT(bson);
-
-   TRACE("cursor_id(%" PRId64 ")", cursor->cursor_id);
-
    if (cursor->client_generation != cursor->client->generation) {
       _mongoc_set_error(&cursor->error,
                         MONGOC_ERROR_CURSOR,
                         MONGOC_ERROR_CURSOR_INVALID_CURSOR,
                         "Cannot advance cursor after client reset");
-      RETURN(false);
-   }
-
-   if (bson) {
-      *bson = NULL;
+      return false;
    }
 
    if (CURSOR_FAILED(cursor)) {
-      RETURN(false);
+      return false;
    }
 
    if (cursor->state == DONE) {
@@ -1028,7 +1024,7 @@ mongoc_cursor_next(mongoc_cursor_t *cursor, const bson_t **bson)
                         MONGOC_ERROR_CURSOR,
                         MONGOC_ERROR_CURSOR_INVALID_CURSOR,
                         "Cannot advance a completed or failed cursor.");
-      RETURN(false);
+      return false;
    }
 
    /*
@@ -1039,6 +1035,29 @@ mongoc_cursor_next(mongoc_cursor_t *cursor, const bson_t **bson)
                         MONGOC_ERROR_CLIENT,
                         MONGOC_ERROR_CLIENT_IN_EXHAUST,
                         "Another cursor derived from this client is in exhaust.");
+      return false;
+   }
+
+   return true;
+}
+
+
+bool
+mongoc_cursor_next(mongoc_cursor_t *cursor, const bson_t **bson)
+{
+   bool ret = false;
+   bool attempted_refresh = false;
+
+   ENTRY;
+
+   BSON_ASSERT(cursor);
+   BSON_ASSERT(bson);
+
+   TRACE("cursor_id(%" PRId64 ")", cursor->cursor_id);
+
+   *bson = NULL;
+
+   if (!_mongoc_cursor_can_advance(cursor)) {
       RETURN(false);
    }
 
@@ -1082,6 +1101,141 @@ done:
 }
 
 
+/* advances to a batch with unread documents, sending at most one getMore, and
+ * returns the response it is read from. returns NULL if the cursor is done,
+ * failed, has no documents yet (e.g. tailable), or does not read command
+ * replies. callers consume documents from the response's batch_iter and add
+ * the number consumed to cursor->count. */
+mongoc_cursor_response_t *
+_mongoc_cursor_next_response(mongoc_cursor_t *cursor)
+{
+   bool attempted_refresh = false;
+   mongoc_cursor_response_t *response;
+   bson_iter_t peek;
+
+   ENTRY;
+
+   BSON_ASSERT_PARAM(cursor);
+
+   if (!_mongoc_cursor_can_advance(cursor)) {
+      RETURN(NULL);
+   }
+
+   if (!cursor->impl.get_response) {
+      _mongoc_set_error(&cursor->error,
+                        MONGOC_ERROR_CURSOR,
+                        MONGOC_ERROR_CURSOR_INVALID_CURSOR,
+                        "Cursor does not support reading whole batches");
+      RETURN(NULL);
+   }
+
+   cursor->current = NULL;
+
+   if (cursor->error.domain) {
+      cursor->state = DONE;
+      RETURN(NULL);
+   }
+
+   while (cursor->state != DONE) {
+      if (cursor->state == IN_BATCH) {
+         response = cursor->impl.get_response(cursor);
+         peek = response->batch_iter;
+         if (bson_iter_next(&peek) && BSON_ITER_HOLDS_DOCUMENT(&peek)) {
+            RETURN(response);
+         }
+
+         cursor->state = cursor->cursor_id ? END_OF_BATCH : DONE;
+         continue;
+      }
+
+      if (cursor->state == END_OF_BATCH) {
+         if (attempted_refresh) {
+            RETURN(NULL);
+         }
+         attempted_refresh = true;
+      }
+
+      cursor->state = _call_transition(cursor);
+   }
+
+   RETURN(NULL);
+}
+
+
+bool
+mongoc_cursor_next_batch(mongoc_cursor_t *cursor, const uint8_t **data, size_t *len, size_t *count)
+{
+   mongoc_cursor_response_t *response;
+   bson_iter_t first;
+   bson_iter_t iter;
+   bool stopped_early = false;
+   bool whole_batch;
+   size_t n = 0;
+
+   ENTRY;
+
+   BSON_ASSERT_PARAM(cursor);
+   BSON_ASSERT_PARAM(data);
+   BSON_ASSERT_PARAM(len);
+   BSON_ASSERT_PARAM(count);
+
+   *data = NULL;
+   *len = 0;
+   *count = 0;
+
+   bson_reinit(&cursor->batch_copy);
+
+   response = _mongoc_cursor_next_response(cursor);
+   if (!response) {
+      RETURN(false);
+   }
+
+   /* _mongoc_cursor_next_response guarantees an unread document. */
+   first = response->batch_iter;
+   BSON_ASSERT(bson_iter_next(&first));
+
+   /* consume documents up to the end of the batch, or the first element that
+    * is not a document, like _mongoc_cursor_response_read. */
+   iter = first;
+   do {
+      if (!BSON_ITER_HOLDS_DOCUMENT(&iter)) {
+         stopped_early = true;
+         break;
+      }
+      response->batch_iter = iter;
+      n++;
+   } while (bson_iter_next(&iter));
+
+   /* hand out the batch array from the reply unless part of it was already
+    * read by mongoc_cursor_next, or it has trailing elements we skipped. */
+   whole_batch = bson_iter_offset(&first) == 4u && !stopped_early;
+   if (whole_batch) {
+      *data = response->batch;
+      *len = response->batch_len;
+   } else {
+      bson_array_builder_t *bab = bson_array_builder_new();
+
+      iter = first;
+      for (size_t i = 0; i < n; i++) {
+         BSON_ASSERT(bson_array_builder_append_iter(bab, &iter));
+         bson_iter_next(&iter);
+      }
+
+      bson_destroy(&cursor->batch_copy);
+      BSON_ASSERT(bson_array_builder_build(bab, &cursor->batch_copy));
+      bson_array_builder_destroy(bab);
+
+      *data = bson_get_data(&cursor->batch_copy);
+      *len = cursor->batch_copy.len;
+   }
+
+   cursor->count += (uint32_t)n;
+   *count = n;
+
+   RETURN(true);
+}
+
+
 bool
 mongoc_cursor_more(mongoc_cursor_t *cursor)
 {
@@ -1156,6 +1310,7 @@ mongoc_cursor_clone(const mongoc_cursor_t *cursor)
 
    bson_copy_to(&cursor->opts, &_clone->opts);
    bson_init(&_clone->error_doc);
+   bson_init(&_clone->batch_copy);
 
    _clone->ns = bson_strdup(cursor->ns);
 
@@ -1356,6 +1511,7 @@ _mongoc_cursor_start_reading_response(mongoc_cursor_t *cursor, mongoc_cursor_res
             _mongoc_set_cursor_ns(cursor, ns, nslen);
          } else if (BSON_ITER_IS_KEY(&child, "firstBatch") || BSON_ITER_IS_KEY(&child, "nextBatch")) {
             if (BSON_ITER_HOLDS_ARRAY(&child) && bson_iter_recurse(&child, &response->batch_iter)) {
+               bson_iter_array(&child, &response->batch_len, &response->batch);
                in_batch = true;
             }
          }
@@ -1401,8 +1557,12 @@ _mongoc_cursor_response_refresh(mongoc_cursor_t *cursor,
                                 const bson_t *opts,
                                 mongoc_cursor_response_t *response)
 {
+   bool ok = false;
+
    ENTRY;
 
+   MONGOC_PROBE2(cursor_batch_start, cursor, _mongoc_get_command_name(command));
+
    bson_destroy(&response->reply);
 
    /* server replies to find / aggregate with {cursor: {id: N, firstBatch: []}},
@@ -1410,16 +1570,18 @@ _mongoc_cursor_response_refresh(mongoc_cursor_t *cursor,
    if (_mongoc_cursor_run_command(cursor, command, opts, &response->reply, false)) {
       if (_mongoc_cursor_start_reading_response(cursor, response)) {
          cursor->in_exhaust = cursor->client->in_exhaust;
-         return;
+         ok = true;
       }
    }
-   if (!cursor->error.domain) {
+   if (!ok && !cursor->error.domain) {
       _mongoc_set_error(&cursor->error,
                         MONGOC_ERROR_PROTOCOL,
                         MONGOC_ERROR_PROTOCOL_INVALID_REPLY,
                         "Invalid reply to %s command.",
                         _mongoc_get_command_name(command));
    }
+
+   MONGOC_PROBE3(cursor_batch_done, cursor, cursor->cursor_id, ok);
 }
 
 void
@@ -46,6 +46,9 @@ mongoc_cursor_more(mongoc_cursor_t *cursor);
 MONGOC_EXPORT(bool)
 mongoc_cursor_next(mongoc_cursor_t *cursor, const bson_t **bson);
 
+MONGOC_EXPORT(bool)
+mongoc_cursor_next_batch(mongoc_cursor_t *cursor, const uint8_t **data, size_t *len, size_t *count);
+
 MONGOC_EXPORT(bool)
 mongoc_cursor_error(mongoc_cursor_t *cursor, bson_error_t *error);
 
@@ -97,6 +100,40 @@ MONGOC_EXPORT(mongoc_cursor_t *)
 mongoc_cursor_new_from_command_reply_with_opts(struct _mongoc_client_t *client, bson_t *reply, const bson_t *opts)
    BSON_GNUC_WARN_UNUSED_RESULT;
 
+typedef struct _mongoc_cursor_columns_t mongoc_cursor_columns_t;
+
+MONGOC_EXPORT(mongoc_cursor_columns_t *)
+mongoc_cursor_columns_new(size_t max_rows) BSON_GNUC_WARN_UNUSED_RESULT;
+
+MONGOC_EXPORT(void)
+mongoc_cursor_columns_destroy(mongoc_cursor_columns_t *columns);
+
+MONGOC_EXPORT(void)
+mongoc_cursor_columns_add_int64(mongoc_cursor_columns_t *columns, const char *path, int64_t *values, uint8_t *nulls);
+
+MONGOC_EXPORT(void)
+mongoc_cursor_columns_add_double(mongoc_cursor_columns_t *columns, const char *path, double *values, uint8_t *nulls);
+
+MONGOC_EXPORT(void)
+mongoc_cursor_columns_add_date_time(mongoc_cursor_columns_t *columns,
+                                    const char *path,
+                                    int64_t *values,
+                                    uint8_t *nulls);
+
+MONGOC_EXPORT(void)
+mongoc_cursor_columns_add_timestamp(mongoc_cursor_columns_t *columns,
+                                    const char *path,
+                                    uint32_t *timestamps,
+                                    uint32_t *increments,
+                                    uint8_t *nulls);
+
+MONGOC_EXPORT(void)
+mongoc_cursor_columns_add_utf8(
+   mongoc_cursor_columns_t *columns, const char *path, const char **values, uint32_t *lengths, uint8_t *nulls);
+
+MONGOC_EXPORT(bool)
+mongoc_cursor_next_columns(mongoc_cursor_t *cursor, mongoc_cursor_columns_t *columns, size_t *n_rows);
+
 BSON_END_DECLS
 
 
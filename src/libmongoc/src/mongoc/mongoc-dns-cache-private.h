@@ -0,0 +1,95 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_DNS_CACHE_PRIVATE_H
+#define MONGOC_DNS_CACHE_PRIVATE_H
+
+#include <mongoc/mongoc-host-list.h>
+#include <mongoc/mongoc-socket.h>
+
+#include <bson/bson.h>
+
+BSON_BEGIN_DECLS
+
+/* How long a successful lookup is reused. */
+#define MONGOC_DNS_CACHE_TTL_MS (10 * 60 * 1000)
+/* How long a failed lookup is reused. Short, so a fixed DNS record is picked
+ * up quickly, but long enough to absorb a reconnect storm. */
+#define MONGOC_DNS_CACHE_NEGATIVE_TTL_MS 1000
+
+/* The reference-counted result of a host name lookup. The addrinfo list is
+ * valid as long as a reference is held and must not be modified. */
+typedef struct _mongoc_dns_result_t mongoc_dns_result_t;
+
+/* A TTL-bounded cache of host name lookups shared by the topology scanner,
+ * server monitors, and application connections of a client or client pool.
+ *
+ * Concurrent lookups of the same host are coalesced: one thread calls the
+ * resolver and the others wait for its result. Once an entry expires, the
+ * thread refreshing it resolves the host again while other threads keep
+ * using the expired result, so only one thread waits on a slow resolver.
+ * Failed lookups are cached for a shorter time. */
+typedef struct _mongoc_dns_cache_t mongoc_dns_cache_t;
+
+/* Resolver hook with the semantics of getaddrinfo. Results are freed with the
+ * matching mongoc_dns_free_fn. Overridable for tests. */
+typedef int (*mongoc_dns_resolve_fn)(
+   const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res, void *ctx);
+typedef void (*mongoc_dns_free_fn)(struct addrinfo *res, void *ctx);
+
+/* Resolve @host without a cache. Returns NULL and sets @error on failure. */
+mongoc_dns_result_t *
+_mongoc_dns_resolve(const mongoc_host_list_t *host, bson_error_t *error);
+
+struct addrinfo *
+_mongoc_dns_result_addrinfo(const mongoc_dns_result_t *result);
+
+mongoc_dns_result_t *
+_mongoc_dns_result_ref(mongoc_dns_result_t *result);
+
+void
+_mongoc_dns_result_release(mongoc_dns_result_t *result);
+
+mongoc_dns_cache_t *
+_mongoc_dns_cache_new(void);
+
+void
+_mongoc_dns_cache_destroy(mongoc_dns_cache_t *cache);
+
+void
+_mongoc_dns_cache_set_ttl(mongoc_dns_cache_t *cache, int64_t ttl_ms, int64_t negative_ttl_ms);
+
+void
+_mongoc_dns_cache_set_resolver(mongoc_dns_cache_t *cache,
+                               mongoc_dns_resolve_fn resolve,
+                               mongoc_dns_free_fn free_fn,
+                               void *ctx);
+
+/* Returns a new reference to the result for @host, resolving it if it is not
+ * cached. Returns NULL and sets @error if the lookup failed, now or within
+ * the negative TTL. If @cache is NULL, resolves @host without caching. */
+mongoc_dns_result_t *
+_mongoc_dns_cache_lookup(mongoc_dns_cache_t *cache, const mongoc_host_list_t *host, bson_error_t *error);
+
+/* Forget the result for @host, e.g. after no address could be connected. */
+void
+_mongoc_dns_cache_invalidate(mongoc_dns_cache_t *cache, const mongoc_host_list_t *host);
+
+BSON_END_DECLS
+
+#endif /* MONGOC_DNS_CACHE_PRIVATE_H */
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common-atomic-private.h>
+#include <common-thread-private.h>
+#include <mongoc/mongoc-counters-private.h>
+#include <mongoc/mongoc-dns-cache-private.h>
+#include <mongoc/mongoc-error-private.h>
+#include <mongoc/mongoc-thread-private.h>
+#include <mongoc/mongoc-trace-private.h>
+
+#include <mongoc/utlist.h>
+
+#include <mlib/cmp.h>
+
+#include <string.h>
+
+#undef MONGOC_LOG_DOMAIN
+#define MONGOC_LOG_DOMAIN "dns-cache"
+
+struct _mongoc_dns_result_t {
+   int refcount;
+   struct addrinfo *addrinfo;
+   mongoc_dns_free_fn free_fn;
+   void *free_ctx;
+};
+
+typedef struct _dns_entry_t {
+   struct _dns_entry_t *next;
+   char *key;
+   /* NULL if the last lookup failed */
+   mongoc_dns_result_t *result;
+   bson_error_t error;
+   /* monotonic time in microseconds, 0 if never resolved */
+   int64_t expires_at;
+   /* a thread is resolving this entry */
+   bool refreshing;
+} dns_entry_t;
+
+struct _mongoc_dns_cache_t {
+   bson_mutex_t mutex;
+   mongoc_cond_t cond;
+   dns_entry_t *entries;
+   int64_t ttl_ms;
+   int64_t negative_ttl_ms;
+   mongoc_dns_resolve_fn resolve;
+   mongoc_dns_free_fn free_fn;
+   void *ctx;
+};
+
+static int
+_default_resolve(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res, void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   return getaddrinfo(node, service, hints, res);
+}
+
+static void
+_default_free(struct addrinfo *res, void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   freeaddrinfo(res);
+}
+
+static mongoc_dns_result_t *
+_resolve_with(const mongoc_host_list_t *host,
+              mongoc_dns_resolve_fn resolve,
+              mongoc_dns_free_fn free_fn,
+              void *ctx,
+              bson_error_t *error)
+{
+   struct addrinfo hints;
+   struct addrinfo *addrinfo = NULL;
+   mongoc_dns_result_t *result;
+   char portstr[8];
+
+   // Expect no truncation.
+   int req = bson_snprintf(portstr, sizeof portstr, "%hu", host->port);
+   BSON_ASSERT(mlib_cmp(req, <, sizeof portstr));
+
+   memset(&hints, 0, sizeof hints);
+   hints.ai_family = host->family;
+   hints.ai_socktype = SOCK_STREAM;
+   hints.ai_flags = 0;
+   hints.ai_protocol = 0;
+
+   TRACE("DNS lookup for %s", host->host);
+   if (resolve(host->host, portstr, &hints, &addrinfo, ctx) != 0 || !addrinfo) {
+      mongoc_counter_dns_failure_inc();
+      TRACE("Failed to resolve %s", host->host);
+      _mongoc_set_error(
+         error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_NAME_RESOLUTION, "Failed to resolve '%s'", host->host);
+      return NULL;
+   }
+
+   mongoc_counter_dns_success_inc();
+
+   result = bson_malloc0(sizeof *result);
+   result->refcount = 1;
+   result->addrinfo = addrinfo;
+   result->free_fn = free_fn;
+   result->free_ctx = ctx;
+
+   return result;
+}
+
+mongoc_dns_result_t *
+_mongoc_dns_resolve(const mongoc_host_list_t *host, bson_error_t *error)
+{
+   BSON_ASSERT_PARAM(host);
+
+   return _resolve_with(host, _default_resolve, _default_free, NULL, error);
+}
+
+struct addrinfo *
+_mongoc_dns_result_addrinfo(const mongoc_dns_result_t *result)
+{
+   BSON_ASSERT_PARAM(result);
+
+   return result->addrinfo;
+}
+
+mongoc_dns_result_t *
+_mongoc_dns_result_ref(mongoc_dns_result_t *result)
+{
+   BSON_ASSERT_PARAM(result);
+
+   mcommon_atomic_int_fetch_add(&result->refcount, 1, mcommon_memory_order_relaxed);
+   return result;
+}
+
+void
+_mongoc_dns_result_release(mongoc_dns_result_t *result)
+{
+   if (!result) {
+      return;
+   }
+
+   if (mcommon_atomic_int_fetch_sub(&result->refcount, 1, mcommon_memory_order_acq_rel) == 1) {
+      result->free_fn(result->addrinfo, result->free_ctx);
+      bson_free(result);
+   }
+}
+
+mongoc_dns_cache_t *
+_mongoc_dns_cache_new(void)
+{
+   mongoc_dns_cache_t *cache = bson_malloc0(sizeof *cache);
+
+   bson_mutex_init(&cache->mutex);
+   mongoc_cond_init(&cache->cond);
+   cache->ttl_ms = MONGOC_DNS_CACHE_TTL_MS;
+   cache->negative_ttl_ms = MONGOC_DNS_CACHE_NEGATIVE_TTL_MS;
+   cache->resolve = _default_resolve;
+   cache->free_fn = _default_free;
+
+   return cache;
+}
+
+void
+_mongoc_dns_cache_destroy(mongoc_dns_cache_t *cache)
+{
+   dns_entry_t *iter;
+   dns_entry_t *tmp;
+
+   if (!cache) {
+      return;
+   }
+
+   LL_FOREACH_SAFE(cache->entries, iter, tmp)
+   {
+      BSON_ASSERT(!iter->refreshing);
+      _mongoc_dns_result_release(iter->result);
+      bson_free(iter->key);
+      bson_free(iter);
+   }
+
+   bson_mutex_destroy(&cache->mutex);
+   mongoc_cond_destroy(&cache->cond);
+   bson_free(cache);
+}
+
+void
+_mongoc_dns_cache_set_ttl(mongoc_dns_cache_t *cache, int64_t ttl_ms, int64_t negative_ttl_ms)
+{
+   BSON_ASSERT_PARAM(cache);
+
+   bson_mutex_lock(&cache->mutex);
+   cache->ttl_ms = ttl_ms;
+   cache->negative_ttl_ms = negative_ttl_ms;
+   bson_mutex_unlock(&cache->mutex);
+}
+
+void
+_mongoc_dns_cache_set_resolver(mongoc_dns_cache_t *cache,
+                               mongoc_dns_resolve_fn resolve,
+                               mongoc_dns_free_fn free_fn,
+                               void *ctx)
+{
+   BSON_ASSERT_PARAM(cache);
+   BSON_ASSERT_PARAM(resolve);
+   BSON_ASSERT_PARAM(free_fn);
+
+   bson_mutex_lock(&cache->mutex);
+   cache->resolve = resolve;
+   cache->free_fn = free_fn;
+   cache->ctx = ctx;
+   bson_mutex_unlock(&cache->mutex);
+}
+
+static char *
+_entry_key(const mongoc_host_list_t *host)
+{
+   return bson_strdup_printf("%s:%hu/%d", host->host, host->port, host->family);
+}
+
+static int
+_entry_cmp(dns_entry_t *entry, const char *key)
+{
+   return strcmp(entry->key, key);
+}
+
+mongoc_dns_result_t *
+_mongoc_dns_cache_lookup(mongoc_dns_cache_t *cache, const mongoc_host_list_t *host, bson_error_t *error)
+{
+   dns_entry_t *entry = NULL;
+   mongoc_dns_result_t *result = NULL;
+   char *key;
+
+   BSON_ASSERT_PARAM(host);
+
+   if (!cache) {
+      return _mongoc_dns_resolve(host, error);
+   }
+
+   key = _entry_key(host);
+
+   bson_mutex_lock(&cache->mutex);
+   LL_SEARCH(cache->entries, entry, key, _entry_cmp);
+   if (!entry) {
+      entry = bson_malloc0(sizeof *entry);
+      entry->key = key;
+      key = NULL;
+      LL_PREPEND(cache->entries, entry);
+   }
+
+   for (;;) {
+      const int64_t now = bson_get_monotonic_time();
+
+      if (entry->expires_at && now < entry->expires_at) {
+         if (entry->result) {
+            result = _mongoc_dns_result_ref(entry->result);
+         } else if (error) {
+            memcpy(error, &entry->error, sizeof *error);
+         }
+         goto done;
+      }
+
+      if (!entry->refreshing) {
+         break;
+      }
+
+      if (entry->result) {
+         /* another thread is refreshing: keep using the expired result */
+         result = _mongoc_dns_result_ref(entry->result);
+         goto done;
+      }
+
+      mongoc_cond_wait(&cache->cond, &cache->mutex);
+   }
+
+   /* this thread refreshes the entry */
+   {
+      const mongoc_dns_resolve_fn resolve = cache->resolve;
+      const mongoc_dns_free_fn free_fn = cache->free_fn;
+      void *const ctx = cache->ctx;
+      bson_error_t lookup_error = {0};
+
+      entry->refreshing = true;
+      bson_mutex_unlock(&cache->mutex);
+
+      result = _resolve_with(host, resolve, free_fn, ctx, &lookup_error);
+
+      bson_mutex_lock(&cache->mutex);
+      entry->refreshing = false;
+      _mongoc_dns_result_release(entry->result);
+      entry->error = lookup_error;
+      if (result) {
+         entry->result = _mongoc_dns_result_ref(result);
+         entry->expires_at = bson_get_monotonic_time() + cache->ttl_ms * 1000;
+      } else {
+         entry->result = NULL;
+         entry->expires_at = bson_get_monotonic_time() + cache->negative_ttl_ms * 1000;
+         if (error) {
+            memcpy(error, &lookup_error, sizeof *error);
+         }
+      }
+      mongoc_cond_broadcast(&cache->cond);
+   }
+
+done:
+   bson_mutex_unlock(&cache->mutex);
+   bson_free(key);
+
+   return result;
+}
+
+void
+_mongoc_dns_cache_invalidate(mongoc_dns_cache_t *cache, const mongoc_host_list_t *host)
+{
+   dns_entry_t *entry = NULL;
+   char *key;
+
+   BSON_ASSERT_PARAM(host);
+
+   if (!cache) {
+      return;
+   }
+
+   key = _entry_key(host);
+
+   bson_mutex_lock(&cache->mutex);
+   LL_SEARCH(cache->entries, entry, key, _entry_cmp);
+   if (entry) {
+      /* expire it, but keep serving a previous result to other threads while
+       * it is resolved again */
+      entry->expires_at = 0;
+   }
+   bson_mutex_unlock(&cache->mutex);
+
+   bson_free(key);
+}
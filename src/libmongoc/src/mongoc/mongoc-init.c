@@ -17,6 +17,7 @@
 
 #include <mongoc/mongoc-init.h>
 
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-cluster-aws-private.h>
 #include <mongoc/mongoc-counters-private.h>
 #include <mongoc/mongoc-handshake-private.h>
@@ -120,6 +121,7 @@ static BSON_ONCE_FUN(_mongoc_do_init)
 #endif
 
    _mongoc_counters_init();
+   _mongoc_alloc_stats_export_counters(true);
 
 #ifdef _WIN32
    {
@@ -185,6 +187,7 @@ static BSON_ONCE_FUN(_mongoc_do_cleanup)
    mongoc_crypto_cng_cleanup();
 #endif
 
+   _mongoc_alloc_stats_export_counters(false);
    _mongoc_counters_cleanup();
 
    _mongoc_handshake_cleanup();
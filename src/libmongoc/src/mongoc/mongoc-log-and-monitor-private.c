@@ -103,3 +103,21 @@ mongoc_log_and_monitor_instance_set_structured_log_opts(mongoc_log_and_monitor_i
    mongoc_structured_log_instance_destroy(instance->structured_log);
    instance->structured_log = mongoc_structured_log_instance_new(opts);
 }
+
+
+/**
+ * @brief Whether anything consumes the per-phase durations of commands
+ *
+ * Phase timings cost a few clock reads per command, so they are only taken for
+ * the shared memory counters or a command succeeded or failed callback.
+ */
+bool
+mongoc_log_and_monitor_instance_collects_command_phases(const mongoc_log_and_monitor_instance_t *instance)
+{
+   BSON_ASSERT_PARAM(instance);
+#ifdef MONGOC_ENABLE_SHM_COUNTERS
+   return true;
+#else
+   return instance->apm_callbacks.succeeded || instance->apm_callbacks.failed;
+#endif
+}
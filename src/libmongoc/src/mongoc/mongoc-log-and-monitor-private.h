@@ -54,5 +54,9 @@ void
 mongoc_log_and_monitor_instance_set_structured_log_opts(mongoc_log_and_monitor_instance_t *instance,
                                                         const struct mongoc_structured_log_opts_t *opts);
 
+bool
+mongoc_log_and_monitor_instance_collects_command_phases(const mongoc_log_and_monitor_instance_t *instance);
+
+
 
 #endif /* MONGOC_LOG_AND_MONITOR_PRIVATE_H */
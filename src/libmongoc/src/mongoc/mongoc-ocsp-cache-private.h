@@ -26,6 +26,10 @@
 #ifdef MONGOC_ENABLE_OCSP_OPENSSL
 #include <openssl/ocsp.h>
 
+/* Upper bound on cached OCSP responses. When full, expired responses are
+ * swept first and then the oldest response is evicted. */
+#define MONGOC_OCSP_CACHE_MAX_ENTRIES 1024
+
 void
 _mongoc_ocsp_cache_init(void);
 
@@ -19,6 +19,7 @@
 #ifdef MONGOC_ENABLE_OCSP_OPENSSL
 
 #include <common-thread-private.h>
+#include <mongoc/mongoc-counters-private.h>
 #include <mongoc/mongoc-trace-private.h>
 
 #include <mongoc/utlist.h>
@@ -27,39 +28,63 @@
 
 #include <mlib/config.h>
 
+/* Number of hash buckets. A power of two so the hash can be masked. */
+#define OCSP_CACHE_BUCKETS 256
+/* Minimum interval between sweeps for expired entries. */
+#define OCSP_CACHE_SWEEP_INTERVAL_USEC (60 * 1000 * 1000)
+
 typedef struct _cache_entry_list_t {
-   struct _cache_entry_list_t *next;
+   /* insertion order, oldest first; used for sweeping and eviction */
+   struct _cache_entry_list_t *prev, *next;
+   /* chain within a hash bucket */
+   struct _cache_entry_list_t *bucket_next;
    OCSP_CERTID *id;
+   /* DER encoding of `id`, which is the lookup key */
+   unsigned char *der;
+   int der_len;
+   uint32_t hash;
    int cert_status, reason;
    ASN1_GENERALIZEDTIME *this_update, *next_update;
 } cache_entry_list_t;
 
 static cache_entry_list_t *cache;
+static cache_entry_list_t *buckets[OCSP_CACHE_BUCKETS];
+static int cache_length;
+static int64_t last_sweep_usec;
 static bson_mutex_t ocsp_cache_mutex;
 
 void
 _mongoc_ocsp_cache_init(void)
 {
    bson_mutex_init(&ocsp_cache_mutex);
+   last_sweep_usec = bson_get_monotonic_time();
 }
 
-static int
-cache_cmp(cache_entry_list_t *out, OCSP_CERTID *id)
+/* FNV-1a over the DER-encoded cert ID. */
+static uint32_t
+hash_der(const unsigned char *der, int der_len)
 {
-   ENTRY;
-   if (!out || !out->id || !id) {
-      RETURN(1);
+   uint32_t hash = 2166136261u;
+
+   for (int i = 0; i < der_len; i++) {
+      hash = (hash ^ der[i]) * 16777619u;
    }
-   RETURN(OCSP_id_cmp(out->id, id));
+
+   return hash;
 }
 
 static cache_entry_list_t *
-get_cache_entry(OCSP_CERTID *id)
+get_cache_entry(const unsigned char *der, int der_len, uint32_t hash)
 {
    cache_entry_list_t *iter = NULL;
    ENTRY;
 
-   LL_SEARCH(cache, iter, id, cache_cmp);
+   for (iter = buckets[hash & (OCSP_CACHE_BUCKETS - 1)]; iter; iter = iter->bucket_next) {
+      if (iter->hash == hash && iter->der_len == der_len && 0 == memcmp(iter->der, der, (size_t)der_len)) {
+         break;
+      }
+   }
+
    RETURN(iter);
 }
 
@@ -105,18 +130,92 @@ _cmp_time(ASN1_TIME *a, ASN1_TIME *b)
 }
 #endif
 
+static void
+cache_entry_destroy(cache_entry_list_t *entry)
+{
+   OCSP_CERTID_free(entry->id);
+   OPENSSL_free(entry->der);
+   ASN1_GENERALIZEDTIME_free(entry->this_update);
+   ASN1_GENERALIZEDTIME_free(entry->next_update);
+   bson_free(entry);
+}
+
+/* Unlinks and frees `entry`. Requires ocsp_cache_mutex. */
+static void
+remove_entry(cache_entry_list_t *entry)
+{
+   LL_DELETE2(buckets[entry->hash & (OCSP_CACHE_BUCKETS - 1)], entry, bucket_next);
+   DL_DELETE(cache, entry);
+   cache_length--;
+   cache_entry_destroy(entry);
+}
+
+static bool
+is_expired(const cache_entry_list_t *entry)
+{
+   return entry->this_update && entry->next_update &&
+          !OCSP_check_validity(entry->this_update, entry->next_update, 0L, -1L);
+}
+
+/* Removes every entry past its nextUpdate. Requires ocsp_cache_mutex. */
+static void
+sweep_expired(void)
+{
+   cache_entry_list_t *iter = NULL;
+   cache_entry_list_t *tmp = NULL;
+   ENTRY;
+
+   DL_FOREACH_SAFE(cache, iter, tmp)
+   {
+      if (is_expired(iter)) {
+         remove_entry(iter);
+      }
+   }
+
+   last_sweep_usec = bson_get_monotonic_time();
+   EXIT;
+}
+
 void
 _mongoc_ocsp_cache_set_resp(
    OCSP_CERTID *id, int cert_status, int reason, ASN1_GENERALIZEDTIME *this_update, ASN1_GENERALIZEDTIME *next_update)
 {
    cache_entry_list_t *entry = NULL;
+   unsigned char *der = NULL;
+   int der_len;
+   uint32_t hash;
    ENTRY;
 
+   if ((der_len = i2d_OCSP_CERTID(id, &der)) <= 0) {
+      MONGOC_WARNING("Could not encode OCSP_CERTID; not caching OCSP response");
+      EXIT;
+   }
+
+   hash = hash_der(der, der_len);
+
    bson_mutex_lock(&ocsp_cache_mutex);
-   if (!(entry = get_cache_entry(id))) {
+   if (!(entry = get_cache_entry(der, der_len, hash))) {
+      /* Drop expired responses periodically, and whenever the cache is full,
+       * so stale entries do not linger until looked up again. */
+      if (cache_length >= MONGOC_OCSP_CACHE_MAX_ENTRIES ||
+          bson_get_monotonic_time() - last_sweep_usec >= OCSP_CACHE_SWEEP_INTERVAL_USEC) {
+         sweep_expired();
+      }
+
+      if (cache_length >= MONGOC_OCSP_CACHE_MAX_ENTRIES) {
+         /* still full: evict the oldest entry */
+         remove_entry(cache);
+      }
+
       entry = bson_malloc0(sizeof(cache_entry_list_t));
       entry->id = OCSP_CERTID_dup(id);
-      LL_APPEND(cache, entry);
+      entry->der = der;
+      entry->der_len = der_len;
+      entry->hash = hash;
+      der = NULL;
+      DL_APPEND(cache, entry);
+      LL_PREPEND2(buckets[hash & (OCSP_CACHE_BUCKETS - 1)], entry, bucket_next);
+      cache_length++;
       update_entry(entry, cert_status, reason, this_update, next_update);
    } else if (next_update && _cmp_time(next_update, entry->next_update) == 1) {
       update_entry(entry, cert_status, reason, this_update, next_update);
@@ -124,28 +223,22 @@ _mongoc_ocsp_cache_set_resp(
       /* Do nothing; our next_update is at a later date */
    }
    bson_mutex_unlock(&ocsp_cache_mutex);
+
+   OPENSSL_free(der);
+   EXIT;
 }
 
 int
 _mongoc_ocsp_cache_length(void)
 {
-   cache_entry_list_t *iter;
    int counter;
 
    bson_mutex_lock(&ocsp_cache_mutex);
-   LL_COUNT(cache, iter, counter);
+   counter = cache_length;
    bson_mutex_unlock(&ocsp_cache_mutex);
    RETURN(counter);
 }
 
-static void
-cache_entry_destroy(cache_entry_list_t *entry)
-{
-   OCSP_CERTID_free(entry->id);
-   ASN1_GENERALIZEDTIME_free(entry->this_update);
-   ASN1_GENERALIZEDTIME_free(entry->next_update);
-   bson_free(entry);
-}
 bool
 _mongoc_ocsp_cache_get_status(OCSP_CERTID *id,
                               int *cert_status,
@@ -154,18 +247,23 @@ _mongoc_ocsp_cache_get_status(OCSP_CERTID *id,
                               ASN1_GENERALIZEDTIME **next_update)
 {
    cache_entry_list_t *entry = NULL;
+   unsigned char *der = NULL;
+   int der_len;
    bool ret = false;
    ENTRY;
 
+   if ((der_len = i2d_OCSP_CERTID(id, &der)) <= 0) {
+      mongoc_counter_ocsp_cache_misses_inc();
+      RETURN(false);
+   }
+
    bson_mutex_lock(&ocsp_cache_mutex);
-   if (!(entry = get_cache_entry(id))) {
+   if (!(entry = get_cache_entry(der, der_len, hash_der(der, der_len)))) {
       GOTO(done);
    }
 
-   if (entry->this_update && entry->next_update &&
-       !OCSP_check_validity(entry->this_update, entry->next_update, 0L, -1L)) {
-      LL_DELETE(cache, entry);
-      cache_entry_destroy(entry);
+   if (is_expired(entry)) {
+      remove_entry(entry);
       GOTO(done);
    }
 
@@ -182,6 +280,14 @@ _mongoc_ocsp_cache_get_status(OCSP_CERTID *id,
    ret = true;
 done:
    bson_mutex_unlock(&ocsp_cache_mutex);
+   OPENSSL_free(der);
+
+   if (ret) {
+      mongoc_counter_ocsp_cache_hits_inc();
+   } else {
+      mongoc_counter_ocsp_cache_misses_inc();
+   }
+
    RETURN(ret);
 }
 
@@ -199,6 +305,8 @@ _mongoc_ocsp_cache_cleanup(void)
    }
 
    cache = NULL;
+   memset(buckets, 0, sizeof(buckets));
+   cache_length = 0;
    bson_mutex_unlock(&ocsp_cache_mutex);
    bson_mutex_destroy(&ocsp_cache_mutex);
 }
@@ -31,6 +31,7 @@
 
 #if (OPENSSL_VERSION_NUMBER >= 0x10001000L) && !defined(OPENSSL_NO_OCSP) && !defined(LIBRESSL_VERSION_NUMBER)
 #define MONGOC_ENABLE_OCSP_OPENSSL
+#include <openssl/ocsp.h>
 #endif
 
 
@@ -48,6 +49,11 @@ _mongoc_openssl_cleanup(void);
 #ifdef MONGOC_ENABLE_OCSP_OPENSSL
 int
 _mongoc_ocsp_tlsext_status(SSL *ssl, mongoc_openssl_ocsp_opt_t *opts);
+
+/* Returns the OCSP ID of the peer certificate of @ssl, or NULL if the peer
+ * certificate or its issuer is not available. Free with OCSP_CERTID_free. */
+OCSP_CERTID *
+_mongoc_ocsp_peer_cert_id(SSL *ssl);
 #endif
 
 bool
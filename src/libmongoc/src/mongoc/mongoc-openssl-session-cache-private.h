@@ -0,0 +1,80 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_OPENSSL_SESSION_CACHE_PRIVATE_H
+#define MONGOC_OPENSSL_SESSION_CACHE_PRIVATE_H
+
+#include <mongoc/mongoc-config.h>
+
+#ifdef MONGOC_ENABLE_SSL_OPENSSL
+#include <mongoc/mongoc-openssl-private.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+
+/* A TLS session cache is attached to the OpenSSL context shared by all
+ * connections of a client or client pool. Sessions are keyed by the server's
+ * "host:port" so a reconnect (application or monitoring) can resume the
+ * previous session with an abbreviated handshake. TLS 1.3 tickets are used at
+ * most once; TLS 1.2 sessions are reused until they expire. */
+
+/* Allocate the ex_data indexes. Called once by _mongoc_openssl_init. */
+void
+_mongoc_openssl_session_cache_init(void);
+
+/* Attach an empty session cache to a client-side context. The cache is freed
+ * with the context. */
+void
+_mongoc_openssl_session_cache_install(SSL_CTX *ctx);
+
+/* Associate @ssl with @key and offer a cached session for it, if any. With
+ * @require_ocsp, a session is only offered while the OCSP cache holds a good
+ * response for the certificate validated by the last full handshake. Returns
+ * false if the context of @ssl has no session cache. */
+bool
+_mongoc_openssl_session_cache_prepare(SSL *ssl, const char *key, bool require_ocsp);
+
+/* Forget the sessions cached for the key of @ssl, e.g. after a failed
+ * handshake. */
+void
+_mongoc_openssl_session_cache_remove(SSL *ssl);
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+/* Record the peer certificate of @ssl, whose full handshake passed OCSP
+ * validation, for the key of @ssl. */
+void
+_mongoc_openssl_session_cache_set_ocsp_peer(SSL *ssl);
+
+/* Servers do not staple an OCSP response on resumption. Returns true if the
+ * resumed session of @ssl has the certificate recorded by
+ * _mongoc_openssl_session_cache_set_ocsp_peer and the OCSP cache still holds
+ * a good response for it. */
+bool
+_mongoc_openssl_session_cache_check_ocsp(SSL *ssl);
+#endif
+
+/* Returns the number of sessions cached for @key. Used in tests. */
+size_t
+_mongoc_openssl_session_cache_count(SSL_CTX *ctx, const char *key);
+
+#endif /* OPENSSL_VERSION_NUMBER >= 0x10100000L */
+#endif /* MONGOC_ENABLE_SSL_OPENSSL */
+
+/* ensure the translation unit is not empty */
+extern int no_mongoc_openssl_session_cache;
+
+#endif /* MONGOC_OPENSSL_SESSION_CACHE_PRIVATE_H */
@@ -0,0 +1,417 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <mongoc/mongoc-openssl-session-cache-private.h>
+
+#if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
+
+#include <common-thread-private.h>
+#include <mongoc/mongoc-ocsp-cache-private.h>
+#include <mongoc/mongoc-trace-private.h>
+
+#include <mongoc/utlist.h>
+
+#include <bson/bson.h>
+
+#include <string.h>
+#include <time.h>
+
+#undef MONGOC_LOG_DOMAIN
+#define MONGOC_LOG_DOMAIN "openssl-session-cache"
+
+/* TLS 1.3 servers usually issue two tickets per connection. Keep a few per
+ * server so concurrent reconnects can each resume with a fresh ticket. */
+#define SESSIONS_PER_KEY 4
+
+typedef struct _cache_entry_list_t {
+   struct _cache_entry_list_t *next;
+   char *key;
+   SSL_SESSION *sessions[SESSIONS_PER_KEY];
+   size_t n_sessions;
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+   /* The server certificate that passed OCSP validation in the last full
+    * handshake, and its OCSP ID. */
+   X509 *ocsp_peer;
+   OCSP_CERTID *ocsp_id;
+#endif
+} cache_entry_list_t;
+
+typedef struct {
+   bson_mutex_t mutex;
+   cache_entry_list_t *entries;
+} session_cache_t;
+
+/* ex_data index of the session_cache_t on an SSL_CTX. */
+static int ctx_cache_index = -1;
+/* ex_data index of the cache key on an SSL. */
+static int ssl_key_index = -1;
+
+static void
+cache_entry_destroy(cache_entry_list_t *entry)
+{
+   for (size_t i = 0; i < entry->n_sessions; i++) {
+      SSL_SESSION_free(entry->sessions[i]);
+   }
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+   X509_free(entry->ocsp_peer);
+   OCSP_CERTID_free(entry->ocsp_id);
+#endif
+   bson_free(entry->key);
+   bson_free(entry);
+}
+
+static int
+cache_cmp(cache_entry_list_t *entry, const char *key)
+{
+   return strcmp(entry->key, key);
+}
+
+static void
+_session_cache_free(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx, long argl, void *argp)
+{
+   session_cache_t *cache = (session_cache_t *)ptr;
+   cache_entry_list_t *iter;
+   cache_entry_list_t *tmp;
+
+   BSON_UNUSED(parent);
+   BSON_UNUSED(ad);
+   BSON_UNUSED(idx);
+   BSON_UNUSED(argl);
+   BSON_UNUSED(argp);
+
+   if (!cache) {
+      return;
+   }
+
+   LL_FOREACH_SAFE(cache->entries, iter, tmp)
+   {
+      cache_entry_destroy(iter);
+   }
+
+   bson_mutex_destroy(&cache->mutex);
+   bson_free(cache);
+}
+
+static void
+_session_key_free(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx, long argl, void *argp)
+{
+   BSON_UNUSED(parent);
+   BSON_UNUSED(ad);
+   BSON_UNUSED(idx);
+   BSON_UNUSED(argl);
+   BSON_UNUSED(argp);
+
+   bson_free(ptr);
+}
+
+static session_cache_t *
+_session_cache_get(SSL_CTX *ctx)
+{
+   if (!ctx || ctx_cache_index < 0) {
+      return NULL;
+   }
+
+   return (session_cache_t *)SSL_CTX_get_ex_data(ctx, ctx_cache_index);
+}
+
+/* Must be called with the cache's mutex locked. */
+static cache_entry_list_t *
+_cache_entry_get_or_create(session_cache_t *cache, const char *key)
+{
+   cache_entry_list_t *entry = NULL;
+
+   LL_SEARCH(cache->entries, entry, key, cache_cmp);
+   if (!entry) {
+      entry = bson_malloc0(sizeof(cache_entry_list_t));
+      entry->key = bson_strdup(key);
+      LL_PREPEND(cache->entries, entry);
+   }
+
+   return entry;
+}
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+/* Whether the OCSP cache holds an unexpired "good" response for the
+ * certificate the sessions of @entry were validated against. */
+static bool
+_cache_entry_ocsp_good(const cache_entry_list_t *entry)
+{
+   int cert_status, reason;
+   ASN1_GENERALIZEDTIME *this_update, *next_update;
+
+   return entry->ocsp_id &&
+          _mongoc_ocsp_cache_get_status(entry->ocsp_id, &cert_status, &reason, &this_update, &next_update) &&
+          cert_status == V_OCSP_CERTSTATUS_GOOD;
+}
+#endif
+
+static bool
+_session_expired(const SSL_SESSION *session, time_t now)
+{
+   return (time_t)SSL_SESSION_get_time(session) + (time_t)SSL_SESSION_get_timeout(session) <= now;
+}
+
+static bool
+_session_is_single_use(const SSL_SESSION *session)
+{
+#ifdef TLS1_3_VERSION
+   /* RFC 8446 Appendix C.4: clients should not reuse a TLS 1.3 ticket. */
+   return SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION;
+#else
+   BSON_UNUSED(session);
+   return false;
+#endif
+}
+
+/* Called by OpenSSL when the server issues a session. For TLS 1.3 this happens
+ * after the handshake, when the client first reads application data. */
+static int
+_session_cache_new_cb(SSL *ssl, SSL_SESSION *session)
+{
+   session_cache_t *cache;
+   cache_entry_list_t *entry = NULL;
+   const char *key;
+
+   cache = _session_cache_get(SSL_get_SSL_CTX(ssl));
+   key = (const char *)SSL_get_ex_data(ssl, ssl_key_index);
+
+   if (!cache || !key) {
+      return 0;
+   }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+   if (!SSL_SESSION_is_resumable(session)) {
+      return 0;
+   }
+#endif
+
+   bson_mutex_lock(&cache->mutex);
+   entry = _cache_entry_get_or_create(cache, key);
+
+   if (entry->n_sessions == SESSIONS_PER_KEY) {
+      /* Evict the oldest session. */
+      SSL_SESSION_free(entry->sessions[0]);
+      memmove(&entry->sessions[0], &entry->sessions[1], (SESSIONS_PER_KEY - 1) * sizeof(SSL_SESSION *));
+      entry->n_sessions--;
+   }
+
+   entry->sessions[entry->n_sessions++] = session;
+   bson_mutex_unlock(&cache->mutex);
+
+   TRACE("cached TLS session for %s", key);
+
+   /* Keep the reference to session. */
+   return 1;
+}
+
+void
+_mongoc_openssl_session_cache_init(void)
+{
+   ctx_cache_index = SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, _session_cache_free);
+   ssl_key_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, _session_key_free);
+}
+
+void
+_mongoc_openssl_session_cache_install(SSL_CTX *ctx)
+{
+   session_cache_t *cache;
+
+   if (!ctx || ctx_cache_index < 0 || ssl_key_index < 0) {
+      return;
+   }
+
+   cache = bson_malloc0(sizeof(session_cache_t));
+   bson_mutex_init(&cache->mutex);
+
+   if (!SSL_CTX_set_ex_data(ctx, ctx_cache_index, cache)) {
+      _session_cache_free(ctx, cache, NULL, ctx_cache_index, 0, NULL);
+      return;
+   }
+
+   /* Sessions are stored and looked up by the driver, not by OpenSSL. */
+   SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+   SSL_CTX_sess_set_new_cb(ctx, _session_cache_new_cb);
+}
+
+bool
+_mongoc_openssl_session_cache_prepare(SSL *ssl, const char *key, bool require_ocsp)
+{
+   session_cache_t *cache;
+   cache_entry_list_t *entry = NULL;
+   const time_t now = time(NULL);
+
+   BSON_ASSERT_PARAM(ssl);
+   BSON_ASSERT_PARAM(key);
+
+   if (!(cache = _session_cache_get(SSL_get_SSL_CTX(ssl)))) {
+      return false;
+   }
+
+   bson_free(SSL_get_ex_data(ssl, ssl_key_index));
+   SSL_set_ex_data(ssl, ssl_key_index, bson_strdup(key));
+
+   bson_mutex_lock(&cache->mutex);
+   LL_SEARCH(cache->entries, entry, key, cache_cmp);
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+   if (entry && require_ocsp && !_cache_entry_ocsp_good(entry)) {
+      /* Do a full handshake so the server's OCSP status is checked again. */
+      entry = NULL;
+   }
+#else
+   BSON_UNUSED(require_ocsp);
+#endif
+   while (entry && entry->n_sessions > 0) {
+      SSL_SESSION *session = entry->sessions[entry->n_sessions - 1];
+
+      if (_session_expired(session, now)) {
+         SSL_SESSION_free(session);
+         entry->n_sessions--;
+         continue;
+      }
+
+      /* SSL_set_session takes its own reference. */
+      SSL_set_session(ssl, session);
+
+      if (_session_is_single_use(session)) {
+         SSL_SESSION_free(session);
+         entry->n_sessions--;
+      }
+
+      break;
+   }
+   bson_mutex_unlock(&cache->mutex);
+
+   return true;
+}
+
+void
+_mongoc_openssl_session_cache_remove(SSL *ssl)
+{
+   session_cache_t *cache;
+   cache_entry_list_t *entry = NULL;
+   const char *key;
+
+   BSON_ASSERT_PARAM(ssl);
+
+   cache = _session_cache_get(SSL_get_SSL_CTX(ssl));
+   key = (const char *)SSL_get_ex_data(ssl, ssl_key_index);
+
+   if (!cache || !key) {
+      return;
+   }
+
+   bson_mutex_lock(&cache->mutex);
+   LL_SEARCH(cache->entries, entry, key, cache_cmp);
+   if (entry) {
+      LL_DELETE(cache->entries, entry);
+      cache_entry_destroy(entry);
+   }
+   bson_mutex_unlock(&cache->mutex);
+}
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+void
+_mongoc_openssl_session_cache_set_ocsp_peer(SSL *ssl)
+{
+   session_cache_t *cache;
+   cache_entry_list_t *entry;
+   const char *key;
+   X509 *peer;
+   OCSP_CERTID *id;
+
+   BSON_ASSERT_PARAM(ssl);
+
+   cache = _session_cache_get(SSL_get_SSL_CTX(ssl));
+   key = (const char *)SSL_get_ex_data(ssl, ssl_key_index);
+
+   if (!cache || !key) {
+      return;
+   }
+
+   peer = SSL_get_peer_certificate(ssl);
+   id = _mongoc_ocsp_peer_cert_id(ssl);
+   if (!peer || !id) {
+      /* Record nothing, so no session for this server is resumed. */
+      X509_free(peer);
+      OCSP_CERTID_free(id);
+      peer = NULL;
+      id = NULL;
+   }
+
+   bson_mutex_lock(&cache->mutex);
+   entry = _cache_entry_get_or_create(cache, key);
+   X509_free(entry->ocsp_peer);
+   OCSP_CERTID_free(entry->ocsp_id);
+   entry->ocsp_peer = peer;
+   entry->ocsp_id = id;
+   bson_mutex_unlock(&cache->mutex);
+}
+
+bool
+_mongoc_openssl_session_cache_check_ocsp(SSL *ssl)
+{
+   session_cache_t *cache;
+   cache_entry_list_t *entry = NULL;
+   const char *key;
+   X509 *peer;
+   bool ret;
+
+   BSON_ASSERT_PARAM(ssl);
+
+   cache = _session_cache_get(SSL_get_SSL_CTX(ssl));
+   key = (const char *)SSL_get_ex_data(ssl, ssl_key_index);
+
+   if (!cache || !key || !(peer = SSL_get_peer_certificate(ssl))) {
+      return false;
+   }
+
+   bson_mutex_lock(&cache->mutex);
+   LL_SEARCH(cache->entries, entry, key, cache_cmp);
+   ret = entry && entry->ocsp_peer && 0 == X509_cmp(peer, entry->ocsp_peer) && _cache_entry_ocsp_good(entry);
+   bson_mutex_unlock(&cache->mutex);
+
+   X509_free(peer);
+
+   return ret;
+}
+#endif /* MONGOC_ENABLE_OCSP_OPENSSL */
+
+size_t
+_mongoc_openssl_session_cache_count(SSL_CTX *ctx, const char *key)
+{
+   session_cache_t *cache;
+   cache_entry_list_t *entry = NULL;
+   size_t count = 0;
+
+   BSON_ASSERT_PARAM(key);
+
+   if (!(cache = _session_cache_get(ctx))) {
+      return 0;
+   }
+
+   bson_mutex_lock(&cache->mutex);
+   LL_SEARCH(cache->entries, entry, key, cache_cmp);
+   if (entry) {
+      count = entry->n_sessions;
+   }
+   bson_mutex_unlock(&cache->mutex);
+
+   return count;
+}
+
+#endif /* defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L */
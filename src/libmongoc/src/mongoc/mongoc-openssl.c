@@ -21,6 +21,7 @@
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-http-private.h>
 #include <mongoc/mongoc-openssl-private.h>
+#include <mongoc/mongoc-openssl-session-cache-private.h>
 #include <mongoc/mongoc-stream-tls-openssl-private.h>
 #include <mongoc/mongoc-thread-private.h>
 #include <mongoc/mongoc-trace-private.h>
@@ -91,6 +92,8 @@ _mongoc_openssl_init(void)
    OpenSSL_add_all_algorithms();
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
    _mongoc_openssl_thread_startup();
+#else
+   _mongoc_openssl_session_cache_init();
 #endif
 
    ctx = SSL_CTX_new(SSLv23_method());
@@ -722,6 +725,28 @@ _contact_ocsp_responder(OCSP_CERTID *id, X509 *peer, mongoc_ssl_opt_t *ssl_opts,
    RETURN(resp);
 }
 
+OCSP_CERTID *
+_mongoc_ocsp_peer_cert_id(SSL *ssl)
+{
+   X509 *peer, *issuer;
+   STACK_OF(X509) *cert_chain;
+   OCSP_CERTID *id = NULL;
+
+   if (!(peer = SSL_get_peer_certificate(ssl))) {
+      return NULL;
+   }
+
+   if ((cert_chain = _get_verified_chain(ssl))) {
+      if ((issuer = _get_issuer(peer, cert_chain))) {
+         id = OCSP_cert_to_id(NULL /* SHA1 */, peer, issuer);
+      }
+      _free_verified_chain(cert_chain);
+   }
+
+   X509_free(peer);
+   return id;
+}
+
 #define SOFT_FAIL(...) ((stapled_response) ? MONGOC_ERROR(__VA_ARGS__) : MONGOC_DEBUG(__VA_ARGS__))
 
 #define OCSP_VERIFY_SUCCESS 1
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_PROBES_PRIVATE_H
+#define MONGOC_PROBES_PRIVATE_H
+
+#include <mongoc/mongoc-config.h>
+
+/* USDT static probes under the "mongoc" provider, e.g. usdt:...:mongoc:command_start in bpftrace. Each probe is a
+ * single nop until a tracer attaches, so unlike ENTRY and TRACE they are cheap enough to leave in release builds.
+ * Without MONGOC_ENABLE_USDT the arguments are not evaluated at all, so they must not have side effects. Keep the
+ * list in doc/usdt_probes.rst in sync. */
+
+#ifdef MONGOC_ENABLE_USDT
+#include <sys/sdt.h>
+
+#define MONGOC_PROBE1(name, a1) DTRACE_PROBE1(mongoc, name, a1)
+#define MONGOC_PROBE2(name, a1, a2) DTRACE_PROBE2(mongoc, name, a1, a2)
+#define MONGOC_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(mongoc, name, a1, a2, a3)
+#define MONGOC_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(mongoc, name, a1, a2, a3, a4)
+#else
+#define MONGOC_PROBE1(name, a1) ((void)0)
+#define MONGOC_PROBE2(name, a1, a2) ((void)0)
+#define MONGOC_PROBE3(name, a1, a2, a3) ((void)0)
+#define MONGOC_PROBE4(name, a1, a2, a3, a4) ((void)0)
+#endif
+
+#endif /* MONGOC_PROBES_PRIVATE_H */
@@ -170,15 +170,18 @@ _mongoc_sasl_get_canonicalized_name(mongoc_stream_t *node_stream, /* IN */
 
    if (stream->type == MONGOC_STREAM_SOCKET) {
       sock = mongoc_stream_socket_get_socket((mongoc_stream_socket_t *)stream);
-      if (sock) {
-         canonicalized = mongoc_socket_getnameinfo(sock);
-         if (canonicalized) {
-            // Truncation is OK.
-            int req = bson_snprintf(name, namelen, "%s", canonicalized);
-            BSON_ASSERT(req > 0);
-            bson_free(canonicalized);
-            RETURN(true);
-         }
+   } else if (stream->type == MONGOC_STREAM_URING) {
+      sock = mongoc_stream_uring_get_socket((mongoc_stream_uring_t *)stream);
+   }
+
+   if (sock) {
+      canonicalized = mongoc_socket_getnameinfo(sock);
+      if (canonicalized) {
+         // Truncation is OK.
+         int req = bson_snprintf(name, namelen, "%s", canonicalized);
+         BSON_ASSERT(req > 0);
+         bson_free(canonicalized);
+         RETURN(true);
       }
    }
 
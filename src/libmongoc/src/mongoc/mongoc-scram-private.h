@@ -42,6 +42,8 @@ enum {
    /* It is unlikely that there will be more than 64 different user accounts
     * used in a single process */
    MONGOC_SCRAM_CACHE_SIZE = 64,
+   /* Number of consecutive slots searched for a cache key before evicting */
+   MONGOC_SCRAM_CACHE_PROBE_LENGTH = 4,
 };
 
 typedef struct _mongoc_scram_t {
@@ -52,6 +54,7 @@ typedef struct _mongoc_scram_t {
    uint8_t decoded_salt[MONGOC_SCRAM_B64_HASH_MAX_SIZE];
    uint32_t iterations;
    uint8_t client_key[MONGOC_SCRAM_HASH_MAX_SIZE];
+   uint8_t stored_key[MONGOC_SCRAM_HASH_MAX_SIZE];
    uint8_t server_key[MONGOC_SCRAM_HASH_MAX_SIZE];
    uint8_t salted_password[MONGOC_SCRAM_HASH_MAX_SIZE];
    char encoded_nonce[48];
@@ -65,8 +68,32 @@ typedef struct _mongoc_scram_t {
 } mongoc_scram_t;
 
 #ifdef MONGOC_ENABLE_CRYPTO
+typedef struct _mongoc_scram_cache_entry_t {
+   /* book keeping */
+   bool taken;
+   /* pre-secrets */
+   mongoc_crypto_hash_algorithm_t algorithm;
+   char hashed_password[MONGOC_SCRAM_HASH_MAX_SIZE];
+   uint8_t decoded_salt[MONGOC_SCRAM_B64_HASH_MAX_SIZE];
+   uint32_t iterations;
+   /* secrets */
+   uint8_t client_key[MONGOC_SCRAM_HASH_MAX_SIZE];
+   uint8_t stored_key[MONGOC_SCRAM_HASH_MAX_SIZE];
+   uint8_t server_key[MONGOC_SCRAM_HASH_MAX_SIZE];
+   uint8_t salted_password[MONGOC_SCRAM_HASH_MAX_SIZE];
+} mongoc_scram_cache_entry_t;
+
 void
 _mongoc_scram_init(mongoc_scram_t *scram, mongoc_crypto_hash_algorithm_t algo);
+
+/* Looks up the secrets derived from scram's pre-secrets in the process-wide
+ * cache. Does not block on concurrent writers. */
+bool
+_mongoc_scram_cache_has_presecrets(mongoc_scram_cache_entry_t *cache /* out */, const mongoc_scram_t *scram);
+
+/* Records scram's pre-secrets and derived secrets in the process-wide cache. */
+void
+_mongoc_scram_update_cache(const mongoc_scram_t *scram);
 #endif
 
 void
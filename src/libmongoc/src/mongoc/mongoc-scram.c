@@ -17,6 +17,7 @@
 
 #ifdef MONGOC_ENABLE_CRYPTO
 
+#include <common-atomic-private.h>
 #include <common-b64-private.h>
 #include <common-thread-private.h>
 #include <mongoc/mongoc-crypto-private.h>
@@ -34,18 +35,12 @@
 
 #include <string.h>
 
-typedef struct _mongoc_scram_cache_entry_t {
-   /* book keeping */
-   bool taken;
-   /* pre-secrets */
-   char hashed_password[MONGOC_SCRAM_HASH_MAX_SIZE];
-   uint8_t decoded_salt[MONGOC_SCRAM_B64_HASH_MAX_SIZE];
-   uint32_t iterations;
-   /* secrets */
-   uint8_t client_key[MONGOC_SCRAM_HASH_MAX_SIZE];
-   uint8_t server_key[MONGOC_SCRAM_HASH_MAX_SIZE];
-   uint8_t salted_password[MONGOC_SCRAM_HASH_MAX_SIZE];
-} mongoc_scram_cache_entry_t;
+typedef struct _mongoc_scram_cache_slot_t {
+   /* Sequence counter guarding `entry`. Odd while a writer is updating the
+    * slot. Readers retry (or report a miss) if it changes during a copy. */
+   int32_t seq;
+   mongoc_scram_cache_entry_t entry;
+} mongoc_scram_cache_slot_t;
 
 #define MONGOC_SCRAM_SERVER_KEY "Server Key"
 #define MONGOC_SCRAM_CLIENT_KEY "Client Key"
@@ -76,34 +71,28 @@ _mongoc_utf8_code_point_length(uint32_t c);
 ssize_t
 _mongoc_utf8_code_point_to_str(uint32_t c, char *out);
 
-static bson_shared_mutex_t g_scram_cache_rwlock;
+/* Serializes writers. Readers never take a lock. */
+static bson_mutex_t g_scram_cache_write_lock;
 
 static bson_once_t init_cache_once_control = BSON_ONCE_INIT;
-static bson_mutex_t clear_cache_lock;
 
 /*
- * Cache lookups are a linear search through this table. This table is a
- * constant size, which is small enough that lookup cost is insignificant.
+ * The cache is an open-addressed table keyed by (algorithm, hashed password,
+ * salt, iterations). Every client and pool in the process shares it, so a
+ * reconnect storm derives the salted password once and then only needs the
+ * per-conversation HMACs.
  *
- * This can be refactored into a hashmap if the cache size needs to grow larger
- * in the future, but a linear lookup is currently fast enough and is much
- * simpler logic to reason about.
+ * Each slot is protected by a sequence counter rather than a lock: lookups
+ * copy the slot and retry if a writer touched it meanwhile. When all probe
+ * slots for a key are taken, one of them is evicted in round-robin order.
  */
-static mongoc_scram_cache_entry_t g_scram_cache[MONGOC_SCRAM_CACHE_SIZE];
-
-static void
-_mongoc_scram_cache_clear(void)
-{
-   bson_mutex_lock(&clear_cache_lock);
-   memset(g_scram_cache, 0, sizeof(g_scram_cache));
-   bson_mutex_unlock(&clear_cache_lock);
-}
+static mongoc_scram_cache_slot_t g_scram_cache[MONGOC_SCRAM_CACHE_SIZE];
+static size_t g_scram_cache_evict_next;
 
 static BSON_ONCE_FUN(_mongoc_scram_cache_init)
 {
-   bson_shared_mutex_init(&g_scram_cache_rwlock);
-   bson_mutex_init(&clear_cache_lock);
-   _mongoc_scram_cache_clear();
+   bson_mutex_init(&g_scram_cache_write_lock);
+   memset(g_scram_cache, 0, sizeof(g_scram_cache));
 
    BSON_ONCE_RETURN;
 }
@@ -114,6 +103,85 @@ _mongoc_scram_cache_init_once(void)
    bson_once(&init_cache_once_control, _mongoc_scram_cache_init);
 }
 
+/* FNV-1a over the cache key. */
+static uint32_t
+_mongoc_scram_cache_hash(const mongoc_scram_t *scram)
+{
+   uint32_t hash = 2166136261u;
+   const uint32_t prime = 16777619u;
+   const uint8_t algorithm = (uint8_t)scram->crypto.algorithm;
+   const size_t password_len = strlen(scram->hashed_password);
+
+   hash = (hash ^ algorithm) * prime;
+
+   for (size_t i = 0; i < password_len; i++) {
+      hash = (hash ^ (uint8_t)scram->hashed_password[i]) * prime;
+   }
+
+   for (size_t i = 0; i < sizeof(scram->decoded_salt); i++) {
+      hash = (hash ^ scram->decoded_salt[i]) * prime;
+   }
+
+   for (size_t i = 0; i < sizeof(scram->iterations); i++) {
+      hash = (hash ^ (uint8_t)(scram->iterations >> (8u * i))) * prime;
+   }
+
+   return hash;
+}
+
+static bool
+_mongoc_scram_cache_entry_matches(const mongoc_scram_cache_entry_t *entry, const mongoc_scram_t *scram)
+{
+   return entry->taken && entry->algorithm == scram->crypto.algorithm && entry->iterations == scram->iterations &&
+          !strncmp(entry->hashed_password, scram->hashed_password, sizeof(entry->hashed_password)) &&
+          !memcmp(entry->decoded_salt, scram->decoded_salt, sizeof(entry->decoded_salt));
+}
+
+/* Copies a consistent snapshot of `slot` into `out`. Returns false if a
+ * writer kept the slot busy for every attempt. */
+static bool
+_mongoc_scram_cache_slot_read(mongoc_scram_cache_slot_t *slot, mongoc_scram_cache_entry_t *out)
+{
+   for (int attempt = 0; attempt < 4; attempt++) {
+      const int32_t before = mcommon_atomic_int32_fetch(&slot->seq, mcommon_memory_order_acquire);
+      if (before & 1) {
+         continue;
+      }
+
+      memcpy(out, &slot->entry, sizeof(*out));
+      mcommon_atomic_thread_fence();
+
+      if (mcommon_atomic_int32_fetch(&slot->seq, mcommon_memory_order_relaxed) == before) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/* Requires g_scram_cache_write_lock. */
+static void
+_mongoc_scram_cache_slot_write(mongoc_scram_cache_slot_t *slot, const mongoc_scram_t *scram)
+{
+   mongoc_scram_cache_entry_t *const entry = &slot->entry;
+
+   mcommon_atomic_int32_fetch_add(&slot->seq, 1, mcommon_memory_order_acq_rel);
+   mcommon_atomic_thread_fence();
+
+   entry->taken = true;
+   entry->algorithm = scram->crypto.algorithm;
+   entry->iterations = scram->iterations;
+   memcpy(entry->hashed_password, scram->hashed_password, sizeof(entry->hashed_password));
+   memcpy(entry->decoded_salt, scram->decoded_salt, sizeof(entry->decoded_salt));
+   memcpy(entry->client_key, scram->client_key, sizeof(entry->client_key));
+   memcpy(entry->stored_key, scram->stored_key, sizeof(entry->stored_key));
+   memcpy(entry->server_key, scram->server_key, sizeof(entry->server_key));
+   memcpy(entry->salted_password, scram->salted_password, sizeof(entry->salted_password));
+
+   mcommon_atomic_thread_fence();
+   mcommon_atomic_int32_fetch_add(&slot->seq, 1, mcommon_memory_order_release);
+}
+
 static int
 _scram_hash_size(mongoc_scram_t *scram)
 {
@@ -134,61 +202,41 @@ _mongoc_scram_cache_apply_secrets(mongoc_scram_cache_entry_t *cache, mongoc_scra
    BSON_ASSERT(scram);
 
    memcpy(scram->client_key, cache->client_key, sizeof(scram->client_key));
+   memcpy(scram->stored_key, cache->stored_key, sizeof(scram->stored_key));
    memcpy(scram->server_key, cache->server_key, sizeof(scram->server_key));
    memcpy(scram->salted_password, cache->salted_password, sizeof(scram->salted_password));
 }
 
 
-void
-_mongoc_scram_cache_destroy(mongoc_scram_cache_entry_t *cache)
-{
-   BSON_ASSERT(cache);
-   bson_free(cache);
-}
-
-
 /*
  * Checks whether the cache contains scram's pre-secrets.
  * Populate `cache` with the values found in the global cache if found.
  */
-static bool
+bool
 _mongoc_scram_cache_has_presecrets(mongoc_scram_cache_entry_t *cache /* out */, const mongoc_scram_t *scram)
 {
-   bool cache_hit = false;
-
    BSON_ASSERT(cache);
    BSON_ASSERT(scram);
 
    _mongoc_scram_cache_init_once();
 
-   /*
-    * - Take a read lock
-    * - Search through g_scram_cache if the hashed_password, decoded_salt, and
-    *   iterations match an entry.
-    * - If so, then return true
-    * - Otherwise return false
-    */
-   bson_shared_mutex_lock_shared(&g_scram_cache_rwlock);
-
-   for (size_t i = 0; i < MONGOC_SCRAM_CACHE_SIZE; i++) {
-      if (g_scram_cache[i].taken) {
-         mongoc_scram_cache_entry_t *cache_entry = &g_scram_cache[i];
-         cache_hit = !strcmp(cache_entry->hashed_password, scram->hashed_password) &&
-                     cache_entry->iterations == scram->iterations &&
-                     !memcmp(cache_entry->decoded_salt, scram->decoded_salt, sizeof(cache_entry->decoded_salt));
-         if (cache_hit) {
-            /* copy the found cache items into the 'cache' output parameter */
-            memcpy(cache->client_key, cache_entry->client_key, sizeof(cache->client_key));
-            memcpy(cache->server_key, cache_entry->server_key, sizeof(cache->server_key));
-            memcpy(cache->salted_password, cache_entry->salted_password, sizeof(cache->salted_password));
-            goto done;
-         }
+   const uint32_t hash = _mongoc_scram_cache_hash(scram);
+
+   for (size_t probe = 0; probe < MONGOC_SCRAM_CACHE_PROBE_LENGTH; probe++) {
+      mongoc_scram_cache_slot_t *const slot = &g_scram_cache[(hash + probe) % MONGOC_SCRAM_CACHE_SIZE];
+
+      if (!_mongoc_scram_cache_slot_read(slot, cache)) {
+         /* Treat a slot under contention as a miss rather than wait. */
+         continue;
+      }
+
+      if (_mongoc_scram_cache_entry_matches(cache, scram)) {
+         return true;
       }
    }
 
-done:
-   bson_shared_mutex_unlock_shared(&g_scram_cache_rwlock);
-   return cache_hit;
+   memset(cache, 0, sizeof(*cache));
+   return false;
 }
 
 
@@ -247,49 +295,40 @@ _mongoc_scram_destroy(mongoc_scram_t *scram)
 static void
 _mongoc_scram_cache_insert(const mongoc_scram_t *scram)
 {
-   bson_shared_mutex_lock(&g_scram_cache_rwlock);
-
-again:
-   for (size_t i = 0; i < MONGOC_SCRAM_CACHE_SIZE; i++) {
-      mongoc_scram_cache_entry_t *cache_entry = &g_scram_cache[i];
-      bool already_exists =
-         !strcmp(cache_entry->hashed_password, scram->hashed_password) &&
-         cache_entry->iterations == scram->iterations &&
-         !memcmp(cache_entry->decoded_salt, scram->decoded_salt, sizeof(cache_entry->decoded_salt)) &&
-         !memcmp(cache_entry->client_key, scram->client_key, sizeof(cache_entry->client_key)) &&
-         !memcmp(cache_entry->server_key, scram->server_key, sizeof(cache_entry->server_key)) &&
-         !memcmp(cache_entry->salted_password, scram->salted_password, sizeof(cache_entry->salted_password));
-
-      if (already_exists) {
-         /* cache entry already populated between read and write lock
+   const uint32_t hash = _mongoc_scram_cache_hash(scram);
+   mongoc_scram_cache_slot_t *target = NULL;
+
+   bson_mutex_lock(&g_scram_cache_write_lock);
+
+   for (size_t probe = 0; probe < MONGOC_SCRAM_CACHE_PROBE_LENGTH; probe++) {
+      mongoc_scram_cache_slot_t *const slot = &g_scram_cache[(hash + probe) % MONGOC_SCRAM_CACHE_SIZE];
+
+      /* Writers are serialized, so the slot can be inspected directly. */
+      if (_mongoc_scram_cache_entry_matches(&slot->entry, scram)) {
+         /* cache entry already populated between lookup and write lock
           * acquisition, skipping */
-         break;
+         goto done;
       }
 
-      if (!cache_entry->taken) {
-         /* found an empty slot */
-         memcpy(cache_entry->client_key, scram->client_key, sizeof(cache_entry->client_key));
-         memcpy(cache_entry->server_key, scram->server_key, sizeof(cache_entry->server_key));
-         memcpy(cache_entry->salted_password, scram->salted_password, sizeof(cache_entry->salted_password));
-         memcpy(cache_entry->decoded_salt, scram->decoded_salt, sizeof(cache_entry->decoded_salt));
-         memcpy(cache_entry->hashed_password, scram->hashed_password, sizeof(cache_entry->hashed_password));
-         cache_entry->iterations = scram->iterations;
-         cache_entry->taken = true;
-         break;
+      if (!target && !slot->entry.taken) {
+         target = slot;
       }
+   }
 
-      /* if cache is full, then invalidate the cache and insert again */
-      if (i == (MONGOC_SCRAM_CACHE_SIZE - 1)) {
-         _mongoc_scram_cache_clear();
-         goto again;
-      }
+   if (!target) {
+      /* every probe slot is taken: evict one of them */
+      const size_t probe = g_scram_cache_evict_next++ % MONGOC_SCRAM_CACHE_PROBE_LENGTH;
+      target = &g_scram_cache[(hash + probe) % MONGOC_SCRAM_CACHE_SIZE];
    }
 
-   bson_shared_mutex_unlock(&g_scram_cache_rwlock);
+   _mongoc_scram_cache_slot_write(target, scram);
+
+done:
+   bson_mutex_unlock(&g_scram_cache_write_lock);
 }
 
 /* Updates the cache with scram's last-used pre-secrets and secrets */
-static void
+void
 _mongoc_scram_update_cache(const mongoc_scram_t *scram)
 {
    mongoc_scram_cache_entry_t cache;
@@ -472,7 +511,6 @@ _mongoc_scram_salt_password(mongoc_scram_t *scram,
 static bool
 _mongoc_scram_generate_client_proof(mongoc_scram_t *scram, uint8_t *outbuf, uint32_t outbufmax, uint32_t *outbuflen)
 {
-   uint8_t stored_key[MONGOC_SCRAM_HASH_MAX_SIZE];
    uint8_t client_signature[MONGOC_SCRAM_HASH_MAX_SIZE];
    unsigned char client_proof[MONGOC_SCRAM_HASH_MAX_SIZE];
    int i;
@@ -488,12 +526,14 @@ _mongoc_scram_generate_client_proof(mongoc_scram_t *scram, uint8_t *outbuf, uint
                          scram->client_key);
    }
 
-   /* StoredKey := H(client_key) */
-   mongoc_crypto_hash(&scram->crypto, scram->client_key, (size_t)_scram_hash_size(scram), stored_key);
+   if (!*scram->stored_key) {
+      /* StoredKey := H(client_key) */
+      mongoc_crypto_hash(&scram->crypto, scram->client_key, (size_t)_scram_hash_size(scram), scram->stored_key);
+   }
 
    /* ClientSignature := HMAC(StoredKey, AuthMessage) */
    mongoc_crypto_hmac(&scram->crypto,
-                      stored_key,
+                      scram->stored_key,
                       _scram_hash_size(scram),
                       scram->auth_message,
                       scram->auth_messagelen,
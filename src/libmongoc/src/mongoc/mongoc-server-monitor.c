@@ -16,6 +16,7 @@
 
 #include <common-atomic-private.h>
 #include <common-thread-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-handshake-private.h>
@@ -935,6 +936,7 @@ _server_monitor_setup_connection(mongoc_server_monitor_t *server_monitor,
                                                      &server_monitor->description->host,
                                                      openssl_ctx_void,
                                                      secure_channel_cred_ptr,
+                                                     server_monitor->topology->dns_cache,
                                                      error);
    }
 
@@ -1184,6 +1186,10 @@ static BSON_THREAD_FUN(_server_monitor_thread, server_monitor_void)
    mongoc_server_description_t *previous_description;
 
    server_monitor = (mongoc_server_monitor_t *)server_monitor_void;
+
+   // Monitor threads only do topology work, so attribute everything they allocate to it.
+   _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_TOPOLOGY);
+
    description = mongoc_server_description_new_copy(server_monitor->description);
    previous_description = NULL;
 
@@ -1275,6 +1281,8 @@ static BSON_THREAD_FUN(_server_monitor_rtt_thread, server_monitor_void)
 {
    mongoc_server_monitor_t *server_monitor = server_monitor_void;
 
+   _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_TOPOLOGY);
+
    while (true) {
       int64_t rtt_ms;
       bson_error_t error;
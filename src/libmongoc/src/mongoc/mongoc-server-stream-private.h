@@ -20,6 +20,7 @@
 #define MONGOC_SERVER_STREAM_H
 
 #include <mongoc/mongoc-server-description-private.h>
+#include <mongoc/mongoc-server-wire-stats-private.h>
 #include <mongoc/mongoc-topology-description-private.h>
 
 #include <mongoc/mongoc-config.h>
@@ -43,6 +44,13 @@ typedef struct _mongoc_server_stream_t {
    bool retry_attempted;
    bool timed_out;   // True if an operation on `stream` timed out.
    bool needs_hello; // True if `stream` has not-yet sent the handshake hello command. Used to apply error labels.
+   // Time spent selecting the server and checking out `stream`, or -1 if not measured. Reported with the first
+   // command sent on this server stream, then reset to -1.
+   int64_t selection_usec;
+   int64_t checkout_usec;
+   // The statistics of the messages exchanged on `stream`, borrowed from its cluster or scanner node. NULL for
+   // server streams that run the handshake or authentication, before the node holds the stream.
+   mongoc_wire_stats_server_t *wire_stats;
 } mongoc_server_stream_t;
 
 
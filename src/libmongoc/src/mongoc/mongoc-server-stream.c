@@ -38,6 +38,9 @@ mongoc_server_stream_new(const mongoc_topology_description_t *td,
    server_stream->retry_attempted = false;
    server_stream->timed_out = false;
    server_stream->needs_hello = false; // Assume hello already sent.
+   server_stream->selection_usec = -1;
+   server_stream->checkout_usec = -1;
+   server_stream->wire_stats = NULL; // Set by the caller if the stream is held by a node.
 
    return server_stream;
 }
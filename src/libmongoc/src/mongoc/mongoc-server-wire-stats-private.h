@@ -0,0 +1,74 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_SERVER_WIRE_STATS_PRIVATE_H
+#define MONGOC_SERVER_WIRE_STATS_PRIVATE_H
+
+#include <mongoc/mongoc-counters-private.h>
+#include <mongoc/mongoc-server-wire-stats.h> // IWYU pragma: export
+#include <mongoc/mongoc-topology-description-private.h>
+
+//
+
+#include <bson/bson.h>
+
+BSON_BEGIN_DECLS
+
+/* The wire statistics of one server, in one slot per CPU. Reference counted:
+ * each connection to the server holds a reference, so recording a message
+ * needs no lock and no lookup. */
+typedef struct _mongoc_wire_stats_server_t mongoc_wire_stats_server_t;
+
+/* The wire statistics of the servers of a topology that it has connected to,
+ * keyed by server id. A server is dropped once it leaves the topology
+ * description; connections that still hold it record into it until they
+ * close, but it no longer appears in snapshots. */
+typedef struct _mongoc_wire_stats_t mongoc_wire_stats_t;
+
+mongoc_wire_stats_t *
+_mongoc_wire_stats_new(void);
+
+void
+_mongoc_wire_stats_destroy(mongoc_wire_stats_t *stats);
+
+/* Returns a new reference to the statistics of @server_id, adding them on
+ * first use, or NULL if @server_id is not in @td. Called when a connection is
+ * opened; release the result with _mongoc_wire_stats_server_release. */
+mongoc_wire_stats_server_t *
+_mongoc_wire_stats_get_server(mongoc_wire_stats_t *stats,
+                              const mongoc_topology_description_t *td,
+                              uint32_t server_id,
+                              const char *host_and_port);
+
+void
+_mongoc_wire_stats_server_release(mongoc_wire_stats_server_t *server);
+
+/* Adds @delta to the calling CPU's slot of the server, and of its shared
+ * memory slots. */
+void
+_mongoc_wire_stats_server_record(mongoc_wire_stats_server_t *server, const mongoc_wire_stats_values_t *delta);
+
+/* Returns a copy of the totals of every server in @td that has been connected
+ * to, to be freed with mongoc_server_wire_stats_destroy_all, or NULL if there
+ * is none. */
+mongoc_server_wire_stats_t **
+_mongoc_wire_stats_snapshot(mongoc_wire_stats_t *stats, const mongoc_topology_description_t *td, size_t *n);
+
+BSON_END_DECLS
+
+#endif /* MONGOC_SERVER_WIRE_STATS_PRIVATE_H */
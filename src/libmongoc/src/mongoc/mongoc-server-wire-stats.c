@@ -0,0 +1,388 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common-atomic-private.h>
+#include <common-thread-private.h>
+#include <mongoc/mongoc-server-wire-stats-private.h>
+#include <mongoc/mongoc-set-private.h>
+#include <mongoc/mongoc-topology-description-private.h>
+
+#include <bson/bson.h>
+
+
+struct _mongoc_wire_stats_server_t {
+   /* Held by the topology's set of servers and by each connection. */
+   int refcount;
+   char host_and_port[BSON_HOST_NAME_MAX + 7];
+   /* _mongoc_get_cpu_count() slots. A thread adds to the slot of the CPU it
+    * runs on, and _mongoc_wire_stats_snapshot adds them up. */
+   mongoc_wire_stats_slot_t *cpus;
+   /* The process-wide slots for this host, or NULL if it is not exported. */
+   mongoc_wire_stats_slot_t *shm;
+};
+
+
+struct _mongoc_server_wire_stats_t {
+   uint32_t server_id;
+   char host_and_port[BSON_HOST_NAME_MAX + 7];
+   mongoc_wire_stats_values_t values;
+};
+
+
+struct _mongoc_wire_stats_t {
+   /* Guards the set. Only taken to open connections and take snapshots. */
+   bson_mutex_t lock;
+   mongoc_set_t *servers;
+};
+
+
+static void
+_mongoc_wire_stats_server_dtor(void *item, void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   _mongoc_wire_stats_server_release(item);
+}
+
+
+mongoc_wire_stats_t *
+_mongoc_wire_stats_new(void)
+{
+   mongoc_wire_stats_t *const stats = bson_malloc0(sizeof *stats);
+
+   bson_mutex_init(&stats->lock);
+   stats->servers = mongoc_set_new(8, _mongoc_wire_stats_server_dtor, NULL);
+
+   return stats;
+}
+
+
+void
+_mongoc_wire_stats_destroy(mongoc_wire_stats_t *stats)
+{
+   if (!stats) {
+      return;
+   }
+
+   mongoc_set_destroy(stats->servers);
+   bson_mutex_destroy(&stats->lock);
+   bson_free(stats);
+}
+
+
+/* Drops the servers that are no longer in @td. Requires stats->lock. A server
+ * that is removed and added again gets a new id, so its totals start over. */
+static void
+_mongoc_wire_stats_prune(mongoc_wire_stats_t *stats, const mongoc_topology_description_t *td)
+{
+   uint32_t *ids_to_remove;
+   size_t n_ids_to_remove = 0u;
+
+   ids_to_remove = BSON_ARRAY_ALLOC0(stats->servers->items_len, uint32_t);
+   for (size_t i = 0u; i < stats->servers->items_len; i++) {
+      uint32_t id;
+
+      (void)mongoc_set_get_item_and_id(stats->servers, i, &id);
+      if (!mongoc_set_get_const(mc_tpld_servers_const(td), id)) {
+         ids_to_remove[n_ids_to_remove++] = id;
+      }
+   }
+
+   for (size_t i = 0u; i < n_ids_to_remove; i++) {
+      mongoc_set_rm(stats->servers, ids_to_remove[i]);
+   }
+   bson_free(ids_to_remove);
+}
+
+
+mongoc_wire_stats_server_t *
+_mongoc_wire_stats_get_server(mongoc_wire_stats_t *stats,
+                              const mongoc_topology_description_t *td,
+                              uint32_t server_id,
+                              const char *host_and_port)
+{
+   mongoc_wire_stats_server_t *server = NULL;
+
+   BSON_ASSERT_PARAM(stats);
+   BSON_ASSERT_PARAM(td);
+   BSON_ASSERT_PARAM(host_and_port);
+
+   bson_mutex_lock(&stats->lock);
+
+   _mongoc_wire_stats_prune(stats, td);
+
+   if (!mongoc_set_get_const(mc_tpld_servers_const(td), server_id)) {
+      /* Removed since the caller looked it up. */
+      goto done;
+   }
+
+   server = mongoc_set_get(stats->servers, server_id);
+   if (!server) {
+      const size_t n_cpu = _mongoc_get_cpu_count();
+
+      server = bson_malloc0(sizeof *server);
+      server->refcount = 1;
+      bson_strncpy(server->host_and_port, host_and_port, sizeof server->host_and_port);
+      server->cpus = bson_aligned_alloc0(BSON_ALIGNOF(mongoc_wire_stats_slot_t), n_cpu * sizeof *server->cpus);
+      server->shm = _mongoc_counters_server(host_and_port);
+      mongoc_set_add(stats->servers, server_id, server);
+   }
+
+   mcommon_atomic_int_fetch_add(&server->refcount, 1, mcommon_memory_order_relaxed);
+
+done:
+   bson_mutex_unlock(&stats->lock);
+
+   return server;
+}
+
+
+void
+_mongoc_wire_stats_server_release(mongoc_wire_stats_server_t *server)
+{
+   if (!server) {
+      return;
+   }
+
+   if (mcommon_atomic_int_fetch_sub(&server->refcount, 1, mcommon_memory_order_acq_rel) == 1) {
+      bson_free(server->cpus);
+      bson_free(server);
+   }
+}
+
+
+static void
+_mongoc_wire_stats_add(int64_t *total, int64_t delta)
+{
+   /* Most messages leave most fields unchanged. */
+   if (delta) {
+      mcommon_atomic_int64_fetch_add(total, delta, mcommon_memory_order_relaxed);
+   }
+}
+
+
+static void
+_mongoc_wire_stats_values_add(mongoc_wire_stats_values_t *values, const mongoc_wire_stats_values_t *delta)
+{
+   _mongoc_wire_stats_add(&values->messages_out, delta->messages_out);
+   _mongoc_wire_stats_add(&values->messages_in, delta->messages_in);
+   _mongoc_wire_stats_add(&values->bytes_out, delta->bytes_out);
+   _mongoc_wire_stats_add(&values->bytes_in, delta->bytes_in);
+   _mongoc_wire_stats_add(&values->compressed_bytes_out, delta->compressed_bytes_out);
+   _mongoc_wire_stats_add(&values->uncompressed_bytes_out, delta->uncompressed_bytes_out);
+   _mongoc_wire_stats_add(&values->compressed_bytes_in, delta->compressed_bytes_in);
+   _mongoc_wire_stats_add(&values->uncompressed_bytes_in, delta->uncompressed_bytes_in);
+   _mongoc_wire_stats_add(&values->in_flight_usec, delta->in_flight_usec);
+   _mongoc_wire_stats_add(&values->errors, delta->errors);
+}
+
+
+void
+_mongoc_wire_stats_server_record(mongoc_wire_stats_server_t *server, const mongoc_wire_stats_values_t *delta)
+{
+   BSON_ASSERT_PARAM(server);
+   BSON_ASSERT_PARAM(delta);
+
+   const unsigned cpu = _mongoc_sched_getcpu();
+
+   _mongoc_wire_stats_values_add(&server->cpus[cpu].values, delta);
+
+   if (server->shm) {
+      _mongoc_wire_stats_values_add(&server->shm[cpu].values, delta);
+   }
+}
+
+
+mongoc_server_wire_stats_t **
+_mongoc_wire_stats_snapshot(mongoc_wire_stats_t *stats, const mongoc_topology_description_t *td, size_t *n)
+{
+   mongoc_server_wire_stats_t **ret = NULL;
+   const unsigned n_cpu = _mongoc_get_cpu_count();
+
+   BSON_ASSERT_PARAM(stats);
+   BSON_ASSERT_PARAM(td);
+   BSON_ASSERT_PARAM(n);
+
+   bson_mutex_lock(&stats->lock);
+
+   _mongoc_wire_stats_prune(stats, td);
+
+   *n = stats->servers->items_len;
+
+   if (*n > 0) {
+      ret = bson_malloc0(*n * sizeof *ret);
+   }
+
+   for (size_t i = 0; i < *n; i++) {
+      uint32_t server_id;
+      const mongoc_wire_stats_server_t *const server = mongoc_set_get_item_and_id(stats->servers, i, &server_id);
+      mongoc_server_wire_stats_t *const out = bson_malloc0(sizeof *out);
+
+      out->server_id = server_id;
+      bson_strncpy(out->host_and_port, server->host_and_port, sizeof out->host_and_port);
+
+      for (unsigned cpu = 0; cpu < n_cpu; cpu++) {
+         const mongoc_wire_stats_values_t *const values = &server->cpus[cpu].values;
+
+#define SUM(field) out->values.field += mcommon_atomic_int64_fetch(&values->field, mcommon_memory_order_relaxed)
+
+         SUM(messages_out);
+         SUM(messages_in);
+         SUM(bytes_out);
+         SUM(bytes_in);
+         SUM(compressed_bytes_out);
+         SUM(uncompressed_bytes_out);
+         SUM(compressed_bytes_in);
+         SUM(uncompressed_bytes_in);
+         SUM(in_flight_usec);
+         SUM(errors);
+
+#undef SUM
+      }
+
+      ret[i] = out;
+   }
+
+   bson_mutex_unlock(&stats->lock);
+
+   return ret;
+}
+
+
+void
+mongoc_server_wire_stats_destroy(mongoc_server_wire_stats_t *stats)
+{
+   bson_free(stats);
+}
+
+
+void
+mongoc_server_wire_stats_destroy_all(mongoc_server_wire_stats_t **stats, size_t n)
+{
+   for (size_t i = 0; i < n; i++) {
+      mongoc_server_wire_stats_destroy(stats[i]);
+   }
+
+   bson_free(stats);
+}
+
+
+uint32_t
+mongoc_server_wire_stats_server_id(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->server_id;
+}
+
+
+const char *
+mongoc_server_wire_stats_host_and_port(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->host_and_port;
+}
+
+
+int64_t
+mongoc_server_wire_stats_messages_out(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.messages_out;
+}
+
+
+int64_t
+mongoc_server_wire_stats_messages_in(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.messages_in;
+}
+
+
+int64_t
+mongoc_server_wire_stats_bytes_out(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.bytes_out;
+}
+
+
+int64_t
+mongoc_server_wire_stats_bytes_in(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.bytes_in;
+}
+
+
+int64_t
+mongoc_server_wire_stats_compressed_bytes_out(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.compressed_bytes_out;
+}
+
+
+int64_t
+mongoc_server_wire_stats_uncompressed_bytes_out(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.uncompressed_bytes_out;
+}
+
+
+int64_t
+mongoc_server_wire_stats_compressed_bytes_in(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.compressed_bytes_in;
+}
+
+
+int64_t
+mongoc_server_wire_stats_uncompressed_bytes_in(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.uncompressed_bytes_in;
+}
+
+
+int64_t
+mongoc_server_wire_stats_in_flight_usec(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.in_flight_usec;
+}
+
+
+int64_t
+mongoc_server_wire_stats_errors(const mongoc_server_wire_stats_t *stats)
+{
+   BSON_ASSERT_PARAM(stats);
+
+   return stats->values.errors;
+}
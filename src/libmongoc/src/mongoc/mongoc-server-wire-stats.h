@@ -0,0 +1,79 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-prelude.h>
+
+#ifndef MONGOC_SERVER_WIRE_STATS_H
+#define MONGOC_SERVER_WIRE_STATS_H
+
+#include <mongoc/mongoc-macros.h>
+
+#include <bson/bson.h>
+
+
+BSON_BEGIN_DECLS
+
+
+typedef struct _mongoc_server_wire_stats_t mongoc_server_wire_stats_t;
+
+
+MONGOC_EXPORT(void)
+mongoc_server_wire_stats_destroy(mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(void)
+mongoc_server_wire_stats_destroy_all(mongoc_server_wire_stats_t **stats, size_t n);
+
+MONGOC_EXPORT(uint32_t)
+mongoc_server_wire_stats_server_id(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(const char *)
+mongoc_server_wire_stats_host_and_port(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_messages_out(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_messages_in(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_bytes_out(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_bytes_in(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_compressed_bytes_out(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_uncompressed_bytes_out(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_compressed_bytes_in(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_uncompressed_bytes_in(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_in_flight_usec(const mongoc_server_wire_stats_t *stats);
+
+MONGOC_EXPORT(int64_t)
+mongoc_server_wire_stats_errors(const mongoc_server_wire_stats_t *stats);
+
+
+BSON_END_DECLS
+
+
+#endif /* MONGOC_SERVER_WIRE_STATS_H */
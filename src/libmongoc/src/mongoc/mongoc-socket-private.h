@@ -32,11 +32,21 @@ struct _mongoc_socket_t {
    int errno_;
    int domain;
    int pid;
+   /* Sends of at least this many bytes use MSG_ZEROCOPY. 0 disables. */
+   size_t zerocopy_threshold;
+   /* Running counts of zero-copy sends and their completion notifications. */
+   uint32_t zerocopy_issued;
+   uint32_t zerocopy_completed;
 };
 
 mongoc_socket_t *
 mongoc_socket_accept_ex(mongoc_socket_t *sock, int64_t expire_at, uint16_t *port);
 
+/* Enables MSG_ZEROCOPY for sends of at least `threshold` bytes. Returns false
+ * if the platform or socket does not support it. */
+bool
+_mongoc_socket_enable_zerocopy(mongoc_socket_t *sock, size_t threshold);
+
 BSON_END_DECLS
 
 #endif /* MONGOC_SOCKET_PRIVATE_H */
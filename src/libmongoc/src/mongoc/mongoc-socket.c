@@ -30,8 +30,15 @@
 
 #include <errno.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <string.h>
 
+#if defined(__linux__) && defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#define MONGOC_SOCKET_HAVE_ZEROCOPY
+#endif
+
 #undef MONGOC_LOG_DOMAIN
 #define MONGOC_LOG_DOMAIN "socket"
 
@@ -1230,7 +1237,10 @@ _mongoc_socket_try_sendv_slow(mongoc_socket_t *sock, /* IN */
  *       Helper used by mongoc_socket_sendv() to try to write as many
  *       bytes to the underlying socket until the socket buffer is full.
  *
- *       This is performed in a non-blocking fashion.
+ *       This is performed in a non-blocking fashion. At most IOV_MAX
+ *       iovecs are passed per call; the caller sends the remainder.
+ *       If @zerocopy is true, MSG_ZEROCOPY is requested and a
+ *       successful call is counted in sock->zerocopy_issued.
  *
  * Returns:
  *       -1 on failure. the number of bytes written on success.
@@ -1244,7 +1254,8 @@ _mongoc_socket_try_sendv_slow(mongoc_socket_t *sock, /* IN */
 static ssize_t
 _mongoc_socket_try_sendv(mongoc_socket_t *sock, /* IN */
                          mongoc_iovec_t *iov,   /* IN */
-                         size_t iovcnt)         /* IN */
+                         size_t iovcnt,         /* IN */
+                         bool zerocopy)         /* IN */
 {
 #ifdef _WIN32
    DWORD dwNumberofBytesSent = 0;
@@ -1263,21 +1274,41 @@ _mongoc_socket_try_sendv(mongoc_socket_t *sock, /* IN */
    DUMP_IOVEC(sendbuf, iov, iovcnt);
 
 #ifdef _WIN32
+   BSON_UNUSED(zerocopy);
    BSON_ASSERT(mlib_in_range(unsigned long, iovcnt));
    ret = WSASend(sock->sd, (LPWSABUF)iov, (DWORD)iovcnt, &dwNumberofBytesSent, 0, NULL, NULL);
    TRACE("WSASend sent: %lu (out of: %zu), ret: %d", dwNumberofBytesSent, iov->iov_len, ret);
 #else
-   memset(&msg, 0, sizeof msg);
-   msg.msg_iov = iov;
-   msg.msg_iovlen = iovcnt;
-   ret = sendmsg(sock->sd,
-                 &msg,
+   int flags = 0;
 #ifdef MSG_NOSIGNAL
-                 MSG_NOSIGNAL);
+   flags |= MSG_NOSIGNAL;
+#endif
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+   if (zerocopy) {
+      flags |= MSG_ZEROCOPY;
+   }
 #else
-                 0);
+   BSON_UNUSED(zerocopy);
+#endif
+
+#ifdef IOV_MAX
+   /* Avoid EMSGSIZE and the one-send-per-iovec slow path below. */
+   if (mlib_cmp(iovcnt, >, IOV_MAX)) {
+      iovcnt = (size_t)IOV_MAX;
+   }
 #endif
+
+   memset(&msg, 0, sizeof msg);
+   msg.msg_iov = iov;
+   msg.msg_iovlen = iovcnt;
+   ret = sendmsg(sock->sd, &msg, flags);
    TRACE("Send %zd out of %zu bytes", ret, iov->iov_len);
+
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+   if (zerocopy && ret >= 0) {
+      sock->zerocopy_issued++;
+   }
+#endif
 #endif
 
 
@@ -1312,6 +1343,120 @@ _mongoc_socket_try_sendv(mongoc_socket_t *sock, /* IN */
 }
 
 
+bool
+_mongoc_socket_enable_zerocopy(mongoc_socket_t *sock, size_t threshold)
+{
+   BSON_ASSERT_PARAM(sock);
+
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+   const int optval = 1;
+
+   if (threshold == 0u || (sock->domain != AF_INET && sock->domain != AF_INET6)) {
+      return false;
+   }
+
+   if (0 != setsockopt(sock->sd, SOL_SOCKET, SO_ZEROCOPY, &optval, sizeof optval)) {
+      TRACE("SO_ZEROCOPY is not supported: %d", errno);
+      return false;
+   }
+
+   sock->zerocopy_threshold = threshold;
+   return true;
+#else
+   BSON_UNUSED(threshold);
+   return false;
+#endif
+}
+
+
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+/*
+ *--------------------------------------------------------------------------
+ *
+ * _mongoc_socket_zerocopy_reap --
+ *
+ *       Consume pending MSG_ZEROCOPY completion notifications from the
+ *       socket error queue without blocking.
+ *
+ * Returns:
+ *       true if at least one send was reported complete.
+ *
+ * Side effects:
+ *       Advances sock->zerocopy_completed. Disables zero-copy for the
+ *       socket if the kernel reports it had to copy the data anyway
+ *       (e.g. loopback), since the completion wait is then pure overhead.
+ *
+ *--------------------------------------------------------------------------
+ */
+
+static bool
+_mongoc_socket_zerocopy_reap(mongoc_socket_t *sock)
+{
+   bool reaped = false;
+
+   for (;;) {
+      char control[128];
+      struct msghdr msg;
+
+      memset(&msg, 0, sizeof msg);
+      msg.msg_control = control;
+      msg.msg_controllen = sizeof control;
+
+      if (recvmsg(sock->sd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+         break;
+      }
+
+      for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+         const bool is_recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                                 (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+         if (!is_recverr) {
+            continue;
+         }
+
+         struct sock_extended_err serr;
+         memcpy(&serr, CMSG_DATA(cm), sizeof serr);
+         if (serr.ee_errno != 0 || serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+            continue;
+         }
+
+         /* ee_info..ee_data is the inclusive range of completed sends. */
+         sock->zerocopy_completed += serr.ee_data - serr.ee_info + 1u;
+         reaped = true;
+
+         if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+            TRACE("%s", "kernel copied a zero-copy send, disabling MSG_ZEROCOPY");
+            sock->zerocopy_threshold = 0u;
+         }
+      }
+   }
+
+   return reaped;
+}
+
+
+/*
+ * Wait until every zero-copy send has completed, after which the kernel no
+ * longer references the caller's buffers.
+ */
+static bool
+_mongoc_socket_zerocopy_wait(mongoc_socket_t *sock, int64_t expire_at)
+{
+   while (sock->zerocopy_completed != sock->zerocopy_issued) {
+      if (_mongoc_socket_zerocopy_reap(sock)) {
+         continue;
+      }
+
+      if (OPERATION_EXPIRED(expire_at) || !_mongoc_socket_wait(sock, POLLERR, expire_at)) {
+         errno = sock->errno_ = ETIMEDOUT;
+         return false;
+      }
+   }
+
+   return true;
+}
+#endif
+
+
 /*
  *--------------------------------------------------------------------------
  *
@@ -1325,6 +1470,10 @@ _mongoc_socket_try_sendv(mongoc_socket_t *sock, /* IN */
  *       or a time using the monotonic clock to expire. Calculate this
  *       using bson_get_monotonic_time() + N_MICROSECONDS.
  *
+ *       If zero-copy is enabled on the socket and the payload reaches
+ *       the threshold, this does not return until the kernel reports
+ *       that it no longer references @in_iov.
+ *
  * Returns:
  *       -1 on failure.
  *       the number of bytes written on success.
@@ -1355,8 +1504,21 @@ mongoc_socket_sendv(mongoc_socket_t *sock,  /* IN */
    iov = BSON_ARRAY_ALLOC(iovcnt, mongoc_iovec_t);
    memcpy(iov, in_iov, sizeof(*iov) * iovcnt);
 
+   bool zerocopy = false;
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+   /* Zero-copy sends must wait for completion, so never use them when the
+    * caller asked not to block. */
+   if (sock->zerocopy_threshold > 0u && expire_at != 0) {
+      size_t total = 0u;
+      for (size_t i = 0u; i < iovcnt; i++) {
+         total += iov[i].iov_len;
+      }
+      zerocopy = total >= sock->zerocopy_threshold;
+   }
+#endif
+
    for (;;) {
-      sent = _mongoc_socket_try_sendv(sock, &iov[cur], iovcnt - cur);
+      sent = _mongoc_socket_try_sendv(sock, &iov[cur], iovcnt - cur, zerocopy);
       TRACE("Sent %zd (of %zu) out of iovcnt=%zu", sent, iov[cur].iov_len, iovcnt);
 
       /*
@@ -1365,6 +1527,13 @@ mongoc_socket_sendv(mongoc_socket_t *sock,  /* IN */
        * underlying socket.
        */
       if (sent == -1) {
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+         if (zerocopy && mongoc_socket_errno(sock) == ENOBUFS) {
+            /* Out of memory for pinning pages; send by copying instead. */
+            zerocopy = false;
+            continue;
+         }
+#endif
          if (!_mongoc_socket_errno_is_again(sock)) {
             ret = -1;
             GOTO(CLEANUP);
@@ -1418,11 +1587,35 @@ mongoc_socket_sendv(mongoc_socket_t *sock,  /* IN */
        * Block on poll() until our desired condition is met.
        */
       if (!_mongoc_socket_wait(sock, POLLOUT, expire_at)) {
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+         /* Completion notifications wake poll() with POLLERR only. */
+         if (zerocopy && _mongoc_socket_zerocopy_reap(sock)) {
+            continue;
+         }
+#endif
          GOTO(CLEANUP);
       }
    }
 
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+   if (!_mongoc_socket_zerocopy_wait(sock, expire_at)) {
+      ret = -1;
+   }
+#endif
+
 CLEANUP:
+#ifdef MONGOC_SOCKET_HAVE_ZEROCOPY
+   if (sock->zerocopy_completed != sock->zerocopy_issued) {
+      /* The send failed with zero-copy sends in flight. The caller may free
+       * the buffers once this returns, so give the kernel until the deadline
+       * to release them, but report the send's own error. */
+      const int send_errno = sock->errno_;
+
+      (void)_mongoc_socket_zerocopy_wait(sock, expire_at);
+      errno = sock->errno_ = send_errno;
+   }
+#endif
+
    bson_free(iov);
 
    RETURN(ret);
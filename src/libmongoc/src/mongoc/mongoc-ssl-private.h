@@ -34,6 +34,8 @@ BSON_BEGIN_DECLS
 typedef struct {
    bool tls_disable_certificate_revocation_check;
    bool tls_disable_ocsp_endpoint_check;
+   bool tls_disable_session_resumption;
+   bool tls_enable_ktls;
 } _mongoc_internal_tls_opts_t;
 
 void
@@ -47,6 +49,12 @@ _mongoc_ssl_opts_disable_certificate_revocation_check(const mongoc_ssl_opt_t *ss
 bool
 _mongoc_ssl_opts_disable_ocsp_endpoint_check(const mongoc_ssl_opt_t *ssl_opt);
 
+bool
+_mongoc_ssl_opts_disable_session_resumption(const mongoc_ssl_opt_t *ssl_opt);
+
+bool
+_mongoc_ssl_opts_enable_ktls(const mongoc_ssl_opt_t *ssl_opt);
+
 void
 _mongoc_ssl_opts_cleanup(mongoc_ssl_opt_t *opt, bool free_internal);
 
@@ -73,6 +73,9 @@ _mongoc_ssl_opts_from_uri(mongoc_ssl_opt_t *ssl_opt, _mongoc_internal_tls_opts_t
       mongoc_uri_get_option_as_bool(uri, MONGOC_URI_TLSDISABLECERTIFICATEREVOCATIONCHECK, false);
    internal->tls_disable_ocsp_endpoint_check =
       mongoc_uri_get_option_as_bool(uri, MONGOC_URI_TLSDISABLEOCSPENDPOINTCHECK, false);
+   internal->tls_disable_session_resumption =
+      mongoc_uri_get_option_as_bool(uri, MONGOC_URI_TLSDISABLESESSIONRESUMPTION, false);
+   internal->tls_enable_ktls = mongoc_uri_get_option_as_bool(uri, MONGOC_URI_TLSENABLEKTLS, false);
 }
 
 void
@@ -128,6 +131,24 @@ _mongoc_ssl_opts_disable_ocsp_endpoint_check(const mongoc_ssl_opt_t *ssl_opt)
    return ((_mongoc_internal_tls_opts_t *)ssl_opt->internal)->tls_disable_ocsp_endpoint_check;
 }
 
+bool
+_mongoc_ssl_opts_disable_session_resumption(const mongoc_ssl_opt_t *ssl_opt)
+{
+   if (!ssl_opt->internal) {
+      return false;
+   }
+   return ((_mongoc_internal_tls_opts_t *)ssl_opt->internal)->tls_disable_session_resumption;
+}
+
+bool
+_mongoc_ssl_opts_enable_ktls(const mongoc_ssl_opt_t *ssl_opt)
+{
+   if (!ssl_opt->internal) {
+      return false;
+   }
+   return ((_mongoc_internal_tls_opts_t *)ssl_opt->internal)->tls_enable_ktls;
+}
+
 bool
 _mongoc_ssl_opts_from_bson(mongoc_ssl_opt_t *ssl_opt, const bson_t *bson, mcommon_string_append_t *errmsg)
 {
@@ -38,6 +38,7 @@ BSON_BEGIN_DECLS
 #define MONGOC_STREAM_TLS 5
 #define MONGOC_STREAM_GRIDFS_UPLOAD 6
 #define MONGOC_STREAM_GRIDFS_DOWNLOAD 7
+#define MONGOC_STREAM_URING 8
 
 bool
 mongoc_stream_wait(mongoc_stream_t *stream, int64_t expire_at);
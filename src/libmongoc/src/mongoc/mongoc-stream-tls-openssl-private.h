@@ -41,6 +41,11 @@ typedef struct {
 void
 mongoc_openssl_ocsp_opt_destroy(void *ocsp_opt);
 
+/* Kernel TLS offload (OpenSSL 3.0+ built with kTLS support, on Linux). */
+#if defined(__linux__) && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define MONGOC_STREAM_TLS_OPENSSL_KTLS
+#endif
+
 /**
  * mongoc_stream_tls_openssl_t:
  *
@@ -51,6 +56,12 @@ typedef struct {
    BIO_METHOD *meth;
    SSL_CTX *ctx;
    mongoc_openssl_ocsp_opt_t *ocsp_opts;
+   /* True if the handshake may resume a session from the context's cache. */
+   bool session_cache;
+   /* True if OpenSSL does I/O on the socket directly, for kernel TLS. */
+   bool socket_bio;
+   /* True if the kernel encrypts writes (kTLS), so writes bypass OpenSSL. */
+   bool ktls_send;
 } mongoc_stream_tls_openssl_t;
 
 #if OPENSSL_VERSION_NUMBER >= 0x10100000L
@@ -60,6 +71,12 @@ mongoc_stream_tls_openssl_new_with_context(mongoc_stream_t *base_stream,
                                            mongoc_ssl_opt_t *opt,
                                            int client,
                                            SSL_CTX *ssl_ctx) BSON_GNUC_WARN_UNUSED_RESULT;
+
+/* Resume and cache TLS sessions for the server at @host_and_port, if the
+ * stream's context has a session cache and resumption is not disabled. Must be
+ * called before the handshake. */
+void
+_mongoc_stream_tls_openssl_set_session_cache_key(mongoc_stream_t *stream, const char *host_and_port);
 #endif
 
 BSON_END_DECLS
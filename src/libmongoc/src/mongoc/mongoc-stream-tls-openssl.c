@@ -23,6 +23,8 @@
 #include <mongoc/mongoc-errno-private.h>
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-openssl-private.h>
+#include <mongoc/mongoc-openssl-session-cache-private.h>
+#include <mongoc/mongoc-socket-private.h>
 #include <mongoc/mongoc-ssl-private.h>
 #include <mongoc/mongoc-stream-private.h>
 #include <mongoc/mongoc-stream-tls-openssl-bio-private.h>
@@ -32,6 +34,7 @@
 
 #include <mongoc/mongoc-log.h>
 #include <mongoc/mongoc-ssl.h>
+#include <mongoc/mongoc-stream-socket.h>
 #include <mongoc/mongoc-stream-tls.h>
 
 #include <bson/bson.h>
@@ -196,6 +199,45 @@ _mongoc_stream_tls_openssl_flush(mongoc_stream_t *stream)
 }
 
 
+/* With a socket BIO, OpenSSL does non-blocking I/O on the socket directly.
+ * Wait until the socket is ready for the operation OpenSSL wants to retry.
+ * Returns false if @expire passed first. */
+static bool
+_mongoc_stream_tls_openssl_wait(mongoc_stream_tls_t *tls, int64_t expire)
+{
+   mongoc_stream_tls_openssl_t *openssl = (mongoc_stream_tls_openssl_t *)tls->ctx;
+   mongoc_stream_poll_t poller;
+   int32_t timeout_msec = INT32_MAX;
+
+   if (expire) {
+      const int64_t remaining = expire - bson_get_monotonic_time();
+
+      if (remaining < 0) {
+         return false;
+      }
+
+      timeout_msec = (int32_t)BSON_MIN(remaining / 1000, INT32_MAX);
+   }
+
+   poller.stream = tls->base_stream;
+   poller.events = BIO_should_read(openssl->bio) ? POLLIN : POLLOUT;
+   poller.revents = 0;
+
+   return mongoc_stream_poll(&poller, 1, timeout_msec) > 0;
+}
+
+static void
+_mongoc_stream_tls_openssl_set_timed_out(mongoc_stream_tls_t *tls)
+{
+   mongoc_counter_streams_timeout_inc();
+   tls->timed_out = true;
+#ifdef _WIN32
+   errno = WSAETIMEDOUT;
+#else
+   errno = ETIMEDOUT;
+#endif
+}
+
 static ssize_t
 _mongoc_stream_tls_openssl_write(mongoc_stream_tls_t *tls, char *buf, size_t buf_len)
 {
@@ -214,7 +256,13 @@ _mongoc_stream_tls_openssl_write(mongoc_stream_tls_t *tls, char *buf, size_t buf
    }
 
    BSON_ASSERT(mlib_in_range(int, buf_len));
-   ret = BIO_write(openssl->bio, buf, (int)buf_len);
+   while ((ret = BIO_write(openssl->bio, buf, (int)buf_len)) <= 0 && openssl->socket_bio &&
+          BIO_should_retry(openssl->bio)) {
+      if (!_mongoc_stream_tls_openssl_wait(tls, expire)) {
+         _mongoc_stream_tls_openssl_set_timed_out(tls);
+         return -1;
+      }
+   }
 
    if (ret <= 0) {
       return ret;
@@ -291,6 +339,18 @@ _mongoc_stream_tls_openssl_writev(mongoc_stream_t *stream, mongoc_iovec_t *iov,
    ENTRY;
 
    tls->timeout_msec = timeout_msec;
+   tls->timed_out = false;
+
+   if (((mongoc_stream_tls_openssl_t *)tls->ctx)->ktls_send) {
+      /* The kernel encrypts, so send straight from the caller's buffers. */
+      ret = mongoc_stream_writev(tls->base_stream, iov, iovcnt, timeout_msec);
+
+      if (ret >= 0) {
+         mongoc_counter_streams_egress_add(ret);
+      }
+
+      RETURN(ret);
+   }
 
    for (i = 0; i < iovcnt; i++) {
       iov_pos = 0;
@@ -432,6 +492,15 @@ _mongoc_stream_tls_openssl_readv(
       while (iov_pos < iov[i].iov_len) {
          read_ret = BIO_read(openssl->bio, (char *)iov[i].iov_base + iov_pos, (int)(iov[i].iov_len - iov_pos));
 
+         if (read_ret <= 0 && openssl->socket_bio && BIO_should_retry(openssl->bio)) {
+            if (!_mongoc_stream_tls_openssl_wait(tls, expire)) {
+               _mongoc_stream_tls_openssl_set_timed_out(tls);
+               RETURN(-1);
+            }
+
+            continue;
+         }
+
          /* https://www.openssl.org/docs/crypto/BIO_should_retry.html:
           *
           * If BIO_should_retry() returns false then the precise "error
@@ -553,6 +622,49 @@ _mongoc_stream_tls_openssl_set_verify_cert_error(SSL *ssl, bson_error_t *error)
    return true;
 }
 
+/* Do not offer the cached sessions for this server again after a failed
+ * handshake. */
+static void
+_mongoc_stream_tls_openssl_forget_session(mongoc_stream_tls_openssl_t *openssl, SSL *ssl)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+   if (openssl->session_cache) {
+      _mongoc_openssl_session_cache_remove(ssl);
+   }
+#else
+   BSON_UNUSED(openssl);
+   BSON_UNUSED(ssl);
+#endif
+}
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+/* Servers do not staple an OCSP response on resumption, so a resumed session
+ * is only accepted while the OCSP cache holds a good response for the
+ * certificate validated by the full handshake that established it. */
+static bool
+_mongoc_stream_tls_openssl_check_ocsp(mongoc_stream_tls_openssl_t *openssl, SSL *ssl, bool resumed)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+   if (resumed) {
+      return _mongoc_openssl_session_cache_check_ocsp(ssl);
+   }
+
+   if (1 != _mongoc_ocsp_tlsext_status(ssl, openssl->ocsp_opts)) {
+      return false;
+   }
+
+   if (openssl->session_cache) {
+      _mongoc_openssl_session_cache_set_ocsp_peer(ssl);
+   }
+
+   return true;
+#else
+   BSON_UNUSED(resumed);
+   return 1 == _mongoc_ocsp_tlsext_status(ssl, openssl->ocsp_opts);
+#endif
+}
+#endif
+
 /**
  * mongoc_stream_tls_openssl_handshake:
  */
@@ -570,11 +682,22 @@ _mongoc_stream_tls_openssl_handshake(mongoc_stream_t *stream, const char *host,
    BIO_get_ssl(openssl->bio, &ssl);
 
    if (BIO_do_handshake(openssl->bio) == 1) {
+      const bool resumed = SSL_session_reused(ssl);
+
       *events = 0;
 
+      if (openssl->session_cache) {
+         if (resumed) {
+            mongoc_counter_tls_session_hits_inc();
+         } else {
+            mongoc_counter_tls_session_misses_inc();
+         }
+      }
+
 #ifdef MONGOC_ENABLE_OCSP_OPENSSL
-      /* Validate OCSP */
-      if (openssl->ocsp_opts && 1 != _mongoc_ocsp_tlsext_status(ssl, openssl->ocsp_opts)) {
+      /* Validate OCSP. */
+      if (openssl->ocsp_opts && !_mongoc_stream_tls_openssl_check_ocsp(openssl, ssl, resumed)) {
+         _mongoc_stream_tls_openssl_forget_session(openssl, ssl);
          _mongoc_set_error(
             error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_SOCKET, "TLS handshake failed: Failed OCSP verification");
          RETURN(false);
@@ -582,9 +705,15 @@ _mongoc_stream_tls_openssl_handshake(mongoc_stream_t *stream, const char *host,
 #endif
 
       if (_mongoc_openssl_check_peer_hostname(ssl, host, tls->ssl_opts.allow_invalid_hostname)) {
+#ifdef MONGOC_STREAM_TLS_OPENSSL_KTLS
+         openssl->ktls_send = openssl->socket_bio && BIO_get_ktls_send(SSL_get_wbio(ssl));
+         TRACE("kernel TLS send offload %s", openssl->ktls_send ? "enabled" : "unavailable");
+#endif
          RETURN(true);
       }
 
+      _mongoc_stream_tls_openssl_forget_session(openssl, ssl);
+
       /* Try to relay certificate failure reason from OpenSSL library if any. */
       if (_mongoc_stream_tls_openssl_set_verify_cert_error(ssl, error)) {
          RETURN(false);
@@ -614,6 +743,8 @@ _mongoc_stream_tls_openssl_handshake(mongoc_stream_t *stream, const char *host,
 
    *events = 0;
 
+   _mongoc_stream_tls_openssl_forget_session(openssl, ssl);
+
    /* Try to relay certificate failure reason from OpenSSL library if any. */
    if (_mongoc_stream_tls_openssl_set_verify_cert_error(ssl, error)) {
       RETURN(false);
@@ -688,6 +819,34 @@ _mongoc_stream_tls_openssl_should_retry(mongoc_stream_t *stream)
    RETURN(mongoc_stream_should_retry(tls->base_stream));
 }
 
+/* Returns a socket BIO for @base_stream and enables kernel TLS on @ssl if the
+ * user opted in, or NULL to do I/O through the mongoc_stream BIO. OpenSSL only
+ * offloads to the kernel when it owns the socket. */
+static BIO *
+_mongoc_stream_tls_openssl_ktls_bio_new(mongoc_stream_t *base_stream, mongoc_ssl_opt_t *opt, int client, SSL *ssl)
+{
+#ifdef MONGOC_STREAM_TLS_OPENSSL_KTLS
+   mongoc_socket_t *sock;
+
+   if (!client || base_stream->type != MONGOC_STREAM_SOCKET || !_mongoc_ssl_opts_enable_ktls(opt)) {
+      return NULL;
+   }
+
+   if (!(sock = mongoc_stream_socket_get_socket((mongoc_stream_socket_t *)base_stream))) {
+      return NULL;
+   }
+
+   SSL_set_options(ssl, SSL_OP_ENABLE_KTLS);
+   return BIO_new_socket(sock->sd, BIO_NOCLOSE);
+#else
+   BSON_UNUSED(base_stream);
+   BSON_UNUSED(opt);
+   BSON_UNUSED(client);
+   BSON_UNUSED(ssl);
+   return NULL;
+#endif
+}
+
 /* Creates a new mongoc_stream_tls_openssl_t with ssl_ctx. */
 static mongoc_stream_t *
 create_stream_with_ctx(
@@ -698,7 +857,8 @@ create_stream_with_ctx(
    mongoc_openssl_ocsp_opt_t *ocsp_opts = NULL;
    BIO *bio_ssl = NULL;
    BIO *bio_mongoc_shim = NULL;
-   BIO_METHOD *meth;
+   BIO *bio_socket;
+   BIO_METHOD *meth = NULL;
    SSL *ssl;
 
    BSON_ASSERT(base_stream);
@@ -734,13 +894,16 @@ create_stream_with_ctx(
    }
 #endif
 
-   meth = mongoc_stream_tls_openssl_bio_meth_new();
-   bio_mongoc_shim = BIO_new(meth);
-   if (!bio_mongoc_shim) {
-      BIO_free_all(bio_ssl);
-      BIO_meth_free(meth);
-      SSL_CTX_free(ssl_ctx);
-      RETURN(NULL);
+   bio_socket = _mongoc_stream_tls_openssl_ktls_bio_new(base_stream, opt, client, ssl);
+   if (!bio_socket) {
+      meth = mongoc_stream_tls_openssl_bio_meth_new();
+      bio_mongoc_shim = BIO_new(meth);
+      if (!bio_mongoc_shim) {
+         BIO_free_all(bio_ssl);
+         BIO_meth_free(meth);
+         SSL_CTX_free(ssl_ctx);
+         RETURN(NULL);
+      }
    }
 
 /* Added in OpenSSL 0.9.8f, as a build time option */
@@ -751,7 +914,7 @@ create_stream_with_ctx(
 #endif
    }
 
-   BIO_push(bio_ssl, bio_mongoc_shim);
+   BIO_push(bio_ssl, bio_socket ? bio_socket : bio_mongoc_shim);
 
 #ifdef MONGOC_ENABLE_OCSP_OPENSSL
    if (client && !opt->weak_cert_validation && !_mongoc_ssl_opts_disable_certificate_revocation_check(opt)) {
@@ -782,6 +945,7 @@ create_stream_with_ctx(
    openssl->meth = meth;
    openssl->ctx = ssl_ctx;
    openssl->ocsp_opts = ocsp_opts;
+   openssl->socket_bio = !!bio_socket;
 
    tls = (mongoc_stream_tls_t *)bson_malloc0(sizeof *tls);
    tls->parent.type = MONGOC_STREAM_TLS;
@@ -801,7 +965,9 @@ create_stream_with_ctx(
    tls->ctx = (void *)openssl;
    tls->timeout_msec = -1;
    tls->base_stream = base_stream;
-   mongoc_stream_tls_openssl_bio_set_data(bio_mongoc_shim, tls);
+   if (bio_mongoc_shim) {
+      mongoc_stream_tls_openssl_bio_set_data(bio_mongoc_shim, tls);
+   }
 
    mongoc_counter_streams_active_inc();
 
@@ -884,6 +1050,26 @@ mongoc_stream_tls_openssl_new_with_context(
 
    return create_stream_with_ctx(base_stream, host, opt, client, ssl_ctx);
 }
+
+void
+_mongoc_stream_tls_openssl_set_session_cache_key(mongoc_stream_t *stream, const char *host_and_port)
+{
+   mongoc_stream_tls_t *tls = (mongoc_stream_tls_t *)stream;
+   mongoc_stream_tls_openssl_t *openssl;
+   SSL *ssl;
+
+   BSON_ASSERT_PARAM(stream);
+   BSON_ASSERT_PARAM(host_and_port);
+   BSON_ASSERT(stream->type == MONGOC_STREAM_TLS);
+
+   if (_mongoc_ssl_opts_disable_session_resumption(&tls->ssl_opts)) {
+      return;
+   }
+
+   openssl = (mongoc_stream_tls_openssl_t *)tls->ctx;
+   BIO_get_ssl(openssl->bio, &ssl);
+   openssl->session_cache = _mongoc_openssl_session_cache_prepare(ssl, host_and_port, openssl->ocsp_opts != NULL);
+}
 #endif
 
 void
@@ -0,0 +1,713 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <mongoc/mongoc-stream-uring.h>
+
+#include <mongoc/mongoc-counters-private.h>
+#include <mongoc/mongoc-errno-private.h>
+#include <mongoc/mongoc-socket-private.h>
+#include <mongoc/mongoc-stream-private.h>
+#include <mongoc/mongoc-trace-private.h>
+
+#ifdef MONGOC_ENABLE_IO_URING
+#include <common-atomic-private.h>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+#undef MONGOC_LOG_DOMAIN
+#define MONGOC_LOG_DOMAIN "stream"
+
+
+/* Every operation submits at most an I/O request and its linked timeout, and
+ * waits for both completions before returning, so the ring never holds more. */
+#define MONGOC_STREAM_URING_ENTRIES 4u
+
+/* Reads and writes no larger than this are staged through a buffer registered
+ * with the ring, which spares the kernel from pinning the caller's pages on
+ * every request. Larger transfers use the caller's iovecs directly. */
+#define MONGOC_STREAM_URING_BUFFER_SIZE (16u * 1024u)
+
+
+struct _mongoc_stream_uring_t {
+   mongoc_stream_t vtable;
+   mongoc_socket_t *sock;
+#ifdef MONGOC_ENABLE_IO_URING
+   int ring_fd;
+   /* The submission and completion rings share one mapping. */
+   void *ring;
+   size_t ring_len;
+   struct io_uring_sqe *sqes;
+   size_t sqes_len;
+   uint32_t *sq_tail;
+   uint32_t *sq_mask;
+   uint32_t *sq_array;
+   uint32_t *cq_head;
+   uint32_t *cq_tail;
+   uint32_t *cq_mask;
+   struct io_uring_cqe *cqes;
+   /* The socket is registered as fixed file 0. */
+   bool fixed_file;
+   /* buf is registered as fixed buffer 0. */
+   uint8_t *buf;
+   bool buf_registered;
+   /* Set if io_uring_enter failed and requests may be left in the ring. */
+   bool broken;
+#endif
+};
+
+
+#ifdef MONGOC_ENABLE_IO_URING
+
+enum {
+   MONGOC_STREAM_URING_OP = 1,
+   MONGOC_STREAM_URING_LINK_TIMEOUT = 2,
+};
+
+
+static BSON_INLINE int64_t
+get_expiration(int32_t timeout_msec)
+{
+   if (timeout_msec < 0) {
+      return -1;
+   } else if (timeout_msec == 0) {
+      return 0;
+   } else {
+      return (bson_get_monotonic_time() + ((int64_t)timeout_msec * 1000L));
+   }
+}
+
+
+static void
+_mongoc_stream_uring_release_ring(mongoc_stream_uring_t *us)
+{
+   if (us->sqes) {
+      munmap(us->sqes, us->sqes_len);
+      us->sqes = NULL;
+   }
+
+   if (us->ring) {
+      munmap(us->ring, us->ring_len);
+      us->ring = NULL;
+   }
+
+   /* Closing the ring drops its references to the registered socket and
+    * buffer. */
+   if (us->ring_fd >= 0) {
+      close(us->ring_fd);
+      us->ring_fd = -1;
+   }
+
+   bson_free(us->buf);
+   us->buf = NULL;
+   us->fixed_file = false;
+   us->buf_registered = false;
+}
+
+
+static void
+_mongoc_stream_uring_push(mongoc_stream_uring_t *us, uint32_t *tail, const struct io_uring_sqe *sqe)
+{
+   const uint32_t index = *tail & *us->sq_mask;
+
+   us->sqes[index] = *sqe;
+   us->sq_array[index] = index;
+   (*tail)++;
+}
+
+
+/*
+ *--------------------------------------------------------------------------
+ *
+ * _mongoc_stream_uring_submit --
+ *
+ *       Submit @op, linked to a timeout that expires at @expire_at, and
+ *       wait until both complete.
+ *
+ * Returns:
+ *       The result of @op: a byte count, or a negative errno. A request
+ *       cancelled by its timeout returns -ETIMEDOUT, or -EAGAIN if
+ *       @expire_at is 0.
+ *
+ *--------------------------------------------------------------------------
+ */
+
+static int32_t
+_mongoc_stream_uring_submit(mongoc_stream_uring_t *us, struct io_uring_sqe *op, int64_t expire_at)
+{
+   struct __kernel_timespec ts = {0};
+   uint32_t tail = *us->sq_tail;
+   unsigned to_submit = 1u;
+   unsigned pending;
+   int32_t res = -ECANCELED;
+
+   if (us->broken) {
+      return -EIO;
+   }
+
+   if (us->fixed_file) {
+      op->fd = 0;
+      op->flags |= IOSQE_FIXED_FILE;
+   } else {
+      op->fd = us->sock->sd;
+   }
+
+   op->user_data = MONGOC_STREAM_URING_OP;
+
+   if (expire_at >= 0) {
+      struct io_uring_sqe timeout = {0};
+      int64_t remaining = 0;
+
+      /* An already-expired timeout still lets a request that completes
+       * immediately succeed, which gives expire_at == 0 non-blocking
+       * semantics. */
+      if (expire_at > 0) {
+         remaining = BSON_MAX(expire_at - bson_get_monotonic_time(), 0);
+      }
+
+      ts.tv_sec = remaining / 1000000;
+      ts.tv_nsec = (remaining % 1000000) * 1000;
+
+      op->flags |= IOSQE_IO_LINK;
+      _mongoc_stream_uring_push(us, &tail, op);
+
+      timeout.opcode = IORING_OP_LINK_TIMEOUT;
+      timeout.fd = -1;
+      timeout.addr = (uint64_t)(uintptr_t)&ts;
+      timeout.len = 1u;
+      timeout.user_data = MONGOC_STREAM_URING_LINK_TIMEOUT;
+      _mongoc_stream_uring_push(us, &tail, &timeout);
+      to_submit = 2u;
+   } else {
+      _mongoc_stream_uring_push(us, &tail, op);
+   }
+
+   mcommon_atomic_int32_exchange((int32_t *)us->sq_tail, (int32_t)tail, mcommon_memory_order_release);
+
+   /* Both the request and its linked timeout always post a completion. */
+   pending = to_submit;
+
+   for (;;) {
+      uint32_t head = *us->cq_head;
+      const uint32_t cq_tail =
+         (uint32_t)mcommon_atomic_int32_fetch((const int32_t *)us->cq_tail, mcommon_memory_order_acquire);
+
+      for (; head != cq_tail && pending > 0u; head++, pending--) {
+         const struct io_uring_cqe *const cqe = &us->cqes[head & *us->cq_mask];
+
+         if (cqe->user_data == MONGOC_STREAM_URING_OP) {
+            res = cqe->res;
+         }
+      }
+
+      mcommon_atomic_int32_exchange((int32_t *)us->cq_head, (int32_t)head, mcommon_memory_order_release);
+
+      if (pending == 0u) {
+         break;
+      }
+
+      const long entered =
+         syscall(__NR_io_uring_enter, us->ring_fd, to_submit, pending, IORING_ENTER_GETEVENTS, NULL, 0);
+
+      if (entered >= 0) {
+         to_submit -= (unsigned)entered;
+      } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+         MONGOC_WARNING("io_uring_enter failed: %d", errno);
+         us->broken = true;
+         return -EIO;
+      }
+   }
+
+   if (res == -ECANCELED) {
+      if (expire_at > 0) {
+         mongoc_counter_streams_timeout_inc();
+      }
+
+      return expire_at == 0 ? -EAGAIN : -ETIMEDOUT;
+   }
+
+   return res;
+}
+
+
+static int
+_mongoc_stream_uring_close(mongoc_stream_t *stream)
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+   int ret;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+
+   /* The ring holds a reference to the registered socket, which would keep
+    * the connection open after the descriptor is closed. */
+   _mongoc_stream_uring_release_ring(us);
+   us->broken = true;
+
+   if (us->sock) {
+      ret = mongoc_socket_close(us->sock);
+      RETURN(ret);
+   }
+
+   RETURN(0);
+}
+
+
+static void
+_mongoc_stream_uring_destroy(mongoc_stream_t *stream)
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+
+   _mongoc_stream_uring_release_ring(us);
+
+   if (us->sock) {
+      mongoc_socket_destroy(us->sock);
+      us->sock = NULL;
+   }
+
+   bson_free(us);
+
+   mongoc_counter_streams_active_dec();
+   mongoc_counter_streams_disposed_inc();
+
+   EXIT;
+}
+
+
+static void
+_mongoc_stream_uring_failed(mongoc_stream_t *stream)
+{
+   ENTRY;
+
+   _mongoc_stream_uring_destroy(stream);
+
+   EXIT;
+}
+
+
+static int
+_mongoc_stream_uring_setsockopt(mongoc_stream_t *stream, int level, int optname, void *optval, mongoc_socklen_t optlen)
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+   int ret;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+   BSON_ASSERT(us->sock);
+
+   ret = mongoc_socket_setsockopt(us->sock, level, optname, optval, optlen);
+
+   RETURN(ret);
+}
+
+
+static int
+_mongoc_stream_uring_flush(mongoc_stream_t *stream)
+{
+   ENTRY;
+   BSON_UNUSED(stream);
+   RETURN(0);
+}
+
+
+static ssize_t
+_mongoc_stream_uring_readv(
+   mongoc_stream_t *stream, mongoc_iovec_t *iov, size_t iovcnt, size_t min_bytes, int32_t timeout_msec)
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+   int64_t expire_at;
+   ssize_t ret = 0;
+   size_t cur = 0;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+   BSON_ASSERT(us->sock);
+
+   expire_at = get_expiration(timeout_msec);
+
+   for (;;) {
+      struct io_uring_sqe op = {0};
+      size_t wanted = 0u;
+      int32_t nread;
+
+      for (size_t i = cur; i < iovcnt; i++) {
+         wanted += iov[i].iov_len;
+      }
+
+      const bool staged = us->buf_registered && wanted <= MONGOC_STREAM_URING_BUFFER_SIZE;
+
+      if (staged) {
+         op.opcode = IORING_OP_READ_FIXED;
+         op.addr = (uint64_t)(uintptr_t)us->buf;
+         op.len = (uint32_t)wanted;
+         op.buf_index = 0u;
+      } else {
+         op.opcode = IORING_OP_READV;
+         op.addr = (uint64_t)(uintptr_t)&iov[cur];
+         op.len = (uint32_t)(iovcnt - cur);
+      }
+
+      nread = _mongoc_stream_uring_submit(us, &op, expire_at);
+
+      if (nread <= 0) {
+         us->sock->errno_ = -nread;
+         if (ret >= (ssize_t)min_bytes) {
+            RETURN(ret);
+         }
+         errno = us->sock->errno_;
+         RETURN(-1);
+      }
+
+      mongoc_counter_streams_ingress_add(nread);
+      ret += nread;
+
+      for (size_t copied = 0u; cur < iovcnt;) {
+         const size_t n = BSON_MIN(iov[cur].iov_len, (size_t)nread);
+
+         if (staged) {
+            memcpy(iov[cur].iov_base, us->buf + copied, n);
+            copied += n;
+         }
+
+         if (n < iov[cur].iov_len) {
+            iov[cur].iov_base = ((char *)iov[cur].iov_base) + n;
+            iov[cur].iov_len -= n;
+            break;
+         }
+
+         nread -= (int32_t)n;
+         cur++;
+      }
+
+      if (cur == iovcnt || ret >= (ssize_t)min_bytes) {
+         RETURN(ret);
+      }
+   }
+}
+
+
+static ssize_t
+_mongoc_stream_uring_writev(mongoc_stream_t *stream, mongoc_iovec_t *in_iov, size_t iovcnt, int32_t timeout_msec)
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+   mongoc_iovec_t *iov;
+   int64_t expire_at;
+   ssize_t ret = 0;
+   size_t cur = 0;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+
+   if (!us->sock) {
+      RETURN(-1);
+   }
+
+   expire_at = get_expiration(timeout_msec);
+
+   iov = BSON_ARRAY_ALLOC(iovcnt, mongoc_iovec_t);
+   memcpy(iov, in_iov, sizeof(*iov) * iovcnt);
+
+   while (cur < iovcnt) {
+      struct io_uring_sqe op = {0};
+      struct msghdr msg = {0};
+      size_t remaining = 0u;
+      int32_t sent;
+
+      for (size_t i = cur; i < iovcnt; i++) {
+         remaining += iov[i].iov_len;
+      }
+
+      if (iovcnt - cur == 1u) {
+         op.opcode = IORING_OP_SEND;
+         op.addr = (uint64_t)(uintptr_t)iov[cur].iov_base;
+         op.len = (uint32_t)BSON_MIN(remaining, (size_t)INT32_MAX);
+      } else if (us->buf_registered && remaining <= MONGOC_STREAM_URING_BUFFER_SIZE) {
+         /* Coalesce a small message into one contiguous send. */
+         size_t offset = 0u;
+
+         for (size_t i = cur; i < iovcnt; i++) {
+            memcpy(us->buf + offset, iov[i].iov_base, iov[i].iov_len);
+            offset += iov[i].iov_len;
+         }
+
+         op.opcode = IORING_OP_SEND;
+         op.addr = (uint64_t)(uintptr_t)us->buf;
+         op.len = (uint32_t)remaining;
+      } else {
+         msg.msg_iov = (struct iovec *)&iov[cur];
+         msg.msg_iovlen = iovcnt - cur;
+         op.opcode = IORING_OP_SENDMSG;
+         op.addr = (uint64_t)(uintptr_t)&msg;
+         op.len = 1u;
+      }
+
+      op.msg_flags = MSG_NOSIGNAL;
+
+      sent = _mongoc_stream_uring_submit(us, &op, expire_at);
+
+      if (sent <= 0) {
+         us->sock->errno_ = sent < 0 ? -sent : EPIPE;
+         errno = us->sock->errno_;
+         if (!MONGOC_ERRNO_IS_AGAIN(errno) && !MONGOC_ERRNO_IS_TIMEDOUT(errno)) {
+            ret = -1;
+         }
+         break;
+      }
+
+      mongoc_counter_streams_egress_add(sent);
+      ret += sent;
+
+      while (cur < iovcnt && sent >= (int32_t)iov[cur].iov_len) {
+         sent -= (int32_t)iov[cur++].iov_len;
+      }
+
+      if (cur < iovcnt) {
+         iov[cur].iov_base = ((char *)iov[cur].iov_base) + sent;
+         iov[cur].iov_len -= (size_t)sent;
+      }
+   }
+
+   bson_free(iov);
+
+   RETURN(ret);
+}
+
+
+static ssize_t
+_mongoc_stream_uring_poll(mongoc_stream_poll_t *streams, size_t nstreams, int32_t timeout_msec)
+{
+   ssize_t ret = -1;
+   mongoc_socket_poll_t *sds;
+   mongoc_stream_uring_t *us;
+
+   ENTRY;
+
+   sds = BSON_ARRAY_ALLOC(nstreams, mongoc_socket_poll_t);
+
+   for (size_t i = 0u; i < nstreams; i++) {
+      us = (mongoc_stream_uring_t *)streams[i].stream;
+
+      if (!us->sock) {
+         goto CLEANUP;
+      }
+
+      sds[i].socket = us->sock;
+      sds[i].events = streams[i].events;
+   }
+
+   ret = mongoc_socket_poll(sds, nstreams, timeout_msec);
+
+   if (ret > 0) {
+      for (size_t i = 0u; i < nstreams; i++) {
+         streams[i].revents = sds[i].revents;
+      }
+   }
+
+CLEANUP:
+   bson_free(sds);
+
+   RETURN(ret);
+}
+
+
+static bool
+_mongoc_stream_uring_check_closed(mongoc_stream_t *stream) /* IN */
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+
+   ENTRY;
+
+   BSON_ASSERT(stream);
+
+   if (us->sock && !us->broken) {
+      RETURN(mongoc_socket_check_closed(us->sock));
+   }
+
+   RETURN(true);
+}
+
+
+static bool
+_mongoc_stream_uring_timed_out(mongoc_stream_t *stream) /* IN */
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+   BSON_ASSERT(us->sock);
+
+   RETURN(MONGOC_ERRNO_IS_TIMEDOUT(us->sock->errno_));
+}
+
+
+static bool
+_mongoc_stream_uring_should_retry(mongoc_stream_t *stream) /* IN */
+{
+   mongoc_stream_uring_t *us = (mongoc_stream_uring_t *)stream;
+
+   ENTRY;
+
+   BSON_ASSERT(us);
+   BSON_ASSERT(us->sock);
+
+   RETURN(MONGOC_ERRNO_IS_AGAIN(us->sock->errno_));
+}
+
+
+static bool
+_mongoc_stream_uring_setup_ring(mongoc_stream_uring_t *us)
+{
+   struct io_uring_params params = {0};
+   struct iovec registered;
+   int flags;
+
+   us->ring_fd = (int)syscall(__NR_io_uring_setup, MONGOC_STREAM_URING_ENTRIES, &params);
+   if (us->ring_fd < 0) {
+      TRACE("io_uring_setup failed: %d", errno);
+      return false;
+   }
+
+   /* Without fast poll, socket requests that cannot complete immediately
+    * would block a kernel worker thread instead of waiting for readiness. */
+   if (!(params.features & IORING_FEAT_FAST_POLL) || !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+      TRACE("%s", "io_uring lacks fast poll support");
+      return false;
+   }
+
+   us->ring_len = BSON_MAX(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                           params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+   us->ring =
+      mmap(NULL, us->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, us->ring_fd, IORING_OFF_SQ_RING);
+   if (us->ring == MAP_FAILED) {
+      us->ring = NULL;
+      return false;
+   }
+
+   us->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+   us->sqes = mmap(NULL, us->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, us->ring_fd, IORING_OFF_SQES);
+   if (us->sqes == MAP_FAILED) {
+      us->sqes = NULL;
+      return false;
+   }
+
+   us->sq_tail = (uint32_t *)((char *)us->ring + params.sq_off.tail);
+   us->sq_mask = (uint32_t *)((char *)us->ring + params.sq_off.ring_mask);
+   us->sq_array = (uint32_t *)((char *)us->ring + params.sq_off.array);
+   us->cq_head = (uint32_t *)((char *)us->ring + params.cq_off.head);
+   us->cq_tail = (uint32_t *)((char *)us->ring + params.cq_off.tail);
+   us->cq_mask = (uint32_t *)((char *)us->ring + params.cq_off.ring_mask);
+   us->cqes = (struct io_uring_cqe *)((char *)us->ring + params.cq_off.cqes);
+
+   /* Fixed files and buffers are optimizations: carry on without them if the
+    * kernel refuses, e.g. when the buffer exceeds RLIMIT_MEMLOCK. */
+   us->fixed_file = 0 == syscall(__NR_io_uring_register, us->ring_fd, IORING_REGISTER_FILES, &us->sock->sd, 1);
+
+   us->buf = bson_malloc(MONGOC_STREAM_URING_BUFFER_SIZE);
+   registered.iov_base = us->buf;
+   registered.iov_len = MONGOC_STREAM_URING_BUFFER_SIZE;
+   us->buf_registered = 0 == syscall(__NR_io_uring_register, us->ring_fd, IORING_REGISTER_BUFFERS, &registered, 1);
+
+   /* io_uring returns EAGAIN for reads on O_NONBLOCK files rather than
+    * waiting for data, so the socket must be switched to blocking mode. Every
+    * wait is bounded by a linked timeout instead. */
+   flags = fcntl(us->sock->sd, F_GETFL);
+   if (flags == -1 || -1 == fcntl(us->sock->sd, F_SETFL, flags & ~O_NONBLOCK)) {
+      return false;
+   }
+
+   return true;
+}
+
+#endif /* MONGOC_ENABLE_IO_URING */
+
+
+mongoc_socket_t *
+mongoc_stream_uring_get_socket(mongoc_stream_uring_t *stream) /* IN */
+{
+   BSON_ASSERT(stream);
+
+   return stream->sock;
+}
+
+
+/*
+ *--------------------------------------------------------------------------
+ *
+ * mongoc_stream_uring_new --
+ *
+ *       Create a new mongoc_stream_t that reads and writes @sock through
+ *       an io_uring instance owned by the stream.
+ *
+ * Returns:
+ *       A new stream that takes ownership of @sock, or NULL if io_uring
+ *       is not available. @sock is left untouched in that case.
+ *
+ *--------------------------------------------------------------------------
+ */
+
+mongoc_stream_t *
+mongoc_stream_uring_new(mongoc_socket_t *sock) /* IN */
+{
+   BSON_ASSERT_PARAM(sock);
+
+#ifdef MONGOC_ENABLE_IO_URING
+   mongoc_stream_uring_t *stream;
+
+   stream = (mongoc_stream_uring_t *)bson_malloc0(sizeof *stream);
+   stream->sock = sock;
+   stream->ring_fd = -1;
+
+   if (!_mongoc_stream_uring_setup_ring(stream)) {
+      _mongoc_stream_uring_release_ring(stream);
+      bson_free(stream);
+      return NULL;
+   }
+
+   stream->vtable.type = MONGOC_STREAM_URING;
+   stream->vtable.close = _mongoc_stream_uring_close;
+   stream->vtable.destroy = _mongoc_stream_uring_destroy;
+   stream->vtable.failed = _mongoc_stream_uring_failed;
+   stream->vtable.flush = _mongoc_stream_uring_flush;
+   stream->vtable.readv = _mongoc_stream_uring_readv;
+   stream->vtable.writev = _mongoc_stream_uring_writev;
+   stream->vtable.setsockopt = _mongoc_stream_uring_setsockopt;
+   stream->vtable.check_closed = _mongoc_stream_uring_check_closed;
+   stream->vtable.timed_out = _mongoc_stream_uring_timed_out;
+   stream->vtable.should_retry = _mongoc_stream_uring_should_retry;
+   stream->vtable.poll = _mongoc_stream_uring_poll;
+
+   mongoc_counter_streams_active_inc();
+   return (mongoc_stream_t *)stream;
+#else
+   return NULL;
+#endif
+}
@@ -21,6 +21,7 @@
 #include <mongoc/mongoc-buffer-private.h>
 #include <mongoc/mongoc-errno-private.h>
 #include <mongoc/mongoc-error-private.h>
+#include <mongoc/mongoc-probes-private.h>
 #include <mongoc/mongoc-rpc-private.h>
 #include <mongoc/mongoc-stream-private.h>
 #include <mongoc/mongoc-trace-private.h>
@@ -166,7 +167,9 @@ mongoc_stream_writev(mongoc_stream_t *stream, mongoc_iovec_t *iov, size_t iovcnt
    }
 
    DUMP_IOVEC(writev, iov, iovcnt);
+   MONGOC_PROBE3(stream_write_start, stream, stream->type, iovcnt);
    ret = stream->writev(stream, iov, iovcnt, timeout_msec);
+   MONGOC_PROBE3(stream_write_done, stream, stream->type, ret);
 
    RETURN(ret);
 }
@@ -231,7 +234,9 @@ mongoc_stream_readv(mongoc_stream_t *stream, mongoc_iovec_t *iov, size_t iovcnt,
 
    BSON_ASSERT(stream->readv);
 
+   MONGOC_PROBE3(stream_read_start, stream, stream->type, min_bytes);
    ret = stream->readv(stream, iov, iovcnt, min_bytes, timeout_msec);
+   MONGOC_PROBE3(stream_read_done, stream, stream->type, ret);
    if (ret >= 0) {
       DUMP_IOVEC(readv, iov, iovcnt);
    }
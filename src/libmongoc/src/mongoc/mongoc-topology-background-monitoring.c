@@ -25,6 +25,7 @@
 #include <mongoc/mongoc-stream-private.h>
 #include <mongoc/mongoc-topology-description-apm-private.h>
 #include <mongoc/mongoc-topology-private.h>
+#include <mongoc/mongoc-topology-scanner-private.h>
 #include <mongoc/mongoc-trace-private.h>
 #include <mongoc/mongoc-util-private.h>
 
@@ -77,6 +78,95 @@ static BSON_THREAD_FUN(srv_polling_run, topology_void)
    BSON_THREAD_RETURN;
 }
 
+/* Add scanner nodes for new servers, and retire nodes of removed servers.
+ *
+ * Called only by the multiplexed monitoring thread, which owns the scanner
+ * nodes. New nodes are checked by the next call to
+ * mongoc_topology_scanner_work.
+ */
+static void
+_multiplexed_monitor_reconcile(mongoc_topology_t *topology)
+{
+   mc_shared_tpld td;
+
+   /* Application threads request a reconcile before they commit their
+    * modification. Wait for the commit, so this sees the servers they added. */
+   bson_mutex_lock(&topology->tpld_modification_mtx);
+   td = mc_tpld_take_ref(topology);
+   bson_mutex_unlock(&topology->tpld_modification_mtx);
+
+   mongoc_topology_reconcile(topology, td.ptr);
+   mc_tpld_drop_ref(&td);
+}
+
+/* The multiplexed monitoring thread function.
+ *
+ * Checks all servers at once with the topology scanner, which multiplexes the
+ * connections and hello commands with poll. Every heartbeatFrequencyMS, or
+ * minHeartbeatFrequencyMS after a scan is requested, starts a check of every
+ * server. In between, checks servers as soon as they are discovered.
+ */
+static BSON_THREAD_FUN(_multiplexed_monitor_run, topology_void)
+{
+   mongoc_topology_t *const topology = topology_void;
+   mongoc_topology_scanner_t *const scanner = topology->scanner;
+   int64_t heartbeat_ms;
+   int64_t last_scan_ms = 0;
+   bool full_scan = true;
+
+   {
+      mc_shared_tpld td = mc_tpld_take_ref(topology);
+      heartbeat_ms = td.ptr->heartbeat_msec;
+      mc_tpld_drop_ref(&td);
+   }
+
+   while (mcommon_atomic_int_fetch(&topology->scanner_state, mcommon_memory_order_relaxed) ==
+          MONGOC_TOPOLOGY_SCANNER_BG_RUNNING) {
+      if (full_scan) {
+         TRACE("%s", "multiplexed monitor checking all servers");
+         mongoc_topology_scanner_start(scanner, false /* obey_cooldown: skip cooldown */);
+         last_scan_ms = bson_get_monotonic_time() / 1000;
+      }
+
+      /* Reconcile after starting the scan, so new nodes are checked once.
+       * Retired nodes are deleted when the next scan starts. Do not call
+       * _mongoc_topology_scanner_finish: the SRV polling thread uses the
+       * scanner error. */
+      _multiplexed_monitor_reconcile(topology);
+      mongoc_topology_scanner_work(scanner);
+
+      bson_mutex_lock(&topology->multiplexed_monitor.mutex);
+      full_scan = false;
+      while (mcommon_atomic_int_fetch(&topology->scanner_state, mcommon_memory_order_relaxed) ==
+             MONGOC_TOPOLOGY_SCANNER_BG_RUNNING) {
+         int64_t scan_due_ms;
+         int64_t sleep_duration_ms;
+
+         if (topology->multiplexed_monitor.reconcile_requested) {
+            topology->multiplexed_monitor.reconcile_requested = false;
+            break;
+         }
+
+         scan_due_ms = last_scan_ms + (topology->multiplexed_monitor.scan_requested
+                                          ? topology->min_heartbeat_frequency_msec
+                                          : heartbeat_ms);
+         sleep_duration_ms = scan_due_ms - bson_get_monotonic_time() / 1000;
+         if (sleep_duration_ms <= 0) {
+            topology->multiplexed_monitor.scan_requested = false;
+            full_scan = true;
+            break;
+         }
+
+         TRACE("multiplexed monitor sleeping for %" PRId64 "ms", sleep_duration_ms);
+         mongoc_cond_timedwait(
+            &topology->multiplexed_monitor.cond, &topology->multiplexed_monitor.mutex, sleep_duration_ms);
+      }
+      bson_mutex_unlock(&topology->multiplexed_monitor.mutex);
+   }
+
+   BSON_THREAD_RETURN;
+}
+
 /* Create a server monitor if necessary.
  *
  * Called by monitor threads and application threads when reconciling the
@@ -149,9 +239,23 @@ _mongoc_topology_background_monitoring_start(mongoc_topology_t *topology)
    if (tdmod.new_td->type == MONGOC_TOPOLOGY_LOAD_BALANCED) {
       /* Do not proceed to start monitoring threads. */
       TRACE("%s", "disabling monitoring for load balanced topology");
+   } else if (topology->multiplexed_monitor.enabled) {
+      int ret = mcommon_thread_create(&topology->multiplexed_monitor.thread, _multiplexed_monitor_run, topology);
+      if (ret == 0) {
+         topology->multiplexed_monitor.is_running = true;
+      } else {
+         char errmsg_buf[BSON_ERROR_BUFFER_SIZE];
+         char *errmsg = bson_strerror_r(ret, errmsg_buf, sizeof errmsg_buf);
+         MONGOC_ERROR("Failed to start multiplexed monitoring thread. Servers "
+                      "may not be selectable. Error: %s",
+                      errmsg);
+      }
    } else {
       /* Reconcile to create the first server monitors. */
       _mongoc_topology_background_monitoring_reconcile(topology, tdmod.new_td);
+   }
+
+   if (tdmod.new_td->type != MONGOC_TOPOLOGY_LOAD_BALANCED) {
       /* Start SRV polling thread. */
       if (mongoc_topology_should_rescan_srv(topology)) {
          int ret = mcommon_thread_create(&topology->srv_polling_thread, srv_polling_run, topology);
@@ -226,6 +330,15 @@ _mongoc_topology_background_monitoring_reconcile(mongoc_topology_t *topology, mo
       return;
    }
 
+   if (topology->multiplexed_monitor.enabled) {
+      /* The monitoring thread owns the scanner nodes. Wake it to reconcile. */
+      bson_mutex_lock(&topology->multiplexed_monitor.mutex);
+      topology->multiplexed_monitor.reconcile_requested = true;
+      mongoc_cond_signal(&topology->multiplexed_monitor.cond);
+      bson_mutex_unlock(&topology->multiplexed_monitor.mutex);
+      return;
+   }
+
    /* Add newly discovered server monitors, and update existing ones. */
    for (size_t i = 0u; i < server_descriptions->items_len; i++) {
       mongoc_server_description_t *sd;
@@ -255,6 +368,14 @@ _mongoc_topology_background_monitoring_request_scan(mongoc_topology_t *topology)
       return;
    }
 
+   if (topology->multiplexed_monitor.enabled) {
+      bson_mutex_lock(&topology->multiplexed_monitor.mutex);
+      topology->multiplexed_monitor.scan_requested = true;
+      mongoc_cond_signal(&topology->multiplexed_monitor.cond);
+      bson_mutex_unlock(&topology->multiplexed_monitor.mutex);
+      return;
+   }
+
    server_monitors = topology->server_monitors;
 
    for (size_t i = 0u; i < server_monitors->items_len; i++) {
@@ -329,6 +450,16 @@ _mongoc_topology_background_monitoring_stop(mongoc_topology_t *topology)
       mongoc_server_monitor_destroy(server_monitor);
    }
 
+   /* Signal the multiplexed monitoring thread to stop, and wait for it. It
+    * finishes a check in progress first. */
+   if (topology->multiplexed_monitor.is_running) {
+      bson_mutex_lock(&topology->multiplexed_monitor.mutex);
+      mongoc_cond_signal(&topology->multiplexed_monitor.cond);
+      bson_mutex_unlock(&topology->multiplexed_monitor.mutex);
+      mcommon_thread_join(topology->multiplexed_monitor.thread);
+      topology->multiplexed_monitor.is_running = false;
+   }
+
    /* Wait for SRV polling thread. */
    if (topology->is_srv_polling) {
       mcommon_thread_join(topology->srv_polling_thread);
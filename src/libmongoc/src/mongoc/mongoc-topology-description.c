@@ -15,6 +15,7 @@
  */
 
 #include <common-oid-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-array-private.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-error-private.h>
@@ -2414,15 +2415,15 @@ _mongoc_topology_description_check_compatible(mongoc_topology_description_t *td)
  *--------------------------------------------------------------------------
  */
 
-void
-mongoc_topology_description_handle_hello(
+static void
+_mongoc_topology_description_handle_hello(
    mongoc_topology_description_t *topology,
    const mongoc_log_and_monitor_instance_t *log_and_monitor,
    uint32_t server_id,
    const bson_t *hello_response,
    int64_t rtt_msec,
    mongoc_topology_description_hello_cluster_time_strategy_t cluster_time_strategy,
-   const bson_error_t *error /* IN */)
+   const bson_error_t *error)
 {
    mongoc_topology_description_t *prev_td = NULL;
    mongoc_server_description_t *prev_sd = NULL;
@@ -2549,6 +2550,22 @@ mongoc_topology_description_handle_hello(
    mongoc_server_description_destroy(prev_sd);
 }
 
+void
+mongoc_topology_description_handle_hello(
+   mongoc_topology_description_t *topology,
+   const mongoc_log_and_monitor_instance_t *log_and_monitor,
+   uint32_t server_id,
+   const bson_t *hello_response,
+   int64_t rtt_msec,
+   mongoc_topology_description_hello_cluster_time_strategy_t cluster_time_strategy,
+   const bson_error_t *error /* IN */)
+{
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_TOPOLOGY);
+   _mongoc_topology_description_handle_hello(
+      topology, log_and_monitor, server_id, hello_response, rtt_msec, cluster_time_strategy, error);
+   _mongoc_alloc_tag_pop(alloc_tag);
+}
+
 /*
  *--------------------------------------------------------------------------
  *
@@ -22,10 +22,12 @@
 #include <common-atomic-private.h>
 #include <mongoc/mongoc-client-session-private.h>
 #include <mongoc/mongoc-crypt-private.h>
+#include <mongoc/mongoc-dns-cache-private.h>
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-log-and-monitor-private.h>
 #include <mongoc/mongoc-oidc-cache-private.h>
 #include <mongoc/mongoc-server-description-private.h>
+#include <mongoc/mongoc-server-wire-stats-private.h>
 #include <mongoc/mongoc-shared-private.h>
 #include <mongoc/mongoc-thread-private.h>
 #include <mongoc/mongoc-topology-description-private.h>
@@ -44,6 +46,7 @@
 #define MONGOC_TOPOLOGY_HEARTBEAT_FREQUENCY_MS_MULTI_THREADED 10000
 #define MONGOC_TOPOLOGY_HEARTBEAT_FREQUENCY_MS_SINGLE_THREADED 60000
 #define MONGOC_TOPOLOGY_MIN_RESCAN_SRV_INTERVAL_MS 60000
+#define MONGOC_TOPOLOGY_MAX_CONNECTING 2
 
 typedef enum {
    MONGOC_TOPOLOGY_SCANNER_OFF,
@@ -57,6 +60,17 @@ typedef enum mongoc_topology_cse_state_t {
    MONGOC_CSE_ENABLED,
 } mongoc_topology_cse_state_t;
 
+typedef struct _mongoc_topology_connecting_waiter_t {
+   struct _mongoc_topology_connecting_waiter_t *prev;
+   struct _mongoc_topology_connecting_waiter_t *next;
+} mongoc_topology_connecting_waiter_t;
+
+/* Connections being established to one server. See max_connecting. */
+typedef struct _mongoc_topology_connecting_t {
+   int32_t in_progress;
+   mongoc_topology_connecting_waiter_t *waiters;
+} mongoc_topology_connecting_t;
+
 struct _mongoc_background_monitor_t;
 struct _mongoc_client_pool_t;
 struct mongoc_structured_log_instance_t;
@@ -176,6 +190,9 @@ typedef struct _mongoc_topology_t {
    bool single_threaded;
    bool stale;
 
+   /* The number of threads blocked in server selection. Atomic. */
+   int32_t selection_waiters;
+
    mongoc_server_session_pool session_pool;
 
    /* Is client side encryption enabled? */
@@ -213,6 +230,29 @@ typedef struct _mongoc_topology_t {
    mongoc_set_t *server_monitors;
    mongoc_set_t *rtt_monitors;
 
+   /* For multiplexed background monitoring (the "multiplexedMonitoring" URI
+    * option), one thread checks all servers with the topology scanner instead
+    * of a server monitor and an RTT monitor per server. The thread owns the
+    * scanner nodes. The requests are protected by mutex. */
+   struct {
+      bool enabled;
+      bool is_running;
+      bson_thread_t thread;
+      bson_mutex_t mutex;
+      mongoc_cond_t cond;
+      bool scan_requested;
+      bool reconcile_requested;
+   } multiplexed_monitor;
+
+   /* For pooled clients, the "maxConnecting" limit on connections to one
+    * server being established concurrently by all clients. Waiters queue in
+    * FIFO order. The set maps a server id to a mongoc_topology_connecting_t
+    * and is protected by connecting_mtx. */
+   int32_t max_connecting;
+   mongoc_set_t *connecting;
+   bson_mutex_t connecting_mtx;
+   mongoc_cond_t connecting_cond;
+
    // APM callbacks, structured logging handlers and callbacks.
    // Documented as per-client and per-pool, implemented as owned by topology_t.
    mongoc_log_and_monitor_instance_t log_and_monitor;
@@ -237,6 +277,12 @@ typedef struct _mongoc_topology_t {
 
    // `oidc_cache` implements the OIDC spec "Client Cache". It is shared among all pooled clients.
    mongoc_oidc_cache_t *oidc_cache;
+
+   // `dns_cache` caches host name lookups for the scanner, the server monitors, and application connections.
+   mongoc_dns_cache_t *dns_cache;
+
+   // `wire_stats` counts the messages and bytes exchanged with each server by every client of the topology.
+   mongoc_wire_stats_t *wire_stats;
 } mongoc_topology_t;
 
 mongoc_topology_t *
@@ -250,7 +296,7 @@ void
 mongoc_topology_destroy(mongoc_topology_t *topology);
 
 void
-mongoc_topology_reconcile(const mongoc_topology_t *topology, mongoc_topology_description_t *td);
+mongoc_topology_reconcile(const mongoc_topology_t *topology, const mongoc_topology_description_t *td);
 
 bool
 mongoc_topology_compatible(const mongoc_topology_description_t *td,
@@ -404,6 +450,17 @@ _mongoc_topology_request_scan(mongoc_topology_t *topology);
 void
 _mongoc_topology_bypass_cooldown(mongoc_topology_t *topology);
 
+/* Wait until fewer than "maxConnecting" connections to @server_id are being
+ * established, then claim a slot. Must be paired with
+ * _mongoc_topology_connecting_end on success. Returns false and sets @error if
+ * connectTimeoutMS expires first, or if the server was marked unknown while
+ * waiting. */
+bool
+_mongoc_topology_connecting_begin(mongoc_topology_t *topology, uint32_t server_id, bson_error_t *error);
+
+void
+_mongoc_topology_connecting_end(mongoc_topology_t *topology, uint32_t server_id);
+
 typedef enum {
    MONGOC_SDAM_APP_ERROR_COMMAND,
    MONGOC_SDAM_APP_ERROR_NETWORK,
@@ -30,9 +30,11 @@
 #include <mongoc/mongoc-async-cmd-private.h>
 #include <mongoc/mongoc-async-private.h>
 #include <mongoc/mongoc-crypto-private.h>
+#include <mongoc/mongoc-dns-cache-private.h>
 #include <mongoc/mongoc-handshake-private.h>
 #include <mongoc/mongoc-scram-private.h>
 #include <mongoc/mongoc-server-description-private.h>
+#include <mongoc/mongoc-server-wire-stats-private.h>
 #include <mongoc/mongoc-shared-private.h>
 
 #include <mongoc/mongoc-host-list.h>
@@ -72,10 +74,11 @@ typedef struct mongoc_topology_scanner_node {
    bson_error_t last_error;
 
    /* the hostname for a node may resolve to multiple DNS results.
-    * dns_results has the full list of DNS results, ordered by host preference.
-    * successful_dns_result is the most recent successful DNS result.
+    * dns_result holds the full list of DNS results, ordered by host
+    * preference. successful_dns_result is the most recent successful DNS
+    * result, and points into dns_result.
     */
-   struct addrinfo *dns_results;
+   mongoc_dns_result_t *dns_result;
    struct addrinfo *successful_dns_result;
    int64_t last_dns_cache;
 
@@ -89,6 +92,10 @@ typedef struct mongoc_topology_scanner_node {
    /* handshake_sd is a server description constructed from the response of the
     * initial handshake. It is bound to the lifetime of stream. */
    mongoc_server_description_t *handshake_sd;
+
+   /* used by single-threaded clients to count the messages exchanged on
+    * stream. Taken on first use, released with the node. */
+   mongoc_wire_stats_server_t *wire_stats;
 } mongoc_topology_scanner_node_t;
 
 typedef enum handshake_state_t {
@@ -140,6 +147,8 @@ typedef struct mongoc_topology_scanner {
 #endif
 
    int64_t dns_cache_timeout_ms;
+   /* shared with the topology's application connections, may be NULL */
+   mongoc_dns_cache_t *dns_cache;
    /* only used by single-threaded clients to negotiate auth mechanisms. */
    bool negotiate_sasl_supported_mechs;
    bool bypass_cooldown;
@@ -235,7 +244,7 @@ void
 _mongoc_topology_scanner_dup_handshake_cmd(mongoc_topology_scanner_t *ts, bson_t *copy_into);
 
 bool
-mongoc_topology_scanner_has_node_for_host(mongoc_topology_scanner_t *ts, mongoc_host_list_t *host);
+mongoc_topology_scanner_has_node_for_host(mongoc_topology_scanner_t *ts, const mongoc_host_list_t *host);
 
 void
 mongoc_topology_scanner_set_stream_initiator(mongoc_topology_scanner_t *ts, mongoc_stream_initiator_t si, void *ctx);
@@ -16,6 +16,7 @@
 
 #include <common-atomic-private.h>
 #include <common-string-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-async-cmd-private.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-cluster-oidc-private.h>
@@ -50,6 +51,7 @@
 #endif
 
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
+#include <mongoc/mongoc-stream-tls-openssl-private.h>
 #include <mongoc/mongoc-stream-tls-private.h>
 
 #include <openssl/ssl.h>
@@ -635,9 +637,7 @@ mongoc_topology_scanner_node_destroy(mongoc_topology_scanner_node_t *node, bool
 {
    DL_DELETE(node->ts->nodes, node);
    mongoc_topology_scanner_node_disconnect(node, failed);
-   if (node->dns_results) {
-      freeaddrinfo(node->dns_results);
-   }
+   _mongoc_dns_result_release(node->dns_result);
 
    bson_destroy(&node->speculative_auth_response);
 
@@ -646,6 +646,7 @@ mongoc_topology_scanner_node_destroy(mongoc_topology_scanner_node_t *node, bool
 #endif
 
    mongoc_oidc_connection_cache_destroy(node->oidc_connection_cache);
+   _mongoc_wire_stats_server_release(node->wire_stats);
 
    bson_free(node);
 }
@@ -688,7 +689,7 @@ mongoc_topology_scanner_get_node(mongoc_topology_scanner_t *ts, uint32_t id)
  *--------------------------------------------------------------------------
  */
 bool
-mongoc_topology_scanner_has_node_for_host(mongoc_topology_scanner_t *ts, mongoc_host_list_t *host)
+mongoc_topology_scanner_has_node_for_host(mongoc_topology_scanner_t *ts, const mongoc_host_list_t *host)
 {
    mongoc_topology_scanner_node_t *ele, *tmp;
 
@@ -791,9 +792,10 @@ _async_error_or_timeout(mongoc_async_cmd_t *acmd, mlib_duration elapsed, const c
       }
 
       /* invalidate any cached DNS results. */
-      if (node->dns_results) {
-         freeaddrinfo(node->dns_results);
-         node->dns_results = NULL;
+      if (node->dns_result) {
+         _mongoc_dns_cache_invalidate(node->ts->dns_cache, &node->host);
+         _mongoc_dns_result_release(node->dns_result);
+         node->dns_result = NULL;
          node->successful_dns_result = NULL;
       }
 
@@ -869,6 +871,9 @@ _mongoc_topology_scanner_node_setup_stream_for_tls(mongoc_topology_scanner_node_
 #if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
       tls_stream = mongoc_stream_tls_new_with_hostname_and_openssl_context(
          stream, node->host.host, node->ts->ssl_opts, 1, node->ts->openssl_ctx);
+      if (tls_stream) {
+         _mongoc_stream_tls_openssl_set_session_cache_key(tls_stream, node->host.host_and_port);
+      }
 #elif defined(MONGOC_ENABLE_SSL_SECURE_CHANNEL)
       tls_stream = mongoc_stream_tls_new_with_secure_channel_cred(
          stream, node->host.host, node->ts->ssl_opts, node->ts->secure_channel_cred_ptr);
@@ -921,46 +926,26 @@ _mongoc_topology_scanner_tcp_initiate(mongoc_async_cmd_t *acmd)
 bool
 mongoc_topology_scanner_node_setup_tcp(mongoc_topology_scanner_node_t *node, bson_error_t *error)
 {
-   struct addrinfo hints;
    struct addrinfo *iter;
-   char portstr[8];
-   mongoc_host_list_t *host;
-   int s;
    mlib_duration delay = mlib_duration();
    int64_t now = bson_get_monotonic_time();
 
    ENTRY;
 
-   host = &node->host;
-
    /* if cached dns results are expired, flush. */
-   if (node->dns_results && (now - node->last_dns_cache) > node->ts->dns_cache_timeout_ms * 1000) {
-      freeaddrinfo(node->dns_results);
-      node->dns_results = NULL;
+   if (node->dns_result && (now - node->last_dns_cache) > node->ts->dns_cache_timeout_ms * 1000) {
+      _mongoc_dns_result_release(node->dns_result);
+      node->dns_result = NULL;
       node->successful_dns_result = NULL;
    }
 
-   if (!node->dns_results) {
-      // Expect no truncation.
-      int req = bson_snprintf(portstr, sizeof portstr, "%hu", host->port);
-      BSON_ASSERT(mlib_cmp(req, <, sizeof portstr));
-
-      memset(&hints, 0, sizeof hints);
-      hints.ai_family = host->family;
-      hints.ai_socktype = SOCK_STREAM;
-      hints.ai_flags = 0;
-      hints.ai_protocol = 0;
-
-      s = getaddrinfo(host->host, portstr, &hints, &node->dns_results);
-
-      if (s != 0) {
-         mongoc_counter_dns_failure_inc();
-         _mongoc_set_error(
-            error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_NAME_RESOLUTION, "Failed to resolve '%s'", host->host);
+   if (!node->dns_result) {
+      /* the topology's cache, shared with application connections */
+      node->dns_result = _mongoc_dns_cache_lookup(node->ts->dns_cache, &node->host, error);
+      if (!node->dns_result) {
          RETURN(false);
       }
 
-      mongoc_counter_dns_success_inc();
       node->last_dns_cache = now;
    }
 
@@ -972,7 +957,7 @@ mongoc_topology_scanner_node_setup_tcp(mongoc_topology_scanner_node_t *node, bso
                        mlib_duration() /* initiate_delay */,
                        true /* use_handshake */);
    } else {
-      LL_FOREACH2(node->dns_results, iter, ai_next)
+      LL_FOREACH2(_mongoc_dns_result_addrinfo(node->dns_result), iter, ai_next)
       {
          _begin_hello_cmd(node, NULL /* stream */, false /* is_setup_done */, iter, delay, true /* use_handshake */);
          /* each subsequent DNS result will have an additional 250ms delay. */
@@ -1290,8 +1275,10 @@ _mongoc_topology_scanner_finish(mongoc_topology_scanner_t *ts)
 void
 mongoc_topology_scanner_work(mongoc_topology_scanner_t *ts)
 {
+   const mongoc_alloc_tag_t alloc_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_TOPOLOGY);
    mongoc_async_run(ts->async);
    BSON_ASSERT(ts->async->ncmds == 0);
+   _mongoc_alloc_tag_pop(alloc_tag);
 }
 
 /*
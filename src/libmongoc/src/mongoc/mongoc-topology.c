@@ -14,13 +14,16 @@
  * limitations under the License.
  */
 
+#include <common-atomic-private.h>
 #include <common-oid-private.h>
 #include <common-string-private.h>
 #include <mongoc/mongoc-client-private.h>
 #include <mongoc/mongoc-cmd-private.h>
+#include <mongoc/mongoc-counters-private.h>
 #include <mongoc/mongoc-error-private.h>
 #include <mongoc/mongoc-handshake-private.h>
 #include <mongoc/mongoc-host-list-private.h>
+#include <mongoc/mongoc-probes-private.h>
 #include <mongoc/mongoc-read-prefs-private.h>
 #include <mongoc/mongoc-structured-log-private.h>
 #include <mongoc/mongoc-topology-background-monitoring-private.h>
@@ -36,6 +39,8 @@
 #include <mongoc/utlist.h>
 
 #include <mlib/cmp.h>
+#include <mlib/duration.h>
+#include <mlib/timer.h>
 
 #include <stdint.h>
 
@@ -43,7 +48,7 @@ static void
 _topology_collect_errors(const mongoc_topology_description_t *topology, bson_error_t *error_out);
 
 static bool
-_mongoc_topology_reconcile_add_nodes(mongoc_server_description_t *sd, mongoc_topology_scanner_t *scanner)
+_mongoc_topology_reconcile_add_nodes(const mongoc_server_description_t *sd, mongoc_topology_scanner_t *scanner)
 {
    mongoc_topology_scanner_node_t *node;
 
@@ -63,27 +68,28 @@ _mongoc_topology_reconcile_add_nodes(mongoc_server_description_t *sd, mongoc_top
 /* Called from:
  * - the topology scanner callback (when a hello was just received)
  * - at the start of a single-threaded scan (mongoc_topology_scan_once)
- * Not called for multi threaded monitoring.
+ * - by the multiplexed monitoring thread
+ * Not called for multi threaded monitoring with a thread per server.
  */
 void
-mongoc_topology_reconcile(const mongoc_topology_t *topology, mongoc_topology_description_t *td)
+mongoc_topology_reconcile(const mongoc_topology_t *topology, const mongoc_topology_description_t *td)
 {
-   mongoc_set_t *servers;
-   mongoc_server_description_t *sd;
+   const mongoc_set_t *servers;
+   const mongoc_server_description_t *sd;
    mongoc_topology_scanner_node_t *ele, *tmp;
 
-   BSON_ASSERT(topology->single_threaded);
-   servers = mc_tpld_servers(td);
+   BSON_ASSERT(topology->single_threaded || topology->multiplexed_monitor.enabled);
+   servers = mc_tpld_servers_const(td);
    /* Add newly discovered nodes */
    for (size_t i = 0u; i < servers->items_len; i++) {
-      sd = mongoc_set_get_item(servers, i);
+      sd = mongoc_set_get_item_const(servers, i);
       _mongoc_topology_reconcile_add_nodes(sd, topology->scanner);
    }
 
    /* Remove removed nodes */
    DL_FOREACH_SAFE(topology->scanner->nodes, ele, tmp)
    {
-      if (!mongoc_topology_description_server_by_id(td, ele->id, NULL)) {
+      if (!mongoc_topology_description_server_by_id_const(td, ele->id, NULL)) {
          mongoc_topology_scanner_node_retire(ele);
       }
    }
@@ -124,11 +130,11 @@ _mongoc_topology_scanner_setup_err_cb(uint32_t id, void *data, const bson_error_
 {
    mongoc_topology_t *topology = BSON_ASSERT_PTR_INLINE(data);
 
-   BSON_ASSERT(topology->single_threaded);
+   BSON_ASSERT(topology->single_threaded || topology->multiplexed_monitor.enabled);
    if (_mongoc_topology_get_type(topology) == MONGOC_TOPOLOGY_LOAD_BALANCED) {
       /* In load balanced mode, scanning is only for connection establishment.
        * It must not modify the topology description. */
-   } else {
+   } else if (topology->single_threaded) {
       // Use `mc_tpld_unsafe_get_mutable` to get a mutable topology description
       // without locking. This function only applies to single-threaded clients.
       mongoc_topology_description_t *td = mc_tpld_unsafe_get_mutable(topology);
@@ -139,41 +145,33 @@ _mongoc_topology_scanner_setup_err_cb(uint32_t id, void *data, const bson_error_
                                                -1 /* rtt_msec */,
                                                MONGOC_TOPOLOGY_DESCRIPTION_HELLO_CLUSTER_TIME_IGNORE,
                                                error);
+   } else if (mcommon_atomic_int_fetch(&topology->scanner_state, mcommon_memory_order_relaxed) ==
+              MONGOC_TOPOLOGY_SCANNER_BG_RUNNING) {
+      /* Called by the multiplexed monitoring thread. */
+      mc_tpld_modification tdmod = mc_tpld_modify_begin(topology);
+      mongoc_topology_description_handle_hello(tdmod.new_td,
+                                               &topology->log_and_monitor,
+                                               id,
+                                               NULL /* hello reply */,
+                                               -1 /* rtt_msec */,
+                                               MONGOC_TOPOLOGY_DESCRIPTION_HELLO_CLUSTER_TIME_IGNORE,
+                                               error);
+      /* Wake threads performing server selection. */
+      mongoc_cond_broadcast(&topology->cond_client);
+      mc_tpld_modify_commit(tdmod);
    }
 }
 
 
-/*
- *-------------------------------------------------------------------------
- *
- * _mongoc_topology_scanner_cb --
- *
- *       Callback method to handle hello responses received by async
- *       command objects.
- *
- *       Only called for single-threaded monitoring.
- *
- *-------------------------------------------------------------------------
- */
-
-void
-_mongoc_topology_scanner_cb(
-   uint32_t id, const bson_t *hello_response, int64_t rtt_msec, void *data, const bson_error_t *error /* IN */)
+static void
+_mongoc_topology_handle_scan_result(mongoc_topology_t *topology,
+                                    mongoc_topology_description_t *td,
+                                    uint32_t id,
+                                    const bson_t *hello_response,
+                                    int64_t rtt_msec,
+                                    const bson_error_t *error)
 {
-   mongoc_topology_t *const topology = BSON_ASSERT_PTR_INLINE(data);
    mongoc_server_description_t *sd;
-   mongoc_topology_description_t *td;
-
-   BSON_ASSERT(topology->single_threaded);
-   if (_mongoc_topology_get_type(topology) == MONGOC_TOPOLOGY_LOAD_BALANCED) {
-      /* In load balanced mode, scanning is only for connection establishment.
-       * It must not modify the topology description. */
-      return;
-   }
-
-   // Use `mc_tpld_unsafe_get_mutable` to get a mutable topology description
-   // without locking. This function only applies to single-threaded clients.
-   td = mc_tpld_unsafe_get_mutable(topology);
 
    sd = mongoc_topology_description_server_by_id(td, id, NULL);
 
@@ -216,6 +214,55 @@ _mongoc_topology_scanner_cb(
    }
 }
 
+
+/*
+ *-------------------------------------------------------------------------
+ *
+ * _mongoc_topology_scanner_cb --
+ *
+ *       Callback method to handle hello responses received by async
+ *       command objects.
+ *
+ *       Only called for single-threaded monitoring, or by the thread of
+ *       multiplexed background monitoring.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+void
+_mongoc_topology_scanner_cb(
+   uint32_t id, const bson_t *hello_response, int64_t rtt_msec, void *data, const bson_error_t *error /* IN */)
+{
+   mongoc_topology_t *const topology = BSON_ASSERT_PTR_INLINE(data);
+   mc_tpld_modification tdmod;
+
+   BSON_ASSERT(topology->single_threaded || topology->multiplexed_monitor.enabled);
+   if (_mongoc_topology_get_type(topology) == MONGOC_TOPOLOGY_LOAD_BALANCED) {
+      /* In load balanced mode, scanning is only for connection establishment.
+       * It must not modify the topology description. */
+      return;
+   }
+
+   if (topology->single_threaded) {
+      // Use `mc_tpld_unsafe_get_mutable` to get a mutable topology description
+      // without locking. This function only applies to single-threaded clients.
+      _mongoc_topology_handle_scan_result(
+         topology, mc_tpld_unsafe_get_mutable(topology), id, hello_response, rtt_msec, error);
+      return;
+   }
+
+   if (mcommon_atomic_int_fetch(&topology->scanner_state, mcommon_memory_order_relaxed) !=
+       MONGOC_TOPOLOGY_SCANNER_BG_RUNNING) {
+      return;
+   }
+
+   tdmod = mc_tpld_modify_begin(topology);
+   _mongoc_topology_handle_scan_result(topology, tdmod.new_td, id, hello_response, rtt_msec, error);
+   /* Wake threads performing server selection. */
+   mongoc_cond_broadcast(&topology->cond_client);
+   mc_tpld_modify_commit(tdmod);
+}
+
 static void
 _server_session_init(void *session, void *unused, bson_error_t *error)
 {
@@ -370,6 +417,14 @@ _detect_nongenuine_hosts(const mongoc_uri_t *uri)
    }
 }
 
+static void
+_mongoc_topology_connecting_dtor(void *item, void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   bson_free(item);
+}
+
 /*
  *-------------------------------------------------------------------------
  *
@@ -411,6 +466,8 @@ mongoc_topology_new(const mongoc_uri_t *uri, bool single_threaded)
    topology = (mongoc_topology_t *)bson_malloc0(sizeof *topology);
 
    topology->oidc_cache = mongoc_oidc_cache_new();
+   topology->dns_cache = _mongoc_dns_cache_new();
+   topology->wire_stats = _mongoc_wire_stats_new();
    // Check if requested to use TCP for SRV lookup.
    {
       char *srv_prefer_tcp = _mongoc_getenv("MONGOC_EXPERIMENTAL_SRV_PREFER_TCP");
@@ -486,6 +543,7 @@ mongoc_topology_new(const mongoc_uri_t *uri, bool single_threaded)
                                                    topology->connect_timeout_msec);
 
    _mongoc_topology_scanner_set_oidc_cache(topology->scanner, topology->oidc_cache);
+   topology->scanner->dns_cache = topology->dns_cache;
    bson_mutex_init(&topology->tpld_modification_mtx);
    mongoc_cond_init(&topology->cond_client);
 
@@ -633,6 +691,15 @@ mongoc_topology_new(const mongoc_uri_t *uri, bool single_threaded)
       topology->rtt_monitors = mongoc_set_new(1, NULL, NULL);
       bson_mutex_init(&topology->srv_polling_mtx);
       mongoc_cond_init(&topology->srv_polling_cond);
+      topology->max_connecting = BSON_MAX(
+         1, mongoc_uri_get_option_as_int32(topology->uri, MONGOC_URI_MAXCONNECTING, MONGOC_TOPOLOGY_MAX_CONNECTING));
+      topology->connecting = mongoc_set_new(1, _mongoc_topology_connecting_dtor, NULL);
+      bson_mutex_init(&topology->connecting_mtx);
+      mongoc_cond_init(&topology->connecting_cond);
+      topology->multiplexed_monitor.enabled =
+         mongoc_uri_get_option_as_bool(topology->uri, MONGOC_URI_MULTIPLEXEDMONITORING, false);
+      bson_mutex_init(&topology->multiplexed_monitor.mutex);
+      mongoc_cond_init(&topology->multiplexed_monitor.cond);
    }
 
    if (!topology->valid) {
@@ -702,6 +769,11 @@ mongoc_topology_destroy(mongoc_topology_t *topology)
       mongoc_set_destroy(topology->rtt_monitors);
       bson_mutex_destroy(&topology->srv_polling_mtx);
       mongoc_cond_destroy(&topology->srv_polling_cond);
+      mongoc_set_destroy(topology->connecting);
+      bson_mutex_destroy(&topology->connecting_mtx);
+      mongoc_cond_destroy(&topology->connecting_cond);
+      bson_mutex_destroy(&topology->multiplexed_monitor.mutex);
+      mongoc_cond_destroy(&topology->multiplexed_monitor.cond);
    }
 
    /* Before reporting this topology as closed, life cycle rules expect us to close
@@ -741,6 +813,8 @@ mongoc_topology_destroy(mongoc_topology_t *topology)
    bson_destroy(topology->encrypted_fields_map);
 
    mongoc_oidc_cache_destroy(topology->oidc_cache);
+   _mongoc_dns_cache_destroy(topology->dns_cache);
+   _mongoc_wire_stats_destroy(topology->wire_stats);
 
    bson_free(topology);
 }
@@ -1127,6 +1201,77 @@ done:
 }
 
 
+/* The waits of one server selection, for counters and the "Server selection
+ * wait ended" log message. */
+typedef struct {
+   /* When the current wait began, or 0 if the selection is not waiting. */
+   int64_t started;
+   int64_t total_usec;
+   int32_t wakeups;
+   /* Threads waiting when the last wait ended, including this one. */
+   int32_t waiting;
+   /* "topologyChange", "timeout" or "error" for clients with background
+    * monitoring, "scan" or "timeout" for single-threaded clients. */
+   const char *woken_by;
+} _mongoc_ss_waits_t;
+
+
+static void
+_mongoc_ss_wait_begin(mongoc_topology_t *topology, _mongoc_ss_waits_t *waits)
+{
+   mcommon_atomic_int32_fetch_add(&topology->selection_waiters, 1, mcommon_memory_order_relaxed);
+   mongoc_counter_server_selection_waiting_inc();
+   waits->started = bson_get_monotonic_time();
+}
+
+
+static void
+_mongoc_ss_wait_finish(mongoc_topology_t *topology, _mongoc_ss_waits_t *waits, const char *woken_by)
+{
+   const int64_t waited = bson_get_monotonic_time() - waits->started;
+
+   waits->waiting = mcommon_atomic_int32_fetch_sub(&topology->selection_waiters, 1, mcommon_memory_order_relaxed);
+   waits->started = 0;
+   waits->total_usec += waited;
+   waits->wakeups++;
+   waits->woken_by = woken_by;
+   mongoc_counter_server_selection_waiting_dec();
+   mongoc_counter_server_selection_wait_usec_add(waited);
+}
+
+
+/* @r is the result of the condition wait. */
+static void
+_mongoc_ss_wait_end(mongoc_topology_t *topology, _mongoc_ss_waits_t *waits, int r)
+{
+   if (mongo_cond_ret_is_timedout(r)) {
+      _mongoc_ss_wait_finish(topology, waits, "timeout");
+      mongoc_counter_server_selection_timeouts_inc();
+   } else if (r == 0) {
+      _mongoc_ss_wait_finish(topology, waits, "topologyChange");
+      mongoc_counter_server_selection_woken_inc();
+   } else {
+      _mongoc_ss_wait_finish(topology, waits, "error");
+   }
+}
+
+
+/* A single-threaded client waits for its next blocking scan. The wait ends
+ * when the selection attempt after that scan is done, or when
+ * serverSelectionTimeoutMS expires first. */
+static void
+_mongoc_ss_wait_end_scan(mongoc_topology_t *topology, _mongoc_ss_waits_t *waits, bool timed_out)
+{
+   if (timed_out) {
+      _mongoc_ss_wait_finish(topology, waits, "timeout");
+      mongoc_counter_server_selection_timeouts_inc();
+   } else {
+      _mongoc_ss_wait_finish(topology, waits, "scan");
+      mongoc_counter_server_selection_rescans_inc();
+   }
+}
+
+
 uint32_t
 mongoc_topology_select_server_id(mongoc_topology_t *topology,
                                  mongoc_ss_optype_t optype,
@@ -1151,6 +1296,10 @@ mongoc_topology_select_server_id(mongoc_topology_t *topology,
    uint32_t server_id;
    mc_shared_tpld td = mc_tpld_take_ref(topology);
    const mongoc_log_and_monitor_instance_t *log_and_monitor = &topology->log_and_monitor;
+   const int64_t selection_started = bson_get_monotonic_time();
+   int64_t selection_usec;
+   _mongoc_ss_waits_t waits = {0};
+   bool timed_out = false;
 
    mcommon_string_append_t topology_type;
    mcommon_string_new_as_append(&topology_type);
@@ -1167,6 +1316,8 @@ mongoc_topology_select_server_id(mongoc_topology_t *topology,
    BSON_ASSERT(topology);
    ts = topology->scanner;
 
+   MONGOC_PROBE1(server_selection_start, optype);
+
    mongoc_structured_log(log_and_monitor->structured_log,
                          MONGOC_STRUCTURED_LOG_LEVEL_DEBUG,
                          MONGOC_STRUCTURED_LOG_COMPONENT_SERVER_SELECTION,
@@ -1221,6 +1372,7 @@ mongoc_topology_select_server_id(mongoc_topology_t *topology,
             if (scan_ready > expire_at && !try_once) {
                /* selection timeout will expire before min heartbeat passes */
                _mongoc_server_selection_error(timeout_msg, &scanner_error, error);
+               timed_out = true;
 
                server_id = 0;
                goto done;
@@ -1295,11 +1447,19 @@ mongoc_topology_select_server_id(mongoc_topology_t *topology,
             if (loop_end > expire_at) {
                /* no time left in server_selection_timeout_msec */
                _mongoc_server_selection_error(timeout_msg, &scanner_error, error);
+               timed_out = true;
 
                server_id = 0;
                goto done;
             }
          }
+
+         /* Wait for the next scan. A scan because the topology is merely
+          * stale is not a wait. */
+         if (waits.started) {
+            _mongoc_ss_wait_end_scan(topology, &waits, false);
+         }
+         _mongoc_ss_wait_begin(topology, &waits);
       }
    }
 
@@ -1356,8 +1516,10 @@ mongoc_topology_select_server_id(mongoc_topology_t *topology,
                                int64("remainingTimeMS", (expire_at - loop_start) / 1000));
       }
       TRACE("server selection about to wait for %" PRId64 "ms", (expire_at - loop_start) / 1000);
+      _mongoc_ss_wait_begin(topology, &waits);
       r = mongoc_cond_timedwait(
          &topology->cond_client, &topology->tpld_modification_mtx, (expire_at - loop_start) / 1000);
+      _mongoc_ss_wait_end(topology, &waits, r);
       TRACE("%s", "server selection awake");
       /* Refresh our topology handle */
       mc_tpld_renew_ref(&td, topology);
@@ -1397,6 +1559,27 @@ mongoc_topology_select_server_id(mongoc_topology_t *topology,
    }
 
 done:
+   if (waits.started) {
+      _mongoc_ss_wait_end_scan(topology, &waits, timed_out);
+   }
+
+   selection_usec = bson_get_monotonic_time() - selection_started;
+   mongoc_histogram_server_selection_wait_record(selection_usec);
+   MONGOC_PROBE3(server_selection_done, optype, server_id, selection_usec);
+
+   if (waits.wakeups > 0) {
+      mongoc_structured_log(log_and_monitor->structured_log,
+                            MONGOC_STRUCTURED_LOG_LEVEL_TRACE,
+                            MONGOC_STRUCTURED_LOG_COMPONENT_SERVER_SELECTION,
+                            "Server selection wait ended",
+                            utf8("operation", log_context->operation),
+                            int64(log_context->has_operation_id ? "operationId" : NULL, log_context->operation_id),
+                            monotonic_time_duration(waits.total_usec),
+                            int32("wakeups", waits.wakeups),
+                            int32("waitingThreads", waits.waiting),
+                            utf8("wokenBy", waits.woken_by));
+   }
+
    /* server_id set to zero indicates an error has occurred and that `error` should be initialized */
    if (server_id == 0) {
       if (error && error->domain == MONGOC_ERROR_SERVER_SELECTION) {
@@ -1758,6 +1941,121 @@ _mongoc_topology_bypass_cooldown(mongoc_topology_t *topology)
    topology->scanner->bypass_cooldown = true;
 }
 
+bool
+_mongoc_topology_connecting_begin(mongoc_topology_t *topology, uint32_t server_id, bson_error_t *error)
+{
+   mongoc_topology_connecting_t *connecting;
+   mongoc_topology_connecting_waiter_t waiter = {0};
+   mlib_timer expires_at = mlib_expires_never();
+
+   BSON_ASSERT_PARAM(topology);
+   BSON_ASSERT(!topology->single_threaded);
+
+   bson_mutex_lock(&topology->connecting_mtx);
+   connecting = mongoc_set_get(topology->connecting, server_id);
+   if (!connecting) {
+      connecting = bson_malloc0(sizeof *connecting);
+      mongoc_set_add(topology->connecting, server_id, connecting);
+   }
+
+   if (!connecting->waiters && connecting->in_progress < topology->max_connecting) {
+      /* fast path: nobody is queued */
+      connecting->in_progress++;
+      bson_mutex_unlock(&topology->connecting_mtx);
+      return true;
+   }
+
+   if (topology->connect_timeout_msec > 0) {
+      expires_at = mlib_expires_after(topology->connect_timeout_msec, ms);
+   }
+
+   DL_APPEND(connecting->waiters, &waiter);
+   mongoc_counter_connections_throttled_inc();
+
+   while (connecting->waiters != &waiter || connecting->in_progress >= topology->max_connecting) {
+      if (topology->connect_timeout_msec <= 0) {
+         mongoc_cond_wait(&topology->connecting_cond, &topology->connecting_mtx);
+         continue;
+      }
+
+      if (mlib_timer_is_expired(expires_at)) {
+         DL_DELETE(connecting->waiters, &waiter);
+         /* the next waiter may now be at the head */
+         mongoc_cond_broadcast(&topology->connecting_cond);
+         bson_mutex_unlock(&topology->connecting_mtx);
+
+         _mongoc_set_error(error,
+                           MONGOC_ERROR_STREAM,
+                           MONGOC_ERROR_STREAM_CONNECT,
+                           "Timed out waiting to connect to server %" PRIu32
+                           ": %" PRId32 " connections (maxConnecting) are already being established",
+                           server_id,
+                           topology->max_connecting);
+         return false;
+      }
+
+      mongoc_cond_timedwait(&topology->connecting_cond,
+                            &topology->connecting_mtx,
+                            mlib_milliseconds_count(mlib_timer_remaining(expires_at)));
+   }
+
+   DL_DELETE(connecting->waiters, &waiter);
+   connecting->in_progress++;
+   /* another slot may be free for the next waiter */
+   mongoc_cond_broadcast(&topology->connecting_cond);
+   bson_mutex_unlock(&topology->connecting_mtx);
+
+   /* If a connection attempt failed while we waited, the server was marked
+    * unknown. Fail now with that error rather than adding to the storm. */
+   {
+      mc_shared_tpld td = mc_tpld_take_ref(topology);
+      const mongoc_server_description_t *sd = mongoc_topology_description_server_by_id_const(td.ptr, server_id, NULL);
+      bool ok = true;
+
+      if (!sd) {
+         _mongoc_set_error(error,
+                           MONGOC_ERROR_STREAM,
+                           MONGOC_ERROR_STREAM_NOT_ESTABLISHED,
+                           "Server %" PRIu32 " was removed while waiting to connect",
+                           server_id);
+         ok = false;
+      } else if (sd->type == MONGOC_SERVER_UNKNOWN && sd->error.code) {
+         if (error) {
+            memcpy(error, &sd->error, sizeof *error);
+         }
+         ok = false;
+      }
+      mc_tpld_drop_ref(&td);
+
+      if (!ok) {
+         _mongoc_topology_connecting_end(topology, server_id);
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void
+_mongoc_topology_connecting_end(mongoc_topology_t *topology, uint32_t server_id)
+{
+   mongoc_topology_connecting_t *connecting;
+
+   BSON_ASSERT_PARAM(topology);
+
+   bson_mutex_lock(&topology->connecting_mtx);
+   connecting = mongoc_set_get(topology->connecting, server_id);
+   BSON_ASSERT(connecting && connecting->in_progress > 0);
+   connecting->in_progress--;
+
+   if (connecting->in_progress == 0 && !connecting->waiters) {
+      mongoc_set_rm(topology->connecting, server_id);
+   } else {
+      mongoc_cond_broadcast(&topology->connecting_cond);
+   }
+   bson_mutex_unlock(&topology->connecting_mtx);
+}
+
 static void
 _find_topology_version(const bson_t *reply, bson_t *topology_version)
 {
@@ -689,9 +689,11 @@ mongoc_uri_option_is_int32(const char *key)
    return mongoc_uri_option_is_int64(key) || !strcasecmp(key, MONGOC_URI_CONNECTTIMEOUTMS) ||
           !strcasecmp(key, MONGOC_URI_HEARTBEATFREQUENCYMS) || !strcasecmp(key, MONGOC_URI_SERVERSELECTIONTIMEOUTMS) ||
           !strcasecmp(key, MONGOC_URI_SOCKETCHECKINTERVALMS) || !strcasecmp(key, MONGOC_URI_SOCKETTIMEOUTMS) ||
-          !strcasecmp(key, MONGOC_URI_LOCALTHRESHOLDMS) || !strcasecmp(key, MONGOC_URI_MAXPOOLSIZE) ||
-          !strcasecmp(key, MONGOC_URI_MAXSTALENESSSECONDS) || !strcasecmp(key, MONGOC_URI_WAITQUEUETIMEOUTMS) ||
-          !strcasecmp(key, MONGOC_URI_ZLIBCOMPRESSIONLEVEL) || !strcasecmp(key, MONGOC_URI_SRVMAXHOSTS);
+          !strcasecmp(key, MONGOC_URI_LOCALTHRESHOLDMS) || !strcasecmp(key, MONGOC_URI_MAXCONNECTING) ||
+          !strcasecmp(key, MONGOC_URI_MAXPOOLSIZE) || !strcasecmp(key, MONGOC_URI_MAXSTALENESSSECONDS) ||
+          !strcasecmp(key, MONGOC_URI_MINPOOLSIZE) || !strcasecmp(key, MONGOC_URI_WAITQUEUETIMEOUTMS) ||
+          !strcasecmp(key, MONGOC_URI_ZLIBCOMPRESSIONLEVEL) || !strcasecmp(key, MONGOC_URI_SRVMAXHOSTS) ||
+          !strcasecmp(key, MONGOC_URI_ZEROCOPYTHRESHOLDBYTES);
 }
 
 bool
@@ -717,7 +719,10 @@ mongoc_uri_option_is_bool(const char *key)
           !strcasecmp(key, MONGOC_URI_TLSALLOWINVALIDCERTIFICATES) ||
           !strcasecmp(key, MONGOC_URI_TLSALLOWINVALIDHOSTNAMES) ||
           !strcasecmp(key, MONGOC_URI_TLSDISABLECERTIFICATEREVOCATIONCHECK) ||
-          !strcasecmp(key, MONGOC_URI_TLSDISABLEOCSPENDPOINTCHECK) || !strcasecmp(key, MONGOC_URI_LOADBALANCED) ||
+          !strcasecmp(key, MONGOC_URI_TLSDISABLEOCSPENDPOINTCHECK) ||
+          !strcasecmp(key, MONGOC_URI_TLSDISABLESESSIONRESUMPTION) || !strcasecmp(key, MONGOC_URI_TLSENABLEKTLS) ||
+          !strcasecmp(key, MONGOC_URI_LOADBALANCED) || !strcasecmp(key, MONGOC_URI_MULTIPLEXEDMONITORING) ||
+          !strcasecmp(key, MONGOC_URI_USEIOURING) ||
           /* deprecated options with canonical equivalents */
           !strcasecmp(key, MONGOC_URI_SSL) || !strcasecmp(key, MONGOC_URI_SSLALLOWINVALIDCERTIFICATES) ||
           !strcasecmp(key, MONGOC_URI_SSLALLOWINVALIDHOSTNAMES);
@@ -2803,7 +2808,9 @@ mongoc_uri_get_tls(const mongoc_uri_t *uri) /* IN */
        bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSINSECURE) ||
        bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSCERTIFICATEKEYFILEPASSWORD) ||
        bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSDISABLEOCSPENDPOINTCHECK) ||
-       bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSDISABLECERTIFICATEREVOCATIONCHECK)) {
+       bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSDISABLECERTIFICATEREVOCATIONCHECK) ||
+       bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSDISABLESESSIONRESUMPTION) ||
+       bson_iter_init_find_case(&iter, &uri->options, MONGOC_URI_TLSENABLEKTLS)) {
       return true;
    }
 
@@ -2979,6 +2986,17 @@ _mongoc_uri_set_option_as_int32_with_error(mongoc_uri_t *uri,
       return false;
    }
 
+   /* Connection Pool Spec: maxConnecting must be a positive integer. */
+   if (!bson_strcasecmp(option, MONGOC_URI_MAXCONNECTING) && value < 1) {
+      MONGOC_URI_ERROR(error, "Invalid \"%s\" of %d: must be at least 1", option_orig, value);
+      return false;
+   }
+
+   if (!bson_strcasecmp(option, MONGOC_URI_ZEROCOPYTHRESHOLDBYTES) && value < 0) {
+      MONGOC_URI_ERROR(error, "Invalid \"%s\" of %d: must be non-negative", option_orig, value);
+      return false;
+   }
+
    /* zlib levels are from -1 (default) through 9 (best compression) */
    if (!bson_strcasecmp(option, MONGOC_URI_ZLIBCOMPRESSIONLEVEL) && (value < -1 || value > 9)) {
       MONGOC_URI_ERROR(error, "Invalid \"%s\" of %d: must be between -1 and 9", option_orig, value);
@@ -46,8 +46,11 @@
 #define MONGOC_URI_JOURNAL "journal"
 #define MONGOC_URI_LOADBALANCED "loadbalanced"
 #define MONGOC_URI_LOCALTHRESHOLDMS "localthresholdms"
+#define MONGOC_URI_MAXCONNECTING "maxconnecting"
 #define MONGOC_URI_MAXPOOLSIZE "maxpoolsize"
 #define MONGOC_URI_MAXSTALENESSSECONDS "maxstalenessseconds"
+#define MONGOC_URI_MINPOOLSIZE "minpoolsize"
+#define MONGOC_URI_MULTIPLEXEDMONITORING "multiplexedmonitoring"
 #define MONGOC_URI_READCONCERNLEVEL "readconcernlevel"
 #define MONGOC_URI_READPREFERENCE "readpreference"
 #define MONGOC_URI_READPREFERENCETAGS "readpreferencetags"
@@ -71,9 +74,13 @@
 #define MONGOC_URI_TLSINSECURE "tlsinsecure"
 #define MONGOC_URI_TLSDISABLECERTIFICATEREVOCATIONCHECK "tlsdisablecertificaterevocationcheck"
 #define MONGOC_URI_TLSDISABLEOCSPENDPOINTCHECK "tlsdisableocspendpointcheck"
+#define MONGOC_URI_TLSDISABLESESSIONRESUMPTION "tlsdisablesessionresumption"
+#define MONGOC_URI_TLSENABLEKTLS "tlsenablektls"
+#define MONGOC_URI_USEIOURING "useiouring"
 #define MONGOC_URI_W "w"
 #define MONGOC_URI_WAITQUEUETIMEOUTMS "waitqueuetimeoutms"
 #define MONGOC_URI_WTIMEOUTMS "wtimeoutms"
+#define MONGOC_URI_ZEROCOPYTHRESHOLDBYTES "zerocopythresholdbytes"
 #define MONGOC_URI_ZLIBCOMPRESSIONLEVEL "zlibcompressionlevel"
 
 /* Deprecated in MongoDB 4.2, use "tls" variants instead. */
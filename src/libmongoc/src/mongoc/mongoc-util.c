@@ -24,6 +24,7 @@
 #include <mongoc/mongoc-client-private.h> // WIRE_VERSION_* macros.
 #include <mongoc/mongoc-client-session-private.h>
 #include <mongoc/mongoc-error-private.h>
+#include <mongoc/mongoc-probes-private.h>
 #include <mongoc/mongoc-rand-private.h>
 #include <mongoc/mongoc-trace-private.h>
 #include <mongoc/mongoc-util-private.h>
@@ -320,6 +321,20 @@ _mongoc_wire_version_to_server_version(int32_t version)
 }
 
 
+/* bson_validate_with_error, between the bson_validate_start and bson_validate_done probes. */
+static bool
+_mongoc_bson_validate(const bson_t *doc, bson_validate_flags_t vflags, bson_error_t *error)
+{
+   bool ok;
+
+   MONGOC_PROBE2(bson_validate_start, doc->len, vflags);
+   ok = bson_validate_with_error(doc, vflags, error);
+   MONGOC_PROBE2(bson_validate_done, doc->len, ok);
+
+   return ok;
+}
+
+
 bool
 _mongoc_validate_new_document(const bson_t *doc, bson_validate_flags_t vflags, bson_error_t *error)
 {
@@ -329,7 +344,7 @@ _mongoc_validate_new_document(const bson_t *doc, bson_validate_flags_t vflags, b
       return true;
    }
 
-   if (!bson_validate_with_error(doc, vflags, &validate_err)) {
+   if (!_mongoc_bson_validate(doc, vflags, &validate_err)) {
       _mongoc_set_error(error,
                         MONGOC_ERROR_COMMAND,
                         MONGOC_ERROR_COMMAND_INVALID_ARG,
@@ -353,7 +368,7 @@ _mongoc_validate_replace(const bson_t *doc, bson_validate_flags_t vflags, bson_e
       return true;
    }
 
-   if (!bson_validate_with_error(doc, vflags, &validate_err)) {
+   if (!_mongoc_bson_validate(doc, vflags, &validate_err)) {
       _mongoc_set_error(error,
                         MONGOC_ERROR_COMMAND,
                         MONGOC_ERROR_COMMAND_INVALID_ARG,
@@ -395,7 +410,7 @@ _mongoc_validate_update(const bson_t *update, bson_validate_flags_t vflags, bson
       return true;
    }
 
-   if (!bson_validate_with_error(update, vflags, &validate_err)) {
+   if (!_mongoc_bson_validate(update, vflags, &validate_err)) {
       _mongoc_set_error(error,
                         MONGOC_ERROR_COMMAND,
                         MONGOC_ERROR_COMMAND_INVALID_ARG,
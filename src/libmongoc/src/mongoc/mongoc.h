@@ -22,6 +22,7 @@
 #include <bson/bson.h>
 
 #define MONGOC_INSIDE
+#include <mongoc/mongoc-alloc-stats.h>
 #include <mongoc/mongoc-apm.h>
 #include <mongoc/mongoc-bulk-operation.h>
 #include <mongoc/mongoc-bulkwrite.h>
@@ -47,12 +48,14 @@
 #include <mongoc/mongoc-log.h>
 #include <mongoc/mongoc-macros.h>
 #include <mongoc/mongoc-opcode.h>
+#include <mongoc/mongoc-server-wire-stats.h>
 #include <mongoc/mongoc-sleep.h>
 #include <mongoc/mongoc-socket.h>
 #include <mongoc/mongoc-stream-buffered.h>
 #include <mongoc/mongoc-stream-file.h>
 #include <mongoc/mongoc-stream-gridfs.h>
 #include <mongoc/mongoc-stream-socket.h>
+#include <mongoc/mongoc-stream-uring.h>
 #include <mongoc/mongoc-stream.h>
 #include <mongoc/mongoc-structured-log.h>
 #include <mongoc/mongoc-uri.h>
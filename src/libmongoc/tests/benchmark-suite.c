@@ -0,0 +1,1788 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Micro- and macro-benchmarks for libbson and libmongoc, with results written as one JSON document so they can be
+ * compared across commits.
+ *
+ * The libbson benchmarks encode, decode, validate, and round-trip through extended JSON the "flat", "deep", and
+ * "full" documents. By default these are generated with a fixed seed in the shape of the driver benchmarking
+ * specification's corpora. Pass --data-dir to load flat_bson.json, deep_bson.json, and full_bson.json from the
+ * specification's data set instead.
+ *
+ * The driver benchmarks cover small inserts, bulk inserts, find-many with getMore, GridFS upload and download, and
+ * pooled clients contending for connections. By default they run against the in-tree mock server, so they measure
+ * client-side cost plus the mock server's own per-message overhead. Pass --uri to run them against a local mongod;
+ * they use (and drop) the "perftest" database.
+ *
+ * The overhead benchmarks measure libmongoc's own cost per operation: inserts, finds with getMore, and client bulk
+ * writes against a mock server in blackhole mode, which answers them with canned replies at line rate and without
+ * allocating. They always use the mock server, even with --uri.
+ *
+ * The stream benchmarks compare request/reply round trips over loopback through the poll-based socket stream and
+ * the io_uring stream. The io_uring benchmark is skipped when io_uring is unavailable.
+ *
+ * Besides wall-clock time, results report the CPU time of the benchmark's thread per operation where the work runs
+ * on that thread, and allocations through bson_malloc and friends per operation where no other thread allocates
+ * meanwhile, which holds for the libbson and overhead benchmarks.
+ *
+ * TO BUILD: % cmake --build cmake-build --target benchmark-suite
+ * TO RUN: % ./cmake-build/src/libmongoc/benchmark-suite [options]
+ * Or: % cmake --build cmake-build --target benchmark
+ * which writes the results to cmake-build/benchmark-results.json.
+ *
+ * Options:
+ *   --uri URI            Run the driver benchmarks against URI instead of the mock server.
+ *   --data-dir DIR       Load the BSON corpora from DIR.
+ *   --filter SUBSTRING   Only run benchmarks whose name contains SUBSTRING.
+ *   --min-time-ms N      Run each benchmark for at least N milliseconds (default 1000).
+ *   --min-iterations N   Run each benchmark at least N times (default 10).
+ *   --max-iterations N   Run each benchmark at most N times (default 100000).
+ *   --label LABEL        Record LABEL, e.g. a commit hash, in the results.
+ *   --output FILE        Write the results to FILE instead of stdout.
+ *   --list               Print the benchmark names and exit.
+ */
+
+#include <common-atomic-private.h>
+#include <common-thread-private.h>
+#include <mongoc/mongoc-client-private.h> // WIRE_VERSION_MAX
+
+#include <mongoc/mongoc.h>
+
+#include <bson/bson.h>
+
+#include <mlib/time_point.h>
+
+#include <TestSuite.h>
+#include <mock_server/mock-server.h>
+#include <test-libmongoc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+#define BENCH_DB "perftest"
+#define BENCH_COLL "corpus"
+#define BENCH_NS BENCH_DB "." BENCH_COLL
+
+#define BENCH_FIND_DOCS 10000
+#define BENCH_FIND_BATCH 1000
+#define BENCH_GRIDFS_CHUNK_SIZE (255 * 1024)
+#define BENCH_GRIDFS_CHUNKS 16
+#define BENCH_POOL_THREADS 8
+#define BENCH_POOL_SIZE 2
+#define BENCH_POOL_OPS 100
+#define BENCH_STREAM_MESSAGE_SIZE (16 * 1024)
+#define BENCH_STREAM_TIMEOUT_MS 10000
+#define BENCH_OVERHEAD_BATCH 100
+
+
+typedef struct _bench_t bench_t;
+
+struct _bench_t {
+   const char *name;
+   /* Optional. Runs once before the first iteration and may set "bytes". */
+   bool (*setup)(bench_t *bench);
+   /* One timed iteration, which performs "ops" operations. */
+   bool (*task)(bench_t *bench);
+   /* Optional. Runs once after the last iteration, even if setup failed. */
+   void (*teardown)(bench_t *bench);
+   const bson_t *corpus;
+   int64_t ops;
+   int64_t bytes;
+   /* Report CPU time per operation: the timed work runs on the calling thread. */
+   bool count_cpu;
+   /* Report allocations per operation: no other thread allocates while it runs. */
+   bool count_allocs;
+   /* Set by setup to report the benchmark as skipped rather than failed. */
+   bool skipped;
+   bson_error_t error;
+};
+
+
+static struct {
+   const char *uri;
+   const char *data_dir;
+   const char *filter;
+   const char *label;
+   const char *output;
+   int64_t min_time_ms;
+   int64_t min_iterations;
+   int64_t max_iterations;
+   bool list;
+} opts = {.min_time_ms = 1000, .min_iterations = 10, .max_iterations = 100000};
+
+
+static bson_t corpus_flat;
+static bson_t corpus_deep;
+static bson_t corpus_full;
+static bson_t small_doc;
+
+/* Keeps the compiler from discarding the results of the decode benchmarks. */
+static volatile uint64_t bench_sink;
+
+
+/* Every allocation through bson_malloc, bson_malloc0, bson_realloc, or bson_aligned_alloc, in any thread. */
+static int64_t bench_allocs;
+
+static void *
+_bench_malloc(size_t num_bytes)
+{
+   mcommon_atomic_int64_fetch_add(&bench_allocs, 1, mcommon_memory_order_relaxed);
+   return malloc(num_bytes);
+}
+
+static void *
+_bench_calloc(size_t n_members, size_t num_bytes)
+{
+   mcommon_atomic_int64_fetch_add(&bench_allocs, 1, mcommon_memory_order_relaxed);
+   return calloc(n_members, num_bytes);
+}
+
+static void *
+_bench_realloc(void *mem, size_t num_bytes)
+{
+   mcommon_atomic_int64_fetch_add(&bench_allocs, 1, mcommon_memory_order_relaxed);
+   return realloc(mem, num_bytes);
+}
+
+static const bson_mem_vtable_t bench_mem_vtable = {
+   .malloc = _bench_malloc,
+   .calloc = _bench_calloc,
+   .realloc = _bench_realloc,
+   .free = free,
+};
+
+
+/* CPU time consumed by the calling thread in nanoseconds, or -1 if the platform can't tell. */
+static int64_t
+_bench_thread_cpu_ns(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+   struct timespec ts;
+
+   if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+      return (int64_t)ts.tv_sec * 1000000000 + (int64_t)ts.tv_nsec;
+   }
+#endif
+
+   return -1;
+}
+
+
+/* xorshift32 with a fixed seed, so the generated documents are identical across runs and platforms. */
+static uint32_t bench_rand_state = 2463534242u;
+
+static uint32_t
+_bench_rand(void)
+{
+   bench_rand_state ^= bench_rand_state << 13;
+   bench_rand_state ^= bench_rand_state >> 17;
+   bench_rand_state ^= bench_rand_state << 5;
+   return bench_rand_state;
+}
+
+
+static void
+_bench_rand_string(char *buf, size_t len)
+{
+   static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ";
+
+   for (size_t i = 0u; i < len; i++) {
+      buf[i] = alphabet[_bench_rand() % (sizeof alphabet - 1u)];
+   }
+
+   buf[len] = '\0';
+}
+
+
+static void
+_bench_rand_bytes(uint8_t *buf, size_t len)
+{
+   for (size_t i = 0u; i < len; i++) {
+      buf[i] = (uint8_t)(_bench_rand() & 0xffu);
+   }
+}
+
+
+/*--------------------------------------------------------------------------
+ *
+ * BSON corpora
+ *
+ *--------------------------------------------------------------------------
+ */
+
+/* Many top-level scalar fields, like flat_bson.json. */
+static void
+_corpus_flat(bson_t *doc, uint32_t target_len)
+{
+   char key[16];
+   char str[64];
+
+   bson_init(doc);
+
+   for (uint32_t i = 0u; doc->len < target_len; i++) {
+      bson_snprintf(key, sizeof key, "field%04" PRIu32, i);
+
+      switch (i % 5u) {
+      case 0u:
+         _bench_rand_string(str, 8u + _bench_rand() % 40u);
+         BSON_ASSERT(BSON_APPEND_UTF8(doc, key, str));
+         break;
+      case 1u:
+         BSON_ASSERT(BSON_APPEND_INT32(doc, key, (int32_t)(_bench_rand() % 100000u)));
+         break;
+      case 2u:
+         BSON_ASSERT(BSON_APPEND_INT64(doc, key, (int64_t)_bench_rand() << 20));
+         break;
+      case 3u:
+         BSON_ASSERT(BSON_APPEND_DOUBLE(doc, key, (double)_bench_rand() / 1000.0));
+         break;
+      default:
+         BSON_ASSERT(BSON_APPEND_BOOL(doc, key, (_bench_rand() & 1u) != 0u));
+         break;
+      }
+   }
+}
+
+
+/* A binary tree of small subdocuments, like deep_bson.json. */
+static void
+_corpus_deep_node(bson_t *parent, const char *key, int depth)
+{
+   bson_t child;
+   char str[17];
+
+   BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(parent, key, &child));
+
+   _bench_rand_string(str, 16u);
+   BSON_ASSERT(BSON_APPEND_UTF8(&child, "name", str));
+   BSON_ASSERT(BSON_APPEND_INT32(&child, "value", (int32_t)(_bench_rand() % 100000u)));
+
+   if (depth > 0) {
+      _corpus_deep_node(&child, "left", depth - 1);
+      _corpus_deep_node(&child, "right", depth - 1);
+   }
+
+   BSON_ASSERT(bson_append_document_end(parent, &child));
+}
+
+
+static void
+_corpus_deep(bson_t *doc)
+{
+   bson_init(doc);
+   _corpus_deep_node(doc, "root", 8);
+}
+
+
+/* An array of records that each hold one of every non-deprecated BSON type, like full_bson.json. */
+static void
+_corpus_full(bson_t *doc)
+{
+   bson_t records;
+   bson_t record;
+   bson_t child;
+   char buf[16];
+   const char *key;
+   char str[33];
+   uint8_t bytes[32];
+   bson_oid_t oid;
+   bson_decimal128_t decimal;
+
+   bson_init(doc);
+   BSON_ASSERT(BSON_APPEND_ARRAY_BEGIN(doc, "records", &records));
+
+   for (uint32_t i = 0u; i < 150u; i++) {
+      bson_uint32_to_string(i, &key, buf, sizeof buf);
+      BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(&records, key, &record));
+
+      _bench_rand_bytes(bytes, 12u);
+      bson_oid_init_from_data(&oid, bytes);
+      BSON_ASSERT(BSON_APPEND_OID(&record, "_id", &oid));
+
+      _bench_rand_string(str, 32u);
+      BSON_ASSERT(BSON_APPEND_UTF8(&record, "string", str));
+      BSON_ASSERT(BSON_APPEND_INT32(&record, "int32", (int32_t)(_bench_rand() % 100000u)));
+      BSON_ASSERT(BSON_APPEND_INT64(&record, "int64", (int64_t)_bench_rand() << 20));
+      BSON_ASSERT(BSON_APPEND_DOUBLE(&record, "double", (double)_bench_rand() / 1000.0));
+
+      bson_snprintf(str, sizeof str, "%" PRIu32 ".%04" PRIu32, _bench_rand() % 100000u, _bench_rand() % 10000u);
+      BSON_ASSERT(bson_decimal128_from_string(str, &decimal));
+      BSON_ASSERT(BSON_APPEND_DECIMAL128(&record, "decimal128", &decimal));
+
+      BSON_ASSERT(BSON_APPEND_BOOL(&record, "bool", (_bench_rand() & 1u) != 0u));
+      BSON_ASSERT(BSON_APPEND_NULL(&record, "null"));
+      BSON_ASSERT(BSON_APPEND_DATE_TIME(&record, "date", 1500000000000 + (int64_t)_bench_rand()));
+      BSON_ASSERT(BSON_APPEND_TIMESTAMP(&record, "timestamp", _bench_rand(), i));
+      BSON_ASSERT(BSON_APPEND_REGEX(&record, "regex", "^abc[0-9]+$", "i"));
+
+      _bench_rand_bytes(bytes, sizeof bytes);
+      BSON_ASSERT(BSON_APPEND_BINARY(&record, "binary", BSON_SUBTYPE_BINARY, bytes, (uint32_t)sizeof bytes));
+
+      BSON_ASSERT(BSON_APPEND_CODE(&record, "code", "function () { return 1; }"));
+      bson_init(&child);
+      BSON_ASSERT(BSON_APPEND_INT32(&child, "x", (int32_t)i));
+      BSON_ASSERT(BSON_APPEND_CODE_WITH_SCOPE(&record, "code_w_scope", "function () { return x; }", &child));
+      bson_destroy(&child);
+
+      BSON_ASSERT(BSON_APPEND_MINKEY(&record, "minkey"));
+      BSON_ASSERT(BSON_APPEND_MAXKEY(&record, "maxkey"));
+
+      BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(&record, "document", &child));
+      _bench_rand_string(str, 16u);
+      BSON_ASSERT(BSON_APPEND_UTF8(&child, "a", str));
+      BSON_ASSERT(BSON_APPEND_INT32(&child, "b", (int32_t)i));
+      BSON_ASSERT(bson_append_document_end(&record, &child));
+
+      BSON_ASSERT(BSON_APPEND_ARRAY_BEGIN(&record, "array", &child));
+      for (uint32_t j = 0u; j < 5u; j++) {
+         bson_uint32_to_string(j, &key, buf, sizeof buf);
+         BSON_ASSERT(BSON_APPEND_INT32(&child, key, (int32_t)(_bench_rand() % 1000u)));
+      }
+      BSON_ASSERT(bson_append_array_end(&record, &child));
+
+      BSON_ASSERT(bson_append_document_end(&records, &record));
+   }
+
+   BSON_ASSERT(bson_append_array_end(doc, &records));
+}
+
+
+static bool
+_corpus_load(bson_t *doc, const char *file_name, bson_error_t *error)
+{
+   char *const path = bson_strdup_printf("%s/%s", opts.data_dir, file_name);
+   bson_json_reader_t *const reader = bson_json_reader_new_from_file(path, error);
+   bool ret = false;
+
+   bson_init(doc);
+
+   if (reader) {
+      const int r = bson_json_reader_read(reader, doc, error);
+
+      if (r == 0) {
+         bson_set_error(error, BSON_ERROR_JSON, BSON_JSON_ERROR_READ_INVALID_PARAM, "%s contains no document", path);
+      }
+
+      ret = r == 1;
+      bson_json_reader_destroy(reader);
+   }
+
+   bson_free(path);
+   return ret;
+}
+
+
+static bool
+_corpora_init(bson_error_t *error)
+{
+   /* About the size of the specification's small_doc.json. */
+   _corpus_flat(&small_doc, 250u);
+
+   if (opts.data_dir) {
+      return _corpus_load(&corpus_flat, "flat_bson.json", error) &&
+             _corpus_load(&corpus_deep, "deep_bson.json", error) &&
+             _corpus_load(&corpus_full, "full_bson.json", error);
+   }
+
+   _corpus_flat(&corpus_flat, 75u * 1000u);
+   _corpus_deep(&corpus_deep);
+   _corpus_full(&corpus_full);
+
+   return true;
+}
+
+
+static void
+_corpora_cleanup(void)
+{
+   bson_destroy(&small_doc);
+   bson_destroy(&corpus_flat);
+   bson_destroy(&corpus_deep);
+   bson_destroy(&corpus_full);
+}
+
+
+/*--------------------------------------------------------------------------
+ *
+ * libbson benchmarks
+ *
+ *--------------------------------------------------------------------------
+ */
+
+static bool
+_bench_bson_setup(bench_t *bench)
+{
+   bench->bytes = bench->ops * (int64_t)bench->corpus->len;
+   return true;
+}
+
+
+/* Rebuild a document element by element, descending into subdocuments and arrays. */
+static void
+_bench_encode_document(bson_t *dst, const bson_t *src)
+{
+   bson_iter_t iter;
+
+   BSON_ASSERT(bson_iter_init(&iter, src));
+
+   while (bson_iter_next(&iter)) {
+      const char *const key = bson_iter_key(&iter);
+      const int key_len = (int)bson_iter_key_len(&iter);
+
+      if (BSON_ITER_HOLDS_DOCUMENT(&iter) || BSON_ITER_HOLDS_ARRAY(&iter)) {
+         const bool is_array = BSON_ITER_HOLDS_ARRAY(&iter);
+         const uint8_t *data;
+         uint32_t len;
+         bson_t src_child;
+         bson_t dst_child;
+
+         if (is_array) {
+            bson_iter_array(&iter, &len, &data);
+            BSON_ASSERT(bson_append_array_begin(dst, key, key_len, &dst_child));
+         } else {
+            bson_iter_document(&iter, &len, &data);
+            BSON_ASSERT(bson_append_document_begin(dst, key, key_len, &dst_child));
+         }
+
+         BSON_ASSERT(bson_init_static(&src_child, data, len));
+         _bench_encode_document(&dst_child, &src_child);
+
+         if (is_array) {
+            BSON_ASSERT(bson_append_array_end(dst, &dst_child));
+         } else {
+            BSON_ASSERT(bson_append_document_end(dst, &dst_child));
+         }
+      } else {
+         BSON_ASSERT(bson_append_value(dst, key, key_len, bson_iter_value(&iter)));
+      }
+   }
+}
+
+
+static bool
+_bench_bson_encode(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      bson_t doc = BSON_INITIALIZER;
+
+      _bench_encode_document(&doc, bench->corpus);
+      BSON_ASSERT(doc.len == bench->corpus->len);
+      bson_destroy(&doc);
+   }
+
+   return true;
+}
+
+
+/* Read every value in a document, descending into subdocuments and arrays. */
+static uint64_t
+_bench_decode_document(bson_iter_t *iter)
+{
+   uint64_t sum = 0u;
+
+   while (bson_iter_next(iter)) {
+      const bson_value_t *const value = bson_iter_value(iter);
+
+      sum += (uint64_t)value->value_type;
+
+      if (value->value_type == BSON_TYPE_UTF8) {
+         sum += value->value.v_utf8.len;
+      } else if (value->value_type == BSON_TYPE_DOCUMENT || value->value_type == BSON_TYPE_ARRAY) {
+         bson_iter_t child;
+
+         BSON_ASSERT(bson_iter_recurse(iter, &child));
+         sum += _bench_decode_document(&child);
+      }
+   }
+
+   return sum;
+}
+
+
+static bool
+_bench_bson_decode(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      bson_iter_t iter;
+
+      BSON_ASSERT(bson_iter_init(&iter, bench->corpus));
+      bench_sink += _bench_decode_document(&iter);
+   }
+
+   return true;
+}
+
+
+static bool
+_bench_bson_validate(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      if (!bson_validate_with_error(bench->corpus, BSON_VALIDATE_UTF8 | BSON_VALIDATE_EMPTY_KEYS, &bench->error)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+
+static bool
+_bench_bson_json(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      size_t len;
+      char *const json = bson_as_canonical_extended_json(bench->corpus, &len);
+      bson_t doc;
+      const bool ok = bson_init_from_json(&doc, json, (ssize_t)len, &bench->error);
+
+      bson_free(json);
+
+      if (!ok) {
+         return false;
+      }
+
+      bson_destroy(&doc);
+   }
+
+   return true;
+}
+
+
+/*--------------------------------------------------------------------------
+ *
+ * Driver benchmarks
+ *
+ *--------------------------------------------------------------------------
+ */
+
+static struct {
+   mongoc_uri_t *uri;
+   /* NULL when running against --uri. */
+   mock_server_t *server;
+
+   mongoc_client_t *client;
+   mongoc_client_pool_t *pool;
+   mongoc_collection_t *collection;
+   mongoc_gridfs_bucket_t *bucket;
+   const bson_t **docs;
+   uint8_t *file_data;
+   uint8_t *read_buf;
+   bson_value_t file_id;
+
+   /* Canned mock server replies, built once. */
+   bson_t ok_reply;
+   bson_t empty_cursor_reply;
+   bson_t find_reply;
+   bson_t getmore_reply;
+   bson_t getmore_last_reply;
+   bson_t files_reply;
+   bson_t chunks_reply;
+   /* Only the single-threaded find-many benchmark issues getMores, so this needs no lock. */
+   int getmores_left;
+} driver;
+
+
+static void
+_mock_cursor_begin(bson_t *reply, bson_t *cursor, bson_t *batch, const char *ns, const char *batch_name, int64_t id)
+{
+   bson_init(reply);
+   BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(reply, "cursor", cursor));
+   BSON_ASSERT(BSON_APPEND_INT64(cursor, "id", id));
+   BSON_ASSERT(BSON_APPEND_UTF8(cursor, "ns", ns));
+   BSON_ASSERT(BSON_APPEND_ARRAY_BEGIN(cursor, batch_name, batch));
+}
+
+
+static void
+_mock_cursor_end(bson_t *reply, bson_t *cursor, bson_t *batch)
+{
+   BSON_ASSERT(bson_append_array_end(cursor, batch));
+   BSON_ASSERT(bson_append_document_end(reply, cursor));
+   BSON_ASSERT(BSON_APPEND_INT32(reply, "ok", 1));
+}
+
+
+static void
+_mock_cursor_reply(bson_t *reply, const char *batch_name, int64_t id, const bson_t *doc, uint32_t n)
+{
+   bson_t cursor;
+   bson_t batch;
+   char buf[16];
+   const char *key;
+
+   _mock_cursor_begin(reply, &cursor, &batch, BENCH_NS, batch_name, id);
+
+   for (uint32_t i = 0u; i < n; i++) {
+      bson_uint32_to_string(i, &key, buf, sizeof buf);
+      BSON_ASSERT(BSON_APPEND_DOCUMENT(&batch, key, doc));
+   }
+
+   _mock_cursor_end(reply, &cursor, &batch);
+}
+
+
+/* The GridFS file every download benchmark reads: the mock server serves it, or setup uploads it to mongod. */
+static void
+_mock_gridfs_replies_init(void)
+{
+   const size_t file_len = (size_t)BENCH_GRIDFS_CHUNK_SIZE * BENCH_GRIDFS_CHUNKS;
+   bson_t cursor;
+   bson_t batch;
+   bson_t doc;
+   bson_oid_t oid;
+   char buf[16];
+   const char *key;
+
+   _mock_cursor_begin(&driver.files_reply, &cursor, &batch, BENCH_DB ".fs.files", "firstBatch", 0);
+   BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(&batch, "0", &doc));
+   BSON_ASSERT(BSON_APPEND_VALUE(&doc, "_id", &driver.file_id));
+   BSON_ASSERT(BSON_APPEND_INT64(&doc, "length", (int64_t)file_len));
+   BSON_ASSERT(BSON_APPEND_INT32(&doc, "chunkSize", BENCH_GRIDFS_CHUNK_SIZE));
+   BSON_ASSERT(BSON_APPEND_DATE_TIME(&doc, "uploadDate", 1500000000000));
+   BSON_ASSERT(BSON_APPEND_UTF8(&doc, "filename", "benchmark"));
+   BSON_ASSERT(bson_append_document_end(&batch, &doc));
+   _mock_cursor_end(&driver.files_reply, &cursor, &batch);
+
+   _mock_cursor_begin(&driver.chunks_reply, &cursor, &batch, BENCH_DB ".fs.chunks", "firstBatch", 0);
+   for (uint32_t i = 0u; i < BENCH_GRIDFS_CHUNKS; i++) {
+      bson_uint32_to_string(i, &key, buf, sizeof buf);
+      BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(&batch, key, &doc));
+      bson_oid_init(&oid, NULL);
+      BSON_ASSERT(BSON_APPEND_OID(&doc, "_id", &oid));
+      BSON_ASSERT(BSON_APPEND_VALUE(&doc, "files_id", &driver.file_id));
+      BSON_ASSERT(BSON_APPEND_INT32(&doc, "n", (int32_t)i));
+      BSON_ASSERT(BSON_APPEND_BINARY(&doc,
+                                     "data",
+                                     BSON_SUBTYPE_BINARY,
+                                     driver.file_data + (size_t)i * BENCH_GRIDFS_CHUNK_SIZE,
+                                     BENCH_GRIDFS_CHUNK_SIZE));
+      BSON_ASSERT(bson_append_document_end(&batch, &doc));
+   }
+   _mock_cursor_end(&driver.chunks_reply, &cursor, &batch);
+}
+
+
+static bool
+_mock_autoresponder(request_t *request, void *data)
+{
+   const bson_t *reply = &driver.ok_reply;
+   bson_t insert_reply = BSON_INITIALIZER;
+   bson_iter_t iter;
+
+   BSON_UNUSED(data);
+
+   if (!request->is_command || !request->command_name) {
+      return false;
+   }
+
+   const char *const name = request->command_name;
+
+   if (0 == bson_strcasecmp(name, "hello") || 0 == bson_strcasecmp(name, "ismaster")) {
+      /* Left to the mock server's auto hello responder. */
+      return false;
+   }
+
+   if (0 == strcmp(name, "insert")) {
+      /* The first document is the command body, the rest are its "documents" payload. */
+      BSON_ASSERT(BSON_APPEND_INT32(&insert_reply, "n", (int32_t)(request->docs.len - 1u)));
+      BSON_ASSERT(BSON_APPEND_INT32(&insert_reply, "ok", 1));
+      reply = &insert_reply;
+   } else if (0 == strcmp(name, "find")) {
+      BSON_ASSERT(bson_iter_init_find(&iter, request_get_doc(request, 0), "find"));
+
+      if (0 == strcmp(bson_iter_utf8(&iter, NULL), "fs.files")) {
+         /* Also answers the upload's index check: a non-empty files collection skips creating indexes. */
+         reply = &driver.files_reply;
+      } else if (0 == strcmp(bson_iter_utf8(&iter, NULL), "fs.chunks")) {
+         reply = &driver.chunks_reply;
+      } else {
+         driver.getmores_left = BENCH_FIND_DOCS / BENCH_FIND_BATCH - 1;
+         reply = &driver.find_reply;
+      }
+   } else if (0 == strcmp(name, "getMore")) {
+      reply = --driver.getmores_left > 0 ? &driver.getmore_reply : &driver.getmore_last_reply;
+   } else if (0 == strcmp(name, "listIndexes")) {
+      reply = &driver.empty_cursor_reply;
+   }
+
+   reply_to_op_msg_request(request, MONGOC_MSG_NONE, reply);
+   request_destroy(request);
+   bson_destroy(&insert_reply);
+
+   return true;
+}
+
+
+static bool
+_driver_init(bson_error_t *error)
+{
+   const size_t file_len = (size_t)BENCH_GRIDFS_CHUNK_SIZE * BENCH_GRIDFS_CHUNKS;
+
+   driver.file_data = bson_malloc(file_len);
+   driver.read_buf = bson_malloc(file_len);
+   _bench_rand_bytes(driver.file_data, file_len);
+
+   if (opts.uri) {
+      driver.uri = mongoc_uri_new_with_error(opts.uri, error);
+      return driver.uri != NULL;
+   }
+
+   driver.file_id.value_type = BSON_TYPE_OID;
+   bson_oid_init_from_string(&driver.file_id.value.v_oid, "000000000000000000000001");
+
+   bson_init(&driver.ok_reply);
+   BSON_ASSERT(BSON_APPEND_INT32(&driver.ok_reply, "ok", 1));
+   _mock_cursor_reply(&driver.empty_cursor_reply, "firstBatch", 0, NULL, 0u);
+   _mock_cursor_reply(&driver.find_reply, "firstBatch", 42, &small_doc, BENCH_FIND_BATCH);
+   _mock_cursor_reply(&driver.getmore_reply, "nextBatch", 42, &small_doc, BENCH_FIND_BATCH);
+   _mock_cursor_reply(&driver.getmore_last_reply, "nextBatch", 0, &small_doc, BENCH_FIND_BATCH);
+   _mock_gridfs_replies_init();
+
+   driver.server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_autoresponds(driver.server, _mock_autoresponder, NULL, NULL);
+   mock_server_run(driver.server);
+   driver.uri = mongoc_uri_copy(mock_server_get_uri(driver.server));
+
+   return true;
+}
+
+
+static void
+_driver_cleanup(void)
+{
+   if (driver.server) {
+      mock_server_destroy(driver.server);
+      bson_destroy(&driver.ok_reply);
+      bson_destroy(&driver.empty_cursor_reply);
+      bson_destroy(&driver.find_reply);
+      bson_destroy(&driver.getmore_reply);
+      bson_destroy(&driver.getmore_last_reply);
+      bson_destroy(&driver.files_reply);
+      bson_destroy(&driver.chunks_reply);
+   }
+
+   mongoc_uri_destroy(driver.uri);
+   bson_free(driver.file_data);
+   bson_free(driver.read_buf);
+}
+
+
+static bool
+_bench_driver_setup(bench_t *bench)
+{
+   driver.client = mongoc_client_new_from_uri_with_error(driver.uri, &bench->error);
+
+   if (!driver.client) {
+      return false;
+   }
+
+   BSON_ASSERT(mongoc_client_set_error_api(driver.client, MONGOC_ERROR_API_VERSION_2));
+   BSON_ASSERT(mongoc_client_set_appname(driver.client, "benchmark-suite"));
+   driver.collection = mongoc_client_get_collection(driver.client, BENCH_DB, BENCH_COLL);
+
+   if (!driver.server) {
+      mongoc_database_t *const db = mongoc_client_get_database(driver.client, BENCH_DB);
+      bson_error_t ignored;
+
+      /* Start from an empty database. Older servers report an error if it does not exist. */
+      (void)mongoc_database_drop(db, &ignored);
+      mongoc_database_destroy(db);
+   }
+
+   return true;
+}
+
+
+static void
+_bench_driver_teardown(bench_t *bench)
+{
+   BSON_UNUSED(bench);
+
+   if (driver.client && !driver.server) {
+      mongoc_database_t *const db = mongoc_client_get_database(driver.client, BENCH_DB);
+      bson_error_t ignored;
+
+      (void)mongoc_database_drop(db, &ignored);
+      mongoc_database_destroy(db);
+   }
+
+   mongoc_gridfs_bucket_destroy(driver.bucket);
+   mongoc_collection_destroy(driver.collection);
+   mongoc_client_destroy(driver.client);
+   bson_free((void *)driver.docs);
+
+   driver.bucket = NULL;
+   driver.collection = NULL;
+   driver.client = NULL;
+   driver.docs = NULL;
+}
+
+
+static bool
+_bench_small_insert_setup(bench_t *bench)
+{
+   bench->bytes = bench->ops * (int64_t)small_doc.len;
+   return _bench_driver_setup(bench);
+}
+
+
+static bool
+_bench_small_insert(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      if (!mongoc_collection_insert_one(driver.collection, &small_doc, NULL, NULL, &bench->error)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+
+static bool
+_bench_bulk_insert_setup(bench_t *bench)
+{
+   bench->bytes = bench->ops * (int64_t)small_doc.len;
+   driver.docs = bson_malloc(sizeof(bson_t *) * (size_t)bench->ops);
+
+   for (int64_t i = 0; i < bench->ops; i++) {
+      driver.docs[i] = &small_doc;
+   }
+
+   return _bench_driver_setup(bench);
+}
+
+
+static bool
+_bench_bulk_insert(bench_t *bench)
+{
+   return mongoc_collection_insert_many(
+      driver.collection, driver.docs, (size_t)bench->ops, NULL, NULL, &bench->error);
+}
+
+
+static bool
+_bench_find_many_setup(bench_t *bench)
+{
+   bench->bytes = bench->ops * (int64_t)small_doc.len;
+
+   if (!_bench_bulk_insert_setup(bench)) {
+      return false;
+   }
+
+   /* The mock server answers with canned batches; a real server needs the documents. */
+   return driver.server || _bench_bulk_insert(bench);
+}
+
+
+static bool
+_bench_find_many(bench_t *bench)
+{
+   const bson_t filter = BSON_INITIALIZER;
+   mongoc_cursor_t *const cursor = mongoc_collection_find_with_opts(driver.collection, &filter, NULL, NULL);
+   const bson_t *doc;
+   int64_t count = 0;
+   bool ret;
+
+   while (mongoc_cursor_next(cursor, &doc)) {
+      count++;
+   }
+
+   ret = !mongoc_cursor_error(cursor, &bench->error);
+   mongoc_cursor_destroy(cursor);
+
+   if (ret && count != bench->ops) {
+      bson_set_error(&bench->error, 0, 0, "expected %" PRId64 " documents, found %" PRId64, bench->ops, count);
+      ret = false;
+   }
+
+   return ret;
+}
+
+
+static bool
+_bench_gridfs_setup(bench_t *bench)
+{
+   mongoc_database_t *db;
+
+   bench->bytes = (int64_t)BENCH_GRIDFS_CHUNK_SIZE * BENCH_GRIDFS_CHUNKS;
+
+   if (!_bench_driver_setup(bench)) {
+      return false;
+   }
+
+   db = mongoc_client_get_database(driver.client, BENCH_DB);
+   driver.bucket = mongoc_gridfs_bucket_new(db, NULL, NULL, &bench->error);
+   mongoc_database_destroy(db);
+
+   return driver.bucket != NULL;
+}
+
+
+static bool
+_bench_gridfs_upload(bench_t *bench)
+{
+   mongoc_stream_t *const stream =
+      mongoc_gridfs_bucket_open_upload_stream(driver.bucket, "benchmark", NULL, NULL, &bench->error);
+   bool ret;
+
+   if (!stream) {
+      return false;
+   }
+
+   ret = mongoc_stream_write(stream, driver.file_data, (size_t)bench->bytes, 0) == (ssize_t)bench->bytes;
+   ret = mongoc_stream_close(stream) == 0 && ret;
+
+   if (!ret) {
+      BSON_ASSERT(mongoc_gridfs_bucket_stream_error(stream, &bench->error));
+   }
+
+   mongoc_stream_destroy(stream);
+   return ret;
+}
+
+
+static bool
+_bench_gridfs_download_setup(bench_t *bench)
+{
+   mongoc_stream_t *stream;
+   bool ret;
+
+   if (!_bench_gridfs_setup(bench) || driver.server) {
+      return driver.bucket != NULL;
+   }
+
+   /* Upload the file the download benchmark reads. The mock server serves a canned copy of it. */
+   stream = mongoc_gridfs_bucket_open_upload_stream(driver.bucket, "benchmark", NULL, &driver.file_id, &bench->error);
+
+   if (!stream) {
+      return false;
+   }
+
+   ret = mongoc_stream_write(stream, driver.file_data, (size_t)bench->bytes, 0) == (ssize_t)bench->bytes;
+   ret = mongoc_stream_close(stream) == 0 && ret;
+
+   if (!ret) {
+      BSON_ASSERT(mongoc_gridfs_bucket_stream_error(stream, &bench->error));
+   }
+
+   mongoc_stream_destroy(stream);
+   return ret;
+}
+
+
+static bool
+_bench_gridfs_download(bench_t *bench)
+{
+   mongoc_stream_t *const stream =
+      mongoc_gridfs_bucket_open_download_stream(driver.bucket, &driver.file_id, &bench->error);
+   size_t total = 0u;
+   ssize_t r = 0;
+
+   if (!stream) {
+      return false;
+   }
+
+   while (total < (size_t)bench->bytes &&
+          (r = mongoc_stream_read(stream, driver.read_buf + total, (size_t)bench->bytes - total, 1, 0)) > 0) {
+      total += (size_t)r;
+   }
+
+   if (r < 0) {
+      BSON_ASSERT(mongoc_gridfs_bucket_stream_error(stream, &bench->error));
+   } else if (total != (size_t)bench->bytes || memcmp(driver.read_buf, driver.file_data, total) != 0) {
+      bson_set_error(&bench->error, 0, 0, "downloaded file does not match the uploaded file");
+      r = -1;
+   }
+
+   mongoc_stream_destroy(stream);
+   return r >= 0;
+}
+
+
+typedef struct {
+   bson_thread_t thread;
+   bool ok;
+   bson_error_t error;
+} bench_pool_worker_t;
+
+
+static BSON_THREAD_FUN(_bench_pool_worker, data)
+{
+   bench_pool_worker_t *const worker = data;
+   bson_t ping = BSON_INITIALIZER;
+
+   BSON_ASSERT(BSON_APPEND_INT32(&ping, "ping", 1));
+   worker->ok = true;
+
+   for (int i = 0; worker->ok && i < BENCH_POOL_OPS; i++) {
+      mongoc_client_t *const client = mongoc_client_pool_pop(driver.pool);
+
+      worker->ok = mongoc_client_command_simple(client, "admin", &ping, NULL, NULL, &worker->error);
+      mongoc_client_pool_push(driver.pool, client);
+   }
+
+   bson_destroy(&ping);
+   BSON_THREAD_RETURN;
+}
+
+
+static bool
+_bench_pool_setup(bench_t *bench)
+{
+   mongoc_uri_t *const uri = mongoc_uri_copy(driver.uri);
+
+   /* More threads than connections, so workers wait on each other for a client. */
+   BSON_ASSERT(mongoc_uri_set_option_as_int32(uri, MONGOC_URI_MAXPOOLSIZE, BENCH_POOL_SIZE));
+   BSON_ASSERT(mongoc_uri_set_appname(uri, "benchmark-suite"));
+   driver.pool = mongoc_client_pool_new_with_error(uri, &bench->error);
+   mongoc_uri_destroy(uri);
+
+   if (!driver.pool) {
+      return false;
+   }
+
+   BSON_ASSERT(mongoc_client_pool_set_error_api(driver.pool, MONGOC_ERROR_API_VERSION_2));
+   return true;
+}
+
+
+static bool
+_bench_pool(bench_t *bench)
+{
+   bench_pool_worker_t workers[BENCH_POOL_THREADS];
+   bool ret = true;
+
+   for (int i = 0; i < BENCH_POOL_THREADS; i++) {
+      BSON_ASSERT(mcommon_thread_create(&workers[i].thread, _bench_pool_worker, &workers[i]) == 0);
+   }
+
+   for (int i = 0; i < BENCH_POOL_THREADS; i++) {
+      BSON_ASSERT(mcommon_thread_join(workers[i].thread) == 0);
+
+      if (ret && !workers[i].ok) {
+         memcpy(&bench->error, &workers[i].error, sizeof bench->error);
+         ret = false;
+      }
+   }
+
+   return ret;
+}
+
+
+static void
+_bench_pool_teardown(bench_t *bench)
+{
+   BSON_UNUSED(bench);
+
+   mongoc_client_pool_destroy(driver.pool);
+   driver.pool = NULL;
+}
+
+
+/*--------------------------------------------------------------------------
+ *
+ * Stream benchmarks
+ *
+ *--------------------------------------------------------------------------
+ */
+
+static struct {
+   mongoc_socket_t *server_sock;
+   mongoc_stream_t *stream;
+   bson_thread_t echo_thread;
+   uint8_t buf[BENCH_STREAM_MESSAGE_SIZE];
+} stream_bench;
+
+
+/* Reply to each message with its own bytes until the client hangs up. */
+static BSON_THREAD_FUN(_bench_stream_echo, data)
+{
+   mongoc_socket_t *const sock = data;
+   uint8_t buf[BENCH_STREAM_MESSAGE_SIZE];
+
+   for (;;) {
+      size_t received = 0u;
+      size_t sent = 0u;
+
+      while (received < sizeof buf) {
+         const ssize_t r = mongoc_socket_recv(sock, buf + received, sizeof buf - received, 0, -1);
+
+         if (r <= 0) {
+            BSON_THREAD_RETURN;
+         }
+
+         received += (size_t)r;
+      }
+
+      while (sent < sizeof buf) {
+         const ssize_t r = mongoc_socket_send(sock, buf + sent, sizeof buf - sent, -1);
+
+         if (r <= 0) {
+            BSON_THREAD_RETURN;
+         }
+
+         sent += (size_t)r;
+      }
+   }
+}
+
+
+/* Connect a client socket to a server socket over loopback. */
+static bool
+_bench_socket_pair(mongoc_socket_t **client_sock, bson_error_t *error)
+{
+   struct sockaddr_in server_addr = {0};
+   mongoc_socklen_t sock_len = (mongoc_socklen_t)sizeof server_addr;
+   mongoc_socket_t *const listen_sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+   bool ret = false;
+
+   *client_sock = NULL;
+   server_addr.sin_family = AF_INET;
+   server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   server_addr.sin_port = htons(0);
+
+   if (!listen_sock || mongoc_socket_bind(listen_sock, (struct sockaddr *)&server_addr, sizeof server_addr) != 0 ||
+       mongoc_socket_getsockname(listen_sock, (struct sockaddr *)&server_addr, &sock_len) != 0 ||
+       mongoc_socket_listen(listen_sock, 10) != 0) {
+      bson_set_error(error, 0, 0, "failed to listen on loopback");
+      goto done;
+   }
+
+   *client_sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+
+   if (!*client_sock ||
+       mongoc_socket_connect(*client_sock, (struct sockaddr *)&server_addr, sizeof server_addr, -1) != 0 ||
+       !(stream_bench.server_sock = mongoc_socket_accept(listen_sock, -1))) {
+      bson_set_error(error, 0, 0, "failed to connect over loopback");
+      goto done;
+   }
+
+   ret = true;
+
+done:
+   if (!ret && *client_sock) {
+      mongoc_socket_destroy(*client_sock);
+      *client_sock = NULL;
+   }
+
+   if (listen_sock) {
+      mongoc_socket_destroy(listen_sock);
+   }
+
+   return ret;
+}
+
+
+static bool
+_bench_stream_setup(bench_t *bench, bool use_uring)
+{
+   mongoc_socket_t *client_sock;
+
+   bench->bytes = bench->ops * 2 * BENCH_STREAM_MESSAGE_SIZE;
+
+   if (!_bench_socket_pair(&client_sock, &bench->error)) {
+      return false;
+   }
+
+   if (use_uring) {
+      stream_bench.stream = mongoc_stream_uring_new(client_sock);
+
+      if (!stream_bench.stream) {
+         mongoc_socket_destroy(client_sock);
+         bson_set_error(&bench->error, 0, 0, "io_uring is unavailable");
+         bench->skipped = true;
+         return false;
+      }
+   } else {
+      stream_bench.stream = mongoc_stream_socket_new(client_sock);
+   }
+
+   _bench_rand_bytes(stream_bench.buf, sizeof stream_bench.buf);
+   BSON_ASSERT(mcommon_thread_create(&stream_bench.echo_thread, _bench_stream_echo, stream_bench.server_sock) == 0);
+
+   return true;
+}
+
+
+static bool
+_bench_stream_socket_setup(bench_t *bench)
+{
+   return _bench_stream_setup(bench, false);
+}
+
+
+static bool
+_bench_stream_uring_setup(bench_t *bench)
+{
+   return _bench_stream_setup(bench, true);
+}
+
+
+/* Send a message as a header and body, the way the cluster writes an OP_MSG, then read the same-sized reply. */
+static bool
+_bench_stream_ping_pong(bench_t *bench)
+{
+   mongoc_iovec_t iov[2];
+
+   for (int64_t i = 0; i < bench->ops; i++) {
+      iov[0].iov_base = (void *)stream_bench.buf;
+      iov[0].iov_len = 16u;
+      iov[1].iov_base = (void *)(stream_bench.buf + 16);
+      iov[1].iov_len = sizeof stream_bench.buf - 16u;
+
+      if (mongoc_stream_writev(stream_bench.stream, iov, 2u, BENCH_STREAM_TIMEOUT_MS) !=
+             (ssize_t)sizeof stream_bench.buf ||
+          mongoc_stream_read(stream_bench.stream,
+                             stream_bench.buf,
+                             sizeof stream_bench.buf,
+                             sizeof stream_bench.buf,
+                             BENCH_STREAM_TIMEOUT_MS) != (ssize_t)sizeof stream_bench.buf) {
+         bson_set_error(&bench->error, 0, 0, "stream round trip failed");
+         return false;
+      }
+   }
+
+   return true;
+}
+
+
+static void
+_bench_stream_teardown(bench_t *bench)
+{
+   BSON_UNUSED(bench);
+
+   if (stream_bench.stream) {
+      /* Closing the client socket ends the echo thread. */
+      mongoc_stream_destroy(stream_bench.stream);
+      BSON_ASSERT(mcommon_thread_join(stream_bench.echo_thread) == 0);
+   }
+
+   if (stream_bench.server_sock) {
+      mongoc_socket_destroy(stream_bench.server_sock);
+   }
+
+   stream_bench.stream = NULL;
+   stream_bench.server_sock = NULL;
+}
+
+
+/*--------------------------------------------------------------------------
+ *
+ * Overhead benchmarks
+ *
+ *--------------------------------------------------------------------------
+ */
+
+static struct {
+   /* Started by the first overhead benchmark. */
+   mock_server_t *server;
+   mongoc_client_t *client;
+   mongoc_collection_t *collection;
+   const bson_t *docs[BENCH_OVERHEAD_BATCH];
+} overhead;
+
+
+static bool
+_bench_overhead_setup(bench_t *bench)
+{
+   if (!overhead.server) {
+      const mock_server_blackhole_opts_t blackhole_opts = {
+         .batch_doc = &small_doc,
+         .batch_size = BENCH_OVERHEAD_BATCH,
+         .n_getmores = 1,
+      };
+
+      overhead.server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+      mock_server_blackhole(overhead.server, &blackhole_opts);
+      mock_server_run(overhead.server);
+   }
+
+   for (size_t i = 0u; i < BENCH_OVERHEAD_BATCH; i++) {
+      overhead.docs[i] = &small_doc;
+   }
+
+   overhead.client = mongoc_client_new_from_uri_with_error(mock_server_get_uri(overhead.server), &bench->error);
+
+   if (!overhead.client) {
+      return false;
+   }
+
+   BSON_ASSERT(mongoc_client_set_error_api(overhead.client, MONGOC_ERROR_API_VERSION_2));
+   overhead.collection = mongoc_client_get_collection(overhead.client, BENCH_DB, BENCH_COLL);
+
+   return true;
+}
+
+
+static void
+_bench_overhead_teardown(bench_t *bench)
+{
+   BSON_UNUSED(bench);
+
+   mongoc_collection_destroy(overhead.collection);
+   mongoc_client_destroy(overhead.client);
+   overhead.collection = NULL;
+   overhead.client = NULL;
+}
+
+
+static bool
+_bench_overhead_insert_one(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      if (!mongoc_collection_insert_one(overhead.collection, &small_doc, NULL, NULL, &bench->error)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+
+static bool
+_bench_overhead_insert_many(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      if (!mongoc_collection_insert_many(
+             overhead.collection, overhead.docs, BENCH_OVERHEAD_BATCH, NULL, NULL, &bench->error)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+
+/* Each find returns a first batch and one getMore's worth of documents. */
+static bool
+_bench_overhead_find(bench_t *bench)
+{
+   const bson_t filter = BSON_INITIALIZER;
+
+   for (int64_t i = 0; i < bench->ops; i++) {
+      mongoc_cursor_t *const cursor = mongoc_collection_find_with_opts(overhead.collection, &filter, NULL, NULL);
+      const bson_t *doc;
+      int64_t count = 0;
+
+      while (mongoc_cursor_next(cursor, &doc)) {
+         count++;
+      }
+
+      const bool failed = mongoc_cursor_error(cursor, &bench->error);
+      mongoc_cursor_destroy(cursor);
+
+      if (failed) {
+         return false;
+      }
+
+      BSON_ASSERT(count == 2 * BENCH_OVERHEAD_BATCH);
+   }
+
+   return true;
+}
+
+
+static bool
+_bench_overhead_bulk_write(bench_t *bench)
+{
+   for (int64_t i = 0; i < bench->ops; i++) {
+      mongoc_bulkwrite_t *const bw = mongoc_client_bulkwrite_new(overhead.client);
+      bool ok = true;
+
+      for (size_t j = 0u; ok && j < BENCH_OVERHEAD_BATCH; j++) {
+         ok = mongoc_bulkwrite_append_insertone(bw, BENCH_NS, &small_doc, NULL, &bench->error);
+      }
+
+      if (ok) {
+         mongoc_bulkwritereturn_t ret = mongoc_bulkwrite_execute(bw, NULL);
+
+         if (ret.exc) {
+            BSON_ASSERT(mongoc_bulkwriteexception_error(ret.exc, &bench->error));
+            ok = false;
+         }
+
+         mongoc_bulkwriteresult_destroy(ret.res);
+         mongoc_bulkwriteexception_destroy(ret.exc);
+      }
+
+      mongoc_bulkwrite_destroy(bw);
+
+      if (!ok) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+
+/*--------------------------------------------------------------------------
+ *
+ * Runner
+ *
+ *--------------------------------------------------------------------------
+ */
+
+#define BSON_BENCH(which, op, fn, n)       \
+   {.name = "bson/" #which "/" op,         \
+    .setup = _bench_bson_setup,            \
+    .task = fn,                            \
+    .corpus = &corpus_##which,             \
+    .ops = n,                              \
+    .count_cpu = true,                     \
+    .count_allocs = true}
+
+#define DRIVER_BENCH(bench_name, setup_fn, task_fn, n) \
+   {.name = "driver/" bench_name,                      \
+    .setup = setup_fn,                                 \
+    .task = task_fn,                                   \
+    .teardown = _bench_driver_teardown,                \
+    .ops = n,                                          \
+    .count_cpu = true}
+
+#define OVERHEAD_BENCH(bench_name, task_fn, n) \
+   {.name = "overhead/" bench_name,            \
+    .setup = _bench_overhead_setup,            \
+    .task = task_fn,                           \
+    .teardown = _bench_overhead_teardown,      \
+    .ops = n,                                  \
+    .count_cpu = true,                         \
+    .count_allocs = true}
+
+static bench_t benches[] = {
+   BSON_BENCH(flat, "encode", _bench_bson_encode, 100),
+   BSON_BENCH(flat, "decode", _bench_bson_decode, 100),
+   BSON_BENCH(flat, "validate", _bench_bson_validate, 100),
+   BSON_BENCH(flat, "json_round_trip", _bench_bson_json, 10),
+   BSON_BENCH(deep, "encode", _bench_bson_encode, 100),
+   BSON_BENCH(deep, "decode", _bench_bson_decode, 100),
+   BSON_BENCH(deep, "validate", _bench_bson_validate, 100),
+   BSON_BENCH(deep, "json_round_trip", _bench_bson_json, 10),
+   BSON_BENCH(full, "encode", _bench_bson_encode, 100),
+   BSON_BENCH(full, "decode", _bench_bson_decode, 100),
+   BSON_BENCH(full, "validate", _bench_bson_validate, 100),
+   BSON_BENCH(full, "json_round_trip", _bench_bson_json, 10),
+   DRIVER_BENCH("small_insert", _bench_small_insert_setup, _bench_small_insert, 100),
+   DRIVER_BENCH("bulk_insert", _bench_bulk_insert_setup, _bench_bulk_insert, 1000),
+   DRIVER_BENCH("find_many", _bench_find_many_setup, _bench_find_many, BENCH_FIND_DOCS),
+   DRIVER_BENCH("gridfs_upload", _bench_gridfs_setup, _bench_gridfs_upload, 1),
+   DRIVER_BENCH("gridfs_download", _bench_gridfs_download_setup, _bench_gridfs_download, 1),
+   {.name = "driver/pooled_contention",
+    .setup = _bench_pool_setup,
+    .task = _bench_pool,
+    .teardown = _bench_pool_teardown,
+    .ops = BENCH_POOL_THREADS * BENCH_POOL_OPS},
+   OVERHEAD_BENCH("insert_one", _bench_overhead_insert_one, 1000),
+   OVERHEAD_BENCH("insert_many", _bench_overhead_insert_many, 100),
+   OVERHEAD_BENCH("find", _bench_overhead_find, 100),
+   OVERHEAD_BENCH("bulk_write", _bench_overhead_bulk_write, 100),
+   {.name = "stream/socket/ping_pong",
+    .setup = _bench_stream_socket_setup,
+    .task = _bench_stream_ping_pong,
+    .teardown = _bench_stream_teardown,
+    .ops = 1000,
+    .count_cpu = true},
+   {.name = "stream/uring/ping_pong",
+    .setup = _bench_stream_uring_setup,
+    .task = _bench_stream_ping_pong,
+    .teardown = _bench_stream_teardown,
+    .ops = 1000,
+    .count_cpu = true},
+};
+
+
+static int
+_cmp_int64(const void *a, const void *b)
+{
+   const int64_t x = *(const int64_t *)a;
+   const int64_t y = *(const int64_t *)b;
+
+   return x < y ? -1 : x > y;
+}
+
+
+/* "cpu_ns" and "allocs" are totals over all n iterations, or -1 if not measured. */
+static void
+_append_stats(bson_t *result, const bench_t *bench, int64_t *samples, int64_t n, int64_t cpu_ns, int64_t allocs)
+{
+   int64_t total = 0;
+
+   qsort(samples, (size_t)n, sizeof *samples, _cmp_int64);
+
+   for (int64_t i = 0; i < n; i++) {
+      total += samples[i];
+   }
+
+   /* Clamp to one microsecond so that sub-microsecond iterations still report finite rates. */
+   const int64_t median = BSON_MAX(samples[n / 2], 1);
+   const double ns_per_op = (double)median * 1000.0 / (double)bench->ops;
+   const double ops_per_sec = (double)bench->ops * 1e6 / (double)median;
+
+   BSON_ASSERT(BSON_APPEND_INT64(result, "iterations", n));
+   BSON_ASSERT(BSON_APPEND_INT64(result, "ops_per_iteration", bench->ops));
+   BSON_ASSERT(BSON_APPEND_INT64(result, "bytes_per_iteration", bench->bytes));
+   BSON_ASSERT(BSON_APPEND_INT64(result, "min_usec", samples[0]));
+   BSON_ASSERT(BSON_APPEND_INT64(result, "median_usec", samples[n / 2]));
+   BSON_ASSERT(BSON_APPEND_INT64(result, "p90_usec", samples[(n - 1) * 9 / 10]));
+   BSON_ASSERT(BSON_APPEND_INT64(result, "max_usec", samples[n - 1]));
+   BSON_ASSERT(BSON_APPEND_DOUBLE(result, "mean_usec", (double)total / (double)n));
+   BSON_ASSERT(BSON_APPEND_DOUBLE(result, "ns_per_op", ns_per_op));
+   BSON_ASSERT(BSON_APPEND_DOUBLE(result, "ops_per_sec", ops_per_sec));
+
+   if (bench->bytes > 0) {
+      /* Bytes per microsecond is megabytes (10^6 bytes) per second. */
+      BSON_ASSERT(BSON_APPEND_DOUBLE(result, "mb_per_sec", (double)bench->bytes / (double)median));
+   }
+
+   if (cpu_ns >= 0) {
+      BSON_ASSERT(BSON_APPEND_DOUBLE(result, "cpu_ns_per_op", (double)cpu_ns / (double)(n * bench->ops)));
+   }
+
+   if (allocs >= 0) {
+      BSON_ASSERT(BSON_APPEND_DOUBLE(result, "allocs_per_op", (double)allocs / (double)(n * bench->ops)));
+   }
+
+   fprintf(stderr, "%-32s %8" PRId64 " iterations %14.1f ns/op %14.1f ops/s\n", bench->name, n, ns_per_op, ops_per_sec);
+}
+
+
+/* Run one benchmark and append its result document to "results". Returns false if it failed. */
+static bool
+_bench_run(bench_t *bench, bson_t *results, const char *key)
+{
+   int64_t *samples;
+   int64_t n = 0;
+   mlib_time_point started;
+   mlib_time_point iteration_started;
+   int64_t cpu_ns = -1;
+   int64_t allocs = -1;
+   bson_t result;
+   bool ok = false;
+
+   samples = bson_malloc(sizeof(int64_t) * (size_t)opts.max_iterations);
+
+   if (bench->setup && !bench->setup(bench)) {
+      goto done;
+   }
+
+   /* One untimed iteration, to open connections and warm caches. */
+   if (!bench->task(bench)) {
+      goto done;
+   }
+
+   started = mlib_now();
+
+   if (bench->count_cpu) {
+      cpu_ns = _bench_thread_cpu_ns();
+   }
+
+   if (bench->count_allocs) {
+      allocs = mcommon_atomic_int64_fetch(&bench_allocs, mcommon_memory_order_relaxed);
+   }
+
+   while (n < opts.max_iterations &&
+          (n < opts.min_iterations || mlib_milliseconds_count(mlib_elapsed_since(started)) < opts.min_time_ms)) {
+      iteration_started = mlib_now();
+
+      if (!bench->task(bench)) {
+         goto done;
+      }
+
+      samples[n++] = mlib_microseconds_count(mlib_elapsed_since(iteration_started));
+   }
+
+   if (cpu_ns >= 0) {
+      cpu_ns = _bench_thread_cpu_ns() - cpu_ns;
+   }
+
+   if (allocs >= 0) {
+      allocs = mcommon_atomic_int64_fetch(&bench_allocs, mcommon_memory_order_relaxed) - allocs;
+   }
+
+   ok = true;
+
+done:
+   if (bench->teardown) {
+      bench->teardown(bench);
+   }
+
+   BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(results, key, &result));
+   BSON_ASSERT(BSON_APPEND_UTF8(&result, "name", bench->name));
+
+   if (ok) {
+      _append_stats(&result, bench, samples, n, cpu_ns, allocs);
+   } else if (bench->skipped) {
+      BSON_ASSERT(BSON_APPEND_UTF8(&result, "skipped", bench->error.message));
+      fprintf(stderr, "%-32s skipped: %s\n", bench->name, bench->error.message);
+   } else {
+      BSON_ASSERT(BSON_APPEND_UTF8(&result, "error", bench->error.message));
+      fprintf(stderr, "%-32s FAILED: %s\n", bench->name, bench->error.message);
+   }
+
+   BSON_ASSERT(bson_append_document_end(results, &result));
+   bson_free(samples);
+
+   return ok || bench->skipped;
+}
+
+
+static void
+_usage(const char *prgname)
+{
+   fprintf(stderr,
+           "usage: %s [--uri URI] [--data-dir DIR] [--filter SUBSTRING] [--min-time-ms N]\n"
+           "       [--min-iterations N] [--max-iterations N] [--label LABEL] [--output FILE] [--list]\n",
+           prgname);
+}
+
+
+static bool
+_parse_args(int argc, char *argv[])
+{
+   for (int i = 1; i < argc; i++) {
+      const char *const arg = argv[i];
+      const char *const value = i + 1 < argc ? argv[i + 1] : NULL;
+
+      if (0 == strcmp(arg, "--list")) {
+         opts.list = true;
+         continue;
+      }
+
+      if (!value) {
+         return false;
+      }
+
+      if (0 == strcmp(arg, "--uri")) {
+         opts.uri = value;
+      } else if (0 == strcmp(arg, "--data-dir")) {
+         opts.data_dir = value;
+      } else if (0 == strcmp(arg, "--filter")) {
+         opts.filter = value;
+      } else if (0 == strcmp(arg, "--label")) {
+         opts.label = value;
+      } else if (0 == strcmp(arg, "--output")) {
+         opts.output = value;
+      } else if (0 == strcmp(arg, "--min-time-ms")) {
+         opts.min_time_ms = strtoll(value, NULL, 10);
+      } else if (0 == strcmp(arg, "--min-iterations")) {
+         opts.min_iterations = strtoll(value, NULL, 10);
+      } else if (0 == strcmp(arg, "--max-iterations")) {
+         opts.max_iterations = strtoll(value, NULL, 10);
+      } else {
+         return false;
+      }
+
+      i++;
+   }
+
+   return opts.min_time_ms >= 0 && opts.min_iterations >= 1 && opts.max_iterations >= opts.min_iterations;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+   TestSuite suite;
+   char *suite_argv[] = {argv[0]};
+   bson_t report = BSON_INITIALIZER;
+   bson_t options;
+   bson_t results;
+   bson_error_t error;
+   char buf[16];
+   const char *key;
+   uint32_t n_results = 0u;
+   bool ok = true;
+
+   if (!_parse_args(argc, argv)) {
+      _usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   if (opts.list) {
+      for (size_t i = 0u; i < sizeof benches / sizeof benches[0]; i++) {
+         printf("%s\n", benches[i].name);
+      }
+
+      return EXIT_SUCCESS;
+   }
+
+   /* Count allocations from the start: the vtable must be set before anything is allocated. */
+   bson_mem_set_vtable(&bench_mem_vtable);
+
+   /* The mock server logs through the global test suite, so initialize it the way test-libmongoc does. */
+   test_libmongoc_init(&suite, 1, suite_argv);
+
+   if (!_corpora_init(&error) || !_driver_init(&error)) {
+      fprintf(stderr, "%s\n", error.message);
+      return EXIT_FAILURE;
+   }
+
+   BSON_ASSERT(BSON_APPEND_UTF8(&report, "driver_version", MONGOC_VERSION_S));
+   if (opts.label) {
+      BSON_ASSERT(BSON_APPEND_UTF8(&report, "label", opts.label));
+   }
+   BSON_ASSERT(BSON_APPEND_UTF8(&report, "target", driver.server ? "mock server" : "mongod"));
+   BSON_ASSERT(BSON_APPEND_UTF8(&report, "corpora", opts.data_dir ? opts.data_dir : "generated"));
+   BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(&report, "options", &options));
+   BSON_ASSERT(BSON_APPEND_INT64(&options, "min_time_ms", opts.min_time_ms));
+   BSON_ASSERT(BSON_APPEND_INT64(&options, "min_iterations", opts.min_iterations));
+   BSON_ASSERT(BSON_APPEND_INT64(&options, "max_iterations", opts.max_iterations));
+   BSON_ASSERT(bson_append_document_end(&report, &options));
+
+   BSON_ASSERT(BSON_APPEND_ARRAY_BEGIN(&report, "results", &results));
+
+   for (size_t i = 0u; i < sizeof benches / sizeof benches[0]; i++) {
+      if (opts.filter && !strstr(benches[i].name, opts.filter)) {
+         continue;
+      }
+
+      bson_uint32_to_string(n_results++, &key, buf, sizeof buf);
+      ok = _bench_run(&benches[i], &results, key) && ok;
+   }
+
+   BSON_ASSERT(bson_append_array_end(&report, &results));
+
+   {
+      char *const json = bson_as_relaxed_extended_json(&report, NULL);
+      FILE *out = stdout;
+
+      if (opts.output && !(out = fopen(opts.output, "w"))) {
+         fprintf(stderr, "failed to open %s\n", opts.output);
+         ok = false;
+      } else {
+         fprintf(out, "%s\n", json);
+
+         if (out != stdout) {
+            fclose(out);
+         }
+      }
+
+      bson_free(json);
+   }
+
+   bson_destroy(&report);
+   mock_server_destroy(overhead.server);
+   _driver_cleanup();
+   _corpora_cleanup();
+   test_libmongoc_destroy(&suite);
+
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
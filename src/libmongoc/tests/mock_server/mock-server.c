@@ -36,6 +36,14 @@
 #include <mlib/intencode.h>
 #include <mlib/time_point.h>
 
+#ifdef MONGOC_ENABLE_SSL_OPENSSL
+#include <mongoc/mongoc-openssl-private.h>
+#include <mongoc/mongoc-stream-tls-private.h>
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+#define MOCK_SERVER_SHARED_OPENSSL_CTX
+#endif
+#endif
+
 #ifdef BSON_HAVE_STRINGS_H
 #include <strings.h>
 #endif
@@ -68,7 +76,17 @@ struct _mock_server_t {
    mongoc_ssl_opt_t ssl_opts;
 #endif
 
+#ifdef MOCK_SERVER_SHARED_OPENSSL_CTX
+   /* Shared by all connections, like a real server's, so clients can resume
+    * TLS sessions. Created on the first connection after the ssl opts are set. */
+   SSL_CTX *openssl_ctx;
+#endif
+
    mock_server_bind_opts_t bind_opts;
+
+   bool blackhole;
+   int32_t blackhole_n_getmores;
+   bson_t blackhole_batch;
 };
 
 
@@ -145,6 +163,7 @@ mock_server_new(void)
    bson_mutex_init(&server->mutex);
    server->q = q_new();
    server->start_time = bson_get_monotonic_time();
+   bson_init(&server->blackhole_batch);
 
    return server;
 }
@@ -298,6 +317,10 @@ mock_server_set_ssl_opts(mock_server_t *server, mongoc_ssl_opt_t *opts)
    bson_mutex_lock(&server->mutex);
    server->ssl = true;
    memcpy(&server->ssl_opts, opts, sizeof *opts);
+#ifdef MOCK_SERVER_SHARED_OPENSSL_CTX
+   SSL_CTX_free(server->openssl_ctx);
+   server->openssl_ctx = NULL;
+#endif
    bson_mutex_unlock(&server->mutex);
 }
 
@@ -1651,6 +1674,10 @@ mock_server_destroy(mock_server_t *server)
 
    _mongoc_array_destroy(&server->autoresponders);
 
+#ifdef MOCK_SERVER_SHARED_OPENSSL_CTX
+   SSL_CTX_free(server->openssl_ctx);
+#endif
+
    mongoc_cond_destroy(&server->cond);
    bson_mutex_destroy(&server->mutex);
    mongoc_socket_destroy(server->sock);
@@ -1662,6 +1689,7 @@ mock_server_destroy(mock_server_t *server)
    }
 
    q_destroy(server->q);
+   bson_destroy(&server->blackhole_batch);
    bson_free(server);
 }
 
@@ -1741,7 +1769,15 @@ static BSON_THREAD_FUN(main_thread, data)
          if (server->ssl) {
             mongoc_stream_t *tls_stream;
             server->ssl_opts.weak_cert_validation = 1;
+#ifdef MOCK_SERVER_SHARED_OPENSSL_CTX
+            if (!server->openssl_ctx) {
+               server->openssl_ctx = _mongoc_openssl_ctx_new(&server->ssl_opts);
+            }
+            tls_stream = mongoc_stream_tls_new_with_hostname_and_openssl_context(
+               client_stream, NULL, &server->ssl_opts, 0, server->openssl_ctx);
+#else
             tls_stream = mongoc_stream_tls_new_with_hostname(client_stream, NULL, &server->ssl_opts, 0);
+#endif
             if (!tls_stream) {
                mongoc_stream_destroy(client_stream);
                bson_mutex_unlock(&server->mutex);
@@ -1799,6 +1835,190 @@ _reply_destroy(reply_t *reply)
 }
 
 
+/* Count the documents in an OP_MSG document sequence, and the "bulkWrite" operations among them by kind. */
+static bool
+_blackhole_count_docs(const uint8_t *docs, size_t len, int32_t counts[4])
+{
+   while (len > 0u) {
+      bson_t doc;
+      bson_iter_t iter;
+      const int32_t doc_len = len >= 4u ? mlib_read_i32le(docs) : 0;
+
+      if (doc_len < 5 || (size_t)doc_len > len || !bson_init_static(&doc, docs, (size_t)doc_len)) {
+         return false;
+      }
+
+      counts[0]++;
+
+      if (bson_iter_init(&iter, &doc) && bson_iter_next(&iter)) {
+         const char *const key = bson_iter_key(&iter);
+
+         counts[1] += 0 == strcmp(key, "insert");
+         counts[2] += 0 == strcmp(key, "update");
+         counts[3] += 0 == strcmp(key, "delete");
+      }
+
+      docs += doc_len;
+      len -= (size_t)doc_len;
+   }
+
+   return true;
+}
+
+
+/* Reply to a message in blackhole mode. Returns false to pass the message to the usual request path. */
+static bool
+_blackhole_reply(mock_server_t *server,
+                 const uint8_t *data,
+                 size_t len,
+                 mongoc_stream_t *client,
+                 bson_t *reply,
+                 int32_t *last_response_id)
+{
+   const uint8_t *seq = NULL;
+   size_t seq_len = 0u;
+   bson_t body;
+   bool have_body = false;
+   bson_iter_t iter;
+   int32_t counts[4] = {0};
+   char ns[512];
+   uint8_t header[21];
+   mongoc_iovec_t iov[2];
+
+   if (len < 21u || mlib_read_i32le(data + 12) != MONGOC_OP_CODE_MSG) {
+      return false;
+   }
+
+   const int32_t request_id = mlib_read_i32le(data + 4);
+   const uint32_t flag_bits = mlib_read_u32le(data + 16);
+   const size_t end = (flag_bits & MONGOC_OP_MSG_FLAG_CHECKSUM_PRESENT) ? len - 4u : len;
+
+   for (size_t pos = 20u; pos < end;) {
+      const uint8_t kind = data[pos++];
+      const int32_t section_len = end - pos >= 4u ? mlib_read_i32le(data + pos) : 0;
+
+      if (section_len < 5 || (size_t)section_len > end - pos) {
+         return false;
+      }
+
+      if (kind == 0u) {
+         have_body = bson_init_static(&body, data + pos, (size_t)section_len);
+      } else if (kind == 1u) {
+         /* A size, a NUL-terminated identifier, then the documents: "documents" or "ops" for our commands. */
+         const uint8_t *const identifier = data + pos + 4;
+         const uint8_t *const nul = memchr(identifier, '\0', (size_t)section_len - 4u);
+
+         if (!nul) {
+            return false;
+         }
+
+         if (0 == strcmp((const char *)identifier, "documents") || 0 == strcmp((const char *)identifier, "ops")) {
+            seq = nul + 1;
+            seq_len = (size_t)(data + pos + section_len - seq);
+         }
+      } else {
+         return false;
+      }
+
+      pos += (size_t)section_len;
+   }
+
+   if (!have_body || !bson_iter_init(&iter, &body) || !bson_iter_next(&iter)) {
+      return false;
+   }
+
+   const char *const name = bson_iter_key(&iter);
+
+   bson_reinit(reply);
+
+   if (0 == strcmp(name, "insert") || 0 == strcmp(name, "bulkWrite")) {
+      if (!seq || !_blackhole_count_docs(seq, seq_len, counts)) {
+         return false;
+      }
+
+      if (0 == strcmp(name, "insert")) {
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "n", counts[0]));
+      } else {
+         bson_t cursor;
+         bson_t batch;
+
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "nErrors", 0));
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "nInserted", counts[1]));
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "nMatched", counts[2]));
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "nModified", counts[2]));
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "nUpserted", 0));
+         BSON_ASSERT(BSON_APPEND_INT32(reply, "nDeleted", counts[3]));
+         BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(reply, "cursor", &cursor));
+         BSON_ASSERT(BSON_APPEND_INT64(&cursor, "id", 0));
+         BSON_ASSERT(BSON_APPEND_UTF8(&cursor, "ns", "admin.$cmd.bulkWrite"));
+         BSON_ASSERT(BSON_APPEND_ARRAY_BEGIN(&cursor, "firstBatch", &batch));
+         BSON_ASSERT(bson_append_array_end(&cursor, &batch));
+         BSON_ASSERT(bson_append_document_end(reply, &cursor));
+      }
+   } else if (0 == strcmp(name, "find") || 0 == strcmp(name, "getMore")) {
+      const bool is_find = 0 == strcmp(name, "find");
+      const char *coll = NULL;
+      const char *db = NULL;
+      int64_t cursor_id;
+      bson_t cursor;
+
+      if (is_find) {
+         coll = BSON_ITER_HOLDS_UTF8(&iter) ? bson_iter_utf8(&iter, NULL) : NULL;
+         cursor_id = server->blackhole_n_getmores;
+      } else {
+         /* The cursor ID is the number of getMores left. */
+         cursor_id = BSON_MAX(bson_iter_as_int64(&iter) - 1, 0);
+
+         if (bson_iter_init_find(&iter, &body, "collection") && BSON_ITER_HOLDS_UTF8(&iter)) {
+            coll = bson_iter_utf8(&iter, NULL);
+         }
+      }
+
+      if (bson_iter_init_find(&iter, &body, "$db") && BSON_ITER_HOLDS_UTF8(&iter)) {
+         db = bson_iter_utf8(&iter, NULL);
+      }
+
+      if (!coll || !db || bson_snprintf(ns, sizeof ns, "%s.%s", db, coll) >= (int)sizeof ns) {
+         return false;
+      }
+
+      BSON_ASSERT(BSON_APPEND_DOCUMENT_BEGIN(reply, "cursor", &cursor));
+      BSON_ASSERT(BSON_APPEND_INT64(&cursor, "id", cursor_id));
+      BSON_ASSERT(BSON_APPEND_UTF8(&cursor, "ns", ns));
+      BSON_ASSERT(BSON_APPEND_ARRAY(&cursor, is_find ? "firstBatch" : "nextBatch", &server->blackhole_batch));
+      BSON_ASSERT(bson_append_document_end(reply, &cursor));
+   } else {
+      return false;
+   }
+
+   BSON_ASSERT(BSON_APPEND_DOUBLE(reply, "ok", 1.0));
+
+   /* An unacknowledged write expects no reply. */
+   if (flag_bits & MONGOC_OP_MSG_FLAG_MORE_TO_COME) {
+      return true;
+   }
+
+   /* A single section of kind 0 after the header and flag bits. */
+   uint8_t *ptr = header;
+   ptr = mlib_write_i32le(ptr, (int32_t)(sizeof header + reply->len));
+   ptr = mlib_write_i32le(ptr, ++*last_response_id);
+   ptr = mlib_write_i32le(ptr, request_id);
+   ptr = mlib_write_i32le(ptr, MONGOC_OP_CODE_MSG);
+   ptr = mlib_write_u32le(ptr, 0u);
+   *ptr = 0u;
+
+   iov[0].iov_base = (void *)header;
+   iov[0].iov_len = sizeof header;
+   iov[1].iov_base = (void *)bson_get_data(reply);
+   iov[1].iov_len = reply->len;
+
+   /* A failed write means the client hung up, which the next read reports. */
+   (void)mongoc_stream_writev(client, iov, 2u, -1);
+
+   return true;
+}
+
+
 static BSON_THREAD_FUN(worker_thread, data)
 {
    worker_closure_t *closure = (worker_closure_t *)data;
@@ -1814,6 +2034,10 @@ static BSON_THREAD_FUN(worker_thread, data)
    ssize_t i;
    autoresponder_handle_t handle;
    reply_t *reply;
+   bool blackhole;
+   bool blackholed;
+   bson_t blackhole_reply = BSON_INITIALIZER;
+   int32_t blackhole_response_id = 0;
 
 #ifdef MONGOC_ENABLE_SSL
    bool ssl;
@@ -1843,7 +2067,13 @@ static BSON_THREAD_FUN(worker_thread, data)
    _mongoc_buffer_init(&buffer, NULL, 0, NULL, NULL);
    _mongoc_array_init(&autoresponders, sizeof(autoresponder_handle_t));
 
+   bson_mutex_lock(&server->mutex);
+   blackhole = server->blackhole;
+   bson_mutex_unlock(&server->mutex);
+
 again:
+   blackholed = false;
+
    /* loop, checking for requests to receive or replies to send */
    if (_mongoc_buffer_fill(&buffer, client_stream, 4, 10, &error) > 0) {
       BSON_ASSERT(buffer.len >= 4);
@@ -1861,6 +2091,18 @@ again:
 
       BSON_ASSERT(buffer.len >= (unsigned)msg_len);
 
+      if (blackhole && _blackhole_reply(server,
+                                        buffer.data,
+                                        (size_t)msg_len,
+                                        client_stream,
+                                        &blackhole_reply,
+                                        &blackhole_response_id)) {
+         memmove(buffer.data, buffer.data + msg_len, buffer.len - msg_len);
+         buffer.len -= msg_len;
+         blackholed = true;
+         GOTO(send_replies);
+      }
+
       /* copies message from buffer */
       request = request_new(&buffer, msg_len, server, client_stream, closure->port, replies);
 
@@ -1895,11 +2137,13 @@ again:
       }
    }
 
+send_replies:
    if (_mock_server_stopping(server)) {
       GOTO(failure);
    }
 
-   reply = q_get(replies, 10);
+   /* Don't wait for replies after a blackholed message: the client is about to send another. */
+   reply = blackholed ? q_get_nowait(replies) : q_get(replies, 10);
    if (reply) {
       _mock_server_reply_with_stream(server, reply, client_stream);
       _reply_destroy(reply);
@@ -1912,6 +2156,7 @@ again:
    GOTO(again);
 
 failure:
+   bson_destroy(&blackhole_reply);
    _mongoc_array_destroy(&autoresponders);
    _mongoc_buffer_destroy(&buffer);
 
@@ -2089,6 +2334,57 @@ mock_server_set_bind_opts(mock_server_t *server, mock_server_bind_opts_t *opts)
    server->bind_opts = *opts;
 }
 
+
+/*--------------------------------------------------------------------------
+ *
+ * mock_server_blackhole --
+ *
+ *       Answer "insert", "find", "getMore", and "bulkWrite" with canned
+ *       replies at line rate, to measure the client's own cost per
+ *       operation. Each connection's worker thread replies as soon as it
+ *       reads the message, without building a request_t, logging, or
+ *       passing through the autoresponders and reply queue, and without
+ *       allocating once its reply buffer has grown. Other messages, such
+ *       as "hello", take the usual path.
+ *
+ *       Writes report every operation as successful. A find opens a
+ *       cursor that is exhausted after opts->n_getmores getMores, and each
+ *       batch holds opts->batch_size copies of opts->batch_doc. The cursor
+ *       ID is the number of getMores left, so cursors need no state. With
+ *       NULL opts, every batch is empty and every cursor is exhausted.
+ *
+ *       Call before mock_server_run.
+ *
+ *--------------------------------------------------------------------------
+ */
+
+void
+mock_server_blackhole(mock_server_t *server, const mock_server_blackhole_opts_t *opts)
+{
+   char buf[16];
+   const char *key;
+
+   BSON_ASSERT_PARAM(server);
+   BSON_OPTIONAL_PARAM(opts);
+   BSON_ASSERT(!server->running);
+
+   server->blackhole = true;
+   server->blackhole_n_getmores = 0;
+   bson_reinit(&server->blackhole_batch);
+
+   if (opts) {
+      BSON_ASSERT(opts->batch_size == 0 || opts->batch_doc);
+      BSON_ASSERT(opts->n_getmores >= 0);
+
+      server->blackhole_n_getmores = opts->n_getmores;
+
+      for (int32_t i = 0; i < opts->batch_size; i++) {
+         bson_uint32_to_string((uint32_t)i, &key, buf, sizeof buf);
+         BSON_ASSERT(BSON_APPEND_DOCUMENT(&server->blackhole_batch, key, opts->batch_doc));
+      }
+   }
+}
+
 void
 rs_response_to_hello(mock_server_t *server, int max_wire_version, bool primary, int has_tags, ...)
 {
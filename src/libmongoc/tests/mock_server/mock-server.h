@@ -49,6 +49,14 @@ typedef struct _mock_server_bind_opts_t {
    int ipv6_only;
 } mock_server_bind_opts_t;
 
+typedef struct _mock_server_blackhole_opts_t {
+   /* Repeated batch_size times in every find and getMore batch. */
+   const bson_t *batch_doc;
+   int32_t batch_size;
+   /* The number of getMores after which each cursor is exhausted. */
+   int32_t n_getmores;
+} mock_server_blackhole_opts_t;
+
 typedef bool (*autoresponder_t)(request_t *request, void *data);
 
 typedef bool (*hello_callback_func_t)(request_t *request, void *data, bson_t *hello_response);
@@ -95,6 +103,9 @@ mock_server_set_ssl_opts(mock_server_t *server, mongoc_ssl_opt_t *opts);
 void
 mock_server_set_bind_opts(mock_server_t *server, mock_server_bind_opts_t *opts);
 
+void
+mock_server_blackhole(mock_server_t *server, const mock_server_blackhole_opts_t *opts);
+
 uint16_t
 mock_server_run(mock_server_t *server);
 
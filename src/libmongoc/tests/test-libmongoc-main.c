@@ -1,5 +1,7 @@
 #include <common-thread-private.h>
 
+#include <mongoc/mongoc-ocsp-cache-private.h> // MONGOC_ENABLE_OCSP_OPENSSL
+
 #include <mongoc/mongoc.h>
 
 #include <bson/bson.h>
@@ -132,6 +134,7 @@ main(int argc, char *argv[])
    TEST_INSTALL(test_cyrus_install);
 #endif
    TEST_INSTALL(test_happy_eyeballs_install);
+   TEST_INSTALL(test_mock_server_install);
    TEST_INSTALL(test_counters_install);
    TEST_INSTALL(test_crud_install);
    TEST_INSTALL(test_apm_install);
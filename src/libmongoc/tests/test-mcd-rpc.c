@@ -2099,6 +2099,85 @@ test_rpc_message_to_iovecs_op_kill_cursors(void)
    mcd_rpc_message_destroy(rpc);
 }
 
+static void
+test_rpc_message_to_compact_iovecs_small(void)
+{
+   const uint8_t data[] = {TEST_DATA_OP_MSG_KIND_1_MULTIPLE};
+
+   mcd_rpc_message *const rpc = mcd_rpc_message_from_data(data, sizeof(data), NULL);
+
+   size_t num_iovecs;
+   mongoc_iovec_t *const iovecs = mcd_rpc_message_to_compact_iovecs(rpc, &num_iovecs);
+   ASSERT(iovecs);
+
+   // Every segment is small, so the whole message is one contiguous copy.
+   ASSERT_CMPSIZE_T(num_iovecs, ==, 1u);
+   ASSERT_CMPSIZE_T(iovecs[0].iov_len, ==, sizeof(data));
+   ASSERT_CMPINT(memcmp(iovecs[0].iov_base, data, sizeof(data)), ==, 0);
+
+   bson_free(iovecs);
+   mcd_rpc_message_destroy(rpc);
+}
+
+static void
+test_rpc_message_to_compact_iovecs_large(void)
+{
+   bson_t *const body = bson_new();
+   char *const value = bson_malloc0(MCD_RPC_COMPACT_IOVEC_THRESHOLD);
+   memset(value, 'x', MCD_RPC_COMPACT_IOVEC_THRESHOLD - 1u);
+   BSON_APPEND_UTF8(body, "value", value);
+
+   const bson_t *const document = tmp_bson("{'a': 1}");
+   const uint8_t *const documents = bson_get_data(document);
+
+   mcd_rpc_message *const rpc = mcd_rpc_message_new();
+   int32_t message_length = 0;
+   message_length += mcd_rpc_header_set_message_length(rpc, 0);
+   message_length += mcd_rpc_header_set_request_id(rpc, 16909060);
+   message_length += mcd_rpc_header_set_response_to(rpc, 0);
+   message_length += mcd_rpc_header_set_op_code(rpc, MONGOC_OP_CODE_MSG);
+   mcd_rpc_op_msg_set_sections_count(rpc, 2u);
+   message_length += mcd_rpc_op_msg_set_flag_bits(rpc, 0u);
+   message_length += mcd_rpc_op_msg_section_set_kind(rpc, 0u, 0);
+   message_length += mcd_rpc_op_msg_section_set_body(rpc, 0u, bson_get_data(body));
+   message_length += mcd_rpc_op_msg_section_set_kind(rpc, 1u, 1);
+   message_length += mcd_rpc_op_msg_section_set_length(rpc, 1u, 4 + 10 + (int32_t)document->len);
+   message_length += mcd_rpc_op_msg_section_set_identifier(rpc, 1u, "documents");
+   message_length += mcd_rpc_op_msg_section_set_document_sequence(rpc, 1u, documents, document->len);
+   mcd_rpc_message_set_length(rpc, message_length);
+
+   size_t num_iovecs;
+   mongoc_iovec_t *const iovecs = mcd_rpc_message_to_compact_iovecs(rpc, &num_iovecs);
+   ASSERT(iovecs);
+
+   // msgHeader, flagBits, and the section 0 kind are coalesced. The large body
+   // is referenced in place. The section 1 fields and its small document
+   // sequence are coalesced again.
+   ASSERT_CMPSIZE_T(num_iovecs, ==, 3u);
+   ASSERT_CMPSIZE_T(iovecs[0].iov_len, ==, 16u + 4u + 1u);
+   ASSERT(iovecs[1].iov_base == (void *)bson_get_data(body));
+   ASSERT_CMPSIZE_T(iovecs[1].iov_len, ==, body->len);
+   ASSERT_CMPSIZE_T(iovecs[2].iov_len, ==, 1u + 4u + 10u + document->len);
+
+   size_t total = 0u;
+   for (size_t i = 0u; i < num_iovecs; ++i) {
+      total += iovecs[i].iov_len;
+   }
+   ASSERT_CMPSIZE_T(total, ==, (size_t)message_length);
+
+   bson_free(iovecs);
+   mcd_rpc_message_destroy(rpc);
+   bson_free(value);
+   bson_destroy(body);
+}
+
+static void
+test_rpc_message_to_compact_iovecs(void)
+{
+   test_rpc_message_to_compact_iovecs_small();
+   test_rpc_message_to_compact_iovecs_large();
+}
+
 
 #define ASSERT_CMPIOVEC_VALUE(index, type, raw_type, from_le, spec)                                               \
    if (1) {                                                                                                       \
@@ -2850,6 +2929,7 @@ test_mcd_rpc_install(TestSuite *suite)
    TestSuite_Add(suite, "/rpc_message/to_iovecs/op_get_more", test_rpc_message_to_iovecs_op_get_more);
    TestSuite_Add(suite, "/rpc_message/to_iovecs/op_delete", test_rpc_message_to_iovecs_op_delete);
    TestSuite_Add(suite, "/rpc_message/to_iovecs/op_kill_cursors", test_rpc_message_to_iovecs_op_kill_cursors);
+   TestSuite_Add(suite, "/rpc_message/to_compact_iovecs", test_rpc_message_to_compact_iovecs);
 
    TestSuite_Add(suite, "/rpc_message/setters/op_compressed", test_rpc_message_setters_op_compressed);
    TestSuite_Add(suite, "/rpc_message/setters/op_msg", test_rpc_message_setters_op_msg);
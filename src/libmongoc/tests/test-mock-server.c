@@ -0,0 +1,111 @@
+/*
+ * Copyright 2009-present MongoDB, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mongoc/mongoc-client-private.h>
+
+#include <mongoc/mongoc.h>
+
+#include <TestSuite.h>
+#include <mock_server/future-functions.h>
+#include <mock_server/mock-server.h>
+#include <test-conveniences.h>
+#include <test-libmongoc.h>
+
+
+/* The blackhole answers writes and cursors itself, without the test receiving the requests. */
+static void
+test_mock_server_blackhole(void)
+{
+   mock_server_t *server;
+   mongoc_client_t *client;
+   mongoc_collection_t *coll;
+   mock_server_blackhole_opts_t opts = {.batch_doc = tmp_bson("{'x': 1}"), .batch_size = 3, .n_getmores = 2};
+   const bson_t *docs[] = {tmp_bson("{'a': 1}"), tmp_bson("{'a': 2}"), tmp_bson("{'a': 3}")};
+   bson_t reply;
+   bson_error_t error;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_blackhole(server, &opts);
+   mock_server_run(server);
+
+   client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+   coll = mongoc_client_get_collection(client, "db", "coll");
+
+   /* Every document is reported inserted. */
+   ASSERT_OR_PRINT(mongoc_collection_insert_many(coll, docs, 3u, NULL, &reply, &error), error);
+   ASSERT_MATCH(&reply, "{'insertedCount': 3}");
+   bson_destroy(&reply);
+
+   /* Unacknowledged writes get no reply. */
+   ASSERT_OR_PRINT(
+      mongoc_collection_insert_one(coll, docs[0], tmp_bson("{'writeConcern': {'w': 0}}"), NULL, &error), error);
+
+   /* The first batch and two getMores, each with three copies of the batch document. */
+   {
+      mongoc_cursor_t *const cursor = mongoc_collection_find_with_opts(coll, tmp_bson("{}"), NULL, NULL);
+      const bson_t *doc;
+      int n = 0;
+
+      while (mongoc_cursor_next(cursor, &doc)) {
+         ASSERT_MATCH(doc, "{'x': 1}");
+         n++;
+      }
+
+      ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+      ASSERT_CMPINT(n, ==, 9);
+      mongoc_cursor_destroy(cursor);
+   }
+
+   /* Client bulk writes report each operation by kind. */
+   {
+      mongoc_bulkwrite_t *const bw = mongoc_client_bulkwrite_new(client);
+
+      ASSERT_OR_PRINT(mongoc_bulkwrite_append_insertone(bw, "db.coll", docs[0], NULL, &error), error);
+      ASSERT_OR_PRINT(mongoc_bulkwrite_append_insertone(bw, "db.coll", docs[1], NULL, &error), error);
+      ASSERT_OR_PRINT(mongoc_bulkwrite_append_deleteone(bw, "db.coll", docs[2], NULL, &error), error);
+
+      mongoc_bulkwritereturn_t ret = mongoc_bulkwrite_execute(bw, NULL);
+      ASSERT_NO_BULKWRITEEXCEPTION(ret);
+      ASSERT_CMPINT64(mongoc_bulkwriteresult_insertedcount(ret.res), ==, 2);
+      ASSERT_CMPINT64(mongoc_bulkwriteresult_deletedcount(ret.res), ==, 1);
+
+      mongoc_bulkwriteresult_destroy(ret.res);
+      mongoc_bulkwriteexception_destroy(ret.exc);
+      mongoc_bulkwrite_destroy(bw);
+   }
+
+   /* Other commands take the usual path. */
+   {
+      const bson_t *const ping = tmp_bson("{'ping': 1}");
+      future_t *const future = future_client_command_simple(client, "admin", ping, NULL, NULL, &error);
+      request_t *const request = mock_server_receives_msg(server, MONGOC_MSG_NONE, ping);
+
+      reply_to_request_with_ok_and_destroy(request);
+      ASSERT_OR_PRINT(future_get_bool(future), error);
+      future_destroy(future);
+   }
+
+   mongoc_collection_destroy(coll);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+}
+
+
+void
+test_mock_server_install(TestSuite *suite)
+{
+   TestSuite_AddMockServerTest(suite, "/mock_server/blackhole", test_mock_server_blackhole);
+}
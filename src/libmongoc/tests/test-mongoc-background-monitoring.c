@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <common-atomic-private.h>
 #include <common-string-private.h>
 #include <mongoc/mongoc-client-pool-private.h>
 #include <mongoc/mongoc-client-private.h>
@@ -28,6 +29,7 @@
 #include <mlib/time_point.h>
 
 #include <TestSuite.h>
+#include <mock_server/future-functions.h>
 #include <mock_server/mock-server.h>
 #include <test-conveniences.h>
 #include <test-libmongoc.h>
@@ -1077,6 +1079,144 @@ test_moretocome_cancel(void)
    tf_destroy(tf);
 }
 
+static void
+_multiplexed_heartbeat_succeeded(const mongoc_apm_server_heartbeat_succeeded_t *event)
+{
+   int *n_succeeded = mongoc_apm_server_heartbeat_succeeded_get_context(event);
+
+   mcommon_atomic_int_fetch_add(n_succeeded, 1, mcommon_memory_order_seq_cst);
+}
+
+/* One thread discovers and checks all servers with multiplexed monitoring. */
+static void
+test_multiplexed(void)
+{
+   mock_server_t *servers[2];
+   mongoc_uri_t *uri;
+   mongoc_apm_callbacks_t *callbacks;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+   mongoc_read_prefs_t *prefs;
+   mongoc_server_description_t *sd;
+   bson_error_t error;
+   int n_succeeded = 0;
+   int n_before_scan;
+
+   for (size_t i = 0u; i < 2u; i++) {
+      servers[i] = mock_server_new();
+      mock_server_run(servers[i]);
+   }
+
+   for (size_t i = 0u; i < 2u; i++) {
+      char *const hello = bson_strdup_printf("{'ok': 1,"
+                                             " 'isWritablePrimary': %s,"
+                                             " 'secondary': %s,"
+                                             " 'minWireVersion': %d,"
+                                             " 'maxWireVersion': %d,"
+                                             " 'setName': 'rs',"
+                                             " 'hosts': ['%s', '%s']}",
+                                             i == 0u ? "true" : "false",
+                                             i == 0u ? "false" : "true",
+                                             WIRE_VERSION_MIN,
+                                             WIRE_VERSION_MAX,
+                                             mock_server_get_host_and_port(servers[0]),
+                                             mock_server_get_host_and_port(servers[1]));
+      mock_server_auto_hello(servers[i], hello);
+      bson_free(hello);
+   }
+
+   /* Only the primary is in the seed list. */
+   uri = mongoc_uri_copy(mock_server_get_uri(servers[0]));
+   mongoc_uri_set_option_as_utf8(uri, MONGOC_URI_REPLICASET, "rs");
+   mongoc_uri_set_option_as_bool(uri, MONGOC_URI_MULTIPLEXEDMONITORING, true);
+   pool = test_framework_client_pool_new_from_uri(uri, NULL);
+   callbacks = mongoc_apm_callbacks_new();
+   mongoc_apm_set_server_heartbeat_succeeded_cb(callbacks, _multiplexed_heartbeat_succeeded);
+   mongoc_client_pool_set_apm_callbacks(pool, callbacks, &n_succeeded);
+   _mongoc_client_pool_get_topology(pool)->min_heartbeat_frequency_msec = FAST_HEARTBEAT_MS;
+   client = mongoc_client_pool_pop(pool);
+
+   /* The secondary is discovered and checked. */
+   prefs = mongoc_read_prefs_new(MONGOC_READ_SECONDARY);
+   sd = mongoc_client_select_server(client, false, prefs, &error);
+   ASSERT_OR_PRINT(sd, error);
+   ASSERT_CMPSTR(mongoc_server_description_host(sd)->host_and_port, mock_server_get_host_and_port(servers[1]));
+   mongoc_server_description_destroy(sd);
+
+   /* No thread per server. */
+   ASSERT_CMPSIZE_T(client->topology->server_monitors->items_len, ==, 0u);
+   ASSERT_CMPSIZE_T(client->topology->rtt_monitors->items_len, ==, 0u);
+
+   /* A requested scan checks both servers before the heartbeat is due. */
+   n_before_scan = mcommon_atomic_int_fetch(&n_succeeded, mcommon_memory_order_seq_cst);
+   _mongoc_topology_request_scan(client->topology);
+   WAIT_UNTIL(mcommon_atomic_int_fetch(&n_succeeded, mcommon_memory_order_seq_cst) >= n_before_scan + 2);
+
+   mongoc_read_prefs_destroy(prefs);
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mongoc_apm_callbacks_destroy(callbacks);
+   mongoc_uri_destroy(uri);
+   for (size_t i = 0u; i < 2u; i++) {
+      mock_server_destroy(servers[i]);
+   }
+}
+
+/* A server whose check fails is checked again at the next heartbeat rather than
+ * after the scanner's cooldown. */
+static void
+test_multiplexed_recheck_after_failure(void)
+{
+   mock_server_t *server;
+   mongoc_uri_t *uri;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+   future_t *future;
+   request_t *request;
+   mongoc_server_description_t *sd;
+   bson_error_t error;
+   int64_t failed_at;
+   char *hello;
+
+   server = mock_server_new();
+   mock_server_run(server);
+
+   uri = mongoc_uri_copy(mock_server_get_uri(server));
+   mongoc_uri_set_option_as_bool(uri, MONGOC_URI_MULTIPLEXEDMONITORING, true);
+   mongoc_uri_set_option_as_int32(uri, MONGOC_URI_HEARTBEATFREQUENCYMS, 500);
+   pool = test_framework_client_pool_new_from_uri(uri, NULL);
+   client = mongoc_client_pool_pop(pool);
+
+   future = future_client_select_server(client, true, NULL, &error);
+
+   /* The first check fails. */
+   request = mock_server_receives_any_hello(server);
+   reply_to_request_with_hang_up(request);
+   request_destroy(request);
+   failed_at = bson_get_monotonic_time();
+
+   /* The next heartbeat checks the server again, instead of skipping it until
+    * MONGOC_TOPOLOGY_COOLDOWN_MS has passed. */
+   request = mock_server_receives_any_hello(server);
+   ASSERT_CMPINT64(bson_get_monotonic_time() - failed_at, <, MONGOC_TOPOLOGY_COOLDOWN_MS * 1000);
+   hello = bson_strdup_printf("{'ok': 1, 'isWritablePrimary': true, 'minWireVersion': %d, 'maxWireVersion': %d}",
+                              WIRE_VERSION_MIN,
+                              WIRE_VERSION_MAX);
+   reply_to_request_simple(request, hello);
+   request_destroy(request);
+
+   sd = future_get_mongoc_server_description_ptr(future);
+   ASSERT_OR_PRINT(sd, error);
+   mongoc_server_description_destroy(sd);
+
+   future_destroy(future);
+   bson_free(hello);
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mongoc_uri_destroy(uri);
+   mock_server_destroy(server);
+}
+
 void
 test_monitoring_install(TestSuite *suite)
 {
@@ -1115,4 +1255,8 @@ test_monitoring_install(TestSuite *suite)
    TestSuite_AddMockServerTest(suite, "/server_monitor_thread/repeated_requestscan", test_repeated_requestscan);
 
    TestSuite_AddMockServerTest(suite, "/server_monitor_thread/sleep_after_scan", test_sleep_after_scan);
+
+   TestSuite_AddMockServerTest(suite, "/server_monitor_thread/multiplexed", test_multiplexed);
+   TestSuite_AddMockServerTest(
+      suite, "/server_monitor_thread/multiplexed/recheck_after_failure", test_multiplexed_recheck_after_failure);
 }
@@ -1026,6 +1026,85 @@ test_bulkwrite_unexpected_results(void)
    mock_server_destroy(server);
 }
 
+// test_bulkwrite_parallel_batches tests that batches of an unordered bulk write are sent concurrently with pooled
+// clients and the results are merged in model order.
+static void
+test_bulkwrite_parallel_batches(void)
+{
+   mock_server_t *server = mock_server_new();
+   mock_server_auto_hello(server,
+                          "{'ok': 1,"
+                          " 'isWritablePrimary': true,"
+                          " 'minWireVersion': %d,"
+                          " 'maxWireVersion': %d,"
+                          " 'maxWriteBatchSize': 1}", // Send each model in a separate batch.
+                          WIRE_VERSION_MIN,
+                          WIRE_VERSION_8_0);
+   mock_server_run(server);
+   mongoc_client_pool_t *pool = test_framework_client_pool_new_from_uri(mock_server_get_uri(server), NULL);
+   mongoc_client_t *client = mongoc_client_pool_pop(pool);
+   mongoc_bulkwrite_t *bw = mongoc_client_bulkwrite_new(client);
+
+   bson_error_t error;
+   bool ok = mongoc_bulkwrite_append_insertone(bw, "db.coll", tmp_bson("{'_id': 0}"), NULL, &error);
+   ASSERT_OR_PRINT(ok, error);
+   ok = mongoc_bulkwrite_append_insertone(bw, "db.coll", tmp_bson("{'_id': 1}"), NULL, &error);
+   ASSERT_OR_PRINT(ok, error);
+
+   mongoc_bulkwriteopts_t *bwo = mongoc_bulkwriteopts_new();
+   mongoc_bulkwriteopts_set_ordered(bwo, false);
+   mongoc_bulkwriteopts_set_verboseresults(bwo, true);
+   mongoc_bulkwriteopts_set_maxparallelbatches(bwo, 2);
+
+   future_t *fut = future_bulkwrite_execute(bw, bwo);
+
+   // Expect both batches to be sent before either is replied to.
+   request_t *reqs[2];
+   for (size_t i = 0; i < 2; i++) {
+      reqs[i] = mock_server_receives_msg(server,
+                                         MONGOC_MSG_NONE,
+                                         tmp_bson("{'bulkWrite': 1, 'ordered': false}"),
+                                         tmp_bson("{'ns': 'db.coll'}"), // "nsInfo"
+                                         tmp_bson("{'insert': 0}"));    // "ops"
+   }
+
+   // Reply to the second batch first.
+   for (size_t i = 2; i > 0; i--) {
+      reply_to_request_simple(reqs[i - 1], BSON_STR({
+                                 "ok" : 1,
+                                 "nInserted" : 1,
+                                 "nMatched" : 0,
+                                 "nModified" : 0,
+                                 "nDeleted" : 0,
+                                 "nUpserted" : 0,
+                                 "nErrors" : 0,
+                                 "cursor" : {
+                                    "id" : 0,
+                                    "firstBatch" : [ {"ok" : 1, "idx" : 0, "n" : 1} ],
+                                    "ns" : "admin.$cmd.bulkWrite"
+                                 }
+                              }));
+      request_destroy(reqs[i - 1]);
+   }
+
+   mongoc_bulkwritereturn_t bwr = future_get_mongoc_bulkwritereturn_t(fut);
+   ASSERT_NO_BULKWRITEEXCEPTION(bwr);
+   ASSERT(bwr.res);
+   ASSERT_CMPINT64(mongoc_bulkwriteresult_insertedcount(bwr.res), ==, 2);
+   const bson_t *insertResults = mongoc_bulkwriteresult_insertresults(bwr.res);
+   ASSERT(insertResults);
+   ASSERT_EQUAL_BSON(tmp_bson("{'0': {'insertedId': 0}, '1': {'insertedId': 1}}"), insertResults);
+
+   future_destroy(fut);
+   mongoc_bulkwriteexception_destroy(bwr.exc);
+   mongoc_bulkwriteresult_destroy(bwr.res);
+   mongoc_bulkwriteopts_destroy(bwo);
+   mongoc_bulkwrite_destroy(bw);
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mock_server_destroy(server);
+}
+
 void
 test_bulkwrite_install(TestSuite *suite)
 {
@@ -1154,4 +1233,5 @@ test_bulkwrite_install(TestSuite *suite)
 
    TestSuite_AddMockServerTest(suite, "/bulkwrite/missing_nModified", test_bulkwrite_missing_nModified);
    TestSuite_AddMockServerTest(suite, "/bulkwrite/unexpected_results", test_bulkwrite_unexpected_results);
+   TestSuite_AddMockServerTest(suite, "/bulkwrite/parallel_batches", test_bulkwrite_parallel_batches);
 }
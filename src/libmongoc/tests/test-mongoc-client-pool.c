@@ -1,6 +1,9 @@
 #include <common-macros-private.h> // BEGIN_IGNORE_DEPRECATIONS
+#include <common-oid-private.h>
 #include <mongoc/mongoc-client-pool-private.h>
 #include <mongoc/mongoc-client-private.h>
+#include <mongoc/mongoc-counters-private.h>
+#include <mongoc/mongoc-topology-private.h>
 #include <mongoc/mongoc-util-private.h>
 
 #include <mongoc/mongoc.h>
@@ -8,6 +11,9 @@
 #include <mlib/time_point.h>
 
 #include <TestSuite.h>
+#include <mock_server/future-functions.h>
+#include <mock_server/mock-server.h>
+#include <test-conveniences.h>
 #include <test-libmongoc.h>
 
 #include <stream-tracker.h>
@@ -601,6 +607,273 @@ test_mongoc_client_set_stream_initiator(void)
    mongoc_client_pool_destroy(pool);
 }
 
+/* Returns true if all @n clients of @pool are idle and connected to server 1
+ * with the current connection pool generation. */
+static bool
+_pool_is_warm(mongoc_client_pool_t *pool, size_t n)
+{
+   mongoc_client_t *clients[3] = {NULL};
+   bool warm = true;
+
+   BSON_ASSERT(n <= sizeof clients / sizeof clients[0]);
+
+   for (size_t i = 0u; i < n; i++) {
+      /* try_pop returns NULL if the warm-up worker holds a client */
+      if (!(clients[i] = mongoc_client_pool_try_pop(pool))) {
+         warm = false;
+         continue;
+      }
+
+      mongoc_server_stream_t *server_stream =
+         mongoc_cluster_stream_for_server(&clients[i]->cluster, 1, false /* reconnect_ok */, NULL, NULL, NULL);
+      if (!server_stream) {
+         warm = false;
+      }
+      mongoc_server_stream_cleanup(server_stream);
+   }
+
+   for (size_t i = 0u; i < n; i++) {
+      if (clients[i]) {
+         mongoc_client_pool_push(pool, clients[i]);
+      }
+   }
+
+   return warm;
+}
+
+static void
+test_mongoc_client_pool_min_size(void)
+{
+   mock_server_t *server;
+   mongoc_uri_t *uri;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MIN);
+   mock_server_run(server);
+   uri = mongoc_uri_copy(mock_server_get_uri(server));
+   mongoc_uri_set_option_as_int32(uri, MONGOC_URI_MINPOOLSIZE, 3);
+   mongoc_uri_set_option_as_int32(uri, MONGOC_URI_MAXPOOLSIZE, 3);
+   mongoc_uri_set_option_as_int32(uri, MONGOC_URI_HEARTBEATFREQUENCYMS, MONGOC_TOPOLOGY_MIN_HEARTBEAT_FREQUENCY_MS);
+   pool = test_framework_client_pool_new_from_uri(uri, NULL);
+
+   /* nothing is created until the first pop */
+   ASSERT_CMPSIZE_T(mongoc_client_pool_get_size(pool), ==, 0);
+   client = mongoc_client_pool_pop(pool);
+   mongoc_client_pool_push(pool, client);
+
+   /* the worker fills the pool with connected clients */
+   WAIT_UNTIL(_pool_is_warm(pool, 3));
+   ASSERT_CMPSIZE_T(mongoc_client_pool_get_size(pool), ==, 3);
+
+   /* clearing the connection pool invalidates the connections, and the worker
+    * reconnects the idle clients */
+   {
+      mongoc_topology_t *topology = _mongoc_client_pool_get_topology(pool);
+      mc_tpld_modification tdmod = mc_tpld_modify_begin(topology);
+      _mongoc_topology_description_clear_connection_pool(tdmod.new_td, 1, &kZeroObjectId);
+      mc_tpld_modify_commit(tdmod);
+   }
+
+   WAIT_UNTIL(_pool_is_warm(pool, 3));
+   ASSERT_CMPSIZE_T(mongoc_client_pool_get_size(pool), ==, 3);
+
+   mongoc_client_pool_destroy(pool);
+   mongoc_uri_destroy(uri);
+   mock_server_destroy(server);
+}
+
+static void
+test_mongoc_client_pool_server_wire_stats(void)
+{
+   mock_server_t *server;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+   mongoc_server_wire_stats_t **stats;
+   size_t n;
+   future_t *future;
+   request_t *request;
+   bson_error_t error;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_run(server);
+   pool = test_framework_client_pool_new_from_uri(mock_server_get_uri(server), NULL);
+   client = mongoc_client_pool_pop(pool);
+
+   /* nothing is counted until a connection is opened */
+   stats = mongoc_client_pool_get_server_wire_stats(pool, &n);
+   ASSERT(!stats);
+   ASSERT_CMPSIZE_T(n, ==, 0);
+
+   future = future_client_command_simple(client, "admin", tmp_bson("{'ping': 1}"), NULL, NULL, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+   reply_to_request_with_ok_and_destroy(request);
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+   future_destroy(future);
+
+   /* the connection handshake is counted too */
+   stats = mongoc_client_pool_get_server_wire_stats(pool, &n);
+   ASSERT_CMPSIZE_T(n, ==, 1);
+   ASSERT_CMPUINT32(mongoc_server_wire_stats_server_id(stats[0]), ==, 1);
+   ASSERT_CMPSTR(mongoc_server_wire_stats_host_and_port(stats[0]), mock_server_get_host_and_port(server));
+   ASSERT_CMPINT64(mongoc_server_wire_stats_messages_out(stats[0]), ==, 2);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_messages_in(stats[0]), ==, 2);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_bytes_out(stats[0]), >, 0);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_bytes_in(stats[0]), >, 0);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_compressed_bytes_out(stats[0]), ==, 0);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_compressed_bytes_in(stats[0]), ==, 0);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_in_flight_usec(stats[0]), >=, 0);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_errors(stats[0]), ==, 0);
+   mongoc_server_wire_stats_destroy_all(stats, n);
+
+   /* a hang up is sent but not answered */
+   future = future_client_command_simple(client, "admin", tmp_bson("{'ping': 1}"), NULL, NULL, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+   reply_to_request_with_hang_up(request);
+   ASSERT(!future_get_bool(future));
+   future_destroy(future);
+   request_destroy(request);
+
+   /* a pooled client reports the same totals as its pool */
+   stats = mongoc_client_get_server_wire_stats(client, &n);
+   ASSERT_CMPSIZE_T(n, ==, 1);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_messages_out(stats[0]), ==, 3);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_messages_in(stats[0]), ==, 2);
+   ASSERT_CMPINT64(mongoc_server_wire_stats_errors(stats[0]), ==, 1);
+   mongoc_server_wire_stats_destroy_all(stats, n);
+
+#ifdef MONGOC_ENABLE_SHM_COUNTERS
+   /* the totals are also exported in the server's shared memory slots, one per CPU */
+   {
+      const mongoc_wire_stats_slot_t *slots = _mongoc_counters_server(mock_server_get_host_and_port(server));
+      int64_t messages_out = 0;
+      int64_t errors = 0;
+
+      ASSERT(slots);
+      for (unsigned i = 0; i < _mongoc_get_cpu_count(); i++) {
+         messages_out += slots[i].values.messages_out;
+         errors += slots[i].values.errors;
+      }
+      ASSERT_CMPINT64(messages_out, >=, 3);
+      ASSERT_CMPINT64(errors, >=, 1);
+   }
+#endif
+
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mock_server_destroy(server);
+}
+
+static size_t
+_server_wire_stats_count(mongoc_client_pool_t *pool)
+{
+   size_t n;
+   mongoc_server_wire_stats_t **const stats = mongoc_client_pool_get_server_wire_stats(pool, &n);
+
+   mongoc_server_wire_stats_destroy_all(stats, n);
+
+   return n;
+}
+
+static void
+_ping_secondary(mongoc_client_t *client, mock_server_t *secondary)
+{
+   mongoc_read_prefs_t *const prefs = mongoc_read_prefs_new(MONGOC_READ_SECONDARY);
+   future_t *future;
+   request_t *request;
+   bson_error_t error;
+
+   future = future_client_command_simple(client, "admin", tmp_bson("{'ping': 1}"), prefs, NULL, &error);
+   request = mock_server_receives_msg(secondary, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+   reply_to_request_with_ok_and_destroy(request);
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+   future_destroy(future);
+   mongoc_read_prefs_destroy(prefs);
+}
+
+/* A server that leaves the topology leaves the snapshots too. */
+static void
+test_mongoc_client_pool_server_wire_stats_removed(void)
+{
+   mock_server_t *primary;
+   mock_server_t *secondary;
+   char *hello_with_secondary;
+   char *hello_without_secondary;
+   int hello_id;
+   mongoc_uri_t *uri;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+   mongoc_server_wire_stats_t **stats;
+   size_t n;
+   uint32_t old_id;
+
+   primary = mock_server_new();
+   secondary = mock_server_new();
+   mock_server_run(primary);
+   mock_server_run(secondary);
+
+   hello_with_secondary = bson_strdup_printf("{'ok': 1, 'isWritablePrimary': true, 'setName': 'rs',"
+                                             " 'minWireVersion': %d, 'maxWireVersion': %d, 'hosts': ['%s', '%s']}",
+                                             WIRE_VERSION_MIN,
+                                             WIRE_VERSION_MAX,
+                                             mock_server_get_host_and_port(primary),
+                                             mock_server_get_host_and_port(secondary));
+   hello_without_secondary = bson_strdup_printf("{'ok': 1, 'isWritablePrimary': true, 'setName': 'rs',"
+                                                " 'minWireVersion': %d, 'maxWireVersion': %d, 'hosts': ['%s']}",
+                                                WIRE_VERSION_MIN,
+                                                WIRE_VERSION_MAX,
+                                                mock_server_get_host_and_port(primary));
+   hello_id = mock_server_auto_hello(primary, hello_with_secondary);
+   mock_server_auto_hello(secondary,
+                          "{'ok': 1, 'isWritablePrimary': false, 'secondary': true, 'setName': 'rs',"
+                          " 'minWireVersion': %d, 'maxWireVersion': %d, 'hosts': ['%s', '%s']}",
+                          WIRE_VERSION_MIN,
+                          WIRE_VERSION_MAX,
+                          mock_server_get_host_and_port(primary),
+                          mock_server_get_host_and_port(secondary));
+
+   uri = mongoc_uri_copy(mock_server_get_uri(primary));
+   mongoc_uri_set_option_as_utf8(uri, MONGOC_URI_REPLICASET, "rs");
+   pool = test_framework_client_pool_new_from_uri(uri, NULL);
+   _mongoc_client_pool_get_topology(pool)->min_heartbeat_frequency_msec = 10;
+   client = mongoc_client_pool_pop(pool);
+
+   _ping_secondary(client, secondary);
+   stats = mongoc_client_pool_get_server_wire_stats(pool, &n);
+   ASSERT_CMPSIZE_T(n, ==, 1);
+   ASSERT_CMPSTR(mongoc_server_wire_stats_host_and_port(stats[0]), mock_server_get_host_and_port(secondary));
+   old_id = mongoc_server_wire_stats_server_id(stats[0]);
+   mongoc_server_wire_stats_destroy_all(stats, n);
+
+   /* the primary drops the secondary from the replica set */
+   mock_server_remove_autoresponder(primary, hello_id);
+   hello_id = mock_server_auto_hello(primary, hello_without_secondary);
+   _mongoc_topology_request_scan(_mongoc_client_pool_get_topology(pool));
+   WAIT_UNTIL(_server_wire_stats_count(pool) == 0);
+
+   /* and adds it back, under a new id: its totals start over */
+   mock_server_remove_autoresponder(primary, hello_id);
+   mock_server_auto_hello(primary, hello_with_secondary);
+   _mongoc_topology_request_scan(_mongoc_client_pool_get_topology(pool));
+   _ping_secondary(client, secondary);
+
+   stats = mongoc_client_pool_get_server_wire_stats(pool, &n);
+   ASSERT_CMPSIZE_T(n, ==, 1);
+   ASSERT_CMPSTR(mongoc_server_wire_stats_host_and_port(stats[0]), mock_server_get_host_and_port(secondary));
+   ASSERT_CMPUINT32(mongoc_server_wire_stats_server_id(stats[0]), !=, old_id);
+   /* the handshake of the new connection, and the ping */
+   ASSERT_CMPINT64(mongoc_server_wire_stats_messages_out(stats[0]), ==, 2);
+   mongoc_server_wire_stats_destroy_all(stats, n);
+
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mongoc_uri_destroy(uri);
+   bson_free(hello_without_secondary);
+   bson_free(hello_with_secondary);
+   mock_server_destroy(secondary);
+   mock_server_destroy(primary);
+}
+
 void
 test_client_pool_install(TestSuite *suite)
 {
@@ -608,6 +881,10 @@ test_client_pool_install(TestSuite *suite)
    TestSuite_Add(suite, "/ClientPool/try_pop", test_mongoc_client_pool_try_pop);
    TestSuite_Add(suite, "/ClientPool/pop_timeout", test_mongoc_client_pool_pop_timeout);
    TestSuite_Add(suite, "/ClientPool/min_size_zero", test_mongoc_client_pool_min_size_zero);
+   TestSuite_AddMockServerTest(suite, "/ClientPool/min_size", test_mongoc_client_pool_min_size);
+   TestSuite_AddMockServerTest(suite, "/ClientPool/server_wire_stats", test_mongoc_client_pool_server_wire_stats);
+   TestSuite_AddMockServerTest(
+      suite, "/ClientPool/server_wire_stats/removed", test_mongoc_client_pool_server_wire_stats_removed);
    TestSuite_Add(suite, "/ClientPool/set_max_size", test_mongoc_client_pool_set_max_size);
 
    TestSuite_Add(suite, "/ClientPool/handshake", test_mongoc_client_pool_handshake);
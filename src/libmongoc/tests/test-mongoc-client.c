@@ -18,6 +18,10 @@
 
 #include <mongoc/mongoc-ssl.h>
 #endif
+#ifdef MONGOC_ENABLE_SSL_OPENSSL
+#include <mongoc/mongoc-stream-tls-openssl-private.h>
+#include <mongoc/mongoc-stream-tls-private.h>
+#endif
 #include <common-macros-private.h> // BEGIN_IGNORE_DEPRECATIONS
 #include <common-oid-private.h>
 #include <mongoc/mongoc-util-private.h>
@@ -2767,6 +2771,145 @@ test_ssl_reconnect_pooled(void)
 {
    _test_ssl_reconnect(true);
 }
+
+
+#ifdef MONGOC_ENABLE_SSL_OPENSSL
+/* Checks that the connection to server 1 does I/O on the socket itself, so
+ * OpenSSL can offload to the kernel, and that the stream's send path agrees
+ * with what OpenSSL negotiated. */
+static void
+_assert_ktls_bio(mongoc_client_t *client, bool pooled)
+{
+   mongoc_stream_t *stream;
+   mongoc_stream_tls_openssl_t *openssl;
+
+   if (pooled) {
+      stream = ((mongoc_cluster_node_t *)mongoc_set_get(client->cluster.nodes, 1))->stream;
+   } else {
+      stream = mongoc_topology_scanner_get_node(client->topology->scanner, 1)->stream;
+   }
+
+   stream = mongoc_stream_get_tls_stream(stream);
+   ASSERT(stream);
+   openssl = (mongoc_stream_tls_openssl_t *)((mongoc_stream_tls_t *)stream)->ctx;
+
+#ifdef MONGOC_STREAM_TLS_OPENSSL_KTLS
+   {
+      SSL *ssl;
+      bool ktls_send;
+      bool ktls_recv;
+
+      ASSERT(openssl->socket_bio);
+
+      BIO_get_ssl(openssl->bio, &ssl);
+      ktls_send = BIO_get_ktls_send(SSL_get_wbio(ssl));
+      ktls_recv = BIO_get_ktls_recv(SSL_get_rbio(ssl));
+      ASSERT_CMPINT((int)openssl->ktls_send, ==, (int)ktls_send);
+
+      if (!ktls_send && !ktls_recv) {
+         MONGOC_DEBUG("kernel does not offload TLS, skipping offload assertion");
+      }
+   }
+#else
+   ASSERT(!openssl->socket_bio);
+   MONGOC_DEBUG("OpenSSL lacks kernel TLS support, skipping offload assertion");
+#endif
+}
+
+
+/* tlsEnableKTLS makes OpenSSL do I/O on the socket itself so it can offload
+ * encryption to the kernel. Without kernel support OpenSSL still encrypts in
+ * user space. Either way, messages spanning many TLS records must round-trip. */
+static void
+_test_ssl_ktls(bool pooled)
+{
+   const size_t payload_len = 1024u * 1024u;
+   mongoc_uri_t *uri;
+   mock_server_t *server;
+   mongoc_ssl_opt_t client_opts = {0};
+   mongoc_ssl_opt_t server_opts = {0};
+   mongoc_client_pool_t *pool = NULL;
+   mongoc_client_t *client;
+   bson_error_t error;
+   future_t *future;
+   request_t *request;
+   char *payload;
+   bson_t cmd = BSON_INITIALIZER;
+   bson_t reply_doc = BSON_INITIALIZER;
+   bson_t reply;
+
+   payload = bson_malloc(payload_len + 1u);
+   memset(payload, 'a', payload_len);
+   payload[payload_len] = '\0';
+
+   client_opts.ca_file = CERT_CA;
+
+   server_opts.weak_cert_validation = true;
+   server_opts.ca_file = CERT_CA;
+   server_opts.pem_file = CERT_SERVER;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MIN);
+   mock_server_set_ssl_opts(server, &server_opts);
+   mock_server_run(server);
+
+   uri = mongoc_uri_copy(mock_server_get_uri(server));
+   mongoc_uri_set_option_as_bool(uri, MONGOC_URI_TLSENABLEKTLS, true);
+
+   if (pooled) {
+      pool = test_framework_client_pool_new_from_uri(uri, NULL);
+      mongoc_client_pool_set_ssl_opts(pool, &client_opts);
+      client = mongoc_client_pool_pop(pool);
+   } else {
+      client = test_framework_client_new_from_uri(uri, NULL);
+      mongoc_client_set_ssl_opts(client, &client_opts);
+   }
+
+   BSON_APPEND_INT32(&cmd, "cmd", 1);
+   BSON_APPEND_UTF8(&cmd, "payload", payload);
+   future = future_client_command_simple(client, "db", &cmd, NULL, &reply, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'$db': 'db', 'cmd': 1}"));
+   ASSERT_CMPSTR(bson_lookup_utf8(request_get_doc(request, 0), "payload"), payload);
+
+   BSON_APPEND_INT32(&reply_doc, "ok", 1);
+   BSON_APPEND_UTF8(&reply_doc, "payload", payload);
+   reply_to_op_msg_request(request, MONGOC_OP_MSG_FLAG_NONE, &reply_doc);
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+   ASSERT_CMPSTR(bson_lookup_utf8(&reply, "payload"), payload);
+
+   bson_destroy(&reply);
+   future_destroy(future);
+   request_destroy(request);
+
+   _assert_ktls_bio(client, pooled);
+
+   if (pooled) {
+      mongoc_client_pool_push(pool, client);
+      mongoc_client_pool_destroy(pool);
+   } else {
+      mongoc_client_destroy(client);
+   }
+
+   bson_destroy(&reply_doc);
+   bson_destroy(&cmd);
+   bson_free(payload);
+   mongoc_uri_destroy(uri);
+   mock_server_destroy(server);
+}
+
+
+static void
+test_ssl_ktls_single(void)
+{
+   _test_ssl_ktls(false);
+}
+
+
+static void
+test_ssl_ktls_pooled(void)
+{
+   _test_ssl_ktls(true);
+}
+#endif /* MONGOC_ENABLE_SSL_OPENSSL */
 #endif /* OpenSSL or Secure Transport */
 
 
@@ -3913,6 +4056,10 @@ test_client_install(TestSuite *suite)
    TestSuite_AddMockServerTest(suite, "/Client/ssl_opts/copies_pooled", test_ssl_client_pooled_copies_args);
    TestSuite_AddMockServerTest(suite, "/Client/ssl/reconnect/single", test_ssl_reconnect_single);
    TestSuite_AddMockServerTest(suite, "/Client/ssl/reconnect/pooled", test_ssl_reconnect_pooled);
+#ifdef MONGOC_ENABLE_SSL_OPENSSL
+   TestSuite_AddMockServerTest(suite, "/Client/ssl/ktls/single", test_ssl_ktls_single);
+   TestSuite_AddMockServerTest(suite, "/Client/ssl/ktls/pooled", test_ssl_ktls_pooled);
+#endif
 
 #endif
 #else
@@ -1,8 +1,11 @@
+#include <mongoc/mongoc-apm-private.h>
 #include <mongoc/mongoc-bulk-operation-private.h>
 #include <mongoc/mongoc-collection-private.h>
 
 #include <mongoc/mongoc.h>
 
+#include <mlib/time_point.h>
+
 #include <json-test-operations.h>
 #include <json-test.h>
 #include <mock_server/future-functions.h>
@@ -1211,11 +1214,208 @@ test_service_id_not_loadbalanced(void)
 }
 
 
+typedef struct {
+   bool get_command;
+   int started;
+   bool deferred;
+   uint32_t n_documents;
+} lazy_payloads_ctx_t;
+
+
+static void
+lazy_payloads_started_cb(const mongoc_apm_command_started_t *event)
+{
+   lazy_payloads_ctx_t *const ctx = (lazy_payloads_ctx_t *)mongoc_apm_command_started_get_context(event);
+
+   if (0 != strcmp(mongoc_apm_command_started_get_command_name(event), "insert")) {
+      return;
+   }
+
+   ctx->started++;
+   /* The documents have not been copied before the callback asks. */
+   ctx->deferred = event->pending_payloads && !event->command_owned;
+
+   if (ctx->get_command) {
+      const bson_t *const command = mongoc_apm_command_started_get_command(event);
+      bson_iter_t iter;
+      bson_t documents;
+
+      ASSERT(bson_iter_init_find(&iter, command, "documents"));
+      bson_iter_bson(&iter, &documents);
+      ctx->n_documents = bson_count_keys(&documents);
+
+      /* Later calls return the same command without appending again. */
+      ASSERT(mongoc_apm_command_started_get_command(event) == command);
+   }
+}
+
+
+static void
+_test_lazy_payloads(bool get_command)
+{
+   lazy_payloads_ctx_t ctx = {.get_command = get_command};
+   const bson_t *docs[] = {tmp_bson("{'_id': 0}"), tmp_bson("{'_id': 1}"), tmp_bson("{'_id': 2}")};
+   bson_error_t error;
+
+   mock_server_t *const server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_run(server);
+
+   mongoc_client_t *const client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+   mongoc_apm_callbacks_t *const callbacks = mongoc_apm_callbacks_new();
+   mongoc_apm_set_command_started_cb(callbacks, lazy_payloads_started_cb);
+   mongoc_client_set_apm_callbacks(client, callbacks, &ctx);
+   mongoc_collection_t *const collection = mongoc_client_get_collection(client, "db", "coll");
+
+   future_t *const future = future_collection_insert_many(collection, docs, 3u, NULL, NULL, &error);
+   request_t *const request = mock_server_receives_msg(server,
+                                                       MONGOC_MSG_NONE,
+                                                       tmp_bson("{'insert': 'coll'}"),
+                                                       tmp_bson("{'_id': 0}"),
+                                                       tmp_bson("{'_id': 1}"),
+                                                       tmp_bson("{'_id': 2}"));
+   reply_to_request_simple(request, "{'ok': 1, 'n': 3}");
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+
+   ASSERT_CMPINT(ctx.started, ==, 1);
+   ASSERT(ctx.deferred);
+   ASSERT_CMPUINT32(ctx.n_documents, ==, get_command ? 3u : 0u);
+
+   future_destroy(future);
+   request_destroy(request);
+   mongoc_collection_destroy(collection);
+   mongoc_apm_callbacks_destroy(callbacks);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+}
+
+
+static void
+test_lazy_payloads(void)
+{
+   _test_lazy_payloads(false);
+   _test_lazy_payloads(true);
+}
+
+
+typedef struct {
+   int64_t find[MONGOC_APM_COMMAND_PHASE_COUNT];
+   int64_t get_more[MONGOC_APM_COMMAND_PHASE_COUNT];
+   int64_t failed[MONGOC_APM_COMMAND_PHASE_COUNT];
+   int64_t duration;
+} phases_ctx_t;
+
+
+static void
+phases_succeeded_cb(const mongoc_apm_command_succeeded_t *event)
+{
+   phases_ctx_t *const ctx = (phases_ctx_t *)mongoc_apm_command_succeeded_get_context(event);
+   const char *const name = mongoc_apm_command_succeeded_get_command_name(event);
+   int64_t *const phases = !strcmp(name, "find") ? ctx->find : ctx->get_more;
+
+   for (int i = 0; i < MONGOC_APM_COMMAND_PHASE_COUNT; i++) {
+      phases[i] = mongoc_apm_command_succeeded_get_phase_duration(event, (mongoc_apm_command_phase_t)i);
+   }
+
+   if (!strcmp(name, "find")) {
+      ctx->duration = mongoc_apm_command_succeeded_get_duration(event);
+   }
+
+   /* Out of range phases are reported as not measured. */
+   const mongoc_apm_command_phase_t invalid = (mongoc_apm_command_phase_t)MONGOC_APM_COMMAND_PHASE_COUNT;
+   ASSERT_CMPINT64(mongoc_apm_command_succeeded_get_phase_duration(event, invalid), ==, -1);
+}
+
+
+static void
+phases_failed_cb(const mongoc_apm_command_failed_t *event)
+{
+   phases_ctx_t *const ctx = (phases_ctx_t *)mongoc_apm_command_failed_get_context(event);
+
+   for (int i = 0; i < MONGOC_APM_COMMAND_PHASE_COUNT; i++) {
+      ctx->failed[i] = mongoc_apm_command_failed_get_phase_duration(event, (mongoc_apm_command_phase_t)i);
+   }
+}
+
+
+static void
+test_phases(void)
+{
+   phases_ctx_t ctx = {{0}};
+   const bson_t *doc;
+   bson_error_t error;
+   future_t *future;
+   request_t *request;
+
+   mock_server_t *const server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_run(server);
+
+   mongoc_client_t *const client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+   mongoc_apm_callbacks_t *const callbacks = mongoc_apm_callbacks_new();
+   mongoc_apm_set_command_succeeded_cb(callbacks, phases_succeeded_cb);
+   mongoc_apm_set_command_failed_cb(callbacks, phases_failed_cb);
+   mongoc_client_set_apm_callbacks(client, callbacks, &ctx);
+   mongoc_collection_t *const collection = mongoc_client_get_collection(client, "db", "coll");
+
+   mongoc_cursor_t *const cursor = mongoc_collection_find_with_opts(collection, tmp_bson("{}"), NULL, NULL);
+   future = future_cursor_next(cursor, &doc);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'find': 'coll'}"));
+   /* The server taking its time shows up as waiting for the first byte. */
+   mlib_sleep_for(50, ms);
+   reply_to_request_simple(request, "{'ok': 1, 'cursor': {'id': 123, 'ns': 'db.coll', 'firstBatch': [{}]}}");
+   ASSERT(future_get_bool(future));
+   future_destroy(future);
+   request_destroy(request);
+
+   for (int i = 0; i < MONGOC_APM_COMMAND_PHASE_COUNT; i++) {
+      if (i == MONGOC_APM_COMMAND_PHASE_COMPRESS || i == MONGOC_APM_COMMAND_PHASE_DECOMPRESS) {
+         /* No compressors are configured. */
+         ASSERT_CMPINT64(ctx.find[i], ==, -1);
+      } else {
+         ASSERT_CMPINT64(ctx.find[i], >=, 0);
+      }
+   }
+   ASSERT_CMPINT64(ctx.find[MONGOC_APM_COMMAND_PHASE_WAIT_FIRST_BYTE], >=, 40 * 1000);
+   ASSERT_CMPINT64(ctx.find[MONGOC_APM_COMMAND_PHASE_WAIT_FIRST_BYTE], <=, ctx.duration);
+
+   /* getMore reuses the cursor's server without selecting one. */
+   future = future_cursor_next(cursor, &doc);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'getMore': {'$numberLong': '123'}}"));
+   reply_to_request_simple(request, "{'ok': 1, 'cursor': {'id': 0, 'ns': 'db.coll', 'nextBatch': [{}]}}");
+   ASSERT(future_get_bool(future));
+   future_destroy(future);
+   request_destroy(request);
+
+   ASSERT_CMPINT64(ctx.get_more[MONGOC_APM_COMMAND_PHASE_SERVER_SELECTION], ==, -1);
+   ASSERT_CMPINT64(ctx.get_more[MONGOC_APM_COMMAND_PHASE_STREAM_CHECKOUT], >=, 0);
+   ASSERT_CMPINT64(ctx.get_more[MONGOC_APM_COMMAND_PHASE_PARSE_REPLY], >=, 0);
+
+   /* A command error still went through every phase. */
+   future = future_client_command_simple(client, "db", tmp_bson("{'ping': 1}"), NULL, NULL, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+   reply_to_request_simple(request, "{'ok': 0, 'code': 1, 'errmsg': 'failed'}");
+   ASSERT(!future_get_bool(future));
+   future_destroy(future);
+   request_destroy(request);
+
+   ASSERT_CMPINT64(ctx.failed[MONGOC_APM_COMMAND_PHASE_SERVER_SELECTION], >=, 0);
+   ASSERT_CMPINT64(ctx.failed[MONGOC_APM_COMMAND_PHASE_WRITE], >=, 0);
+   ASSERT_CMPINT64(ctx.failed[MONGOC_APM_COMMAND_PHASE_PARSE_REPLY], >=, 0);
+
+   mongoc_cursor_destroy(cursor);
+   mongoc_collection_destroy(collection);
+   mongoc_apm_callbacks_destroy(callbacks);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+}
+
+
 void
 test_command_monitoring_install(TestSuite *suite)
 {
    test_all_spec_tests(suite);
    TestSuite_AddMockServerTest(suite, "/command_monitoring/get_error", test_get_error);
+   TestSuite_AddMockServerTest(suite, "/command_monitoring/started/lazy_payloads", test_lazy_payloads);
+   TestSuite_AddMockServerTest(suite, "/command_monitoring/phases", test_phases);
    TestSuite_AddLive(suite, "/command_monitoring/set_callbacks/single", test_set_callbacks_single);
    TestSuite_AddLive(suite, "/command_monitoring/set_callbacks/pooled", test_set_callbacks_pooled);
    TestSuite_AddLive(suite, "/command_monitoring/set_callbacks/pooled_try_pop", test_set_callbacks_pooled_try_pop);
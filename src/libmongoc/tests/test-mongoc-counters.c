@@ -15,6 +15,7 @@
  */
 
 #include <common-atomic-private.h>
+#include <mongoc/mongoc-alloc-stats-private.h>
 #include <mongoc/mongoc-counters-private.h>
 #include <mongoc/mongoc-util-private.h>
 
@@ -27,6 +28,13 @@
 #include <test-conveniences.h>
 #include <test-libmongoc.h>
 
+#ifdef MONGOC_ENABLE_SSL_OPENSSL
+#include <mongoc/mongoc-ocsp-cache-private.h>
+
+#include <openssl/opensslv.h>
+#include <openssl/pem.h>
+#endif
+
 /* test statistics counters excluding OP_INSERT, OP_UPDATE, and OP_DELETE since
  * those were superseded by write commands in 2.6. */
 #ifdef MONGOC_ENABLE_SHM_COUNTERS
@@ -1447,8 +1455,510 @@ test_counters_auth_pooled_op_msg(void *context)
 }
 #endif
 
+#if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
+static void
+_tls_ping(mock_server_t *server, mongoc_client_t *client, bool server_replies)
+{
+   bson_error_t error;
+   future_t *future;
+   request_t *request;
+
+   future = future_client_command_simple(client, "admin", tmp_bson("{'ping': 1}"), NULL, NULL, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+
+   if (server_replies) {
+      reply_to_request_with_ok_and_destroy(request);
+      ASSERT_OR_PRINT(future_get_bool(future), error);
+   } else {
+      reply_to_request_with_hang_up(request);
+      request_destroy(request);
+      ASSERT(!future_get_bool(future));
+   }
+
+   future_destroy(future);
+}
+
+typedef enum {
+   TLS_RESUME_DEFAULT,
+   TLS_RESUME_DISABLED,
+   /* OCSP checks enabled, without a cached OCSP response for the server. */
+   TLS_RESUME_OCSP_UNKNOWN,
+   /* OCSP checks enabled, with a cached "good" OCSP response for the server. */
+   TLS_RESUME_OCSP_GOOD,
+} tls_resume_test_t;
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+static void
+_cache_good_ocsp_response(const char *cert_file, const char *issuer_file)
+{
+   FILE *fp;
+   X509 *cert;
+   X509 *issuer;
+   OCSP_CERTID *id;
+   ASN1_GENERALIZEDTIME *this_update;
+   ASN1_GENERALIZEDTIME *next_update;
+
+   ASSERT((fp = fopen(cert_file, "r")));
+   ASSERT((cert = PEM_read_X509(fp, NULL, NULL, NULL)));
+   fclose(fp);
+   ASSERT((fp = fopen(issuer_file, "r")));
+   ASSERT((issuer = PEM_read_X509(fp, NULL, NULL, NULL)));
+   fclose(fp);
+
+   ASSERT((id = OCSP_cert_to_id(NULL /* SHA1 */, cert, issuer)));
+   this_update = ASN1_GENERALIZEDTIME_set(NULL, time(NULL));
+   next_update = ASN1_GENERALIZEDTIME_set(NULL, time(NULL) + 999);
+   _mongoc_ocsp_cache_set_resp(id, V_OCSP_CERTSTATUS_GOOD, OCSP_REVOKED_STATUS_NOSTATUS, this_update, next_update);
+
+   ASN1_GENERALIZEDTIME_free(next_update);
+   ASN1_GENERALIZEDTIME_free(this_update);
+   OCSP_CERTID_free(id);
+   X509_free(issuer);
+   X509_free(cert);
+}
+
+static void
+_clear_ocsp_cache(void)
+{
+   _mongoc_ocsp_cache_cleanup();
+   _mongoc_ocsp_cache_init();
+}
+#endif
+
+static void
+_test_counters_tls_session_resumption(tls_resume_test_t test)
+{
+   mock_server_t *server;
+   mongoc_ssl_opt_t client_opts = {0};
+   mongoc_ssl_opt_t server_opts = {0};
+   mongoc_uri_t *uri;
+   mongoc_client_t *client;
+   const bool check_ocsp = test == TLS_RESUME_OCSP_UNKNOWN || test == TLS_RESUME_OCSP_GOOD;
+   const bool resumes = test == TLS_RESUME_DEFAULT || test == TLS_RESUME_OCSP_GOOD;
+
+   client_opts.ca_file = CERT_CA;
+
+   server_opts.weak_cert_validation = true;
+   server_opts.ca_file = CERT_CA;
+   server_opts.pem_file = CERT_SERVER;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MIN);
+   mock_server_set_ssl_opts(server, &server_opts);
+   mock_server_run(server);
+
+   uri = mongoc_uri_copy(mock_server_get_uri(server));
+   mongoc_uri_set_option_as_bool(uri, MONGOC_URI_TLSDISABLESESSIONRESUMPTION, test == TLS_RESUME_DISABLED);
+   if (check_ocsp) {
+      /* The mock server does not staple OCSP responses. */
+      mongoc_uri_set_option_as_bool(uri, MONGOC_URI_TLSDISABLEOCSPENDPOINTCHECK, true);
+   } else {
+      mongoc_uri_set_option_as_bool(uri, MONGOC_URI_TLSDISABLECERTIFICATEREVOCATIONCHECK, true);
+   }
+   client = test_framework_client_new_from_uri(uri, NULL);
+   mongoc_client_set_ssl_opts(client, &client_opts);
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+   if (check_ocsp) {
+      _clear_ocsp_cache();
+      if (test == TLS_RESUME_OCSP_GOOD) {
+         _cache_good_ocsp_response(CERT_SERVER, CERT_CA);
+      }
+   }
+#endif
+
+   reset_all_counters();
+
+   /* The first connection does a full handshake. */
+   _tls_ping(server, client, true);
+   DIFF_AND_RESET(tls_session_hits, ==, 0);
+   DIFF_AND_RESET(tls_session_misses, ==, test == TLS_RESUME_DISABLED ? 0 : 1);
+
+   capture_logs(true);
+   _tls_ping(server, client, false /* server hangs up */);
+   capture_logs(false);
+
+   /* The reconnect resumes the session issued on the first connection, unless
+    * the server's OCSP status has to be checked again. */
+   _tls_ping(server, client, true);
+   DIFF_AND_RESET(tls_session_hits, ==, resumes ? 1 : 0);
+   DIFF_AND_RESET(tls_session_misses, ==, test == TLS_RESUME_OCSP_UNKNOWN ? 1 : 0);
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+   if (check_ocsp) {
+      _clear_ocsp_cache();
+   }
+#endif
+
+   mongoc_client_destroy(client);
+   mongoc_uri_destroy(uri);
+   mock_server_destroy(server);
+}
+
+static void
+test_counters_tls_session_resumption(void)
+{
+   _test_counters_tls_session_resumption(TLS_RESUME_DEFAULT);
+}
+
+static void
+test_counters_tls_session_resumption_disabled(void)
+{
+   _test_counters_tls_session_resumption(TLS_RESUME_DISABLED);
+}
+
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+static void
+test_counters_tls_session_resumption_ocsp_unknown(void)
+{
+   _test_counters_tls_session_resumption(TLS_RESUME_OCSP_UNKNOWN);
+}
+
+static void
+test_counters_tls_session_resumption_ocsp_good(void)
+{
+   _test_counters_tls_session_resumption(TLS_RESUME_OCSP_GOOD);
+}
+#endif
+#endif
+
+static void
+test_counters_histogram_buckets(void)
+{
+   int64_t v;
+   uint32_t prev = 0;
+
+   ASSERT_CMPUINT32(_mongoc_histogram_bucket(-5), ==, 0u);
+   for (v = 0; v < MONGOC_HISTOGRAM_SUB_BUCKETS; v++) {
+      ASSERT_CMPUINT32(_mongoc_histogram_bucket(v), ==, (uint32_t)v);
+   }
+
+   /* 16 and 17 share a bucket once each power of two is split in eight. */
+   ASSERT_CMPUINT32(_mongoc_histogram_bucket(16), ==, _mongoc_histogram_bucket(17));
+   ASSERT_CMPUINT32(_mongoc_histogram_bucket(17), <, _mongoc_histogram_bucket(18));
+
+   /* Every value falls within its bucket's bounds, and buckets never go backwards. */
+   for (v = 1; v < (INT64_C(1) << 32); v += v / 7 + 1) {
+      const uint32_t idx = _mongoc_histogram_bucket(v);
+
+      ASSERT_CMPUINT32(idx, >=, prev);
+      ASSERT_CMPINT64(_mongoc_histogram_bucket_lower(idx), <=, v);
+      if (idx + 1 < MONGOC_HISTOGRAM_N_BUCKETS) {
+         ASSERT_CMPINT64(v, <, _mongoc_histogram_bucket_lower(idx + 1));
+      }
+      prev = idx;
+   }
+
+   /* Values beyond the covered range go into the last bucket. */
+   ASSERT_CMPUINT32(_mongoc_histogram_bucket((INT64_C(1) << 32) - 1), ==, MONGOC_HISTOGRAM_N_BUCKETS - 1);
+   ASSERT_CMPUINT32(_mongoc_histogram_bucket(INT64_MAX), ==, MONGOC_HISTOGRAM_N_BUCKETS - 1);
+}
+
+static void
+test_counters_histogram_latencies(void)
+{
+   mock_server_t *server;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+   bson_error_t error;
+   future_t *future;
+   request_t *request;
+
+   const int64_t find_before = mongoc_histogram_cmd_rtt_find_count();
+   const int64_t other_before = mongoc_histogram_cmd_rtt_other_count();
+   const int64_t selection_before = mongoc_histogram_server_selection_wait_count();
+   const int64_t checkout_before = mongoc_histogram_client_pools_checkout_count();
+   const int64_t connect_before = mongoc_histogram_connect_handshake_count();
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_run(server);
+
+   pool = test_framework_client_pool_new_from_uri(mock_server_get_uri(server), NULL);
+   client = mongoc_client_pool_pop(pool);
+   ASSERT_CMPINT64(mongoc_histogram_client_pools_checkout_count(), ==, checkout_before + 1);
+
+   future = future_client_command_simple(client, "db", tmp_bson("{'find': 'coll'}"), NULL, NULL, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'find': 'coll'}"));
+   reply_to_request_simple(request, "{'ok': 1, 'cursor': {'id': 0, 'ns': 'db.coll', 'firstBatch': []}}");
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+   future_destroy(future);
+   request_destroy(request);
+
+   future = future_client_command_simple(client, "admin", tmp_bson("{'ping': 1}"), NULL, NULL, &error);
+   request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+   reply_to_request_with_ok_and_destroy(request);
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+   future_destroy(future);
+
+   ASSERT_CMPINT64(mongoc_histogram_cmd_rtt_find_count(), ==, find_before + 1);
+   ASSERT_CMPINT64(mongoc_histogram_cmd_rtt_other_count(), ==, other_before + 1);
+   ASSERT_CMPINT64(mongoc_histogram_server_selection_wait_count(), >=, selection_before + 2);
+   /* Only the first command opens a connection. */
+   ASSERT_CMPINT64(mongoc_histogram_connect_handshake_count(), ==, connect_before + 1);
+
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mock_server_destroy(server);
+}
+
+/* Keeps the last structured log message with the given text. */
+typedef struct {
+   const char *message;
+   bson_t *last;
+} wait_log_t;
+
+static void
+_wait_log_handler(const mongoc_structured_log_entry_t *entry, void *user_data)
+{
+   wait_log_t *const log = user_data;
+
+   if (0 == strcmp(mongoc_structured_log_entry_get_message_string(entry), log->message)) {
+      bson_destroy(log->last);
+      log->last = mongoc_structured_log_entry_message_as_bson(entry);
+   }
+}
+
+static mongoc_structured_log_opts_t *
+_wait_log_opts(wait_log_t *log, mongoc_structured_log_component_t component)
+{
+   mongoc_structured_log_opts_t *const opts = mongoc_structured_log_opts_new();
+
+   ASSERT(mongoc_structured_log_opts_set_max_level_for_component(opts, component, MONGOC_STRUCTURED_LOG_LEVEL_TRACE));
+   mongoc_structured_log_opts_set_handler(opts, _wait_log_handler, log);
+
+   return opts;
+}
+
+static BSON_THREAD_FUN(_pool_pop_and_push, pool_void)
+{
+   mongoc_client_pool_t *const pool = pool_void;
+   mongoc_client_t *const client = mongoc_client_pool_pop(pool);
+
+   BSON_ASSERT(client);
+   mongoc_client_pool_push(pool, client);
+
+   BSON_THREAD_RETURN;
+}
+
+static void
+test_counters_pool_wait(void)
+{
+   mock_server_t *server;
+   mongoc_uri_t *uri;
+   mongoc_client_pool_t *pool;
+   mongoc_client_t *client;
+   mongoc_structured_log_opts_t *log_opts;
+   wait_log_t log = {.message = "Client pool checkout wait ended"};
+   bson_thread_t thread;
+
+   const int32_t timeouts_before = mongoc_counter_client_pools_timeouts_count();
+   const int32_t woken_before = mongoc_counter_client_pools_woken_count();
+   const int32_t wait_usec_before = mongoc_counter_client_pools_wait_usec_count();
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_run(server);
+
+   uri = mongoc_uri_copy(mock_server_get_uri(server));
+   mongoc_uri_set_option_as_int32(uri, MONGOC_URI_MAXPOOLSIZE, 1);
+   mongoc_uri_set_option_as_int32(uri, MONGOC_URI_WAITQUEUETIMEOUTMS, 50);
+   pool = test_framework_client_pool_new_from_uri(uri, NULL);
+   log_opts = _wait_log_opts(&log, MONGOC_STRUCTURED_LOG_COMPONENT_CONNECTION);
+   ASSERT(mongoc_client_pool_set_structured_log_opts(pool, log_opts));
+
+   client = mongoc_client_pool_pop(pool);
+   ASSERT(client);
+   ASSERT(!log.last);
+
+   /* The only client is checked out, so the next pop waits until waitQueueTimeoutMS. */
+   ASSERT(!mongoc_client_pool_pop(pool));
+   ASSERT_CMPINT32(mongoc_counter_client_pools_timeouts_count(), ==, timeouts_before + 1);
+   ASSERT_CMPINT32(mongoc_counter_client_pools_wait_usec_count(), >, wait_usec_before);
+   ASSERT_CMPINT32(mongoc_counter_client_pools_waiting_count(), ==, 0);
+   ASSERT(log.last);
+   ASSERT_MATCH(log.last,
+                "{'message': 'Client pool checkout wait ended', 'durationMS': {'$exists': true}, 'wakeups': 1, "
+                "'waitingThreads': 1, 'wokenBy': 'timeout', 'succeeded': false}");
+
+   /* Another thread waits until the client is returned. */
+   ASSERT_CMPINT(mcommon_thread_create(&thread, _pool_pop_and_push, pool), ==, 0);
+   WAIT_UNTIL(mongoc_counter_client_pools_waiting_count() == 1);
+   mongoc_client_pool_push(pool, client);
+   ASSERT_CMPINT(mcommon_thread_join(thread), ==, 0);
+   ASSERT_CMPINT32(mongoc_counter_client_pools_woken_count(), ==, woken_before + 1);
+   ASSERT_CMPINT32(mongoc_counter_client_pools_waiting_count(), ==, 0);
+   ASSERT_MATCH(log.last, "{'wokenBy': 'clientReturned', 'succeeded': true}");
+
+   bson_destroy(log.last);
+   mongoc_structured_log_opts_destroy(log_opts);
+   mongoc_client_pool_destroy(pool);
+   mongoc_uri_destroy(uri);
+   mock_server_destroy(server);
+}
+
+static void
+test_counters_server_selection_wait(void)
+{
+   mongoc_client_t *client;
+   mongoc_structured_log_opts_t *log_opts;
+   wait_log_t log = {.message = "Server selection wait ended"};
+   bson_error_t error;
+
+   const int32_t woken_before = mongoc_counter_server_selection_woken_count();
+   const int32_t rescans_before = mongoc_counter_server_selection_rescans_count();
+   const int32_t timeouts_before = mongoc_counter_server_selection_timeouts_count();
+
+   /* Nothing listens on the port. With serverSelectionTryOnce the selection
+    * fails after the initial scan, which is not a wait. */
+   client = test_framework_client_new("mongodb://localhost:12345/?serverSelectionTimeoutMS=100", NULL);
+   log_opts = _wait_log_opts(&log, MONGOC_STRUCTURED_LOG_COMPONENT_SERVER_SELECTION);
+   ASSERT(mongoc_client_set_structured_log_opts(client, log_opts));
+
+   ASSERT(!mongoc_client_select_server(client, false, NULL, &error));
+   ASSERT(!log.last);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_rescans_count(), ==, rescans_before);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_timeouts_count(), ==, timeouts_before);
+   mongoc_structured_log_opts_destroy(log_opts);
+   mongoc_client_destroy(client);
+
+   /* Without it, the selection waits for a rescan, but serverSelectionTimeoutMS
+    * expires before the minimum heartbeat frequency allows one. */
+   client = test_framework_client_new(
+      "mongodb://localhost:12345/?serverSelectionTimeoutMS=100&serverSelectionTryOnce=false", NULL);
+   log_opts = _wait_log_opts(&log, MONGOC_STRUCTURED_LOG_COMPONENT_SERVER_SELECTION);
+   ASSERT(mongoc_client_set_structured_log_opts(client, log_opts));
+
+   ASSERT(!mongoc_client_select_server(client, false, NULL, &error));
+   ASSERT_CMPINT32(mongoc_counter_server_selection_timeouts_count(), ==, timeouts_before + 1);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_rescans_count(), ==, rescans_before);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_woken_count(), ==, woken_before);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_waiting_count(), ==, 0);
+   ASSERT(log.last);
+   ASSERT_MATCH(log.last,
+                "{'message': 'Server selection wait ended', 'operation': 'mongoc_client_select_server', "
+                "'durationMS': {'$exists': true}, 'wakeups': 1, 'waitingThreads': 1, 'wokenBy': 'timeout'}");
+   bson_destroy(log.last);
+   log.last = NULL;
+   mongoc_structured_log_opts_destroy(log_opts);
+   mongoc_client_destroy(client);
+
+   /* With time for one rescan, that rescan ends the first wait. */
+   client = test_framework_client_new(
+      "mongodb://localhost:12345/?serverSelectionTimeoutMS=700&serverSelectionTryOnce=false", NULL);
+   log_opts = _wait_log_opts(&log, MONGOC_STRUCTURED_LOG_COMPONENT_SERVER_SELECTION);
+   ASSERT(mongoc_client_set_structured_log_opts(client, log_opts));
+
+   ASSERT(!mongoc_client_select_server(client, false, NULL, &error));
+   ASSERT_CMPINT32(mongoc_counter_server_selection_rescans_count(), ==, rescans_before + 1);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_timeouts_count(), ==, timeouts_before + 2);
+   ASSERT_CMPINT32(mongoc_counter_server_selection_waiting_count(), ==, 0);
+   ASSERT(log.last);
+   ASSERT_MATCH(log.last, "{'wakeups': 2, 'wokenBy': 'timeout'}");
+
+   bson_destroy(log.last);
+   mongoc_structured_log_opts_destroy(log_opts);
+   mongoc_client_destroy(client);
+}
+
+#endif
+
+/* Allocations are attributed to the innermost driver subsystem on the calling
+ * thread. */
+static void
+test_counters_alloc_stats(void)
+{
+   mock_server_t *server;
+   mongoc_client_t *client;
+   mongoc_collection_t *coll;
+   mongoc_bulk_operation_t *bulk;
+   mongoc_cursor_t *cursor;
+   const bson_t *doc;
+   bson_error_t error;
+   int64_t before[MONGOC_ALLOC_TAG_TOPOLOGY + 1];
+   int64_t count;
+   int64_t bytes;
+   int64_t reallocs;
+   mongoc_alloc_tag_t prev_tag;
+   char *mem;
+   const mock_server_blackhole_opts_t blackhole_opts = {.batch_doc = tmp_bson("{'x': 1}"), .batch_size = 2};
+
+   mongoc_alloc_stats_enable();
+   /* Enabling again keeps the same wrapper. */
+   mongoc_alloc_stats_enable();
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_blackhole(server, &blackhole_opts);
+   mock_server_run(server);
+
+   for (int i = MONGOC_ALLOC_TAG_BSON; i <= MONGOC_ALLOC_TAG_TOPOLOGY; i++) {
+      before[i] = mongoc_alloc_stats_get_count((mongoc_alloc_tag_t)i);
+   }
+
+   /* Allocations outside the driver. */
+   bson_free(bson_malloc(100));
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_count(MONGOC_ALLOC_TAG_BSON), >, before[MONGOC_ALLOC_TAG_BSON]);
+
+   /* Resizing a block is counted apart from allocations. Use a tag the mock
+    * server's threads do not. */
+   prev_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CURSOR);
+   count = mongoc_alloc_stats_get_count(MONGOC_ALLOC_TAG_CURSOR);
+   bytes = mongoc_alloc_stats_get_bytes(MONGOC_ALLOC_TAG_CURSOR);
+   reallocs = mongoc_alloc_stats_get_realloc_count(MONGOC_ALLOC_TAG_CURSOR);
+   mem = bson_realloc(NULL, 100);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_count(MONGOC_ALLOC_TAG_CURSOR), ==, count + 1);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_bytes(MONGOC_ALLOC_TAG_CURSOR), ==, bytes + 100);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_realloc_count(MONGOC_ALLOC_TAG_CURSOR), ==, reallocs);
+   mem = bson_realloc(mem, 200);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_count(MONGOC_ALLOC_TAG_CURSOR), ==, count + 1);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_bytes(MONGOC_ALLOC_TAG_CURSOR), ==, bytes + 100);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_realloc_count(MONGOC_ALLOC_TAG_CURSOR), ==, reallocs + 1);
+   bson_free(mem);
+   _mongoc_alloc_tag_pop(prev_tag);
+
+   client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+   coll = mongoc_client_get_collection(client, "db", "coll");
+
+   bulk = mongoc_collection_create_bulk_operation_with_opts(coll, NULL);
+   mongoc_bulk_operation_insert(bulk, tmp_bson("{'a': 1}"));
+   ASSERT_OR_PRINT(mongoc_bulk_operation_execute(bulk, NULL, &error), error);
+   mongoc_bulk_operation_destroy(bulk);
+
+   cursor = mongoc_collection_find_with_opts(coll, tmp_bson("{}"), NULL, NULL);
+   while (mongoc_cursor_next(cursor, &doc)) {
+   }
+   ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+   mongoc_cursor_destroy(cursor);
+
+   /* The single-threaded client scans the topology and runs commands on the
+    * calling thread. */
+   for (int i = MONGOC_ALLOC_TAG_CLUSTER; i <= MONGOC_ALLOC_TAG_TOPOLOGY; i++) {
+      if (i == MONGOC_ALLOC_TAG_APM) {
+         continue;
+      }
+      ASSERT_CMPINT64(mongoc_alloc_stats_get_count((mongoc_alloc_tag_t)i), >, before[i]);
+      ASSERT_CMPINT64(mongoc_alloc_stats_get_bytes((mongoc_alloc_tag_t)i), >, 0);
+   }
+
+#ifdef MONGOC_ENABLE_SHM_COUNTERS
+   ASSERT_CMPINT32(mongoc_counter_allocs_cursor_count(), >, 0);
+   ASSERT_CMPINT32(mongoc_counter_alloc_bytes_cursor_count(), >, 0);
 #endif
 
+   mongoc_alloc_stats_reset();
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_count(MONGOC_ALLOC_TAG_CURSOR), ==, 0);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_bytes(MONGOC_ALLOC_TAG_CURSOR), ==, 0);
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_realloc_count(MONGOC_ALLOC_TAG_CURSOR), ==, 0);
+
+   mongoc_collection_destroy(coll);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+
+   /* Later tests run with the allocator that was installed before. */
+   _mongoc_alloc_stats_disable();
+   prev_tag = _mongoc_alloc_tag_push(MONGOC_ALLOC_TAG_CURSOR);
+   bson_free(bson_malloc(100));
+   ASSERT_CMPINT64(mongoc_alloc_stats_get_count(MONGOC_ALLOC_TAG_CURSOR), ==, 0);
+   _mongoc_alloc_tag_pop(prev_tag);
+}
+
 void
 test_counters_install(TestSuite *suite)
 {
@@ -1541,5 +2051,21 @@ test_counters_install(TestSuite *suite)
                      test_framework_skip_if_max_wire_version_less_than_13,
                      test_framework_skip_if_not_replset);
 #endif // defined(MONGOC_ENABLE_SSL)
+#if defined(MONGOC_ENABLE_SSL_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x10100000L
+   TestSuite_AddMockServerTest(suite, "/counters/tls_session_resumption", test_counters_tls_session_resumption);
+   TestSuite_AddMockServerTest(
+      suite, "/counters/tls_session_resumption/disabled", test_counters_tls_session_resumption_disabled);
+#ifdef MONGOC_ENABLE_OCSP_OPENSSL
+   TestSuite_AddMockServerTest(
+      suite, "/counters/tls_session_resumption/ocsp_unknown", test_counters_tls_session_resumption_ocsp_unknown);
+   TestSuite_AddMockServerTest(
+      suite, "/counters/tls_session_resumption/ocsp_good", test_counters_tls_session_resumption_ocsp_good);
+#endif
+#endif
+   TestSuite_Add(suite, "/counters/histogram/buckets", test_counters_histogram_buckets);
+   TestSuite_AddMockServerTest(suite, "/counters/histogram/latencies", test_counters_histogram_latencies);
+   TestSuite_AddMockServerTest(suite, "/counters/wait/pool", test_counters_pool_wait);
+   TestSuite_AddMockServerTest(suite, "/counters/wait/server_selection", test_counters_server_selection_wait);
 #endif
+   TestSuite_AddMockServerTest(suite, "/counters/alloc_stats", test_counters_alloc_stats);
 }
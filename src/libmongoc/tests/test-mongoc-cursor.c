@@ -1950,6 +1950,209 @@ test_empty_final_batch(void)
 }
 
 
+static void
+test_cursor_next_columns(void)
+{
+   mock_server_t *server;
+   mongoc_client_t *client;
+   mongoc_cursor_t *cursor;
+   mongoc_cursor_columns_t *columns;
+   const bson_t *doc;
+   future_t *future;
+   request_t *request;
+   bson_error_t error;
+   size_t n_rows;
+   int64_t a[2];
+   uint8_t a_nulls[2];
+   double c[2];
+   uint8_t c_nulls[2];
+   const char *s[2];
+   uint32_t s_lens[2];
+   uint8_t s_nulls[2];
+   uint32_t t[2];
+   uint32_t i[2];
+   int64_t d[2];
+   uint8_t d_nulls[2];
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MIN);
+   mock_server_run(server);
+
+   client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+
+   // An open cursor requires a serverId.
+   uint32_t server_id;
+   {
+      mongoc_server_description_t *sd =
+         mongoc_client_select_server(client, false /* for_writes */, NULL /* prefs */, &error);
+      ASSERT_OR_PRINT(sd, error);
+      server_id = mongoc_server_description_id(sd);
+      mongoc_server_description_destroy(sd);
+   }
+
+   cursor = mongoc_cursor_new_from_command_reply_with_opts(
+      client,
+      bson_copy(tmp_bson("{'ok': 1,"
+                         " 'cursor': {"
+                         "    'id': {'$numberLong': '123'},"
+                         "    'ns': 'db.coll',"
+                         "    'firstBatch': ["
+                         "       {'a': 1, 'b': {'c': 1.5}, 's': 'xy', 't': {'$timestamp': {'t': 10, 'i': 2}},"
+                         "        'd': {'$date': {'$numberLong': '5'}}},"
+                         "       {'a': {'$numberLong': '7'}, 'b': {'c': 2}, 's': 1, 'a': 99},"
+                         "       {'b': 1}]}}")),
+      tmp_bson("{'serverId': %" PRIu32 "}", server_id));
+   ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+
+   columns = mongoc_cursor_columns_new(2);
+   mongoc_cursor_columns_add_int64(columns, "a", a, a_nulls);
+   mongoc_cursor_columns_add_double(columns, "b.c", c, c_nulls);
+   mongoc_cursor_columns_add_utf8(columns, "s", s, s_lens, s_nulls);
+   mongoc_cursor_columns_add_timestamp(columns, "t", t, i, NULL);
+   mongoc_cursor_columns_add_date_time(columns, "d", d, d_nulls);
+
+   // The first batch is decoded without sending a command.
+   ASSERT(mongoc_cursor_next_columns(cursor, columns, &n_rows));
+   ASSERT_CMPSIZE_T(n_rows, ==, 2);
+   ASSERT_CMPINT64(a[0], ==, 1);
+   ASSERT_CMPINT(a_nulls[0], ==, 0);
+   ASSERT_CMPDOUBLE(c[0], ==, 1.5);
+   ASSERT_CMPINT(c_nulls[0], ==, 0);
+   ASSERT_CMPUINT32(s_lens[0], ==, 2);
+   ASSERT_CMPSTR(s[0], "xy");
+   ASSERT_CMPINT(s_nulls[0], ==, 0);
+   ASSERT_CMPUINT32(t[0], ==, 10);
+   ASSERT_CMPUINT32(i[0], ==, 2);
+   ASSERT_CMPINT64(d[0], ==, 5);
+   ASSERT_CMPINT(d_nulls[0], ==, 0);
+
+   // The first of duplicate keys wins. Mismatched and missing fields are null.
+   ASSERT_CMPINT64(a[1], ==, 7);
+   ASSERT_CMPINT(a_nulls[1], ==, 0);
+   ASSERT_CMPDOUBLE(c[1], ==, 2.0);
+   ASSERT_CMPINT(c_nulls[1], ==, 0);
+   ASSERT(!s[1]);
+   ASSERT_CMPINT(s_nulls[1], ==, 1);
+   ASSERT_CMPUINT32(t[1], ==, 0);
+   ASSERT_CMPINT64(d[1], ==, 0);
+   ASSERT_CMPINT(d_nulls[1], ==, 1);
+
+   // The rest of the batch.
+   ASSERT(mongoc_cursor_next_columns(cursor, columns, &n_rows));
+   ASSERT_CMPSIZE_T(n_rows, ==, 1);
+   ASSERT_CMPINT(a_nulls[0], ==, 1);
+   ASSERT_CMPINT(c_nulls[0], ==, 1);
+
+   // Decoding columns and iterating documents can be mixed.
+   future = future_cursor_next(cursor, &doc);
+   request = mock_server_receives_msg(
+      server, MONGOC_MSG_NONE, tmp_bson("{'$db': 'db', 'getMore': {'$numberLong': '123'}, 'collection': 'coll'}"));
+   reply_to_op_msg_request(request,
+                           MONGOC_MSG_NONE,
+                           tmp_bson("{'ok': 1,"
+                                    " 'cursor': {"
+                                    "    'id': {'$numberLong': '0'},"
+                                    "    'ns': 'db.coll',"
+                                    "    'nextBatch': [{'a': 3}, {'a': 4}]}}"));
+   ASSERT(future_get_bool(future));
+   ASSERT_MATCH(doc, "{'a': 3}");
+   future_destroy(future);
+   request_destroy(request);
+
+   ASSERT(mongoc_cursor_next_columns(cursor, columns, &n_rows));
+   ASSERT_CMPSIZE_T(n_rows, ==, 1);
+   ASSERT_CMPINT64(a[0], ==, 4);
+
+   ASSERT(!mongoc_cursor_next_columns(cursor, columns, &n_rows));
+   ASSERT_CMPSIZE_T(n_rows, ==, 0);
+   ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+
+   mongoc_cursor_columns_destroy(columns);
+   mongoc_cursor_destroy(cursor);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+}
+
+
+static void
+test_cursor_next_batch(void)
+{
+   mock_server_t *server;
+   mongoc_client_t *client;
+   mongoc_cursor_t *cursor;
+   const bson_t *doc;
+   future_t *future;
+   request_t *request;
+   bson_error_t error;
+   const uint8_t *data;
+   size_t len;
+   size_t count;
+   bson_t batch;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MIN);
+   mock_server_run(server);
+
+   client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+
+   // An open cursor requires a serverId.
+   uint32_t server_id;
+   {
+      mongoc_server_description_t *sd =
+         mongoc_client_select_server(client, false /* for_writes */, NULL /* prefs */, &error);
+      ASSERT_OR_PRINT(sd, error);
+      server_id = mongoc_server_description_id(sd);
+      mongoc_server_description_destroy(sd);
+   }
+
+   cursor = mongoc_cursor_new_from_command_reply_with_opts(client,
+                                                           bson_copy(tmp_bson("{'ok': 1,"
+                                                                              " 'cursor': {"
+                                                                              "    'id': {'$numberLong': '123'},"
+                                                                              "    'ns': 'db.coll',"
+                                                                              "    'firstBatch': [{'a': 1}, {'a': 2}]"
+                                                                              " }"
+                                                                              "}")),
+                                                           tmp_bson("{'serverId': %" PRIu32 "}", server_id));
+   ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+
+   // An unread batch is returned as the array in the reply.
+   ASSERT(mongoc_cursor_next_batch(cursor, &data, &len, &count));
+   ASSERT_CMPSIZE_T(count, ==, 2);
+   ASSERT(bson_init_static(&batch, data, len));
+   ASSERT_MATCH(&batch, "{'0': {'a': 1}, '1': {'a': 2}}");
+
+   // Read one document of the next batch, then the rest of it.
+   future = future_cursor_next(cursor, &doc);
+   request = mock_server_receives_msg(
+      server, MONGOC_MSG_NONE, tmp_bson("{'$db': 'db', 'getMore': {'$numberLong': '123'}, 'collection': 'coll'}"));
+   reply_to_op_msg_request(request,
+                           MONGOC_MSG_NONE,
+                           tmp_bson("{'ok': 1,"
+                                    " 'cursor': {"
+                                    "    'id': {'$numberLong': '0'},"
+                                    "    'ns': 'db.coll',"
+                                    "    'nextBatch': [{'a': 3}, {'a': 4}, {'a': 5}]}}"));
+   ASSERT(future_get_bool(future));
+   ASSERT_MATCH(doc, "{'a': 3}");
+   future_destroy(future);
+   request_destroy(request);
+
+   ASSERT(mongoc_cursor_next_batch(cursor, &data, &len, &count));
+   ASSERT_CMPSIZE_T(count, ==, 2);
+   ASSERT(bson_init_static(&batch, data, len));
+   ASSERT_CMPINT(bson_count_keys(&batch), ==, 2);
+   ASSERT_MATCH(&batch, "{'0': {'a': 4}, '1': {'a': 5}}");
+
+   ASSERT(!mongoc_cursor_next_batch(cursor, &data, &len, &count));
+   ASSERT_CMPSIZE_T(count, ==, 0);
+   ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+   ASSERT(!mongoc_cursor_next(cursor, &doc));
+
+   mongoc_cursor_destroy(cursor);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+}
+
+
 static void
 test_error_document_query(void)
 {
@@ -2556,6 +2759,8 @@ test_cursor_install(TestSuite *suite)
    TestSuite_AddMockServerTest(suite, "/Cursor/n_return/find_cmd/with_opts", test_n_return_find_cmd_with_opts);
    TestSuite_AddLive(suite, "/Cursor/empty_final_batch_live", test_empty_final_batch_live);
    TestSuite_AddMockServerTest(suite, "/Cursor/empty_final_batch", test_empty_final_batch);
+   TestSuite_AddMockServerTest(suite, "/Cursor/next_columns", test_cursor_next_columns);
+   TestSuite_AddMockServerTest(suite, "/Cursor/next_batch", test_cursor_next_batch);
    TestSuite_AddLive(suite, "/Cursor/error_document/query", test_error_document_query);
    TestSuite_AddLive(suite, "/Cursor/error_document/getmore", test_error_document_getmore);
    TestSuite_AddLive(suite, "/Cursor/find_error/is_alive", test_find_error_is_alive);
@@ -638,6 +638,82 @@ _mock_test_exhaust(bool pooled, exhaust_error_when_t error_when, exhaust_error_t
    mock_server_destroy(server);
 }
 
+// Test that the server streams batches of an exhaust aggregate without further "getMore" requests.
+static void
+test_exhaust_aggregate_streams_batches(void)
+{
+   mock_server_t *server;
+   mongoc_client_t *client;
+   mongoc_collection_t *collection;
+   mongoc_cursor_t *cursor;
+   const bson_t *doc;
+   future_t *future;
+   request_t *request;
+   bson_error_t error;
+
+   server = mock_server_with_auto_hello(WIRE_VERSION_MIN);
+   mock_server_run(server);
+
+   client = test_framework_client_new_from_uri(mock_server_get_uri(server), NULL);
+   collection = mongoc_client_get_collection(client, "db", "test");
+   cursor = mongoc_collection_aggregate(
+      collection, MONGOC_QUERY_NONE, tmp_bson("[{'$match': {}}]"), tmp_bson("{'exhaust': true}"), NULL);
+
+   future = future_cursor_next(cursor, &doc);
+   // "exhaust" is not sent as a command field.
+   request = mock_server_receives_msg(server,
+                                      MONGOC_OP_MSG_FLAG_EXHAUST_ALLOWED,
+                                      tmp_bson(BSON_STR({"aggregate" : "test", "exhaust" : {"$exists" : false}})));
+   reply_to_op_msg_request(request,
+                           MONGOC_OP_MSG_FLAG_NONE,
+                           tmp_bson("{'ok': 1,"
+                                    " 'cursor': {"
+                                    "    'id': {'$numberLong': '123'},"
+                                    "    'ns': 'db.test',"
+                                    "    'firstBatch': [{'a': 1}]}}"));
+   ASSERT(future_get_bool(future));
+   ASSERT_MATCH(doc, "{'a': 1}");
+   future_destroy(future);
+   request_destroy(request);
+
+   future = future_cursor_next(cursor, &doc);
+   request = mock_server_receives_msg(
+      server, MONGOC_OP_MSG_FLAG_EXHAUST_ALLOWED, tmp_bson(BSON_STR({"getMore" : {"$numberLong" : "123"}})));
+   reply_to_op_msg_request(request,
+                           MONGOC_OP_MSG_FLAG_MORE_TO_COME,
+                           tmp_bson("{'ok': 1,"
+                                    " 'cursor': {"
+                                    "    'id': {'$numberLong': '123'},"
+                                    "    'ns': 'db.test',"
+                                    "    'nextBatch': [{'a': 2}]}}"));
+   ASSERT(future_get_bool(future));
+   ASSERT_MATCH(doc, "{'a': 2}");
+   future_destroy(future);
+
+   // The next batch is read without sending another "getMore".
+   future = future_cursor_next(cursor, &doc);
+   reply_to_op_msg_request(request,
+                           MONGOC_OP_MSG_FLAG_NONE,
+                           tmp_bson("{'ok': 1,"
+                                    " 'cursor': {"
+                                    "    'id': {'$numberLong': '0'},"
+                                    "    'ns': 'db.test',"
+                                    "    'nextBatch': [{'a': 3}]}}"));
+   ASSERT(future_get_bool(future));
+   ASSERT_MATCH(doc, "{'a': 3}");
+   future_destroy(future);
+   request_destroy(request);
+
+   ASSERT(!mongoc_cursor_next(cursor, &doc));
+   ASSERT_OR_PRINT(!mongoc_cursor_error(cursor, &error), error);
+   ASSERT(!client->in_exhaust);
+
+   mongoc_cursor_destroy(cursor);
+   mongoc_collection_destroy(collection);
+   mongoc_client_destroy(client);
+   mock_server_destroy(server);
+}
+
 static void
 test_exhaust_network_err_1st_batch_single(void)
 {
@@ -805,6 +881,7 @@ test_exhaust_install(TestSuite *suite)
                      NULL,
                      NULL,
                      skip_if_no_exhaust);
+   TestSuite_AddMockServerTest(suite, "/Client/exhaust_cursor/aggregate", test_exhaust_aggregate_streams_batches);
    TestSuite_AddMockServerTest(
       suite, "/Client/exhaust_cursor/err/network/1st_batch/single", test_exhaust_network_err_1st_batch_single);
    TestSuite_AddMockServerTest(
@@ -166,12 +166,93 @@ test_mongoc_cache_remove_expired_cert(void)
    CLEAR_CACHE;
 }
 
+static void
+test_mongoc_cache_size_bound(void)
+{
+   ASN1_GENERALIZEDTIME *this_update_in, *next_update_in;
+   ASN1_GENERALIZEDTIME *this_update_out, *next_update_out;
+   int status = V_OCSP_CERTSTATUS_GOOD, reason = OCSP_REVOKED_STATUS_NOSTATUS;
+   int s, r;
+   OCSP_CERTID *id;
+
+   CLEAR_CACHE;
+
+   next_update_in = ASN1_GENERALIZEDTIME_set(NULL, time(NULL) + 999);
+   this_update_in = ASN1_GENERALIZEDTIME_set(NULL, time(NULL));
+   for (int i = 0; i < MONGOC_OCSP_CACHE_MAX_ENTRIES + 10; i++) {
+      id = create_cert_id(i);
+      _mongoc_ocsp_cache_set_resp(id, status, reason, this_update_in, next_update_in);
+      OCSP_CERTID_free(id);
+   }
+
+   BSON_ASSERT(_mongoc_ocsp_cache_length() == MONGOC_OCSP_CACHE_MAX_ENTRIES);
+
+   /* The oldest entries were evicted to make room. */
+   id = create_cert_id(0);
+   BSON_ASSERT(!_mongoc_ocsp_cache_get_status(id, &s, &r, &this_update_out, &next_update_out));
+   OCSP_CERTID_free(id);
+
+   id = create_cert_id(MONGOC_OCSP_CACHE_MAX_ENTRIES + 9);
+   BSON_ASSERT(_mongoc_ocsp_cache_get_status(id, &s, &r, &this_update_out, &next_update_out));
+   OCSP_CERTID_free(id);
+
+   CLEAR_CACHE;
+   ASN1_GENERALIZEDTIME_free(this_update_in);
+   ASN1_GENERALIZEDTIME_free(next_update_in);
+}
+
+static void
+test_mongoc_cache_sweep_expired(void)
+{
+   ASN1_GENERALIZEDTIME *this_update_in, *next_update_in, *expired_in;
+   ASN1_GENERALIZEDTIME *this_update_out, *next_update_out;
+   int status = V_OCSP_CERTSTATUS_GOOD, reason = OCSP_REVOKED_STATUS_NOSTATUS;
+   const int expired_count = 10;
+   int s, r;
+
+   CLEAR_CACHE;
+
+   this_update_in = ASN1_GENERALIZEDTIME_set(NULL, time(NULL) - 999);
+   next_update_in = ASN1_GENERALIZEDTIME_set(NULL, time(NULL) + 999);
+   expired_in = ASN1_GENERALIZEDTIME_set(NULL, time(NULL) - 1);
+
+   /* Fill the cache, with the oldest entries already expired. */
+   for (int i = 0; i < MONGOC_OCSP_CACHE_MAX_ENTRIES; i++) {
+      OCSP_CERTID *id = create_cert_id(i);
+      _mongoc_ocsp_cache_set_resp(id, status, reason, this_update_in, i < expired_count ? expired_in : next_update_in);
+      OCSP_CERTID_free(id);
+   }
+
+   BSON_ASSERT(_mongoc_ocsp_cache_length() == MONGOC_OCSP_CACHE_MAX_ENTRIES);
+
+   /* Inserting into a full cache sweeps the expired entries instead of
+    * evicting a valid one. */
+   OCSP_CERTID *id = create_cert_id(MONGOC_OCSP_CACHE_MAX_ENTRIES);
+   _mongoc_ocsp_cache_set_resp(id, status, reason, this_update_in, next_update_in);
+   OCSP_CERTID_free(id);
+
+   BSON_ASSERT(_mongoc_ocsp_cache_length() == MONGOC_OCSP_CACHE_MAX_ENTRIES - expired_count + 1);
+
+   for (int i = expired_count; i <= MONGOC_OCSP_CACHE_MAX_ENTRIES; i++) {
+      id = create_cert_id(i);
+      BSON_ASSERT(_mongoc_ocsp_cache_get_status(id, &s, &r, &this_update_out, &next_update_out));
+      OCSP_CERTID_free(id);
+   }
+
+   CLEAR_CACHE;
+   ASN1_GENERALIZEDTIME_free(this_update_in);
+   ASN1_GENERALIZEDTIME_free(next_update_in);
+   ASN1_GENERALIZEDTIME_free(expired_in);
+}
+
 void
 test_ocsp_cache_install(TestSuite *suite)
 {
    TestSuite_Add(suite, "/OCSPCache/insert", test_mongoc_cache_insert);
    TestSuite_Add(suite, "/OCSPCache/update", test_mongoc_cache_update);
    TestSuite_Add(suite, "/OCSPCache/remove_expired_cert", test_mongoc_cache_remove_expired_cert);
+   TestSuite_Add(suite, "/OCSPCache/size_bound", test_mongoc_cache_size_bound);
+   TestSuite_Add(suite, "/OCSPCache/sweep_expired", test_mongoc_cache_sweep_expired);
 }
 #else
 extern int no_mongoc_ocsp;
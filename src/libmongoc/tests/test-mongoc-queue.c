@@ -50,9 +50,35 @@ test_mongoc_queue_pop_tail(void)
 }
 
 
+static void
+test_mongoc_queue_remove(void)
+{
+   mongoc_queue_t q = MONGOC_QUEUE_INITIALIZER;
+
+   ASSERT(!_mongoc_queue_remove(&q, (void *)1));
+
+   _mongoc_queue_push_tail(&q, (void *)1);
+   _mongoc_queue_push_tail(&q, (void *)2);
+   _mongoc_queue_push_tail(&q, (void *)3);
+
+   /* middle, tail, then head */
+   ASSERT(_mongoc_queue_remove(&q, (void *)2));
+   ASSERT(!_mongoc_queue_remove(&q, (void *)2));
+   ASSERT_CMPUINT32(_mongoc_queue_get_length(&q), ==, (uint32_t)2);
+   ASSERT(_mongoc_queue_remove(&q, (void *)3));
+   _mongoc_queue_push_tail(&q, (void *)4);
+   ASSERT_CMPVOID(_mongoc_queue_pop_tail(&q), ==, (void *)4);
+   ASSERT(_mongoc_queue_remove(&q, (void *)1));
+   ASSERT_CMPUINT32(_mongoc_queue_get_length(&q), ==, (uint32_t)0);
+   ASSERT_CMPVOID(_mongoc_queue_pop_head(&q), ==, (void *)NULL);
+   ASSERT_CMPVOID(_mongoc_queue_pop_tail(&q), ==, (void *)NULL);
+}
+
+
 void
 test_queue_install(TestSuite *suite)
 {
    TestSuite_Add(suite, "/Queue/basic", test_mongoc_queue_basic);
    TestSuite_Add(suite, "/Queue/pop_tail", test_mongoc_queue_pop_tail);
+   TestSuite_Add(suite, "/Queue/remove", test_mongoc_queue_remove);
 }
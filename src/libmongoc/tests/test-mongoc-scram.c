@@ -162,6 +162,118 @@ test_mongoc_utf8_to_unicode(void)
    ASSERT_CMPUINT32(_mongoc_utf8_get_first_code_point("🌂", 4), ==, 0x1F302);
 }
 
+/* Fills scram with pre-secrets derived from `id` and secrets derived from
+ * the pre-secrets, so any cache hit can be checked for consistency. */
+static void
+_scram_cache_test_fill(mongoc_scram_t *scram, mongoc_crypto_hash_algorithm_t algo, const char *prefix, uint32_t id)
+{
+   _mongoc_scram_init(scram, algo);
+   bson_snprintf(scram->hashed_password, sizeof(scram->hashed_password), "%s%" PRIu32, prefix, id);
+   memset(scram->decoded_salt, (int)(id % 251u), sizeof(scram->decoded_salt));
+   scram->iterations = 4096u + id;
+   memset(scram->client_key, (int)(id % 253u) + 1, sizeof(scram->client_key));
+   memset(scram->stored_key, (int)(id % 239u) + 1, sizeof(scram->stored_key));
+   memset(scram->server_key, (int)(id % 241u) + 1, sizeof(scram->server_key));
+   memset(scram->salted_password, (int)(id % 233u) + 1, sizeof(scram->salted_password));
+}
+
+static bool
+_scram_cache_test_hit_is_consistent(const mongoc_scram_cache_entry_t *cache, const mongoc_scram_t *scram)
+{
+   return !memcmp(cache->client_key, scram->client_key, sizeof(cache->client_key)) &&
+          !memcmp(cache->stored_key, scram->stored_key, sizeof(cache->stored_key)) &&
+          !memcmp(cache->server_key, scram->server_key, sizeof(cache->server_key)) &&
+          !memcmp(cache->salted_password, scram->salted_password, sizeof(cache->salted_password));
+}
+
+static void
+test_mongoc_scram_cache_lookup(void)
+{
+   mongoc_scram_t sha256;
+   mongoc_scram_t sha1;
+   mongoc_scram_cache_entry_t cache;
+
+   _scram_cache_test_fill(&sha256, MONGOC_CRYPTO_ALGORITHM_SHA_256, "lookup", 1);
+   _scram_cache_test_fill(&sha1, MONGOC_CRYPTO_ALGORITHM_SHA_1, "lookup", 1);
+
+   ASSERT(!_mongoc_scram_cache_has_presecrets(&cache, &sha256));
+   _mongoc_scram_update_cache(&sha256);
+   ASSERT(_mongoc_scram_cache_has_presecrets(&cache, &sha256));
+   ASSERT(_scram_cache_test_hit_is_consistent(&cache, &sha256));
+
+   /* Identical pre-secrets under a different mechanism must not match. */
+   ASSERT(!_mongoc_scram_cache_has_presecrets(&cache, &sha1));
+
+   /* Neither may a different iteration count. */
+   sha256.iterations++;
+   ASSERT(!_mongoc_scram_cache_has_presecrets(&cache, &sha256));
+
+   _mongoc_scram_destroy(&sha256);
+   _mongoc_scram_destroy(&sha1);
+}
+
+static void
+test_mongoc_scram_cache_eviction(void)
+{
+   mongoc_scram_t scram;
+   mongoc_scram_cache_entry_t cache;
+
+   /* Overfill the cache: each newly inserted entry is immediately found. */
+   for (uint32_t i = 0; i < 4u * MONGOC_SCRAM_CACHE_SIZE; i++) {
+      _scram_cache_test_fill(&scram, MONGOC_CRYPTO_ALGORITHM_SHA_256, "eviction", i);
+      _mongoc_scram_update_cache(&scram);
+      ASSERT(_mongoc_scram_cache_has_presecrets(&cache, &scram));
+      ASSERT(_scram_cache_test_hit_is_consistent(&cache, &scram));
+      _mongoc_scram_destroy(&scram);
+   }
+}
+
+enum {
+   SCRAM_CACHE_CONCURRENT_THREADS = 4,
+   SCRAM_CACHE_CONCURRENT_ITERATIONS = 2000,
+};
+
+static BSON_THREAD_FUN(_scram_cache_concurrent_thread, seed_ptr)
+{
+   const uint32_t seed = *(uint32_t *)seed_ptr;
+   mongoc_scram_t scram;
+   mongoc_scram_cache_entry_t cache;
+
+   for (uint32_t i = 0; i < SCRAM_CACHE_CONCURRENT_ITERATIONS; i++) {
+      /* More distinct keys than slots so that writers keep evicting. */
+      const uint32_t id = (i * 7u + seed) % (2u * MONGOC_SCRAM_CACHE_SIZE);
+
+      _scram_cache_test_fill(&scram, MONGOC_CRYPTO_ALGORITHM_SHA_256, "concurrent", id);
+      if (_mongoc_scram_cache_has_presecrets(&cache, &scram)) {
+         /* A hit must never observe a partially written slot. */
+         ASSERT(_scram_cache_test_hit_is_consistent(&cache, &scram));
+      } else {
+         _mongoc_scram_update_cache(&scram);
+      }
+      _mongoc_scram_destroy(&scram);
+   }
+
+   BSON_THREAD_RETURN;
+}
+
+static void
+test_mongoc_scram_cache_concurrent(void)
+{
+   bson_thread_t threads[SCRAM_CACHE_CONCURRENT_THREADS];
+   uint32_t seeds[SCRAM_CACHE_CONCURRENT_THREADS];
+
+   for (int i = 0; i < SCRAM_CACHE_CONCURRENT_THREADS; i++) {
+      seeds[i] = (uint32_t)i * 13u;
+      int rc = mcommon_thread_create(&threads[i], _scram_cache_concurrent_thread, &seeds[i]);
+      BSON_ASSERT(rc == 0);
+   }
+
+   for (int i = 0; i < SCRAM_CACHE_CONCURRENT_THREADS; i++) {
+      int rc = mcommon_thread_join(threads[i]);
+      BSON_ASSERT(rc == 0);
+   }
+}
+
 #endif
 
 enum {
@@ -747,6 +859,9 @@ test_scram_install(TestSuite *suite)
    TestSuite_Add(suite, "/scram/utf8_char_length", test_mongoc_utf8_char_length);
    TestSuite_Add(suite, "/scram/utf8_string_length", test_mongoc_utf8_string_length);
    TestSuite_Add(suite, "/scram/utf8_to_unicode", test_mongoc_utf8_to_unicode);
+   TestSuite_Add(suite, "/scram/cache/lookup", test_mongoc_scram_cache_lookup);
+   TestSuite_Add(suite, "/scram/cache/eviction", test_mongoc_scram_cache_eviction);
+   TestSuite_Add(suite, "/scram/cache/concurrent", test_mongoc_scram_cache_concurrent);
 #endif
    TestSuite_AddFull(suite,
                      "/scram/cache_invalidation [lock:live-server]",
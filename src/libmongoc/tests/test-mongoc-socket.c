@@ -1,5 +1,9 @@
+#include <mongoc/mongoc-client-private.h>
+#include <mongoc/mongoc-cluster-private.h>
 #include <mongoc/mongoc-errno-private.h>
+#include <mongoc/mongoc-set-private.h>
 #include <mongoc/mongoc-socket-private.h>
+#include <mongoc/mongoc-stream-private.h>
 #include <mongoc/mongoc-thread-private.h>
 #include <mongoc/mongoc-util-private.h>
 
@@ -8,7 +12,10 @@
 #include <mlib/cmp.h>
 #include <mlib/time_point.h>
 
+#include <mock_server/future-functions.h>
+#include <mock_server/mock-server.h>
 #include <TestSuite.h>
+#include <test-conveniences.h>
 #include <test-libmongoc.h>
 
 #include <fcntl.h>
@@ -409,6 +416,293 @@ test_mongoc_socket_sendv(void *ctx)
    mongoc_cond_destroy(&data.cond);
 }
 
+typedef struct {
+   mongoc_socket_t *sock;
+   size_t expected;
+   bool matched;
+} zerocopy_reader_t;
+
+
+static BSON_THREAD_FUN(zerocopy_test_reader, data_)
+{
+   zerocopy_reader_t *const reader = (zerocopy_reader_t *)data_;
+   uint8_t *const buf = bson_malloc(reader->expected);
+   size_t received = 0u;
+
+   while (received < reader->expected) {
+      const ssize_t r = mongoc_socket_recv(reader->sock, buf + received, reader->expected - received, 0, -1);
+      if (r <= 0) {
+         break;
+      }
+      received += (size_t)r;
+   }
+
+   reader->matched = received == reader->expected;
+   for (size_t i = 0u; reader->matched && i < received; i++) {
+      reader->matched = buf[i] == (uint8_t)(i % 251u);
+   }
+
+   bson_free(buf);
+
+   BSON_THREAD_RETURN;
+}
+
+
+static void
+test_mongoc_socket_sendv_zerocopy(void)
+{
+   struct sockaddr_in server_addr = {0};
+   mongoc_socklen_t sock_len = (mongoc_socklen_t)sizeof(server_addr);
+
+   mongoc_socket_t *const listen_sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+   BSON_ASSERT(listen_sock);
+
+   server_addr.sin_family = AF_INET;
+   server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   server_addr.sin_port = htons(0);
+
+   ASSERT_CMPINT(mongoc_socket_bind(listen_sock, (struct sockaddr *)&server_addr, sizeof server_addr), ==, 0);
+   ASSERT_CMPINT(mongoc_socket_getsockname(listen_sock, (struct sockaddr *)&server_addr, &sock_len), ==, 0);
+   ASSERT_CMPINT(mongoc_socket_listen(listen_sock, 10), ==, 0);
+
+   mongoc_socket_t *const client_sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+   BSON_ASSERT(client_sock);
+   ASSERT_CMPINT(mongoc_socket_connect(client_sock, (struct sockaddr *)&server_addr, sizeof(server_addr), -1), ==, 0);
+
+   mongoc_socket_t *const server_sock = mongoc_socket_accept(listen_sock, -1);
+   BSON_ASSERT(server_sock);
+
+   /* Whether the kernel supports SO_ZEROCOPY or not, the data must arrive
+    * intact and sendv must not return before the buffers are released. */
+   const bool enabled = _mongoc_socket_enable_zerocopy(client_sock, 64u * 1024u);
+
+   uint8_t *const buf = bson_malloc(gFourMB);
+   for (size_t i = 0u; i < gFourMB; i++) {
+      buf[i] = (uint8_t)(i % 251u);
+   }
+
+   /* Split the payload so that more than one iovec is sent. */
+   mongoc_iovec_t iov[2];
+   iov[0].iov_base = (char *)buf;
+   iov[0].iov_len = 100u;
+   iov[1].iov_base = (char *)buf + 100u;
+   iov[1].iov_len = gFourMB - 100u;
+
+   zerocopy_reader_t reader = {.sock = server_sock, .expected = gFourMB};
+   bson_thread_t thread;
+   ASSERT_CMPINT(mcommon_thread_create(&thread, zerocopy_test_reader, &reader), ==, 0);
+
+   const ssize_t sent = mongoc_socket_sendv(client_sock, iov, 2u, bson_get_monotonic_time() + TIMEOUT * 1000);
+   ASSERT_CMPSSIZE_T(sent, ==, (ssize_t)gFourMB);
+   ASSERT_CMPUINT32(client_sock->zerocopy_completed, ==, client_sock->zerocopy_issued);
+   if (!enabled) {
+      ASSERT_CMPUINT32(client_sock->zerocopy_issued, ==, 0u);
+   }
+
+   /* The buffer may be reused as soon as sendv returns. */
+   memset(buf, 0, gFourMB);
+
+   ASSERT_CMPINT(mcommon_thread_join(thread), ==, 0);
+   BSON_ASSERT(reader.matched);
+
+   bson_free(buf);
+   mongoc_socket_destroy(server_sock);
+   mongoc_socket_destroy(client_sock);
+   mongoc_socket_destroy(listen_sock);
+}
+
+
+/* Connect a client socket to a server socket over loopback. */
+static void
+_socket_pair(mongoc_socket_t **client_sock, mongoc_socket_t **server_sock)
+{
+   struct sockaddr_in server_addr = {0};
+   mongoc_socklen_t sock_len = (mongoc_socklen_t)sizeof(server_addr);
+
+   mongoc_socket_t *const listen_sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+   BSON_ASSERT(listen_sock);
+
+   server_addr.sin_family = AF_INET;
+   server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   server_addr.sin_port = htons(0);
+
+   ASSERT_CMPINT(mongoc_socket_bind(listen_sock, (struct sockaddr *)&server_addr, sizeof server_addr), ==, 0);
+   ASSERT_CMPINT(mongoc_socket_getsockname(listen_sock, (struct sockaddr *)&server_addr, &sock_len), ==, 0);
+   ASSERT_CMPINT(mongoc_socket_listen(listen_sock, 10), ==, 0);
+
+   *client_sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+   BSON_ASSERT(*client_sock);
+   ASSERT_CMPINT(mongoc_socket_connect(*client_sock, (struct sockaddr *)&server_addr, sizeof(server_addr), -1), ==, 0);
+
+   *server_sock = mongoc_socket_accept(listen_sock, -1);
+   BSON_ASSERT(*server_sock);
+
+   mongoc_socket_destroy(listen_sock);
+}
+
+
+static int
+skip_if_no_io_uring(void)
+{
+   mongoc_socket_t *const sock = mongoc_socket_new(AF_INET, SOCK_STREAM, 0);
+   mongoc_stream_t *const stream = mongoc_stream_uring_new(sock);
+   const bool available = stream != NULL;
+
+   if (stream) {
+      mongoc_stream_destroy(stream);
+   } else {
+      mongoc_socket_destroy(sock);
+   }
+
+   return available ? 1 : 0;
+}
+
+
+static void
+test_stream_uring_readv_writev(void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   mongoc_socket_t *client_sock;
+   mongoc_socket_t *server_sock;
+   char buf[16] = {0};
+   mongoc_iovec_t iov[2];
+
+   _socket_pair(&client_sock, &server_sock);
+
+   mongoc_stream_t *const stream = mongoc_stream_uring_new(client_sock);
+   BSON_ASSERT(stream);
+   BSON_ASSERT(mongoc_stream_uring_get_socket((mongoc_stream_uring_t *)stream) == client_sock);
+
+   /* A small message with several iovecs is coalesced into one send. */
+   iov[0].iov_base = "hello";
+   iov[0].iov_len = 5u;
+   iov[1].iov_base = " world";
+   iov[1].iov_len = 6u;
+   ASSERT_CMPSSIZE_T(mongoc_stream_writev(stream, iov, 2u, TIMEOUT), ==, 11);
+   ASSERT_CMPSSIZE_T(mongoc_socket_recv(server_sock, buf, 11u, 0, -1), ==, 11);
+   ASSERT_CMPSTR(buf, "hello world");
+
+   /* A small read is scattered from the registered buffer. */
+   char head[4];
+   char tail[7] = {0};
+   iov[0].iov_base = head;
+   iov[0].iov_len = sizeof head;
+   iov[1].iov_base = tail;
+   iov[1].iov_len = 6u;
+   ASSERT_CMPSSIZE_T(mongoc_socket_send(server_sock, "abcdefghij", 10u, -1), ==, 10);
+   ASSERT_CMPSSIZE_T(mongoc_stream_readv(stream, iov, 2u, 10u, TIMEOUT), ==, 10);
+   BSON_ASSERT(memcmp(head, "abcd", 4u) == 0);
+   ASSERT_CMPSTR(tail, "efghij");
+
+   /* Large messages bypass the registered buffer in both directions. */
+   uint8_t *const large = bson_malloc(gFourMB);
+   for (size_t i = 0u; i < gFourMB; i++) {
+      large[i] = (uint8_t)(i % 251u);
+   }
+
+   zerocopy_reader_t reader = {.sock = server_sock, .expected = gFourMB};
+   bson_thread_t thread;
+   ASSERT_CMPINT(mcommon_thread_create(&thread, zerocopy_test_reader, &reader), ==, 0);
+
+   iov[0].iov_base = (char *)large;
+   iov[0].iov_len = 100u;
+   iov[1].iov_base = (char *)large + 100u;
+   iov[1].iov_len = gFourMB - 100u;
+   ASSERT_CMPSSIZE_T(mongoc_stream_writev(stream, iov, 2u, TIMEOUT), ==, (ssize_t)gFourMB);
+   ASSERT_CMPINT(mcommon_thread_join(thread), ==, 0);
+   BSON_ASSERT(reader.matched);
+
+   const size_t read_len = 64u * 1024u;
+   ASSERT_CMPSSIZE_T(mongoc_socket_send(server_sock, large, read_len, -1), ==, (ssize_t)read_len);
+   memset(large, 0, read_len);
+   iov[0].iov_base = (char *)large;
+   iov[0].iov_len = read_len;
+   ASSERT_CMPSSIZE_T(mongoc_stream_readv(stream, iov, 1u, read_len, TIMEOUT), ==, (ssize_t)read_len);
+   for (size_t i = 0u; i < read_len; i++) {
+      BSON_ASSERT(large[i] == (uint8_t)(i % 251u));
+   }
+
+   bson_free(large);
+   mongoc_stream_destroy(stream);
+   mongoc_socket_destroy(server_sock);
+}
+
+
+static void
+test_stream_uring_timed_out(void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   mongoc_socket_t *client_sock;
+   mongoc_socket_t *server_sock;
+   char buf[4];
+   mongoc_iovec_t iov = {.iov_base = buf, .iov_len = sizeof buf};
+
+   _socket_pair(&client_sock, &server_sock);
+
+   mongoc_stream_t *const stream = mongoc_stream_uring_new(client_sock);
+   BSON_ASSERT(stream);
+
+   const mlib_time_point start = mlib_now();
+   ASSERT_CMPSSIZE_T(mongoc_stream_readv(stream, &iov, 1u, sizeof buf, 50), ==, -1);
+   ASSERT_CMPINT64(mlib_milliseconds_count(mlib_elapsed_since(start)), >=, 40);
+   BSON_ASSERT(mongoc_stream_timed_out(stream));
+   BSON_ASSERT(!mongoc_stream_should_retry(stream));
+
+   /* A zero timeout does not block. */
+   ASSERT_CMPSSIZE_T(mongoc_stream_readv(stream, &iov, 1u, sizeof buf, 0), ==, -1);
+   BSON_ASSERT(mongoc_stream_should_retry(stream));
+
+   /* The stream still works after a request was cancelled. */
+   BSON_ASSERT(!mongoc_stream_check_closed(stream));
+   ASSERT_CMPSSIZE_T(mongoc_socket_send(server_sock, "pong", 4u, -1), ==, 4);
+   ASSERT_CMPSSIZE_T(mongoc_stream_readv(stream, &iov, 1u, sizeof buf, TIMEOUT), ==, 4);
+   BSON_ASSERT(memcmp(buf, "pong", 4u) == 0);
+
+   mongoc_socket_destroy(server_sock);
+   iov.iov_base = buf;
+   iov.iov_len = sizeof buf;
+   ASSERT_CMPSSIZE_T(mongoc_stream_readv(stream, &iov, 1u, sizeof buf, TIMEOUT), ==, -1);
+   BSON_ASSERT(!mongoc_stream_timed_out(stream));
+   BSON_ASSERT(mongoc_stream_check_closed(stream));
+
+   mongoc_stream_destroy(stream);
+}
+
+
+static void
+test_stream_uring_pooled(void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   bson_error_t error;
+
+   mock_server_t *const server = mock_server_with_auto_hello(WIRE_VERSION_MAX);
+   mock_server_run(server);
+
+   mongoc_uri_t *const uri = mongoc_uri_copy(mock_server_get_uri(server));
+   mongoc_uri_set_option_as_bool(uri, MONGOC_URI_USEIOURING, true);
+   mongoc_client_pool_t *const pool = test_framework_client_pool_new_from_uri(uri, NULL);
+   mongoc_client_t *const client = mongoc_client_pool_pop(pool);
+
+   future_t *const future = future_client_command_simple(client, "admin", tmp_bson("{'ping': 1}"), NULL, NULL, &error);
+   request_t *const request = mock_server_receives_msg(server, MONGOC_MSG_NONE, tmp_bson("{'ping': 1}"));
+   reply_to_request_with_ok_and_destroy(request);
+   ASSERT_OR_PRINT(future_get_bool(future), error);
+   future_destroy(future);
+
+   const mongoc_cluster_node_t *const node = mongoc_set_get_item(client->cluster.nodes, 0);
+   BSON_ASSERT(node);
+   ASSERT_CMPINT(mongoc_stream_get_root_stream(node->stream)->type, ==, MONGOC_STREAM_URING);
+
+   mongoc_client_pool_push(pool, client);
+   mongoc_client_pool_destroy(pool);
+   mongoc_uri_destroy(uri);
+   mock_server_destroy(server);
+}
+
+
 void
 test_socket_install(TestSuite *suite)
 {
@@ -417,4 +711,9 @@ test_socket_install(TestSuite *suite)
       suite, "/Socket/timed_out [timeout:30]", test_mongoc_socket_timed_out, NULL, NULL, test_framework_skip_if_slow);
    TestSuite_AddFull(
       suite, "/Socket/sendv [timeout:30]", test_mongoc_socket_sendv, NULL, NULL, test_framework_skip_if_slow);
+   TestSuite_Add(suite, "/Socket/sendv/zerocopy", test_mongoc_socket_sendv_zerocopy);
+   TestSuite_AddFull(
+      suite, "/Stream/uring/readv_writev", test_stream_uring_readv_writev, NULL, NULL, skip_if_no_io_uring);
+   TestSuite_AddFull(suite, "/Stream/uring/timed_out", test_stream_uring_timed_out, NULL, NULL, skip_if_no_io_uring);
+   TestSuite_AddFull(suite, "/Stream/uring/pooled", test_stream_uring_pooled, NULL, NULL, skip_if_no_io_uring);
 }
@@ -1,5 +1,6 @@
 #include <common-oid-private.h>
 #include <mongoc/mongoc-client-private.h>
+#include <mongoc/mongoc-dns-cache-private.h>
 #include <mongoc/mongoc-host-list-private.h>
 #include <mongoc/mongoc-socket-private.h>
 #include <mongoc/mongoc-stream-private.h>
@@ -550,6 +551,187 @@ test_topology_scanner_dns(void)
    }
 }
 
+typedef struct {
+   bson_mutex_t mutex;
+   int ncalls;
+   bool fail;
+   int64_t delay_ms;
+} dns_stub_t;
+
+static int
+_dns_stub_resolve(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res, void *ctx)
+{
+   dns_stub_t *stub = ctx;
+   bool fail;
+   int64_t delay_ms;
+
+   BSON_UNUSED(node);
+   BSON_UNUSED(service);
+   BSON_UNUSED(hints);
+
+   bson_mutex_lock(&stub->mutex);
+   stub->ncalls++;
+   fail = stub->fail;
+   delay_ms = stub->delay_ms;
+   bson_mutex_unlock(&stub->mutex);
+
+   if (delay_ms) {
+      mlib_sleep_for(delay_ms, ms);
+   }
+
+   if (fail) {
+      return EAI_NONAME;
+   }
+
+   *res = bson_malloc0(sizeof **res);
+   (*res)->ai_family = AF_INET;
+   return 0;
+}
+
+static void
+_dns_stub_free(struct addrinfo *res, void *ctx)
+{
+   BSON_UNUSED(ctx);
+
+   bson_free(res);
+}
+
+static int
+_dns_stub_ncalls(dns_stub_t *stub)
+{
+   int ncalls;
+
+   bson_mutex_lock(&stub->mutex);
+   ncalls = stub->ncalls;
+   bson_mutex_unlock(&stub->mutex);
+
+   return ncalls;
+}
+
+static void
+test_dns_cache(void)
+{
+   dns_stub_t stub = {0};
+   mongoc_dns_cache_t *cache;
+   mongoc_dns_result_t *result;
+   mongoc_dns_result_t *again;
+   mongoc_host_list_t host;
+   mongoc_host_list_t other;
+   bson_error_t error;
+
+   bson_mutex_init(&stub.mutex);
+   cache = _mongoc_dns_cache_new();
+   _mongoc_dns_cache_set_resolver(cache, _dns_stub_resolve, _dns_stub_free, &stub);
+   BSON_ASSERT(_mongoc_host_list_from_string(&host, "a.example.com:27017"));
+   BSON_ASSERT(_mongoc_host_list_from_string(&other, "a.example.com:27018"));
+
+   /* a second lookup of the same host is served from the cache */
+   result = _mongoc_dns_cache_lookup(cache, &host, &error);
+   ASSERT_OR_PRINT(result, error);
+   again = _mongoc_dns_cache_lookup(cache, &host, &error);
+   ASSERT_OR_PRINT(again, error);
+   ASSERT(_mongoc_dns_result_addrinfo(result) == _mongoc_dns_result_addrinfo(again));
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 1);
+   _mongoc_dns_result_release(again);
+
+   /* the port is part of the key */
+   again = _mongoc_dns_cache_lookup(cache, &other, &error);
+   ASSERT_OR_PRINT(again, error);
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 2);
+   _mongoc_dns_result_release(again);
+
+   /* an invalidated result is resolved again, and the old result stays valid
+    * for its holders */
+   _mongoc_dns_cache_invalidate(cache, &host);
+   again = _mongoc_dns_cache_lookup(cache, &host, &error);
+   ASSERT_OR_PRINT(again, error);
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 3);
+   ASSERT(_mongoc_dns_result_addrinfo(result) != _mongoc_dns_result_addrinfo(again));
+   ASSERT_CMPINT(_mongoc_dns_result_addrinfo(result)->ai_family, ==, AF_INET);
+   _mongoc_dns_result_release(again);
+   _mongoc_dns_result_release(result);
+
+   /* failures are cached for the negative TTL */
+   _mongoc_dns_cache_set_ttl(cache, 0, 60 * 1000);
+   _mongoc_dns_cache_invalidate(cache, &host);
+   stub.fail = true;
+   ASSERT(!_mongoc_dns_cache_lookup(cache, &host, &error));
+   ASSERT_ERROR_CONTAINS(
+      error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_NAME_RESOLUTION, "Failed to resolve 'a.example.com'");
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 4);
+   memset(&error, 0, sizeof error);
+   ASSERT(!_mongoc_dns_cache_lookup(cache, &host, &error));
+   ASSERT_ERROR_CONTAINS(
+      error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_NAME_RESOLUTION, "Failed to resolve 'a.example.com'");
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 4);
+
+   /* with no TTL, every lookup resolves */
+   _mongoc_dns_cache_set_ttl(cache, 0, 0);
+   _mongoc_dns_cache_invalidate(cache, &host);
+   stub.fail = false;
+   result = _mongoc_dns_cache_lookup(cache, &host, &error);
+   ASSERT_OR_PRINT(result, error);
+   _mongoc_dns_result_release(result);
+   result = _mongoc_dns_cache_lookup(cache, &host, &error);
+   ASSERT_OR_PRINT(result, error);
+   _mongoc_dns_result_release(result);
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 6);
+
+   _mongoc_dns_cache_destroy(cache);
+   bson_mutex_destroy(&stub.mutex);
+}
+
+typedef struct {
+   mongoc_dns_cache_t *cache;
+   mongoc_host_list_t host;
+   bool ok;
+} dns_lookup_thread_t;
+
+static BSON_THREAD_FUN(_dns_lookup_thread, data)
+{
+   dns_lookup_thread_t *ctx = data;
+   mongoc_dns_result_t *result;
+   bson_error_t error;
+
+   result = _mongoc_dns_cache_lookup(ctx->cache, &ctx->host, &error);
+   ctx->ok = result != NULL;
+   _mongoc_dns_result_release(result);
+
+   BSON_THREAD_RETURN;
+}
+
+/* concurrent lookups of one host call the resolver once */
+static void
+test_dns_cache_single_flight(void)
+{
+   dns_stub_t stub = {0};
+   mongoc_dns_cache_t *cache;
+   dns_lookup_thread_t ctx[8];
+   bson_thread_t threads[8];
+
+   bson_mutex_init(&stub.mutex);
+   stub.delay_ms = 100;
+   cache = _mongoc_dns_cache_new();
+   _mongoc_dns_cache_set_resolver(cache, _dns_stub_resolve, _dns_stub_free, &stub);
+
+   for (size_t i = 0; i < 8; i++) {
+      ctx[i].cache = cache;
+      ctx[i].ok = false;
+      BSON_ASSERT(_mongoc_host_list_from_string(&ctx[i].host, "a.example.com:27017"));
+      ASSERT_CMPINT(0, ==, mcommon_thread_create(&threads[i], _dns_lookup_thread, &ctx[i]));
+   }
+
+   for (size_t i = 0; i < 8; i++) {
+      ASSERT_CMPINT(0, ==, mcommon_thread_join(threads[i]));
+      ASSERT(ctx[i].ok);
+   }
+
+   ASSERT_CMPINT(_dns_stub_ncalls(&stub), ==, 1);
+
+   _mongoc_dns_cache_destroy(cache);
+   bson_mutex_destroy(&stub.mutex);
+}
+
 static void
 _retired_fails_to_initiate_cb(
    uint32_t id, const bson_t *bson, int64_t rtt_msec, void *data, const bson_error_t *error /* IN */)
@@ -716,6 +898,8 @@ test_topology_scanner_install(TestSuite *suite)
    TestSuite_AddMockServerTest(
       suite, "/TOPOLOGY/dns", test_topology_scanner_dns, test_framework_skip_if_no_dual_ip_hostname);
    TestSuite_AddMockServerTest(suite, "/TOPOLOGY/retired_fails_to_initiate", test_topology_retired_fails_to_initiate);
+   TestSuite_Add(suite, "/TOPOLOGY/dns_cache", test_dns_cache);
+   TestSuite_Add(suite, "/TOPOLOGY/dns_cache/single_flight", test_dns_cache_single_flight);
    TestSuite_AddFull(suite,
                      "/TOPOLOGY/scanner/renegotiate/single [lock:live-server][timeout:30]",
                      test_topology_scanner_does_not_renegotiate_single,
@@ -6,6 +6,8 @@
 #include <mongoc/mongoc-uri-private.h>
 #include <mongoc/mongoc-util-private.h>
 
+#include <common-atomic-private.h>
+
 #include <mongoc/mongoc.h>
 
 #include <mlib/time_point.h>
@@ -2585,6 +2587,78 @@ test_detect_nongenuine_hosts(void)
    }
 }
 
+typedef struct {
+   mongoc_topology_t *topology;
+   bool ok;
+   bson_error_t error;
+   int done;
+} connecting_args_t;
+
+static BSON_THREAD_FUN(connecting_worker, arg)
+{
+   connecting_args_t *args = arg;
+
+   args->ok = _mongoc_topology_connecting_begin(args->topology, 1, &args->error);
+   mcommon_atomic_int_exchange(&args->done, 1, mcommon_memory_order_seq_cst);
+   BSON_THREAD_RETURN;
+}
+
+static bool
+connecting_worker_done(connecting_args_t *args)
+{
+   return mcommon_atomic_int_fetch(&args->done, mcommon_memory_order_seq_cst) == 1;
+}
+
+static void
+test_max_connecting(void)
+{
+   mongoc_uri_t *uri;
+   mongoc_topology_t *topology;
+   bson_error_t error;
+   bson_thread_t thread;
+   connecting_args_t args = {0};
+
+   uri = mongoc_uri_new("mongodb://localhost:27017/?maxConnecting=1&connectTimeoutMS=100");
+   topology = mongoc_topology_new(uri, false /* pooled */);
+   ASSERT_CMPINT32(topology->max_connecting, ==, 1);
+
+   /* the limit applies per server */
+   ASSERT_OR_PRINT(_mongoc_topology_connecting_begin(topology, 1, &error), error);
+   ASSERT_OR_PRINT(_mongoc_topology_connecting_begin(topology, 2, &error), error);
+   _mongoc_topology_connecting_end(topology, 2);
+
+   /* waiting for a slot is bounded by connectTimeoutMS */
+   ASSERT(!_mongoc_topology_connecting_begin(topology, 1, &error));
+   ASSERT_ERROR_CONTAINS(error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_CONNECT, "maxConnecting");
+
+   /* a waiter takes the slot once it is released */
+   topology->connect_timeout_msec = 10 * 1000;
+   args.topology = topology;
+   BSON_ASSERT(mcommon_thread_create(&thread, connecting_worker, &args) == 0);
+   mlib_sleep_for(100, ms);
+   ASSERT(!connecting_worker_done(&args));
+   _mongoc_topology_connecting_end(topology, 1);
+   mcommon_thread_join(thread);
+   ASSERT_OR_PRINT(args.ok, args.error);
+
+   /* a waiter fails early if the server is marked unknown while it waits */
+   args.done = 0;
+   BSON_ASSERT(mcommon_thread_create(&thread, connecting_worker, &args) == 0);
+   mlib_sleep_for(100, ms);
+   ASSERT(!connecting_worker_done(&args));
+   _mongoc_topology_invalidate_server(topology, 1);
+   _mongoc_topology_connecting_end(topology, 1);
+   mcommon_thread_join(thread);
+   ASSERT(!args.ok);
+   ASSERT_ERROR_CONTAINS(args.error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_CONNECT, "invalidated");
+
+   /* all slots were released */
+   ASSERT_CMPSIZE_T(topology->connecting->items_len, ==, 0);
+
+   mongoc_topology_destroy(topology);
+   mongoc_uri_destroy(uri);
+}
+
 void
 test_topology_install(TestSuite *suite)
 {
@@ -2702,5 +2776,6 @@ test_topology_install(TestSuite *suite)
    TestSuite_AddMockServerTest(suite, "/Topology/hello_ok/single", test_hello_ok_single);
    TestSuite_AddMockServerTest(suite, "/Topology/hello_ok/pooled", test_hello_ok_pooled);
    TestSuite_AddMockServerTest(suite, "/Topology/failure_to_setup_after_retry", test_failure_to_setup_after_retry);
+   TestSuite_Add(suite, "/Topology/max_connecting", test_max_connecting);
    TestSuite_Add(suite, "/Topology/detect_nongenuine_hosts [lock:live-server]", test_detect_nongenuine_hosts);
 }
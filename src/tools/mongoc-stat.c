@@ -53,7 +53,13 @@ typedef struct {
    uint32_t n_counters;
    uint32_t infos_offset;
    uint32_t values_offset;
-   uint8_t padding[44];
+   uint32_t n_histograms;
+   uint32_t histogram_infos_offset;
+   uint32_t histogram_values_offset;
+   uint32_t n_servers;
+   uint32_t servers_offset;
+   uint32_t server_values_offset;
+   uint8_t padding[20];
 } mongoc_counters_t;
 #pragma pack()
 
@@ -74,6 +80,62 @@ typedef struct {
 } mongoc_counter_t;
 
 
+#pragma pack(1)
+typedef struct {
+   uint32_t offset;
+   uint16_t n_buckets;
+   uint16_t sub_bucket_bits;
+   char category[24];
+   char name[32];
+   char description[64];
+} mongoc_histogram_info_t;
+#pragma pack()
+
+
+BSON_STATIC_ASSERT2 (sizeof_histogram_info_t, sizeof (mongoc_histogram_info_t) == 128);
+
+
+#define HISTOGRAM_N_BUCKETS 240
+#define HISTOGRAM_SUB_BUCKET_BITS 3
+
+
+typedef struct {
+   int64_t buckets[HISTOGRAM_N_BUCKETS];
+   int64_t sum;
+   int64_t padding[15];
+} mongoc_histogram_slots_t;
+
+
+BSON_STATIC_ASSERT2 (sizeof_histogram_slots, sizeof (mongoc_histogram_slots_t) == 2048);
+
+
+typedef struct {
+   char host_and_port[64];
+} mongoc_counters_server_t;
+
+
+BSON_STATIC_ASSERT2 (sizeof_counters_server, sizeof (mongoc_counters_server_t) == 64);
+
+
+/* One CPU's share of a server's totals. */
+typedef struct {
+   int64_t messages_out;
+   int64_t messages_in;
+   int64_t bytes_out;
+   int64_t bytes_in;
+   int64_t compressed_bytes_out;
+   int64_t uncompressed_bytes_out;
+   int64_t compressed_bytes_in;
+   int64_t uncompressed_bytes_in;
+   int64_t in_flight_usec;
+   int64_t errors;
+   int64_t padding[6];
+} mongoc_wire_stats_slot_t;
+
+
+BSON_STATIC_ASSERT2 (sizeof_wire_stats_slot, sizeof (mongoc_wire_stats_slot_t) == 128);
+
+
 static void
 mongoc_counters_destroy (mongoc_counters_t *counters)
 {
@@ -187,6 +249,158 @@ mongoc_counters_print_info (mongoc_counters_t *counters, mongoc_counter_info_t *
 }
 
 
+/* The largest value recorded into bucket @idx. */
+static int64_t
+mongoc_histogram_bucket_upper (uint32_t idx)
+{
+   const uint32_t sub_buckets = 1u << HISTOGRAM_SUB_BUCKET_BITS;
+   uint32_t next = idx + 1;
+
+   if (next < sub_buckets) {
+      return (int64_t) idx;
+   }
+
+   return ((int64_t) (sub_buckets + next % sub_buckets) << (next / sub_buckets - 1)) - 1;
+}
+
+
+static int64_t
+mongoc_histogram_percentile (const int64_t *buckets, int64_t count, double pct)
+{
+   int64_t rank = (int64_t) ((double) count * pct / 100.0 + 0.5);
+   int64_t seen = 0;
+   uint32_t i;
+
+   if (rank < 1) {
+      rank = 1;
+   }
+
+   for (i = 0; i < HISTOGRAM_N_BUCKETS; i++) {
+      seen += buckets[i];
+      if (seen >= rank) {
+         return mongoc_histogram_bucket_upper (i);
+      }
+   }
+
+   return 0;
+}
+
+
+static void
+mongoc_counters_print_histogram (mongoc_counters_t *counters, mongoc_histogram_info_t *info, FILE *file)
+{
+   const mongoc_histogram_slots_t *cpus;
+   int64_t buckets[HISTOGRAM_N_BUCKETS] = {0};
+   int64_t count = 0;
+   int64_t sum = 0;
+   unsigned i;
+   uint32_t j;
+
+   BSON_ASSERT (info);
+   BSON_ASSERT (file);
+   BSON_ASSERT ((info->offset & 0x3f) == 0);
+
+   if (info->n_buckets != HISTOGRAM_N_BUCKETS || info->sub_bucket_bits != HISTOGRAM_SUB_BUCKET_BITS) {
+      fprintf (file, "%24s : %-24s : unsupported histogram layout\n", info->category, info->name);
+      return;
+   }
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wcast-align"
+#endif
+   cpus = (const mongoc_histogram_slots_t *) (((char *) counters) + info->offset);
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+   for (i = 0; i < counters->n_cpu; i++) {
+      for (j = 0; j < HISTOGRAM_N_BUCKETS; j++) {
+         buckets[j] += cpus[i].buckets[j];
+      }
+      sum += cpus[i].sum;
+   }
+
+   for (j = 0; j < HISTOGRAM_N_BUCKETS; j++) {
+      count += buckets[j];
+   }
+
+   fprintf (
+      file, "%24s : %-24s : %-50s : count=%lld", info->category, info->name, info->description, (long long) count);
+
+   if (count > 0) {
+      int64_t max = 0;
+
+      for (j = 0; j < HISTOGRAM_N_BUCKETS; j++) {
+         if (buckets[j]) {
+            max = mongoc_histogram_bucket_upper (j);
+         }
+      }
+
+      fprintf (file,
+               " mean=%lldus p50=%lldus p90=%lldus p99=%lldus p99.9=%lldus max=%lldus",
+               (long long) (sum / count),
+               (long long) mongoc_histogram_percentile (buckets, count, 50.0),
+               (long long) mongoc_histogram_percentile (buckets, count, 90.0),
+               (long long) mongoc_histogram_percentile (buckets, count, 99.0),
+               (long long) mongoc_histogram_percentile (buckets, count, 99.9),
+               (long long) max);
+   }
+
+   fprintf (file, "\n");
+}
+
+
+/* The size of compressed messages as a percentage of their original size. */
+static double
+mongoc_server_compression_pct (int64_t compressed, int64_t uncompressed)
+{
+   return uncompressed > 0 ? 100.0 * (double) compressed / (double) uncompressed : 100.0;
+}
+
+
+static void
+mongoc_counters_print_server (const mongoc_counters_server_t *server,
+                              const mongoc_wire_stats_slot_t *cpus,
+                              uint32_t n_cpu,
+                              FILE *file)
+{
+   mongoc_wire_stats_slot_t sum = {0};
+   uint32_t i;
+
+   BSON_ASSERT (server);
+   BSON_ASSERT (cpus);
+   BSON_ASSERT (file);
+
+   for (i = 0; i < n_cpu; i++) {
+      sum.messages_out += cpus[i].messages_out;
+      sum.messages_in += cpus[i].messages_in;
+      sum.bytes_out += cpus[i].bytes_out;
+      sum.bytes_in += cpus[i].bytes_in;
+      sum.compressed_bytes_out += cpus[i].compressed_bytes_out;
+      sum.uncompressed_bytes_out += cpus[i].uncompressed_bytes_out;
+      sum.compressed_bytes_in += cpus[i].compressed_bytes_in;
+      sum.uncompressed_bytes_in += cpus[i].uncompressed_bytes_in;
+      sum.in_flight_usec += cpus[i].in_flight_usec;
+      sum.errors += cpus[i].errors;
+   }
+
+   fprintf (file,
+            "%24s : %-24s : msgs out=%lld in=%lld bytes out=%lld in=%lld"
+            " compressed out=%.1f%% in=%.1f%% avg in-flight=%lldus errors=%lld\n",
+            "Servers",
+            server->host_and_port,
+            (long long) sum.messages_out,
+            (long long) sum.messages_in,
+            (long long) sum.bytes_out,
+            (long long) sum.bytes_in,
+            mongoc_server_compression_pct (sum.compressed_bytes_out, sum.uncompressed_bytes_out),
+            mongoc_server_compression_pct (sum.compressed_bytes_in, sum.uncompressed_bytes_in),
+            (long long) (sum.messages_in > 0 ? sum.in_flight_usec / sum.messages_in : 0),
+            (long long) sum.errors);
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -212,6 +426,36 @@ main (int argc, char *argv[])
       mongoc_counters_print_info (counters, &infos[i], stdout);
    }
 
+   /* Segments written by drivers that predate histograms leave these zeroed. */
+   if (counters->n_histograms > 0) {
+      mongoc_histogram_info_t *histogram_infos =
+         (mongoc_histogram_info_t *) (((char *) counters) + counters->histogram_infos_offset);
+
+      for (i = 0; i < counters->n_histograms; i++) {
+         mongoc_counters_print_histogram (counters, &histogram_infos[i], stdout);
+      }
+   }
+
+   /* Likewise for segments that predate per-server slots. */
+   if (counters->n_servers > 0) {
+      const mongoc_counters_server_t *servers;
+      const mongoc_wire_stats_slot_t *values;
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wcast-align"
+#endif
+      servers = (const mongoc_counters_server_t *) (((char *) counters) + counters->servers_offset);
+      values = (const mongoc_wire_stats_slot_t *) (((char *) counters) + counters->server_values_offset);
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+      for (i = 0; i < counters->n_servers; i++) {
+         mongoc_counters_print_server (&servers[i], &values[i * counters->n_cpu], counters->n_cpu, stdout);
+      }
+   }
+
    mongoc_counters_destroy (counters);
 
    return EXIT_SUCCESS;